@@ -0,0 +1,274 @@
+#include "Batch.hpp"
+#include "RealMatrix4x3.hpp"
+#include "RealQuaternion.hpp"
+
+#include <intrin.h>
+#include <xmmintrin.h>
+
+namespace
+{
+	using Blam::Math::RealVector3D;
+
+	// out = translation + p.I * x + p.J * y + p.K * z
+	struct AffineTransform
+	{
+		RealVector3D X;
+		RealVector3D Y;
+		RealVector3D Z;
+		RealVector3D Translation;
+	};
+
+	bool DetectSse();
+
+	bool sseSupported = DetectSse();
+	bool sseEnabled = sseSupported;
+
+	AffineTransform FromMatrix(const Blam::Math::RealMatrix4x3 &matrix, bool includePosition);
+	AffineTransform FromQuaternion(const Blam::Math::RealQuaternion &rotation, const RealVector3D &translation);
+
+	void TransformScalar(const AffineTransform &transform, const RealVector3D *points, RealVector3D *out, size_t count);
+	void TransformSse(const AffineTransform &transform, const RealVector3D *points, RealVector3D *out, size_t count);
+	void DistancesSquaredScalar(const RealVector3D &origin, const RealVector3D *points, float *out, size_t count);
+	void DistancesSquaredSse(const RealVector3D &origin, const RealVector3D *points, float *out, size_t count);
+	size_t PointsInBoundsScalar(const Blam::Math::Bounds<RealVector3D> &bounds, const RealVector3D *points, uint8_t *out, size_t count);
+	size_t PointsInBoundsSse(const Blam::Math::Bounds<RealVector3D> &bounds, const RealVector3D *points, uint8_t *out, size_t count);
+
+	void Transform(const AffineTransform &transform, const RealVector3D *points, RealVector3D *out, size_t count)
+	{
+		if (sseEnabled)
+			TransformSse(transform, points, out, count);
+		else
+			TransformScalar(transform, points, out, count);
+	}
+}
+
+namespace Blam::Math::Batch
+{
+	bool IsSseSupported()
+	{
+		return sseSupported;
+	}
+
+	void SetSseEnabled(bool enabled)
+	{
+		sseEnabled = enabled && sseSupported;
+	}
+
+	bool IsSseEnabled()
+	{
+		return sseEnabled;
+	}
+
+	void TransformPoints(const RealMatrix4x3 &matrix, const RealVector3D *points, RealVector3D *out, size_t count)
+	{
+		Transform(FromMatrix(matrix, true), points, out, count);
+	}
+
+	void TransformVectors(const RealMatrix4x3 &matrix, const RealVector3D *vectors, RealVector3D *out, size_t count)
+	{
+		Transform(FromMatrix(matrix, false), vectors, out, count);
+	}
+
+	void TransformPoints(const RealQuaternion &rotation, const RealVector3D &translation, const RealVector3D *points, RealVector3D *out, size_t count)
+	{
+		Transform(FromQuaternion(rotation, translation), points, out, count);
+	}
+
+	void DistancesSquared(const RealVector3D &origin, const RealVector3D *points, float *out, size_t count)
+	{
+		if (sseEnabled)
+			DistancesSquaredSse(origin, points, out, count);
+		else
+			DistancesSquaredScalar(origin, points, out, count);
+	}
+
+	size_t PointsInBounds(const Bounds<RealVector3D> &bounds, const RealVector3D *points, uint8_t *out, size_t count)
+	{
+		if (sseEnabled)
+			return PointsInBoundsSse(bounds, points, out, count);
+		return PointsInBoundsScalar(bounds, points, out, count);
+	}
+}
+
+namespace
+{
+	bool DetectSse()
+	{
+		int info[4];
+		__cpuid(info, 0);
+		if (info[0] < 1)
+			return false;
+
+		__cpuid(info, 1);
+		return (info[3] & (1 << 25)) != 0; // EDX bit 25
+	}
+
+	AffineTransform FromMatrix(const Blam::Math::RealMatrix4x3 &matrix, bool includePosition)
+	{
+		AffineTransform result;
+		result.X = matrix.Forward * matrix.Scale;
+		result.Y = matrix.Left * matrix.Scale;
+		result.Z = matrix.Up * matrix.Scale;
+		result.Translation = includePosition ? matrix.Position : RealVector3D();
+		return result;
+	}
+
+	AffineTransform FromQuaternion(const Blam::Math::RealQuaternion &rotation, const RealVector3D &translation)
+	{
+		// Same coefficients as RealVector3D::Transform so the results match it
+		auto x2 = rotation.I + rotation.I;
+		auto y2 = rotation.J + rotation.J;
+		auto z2 = rotation.K + rotation.K;
+
+		auto wx2 = rotation.W * x2;
+		auto wy2 = rotation.W * y2;
+		auto wz2 = rotation.W * z2;
+		auto xx2 = rotation.I * x2;
+		auto xy2 = rotation.I * y2;
+		auto xz2 = rotation.I * z2;
+		auto yy2 = rotation.J * y2;
+		auto yz2 = rotation.J * z2;
+		auto zz2 = rotation.K * z2;
+
+		AffineTransform result;
+		result.X = RealVector3D(1.0f - yy2 - zz2, xy2 + wz2, xz2 - wy2);
+		result.Y = RealVector3D(xy2 - wz2, 1.0f - xx2 - zz2, yz2 + wx2);
+		result.Z = RealVector3D(xz2 + wy2, yz2 - wx2, 1.0f - xx2 - yy2);
+		result.Translation = translation;
+		return result;
+	}
+
+	// Loads 4 packed vectors (12 floats) and splits them into one register per component.
+	inline void LoadVectors(const RealVector3D *vectors, __m128 &i, __m128 &j, __m128 &k)
+	{
+		auto data = reinterpret_cast<const float *>(vectors);
+		auto a = _mm_loadu_ps(data);     // i0 j0 k0 i1
+		auto b = _mm_loadu_ps(data + 4); // j1 k1 i2 j2
+		auto c = _mm_loadu_ps(data + 8); // k2 i3 j3 k3
+
+		i = _mm_shuffle_ps(a, _mm_shuffle_ps(b, c, _MM_SHUFFLE(1, 1, 2, 2)), _MM_SHUFFLE(2, 0, 3, 0));
+		j = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 1, 1)), _mm_shuffle_ps(b, c, _MM_SHUFFLE(2, 2, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0));
+		k = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 1, 2, 2)), c, _MM_SHUFFLE(3, 0, 2, 0));
+	}
+
+	// Inverse of LoadVectors.
+	inline void StoreVectors(RealVector3D *vectors, __m128 i, __m128 j, __m128 k)
+	{
+		auto a = _mm_shuffle_ps(_mm_shuffle_ps(i, j, _MM_SHUFFLE(0, 0, 0, 0)), _mm_shuffle_ps(k, i, _MM_SHUFFLE(1, 1, 0, 0)), _MM_SHUFFLE(2, 0, 2, 0));
+		auto b = _mm_shuffle_ps(_mm_shuffle_ps(j, k, _MM_SHUFFLE(1, 1, 1, 1)), _mm_shuffle_ps(i, j, _MM_SHUFFLE(2, 2, 2, 2)), _MM_SHUFFLE(2, 0, 2, 0));
+		auto c = _mm_shuffle_ps(_mm_shuffle_ps(k, i, _MM_SHUFFLE(3, 3, 2, 2)), _mm_shuffle_ps(j, k, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0));
+
+		auto data = reinterpret_cast<float *>(vectors);
+		_mm_storeu_ps(data, a);
+		_mm_storeu_ps(data + 4, b);
+		_mm_storeu_ps(data + 8, c);
+	}
+
+	void TransformScalar(const AffineTransform &transform, const RealVector3D *points, RealVector3D *out, size_t count)
+	{
+		auto &x = transform.X;
+		auto &y = transform.Y;
+		auto &z = transform.Z;
+		auto &t = transform.Translation;
+		for (size_t n = 0; n < count; n++)
+		{
+			auto p = points[n];
+			out[n] = RealVector3D(
+				p.I * x.I + p.J * y.I + p.K * z.I + t.I,
+				p.I * x.J + p.J * y.J + p.K * z.J + t.J,
+				p.I * x.K + p.J * y.K + p.K * z.K + t.K);
+		}
+	}
+
+	void TransformSse(const AffineTransform &transform, const RealVector3D *points, RealVector3D *out, size_t count)
+	{
+		auto xi = _mm_set1_ps(transform.X.I), xj = _mm_set1_ps(transform.X.J), xk = _mm_set1_ps(transform.X.K);
+		auto yi = _mm_set1_ps(transform.Y.I), yj = _mm_set1_ps(transform.Y.J), yk = _mm_set1_ps(transform.Y.K);
+		auto zi = _mm_set1_ps(transform.Z.I), zj = _mm_set1_ps(transform.Z.J), zk = _mm_set1_ps(transform.Z.K);
+		auto ti = _mm_set1_ps(transform.Translation.I), tj = _mm_set1_ps(transform.Translation.J), tk = _mm_set1_ps(transform.Translation.K);
+
+		size_t n = 0;
+		for (; n + 4 <= count; n += 4)
+		{
+			__m128 pi, pj, pk;
+			LoadVectors(&points[n], pi, pj, pk);
+
+			// Same operation order as the scalar version so the results are identical
+			auto ri = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(pi, xi), _mm_mul_ps(pj, yi)), _mm_mul_ps(pk, zi)), ti);
+			auto rj = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(pi, xj), _mm_mul_ps(pj, yj)), _mm_mul_ps(pk, zj)), tj);
+			auto rk = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(pi, xk), _mm_mul_ps(pj, yk)), _mm_mul_ps(pk, zk)), tk);
+
+			StoreVectors(&out[n], ri, rj, rk);
+		}
+		TransformScalar(transform, &points[n], &out[n], count - n);
+	}
+
+	void DistancesSquaredScalar(const RealVector3D &origin, const RealVector3D *points, float *out, size_t count)
+	{
+		for (size_t n = 0; n < count; n++)
+			out[n] = (points[n] - origin).Length2();
+	}
+
+	void DistancesSquaredSse(const RealVector3D &origin, const RealVector3D *points, float *out, size_t count)
+	{
+		auto oi = _mm_set1_ps(origin.I), oj = _mm_set1_ps(origin.J), ok = _mm_set1_ps(origin.K);
+
+		size_t n = 0;
+		for (; n + 4 <= count; n += 4)
+		{
+			__m128 pi, pj, pk;
+			LoadVectors(&points[n], pi, pj, pk);
+
+			auto di = _mm_sub_ps(pi, oi);
+			auto dj = _mm_sub_ps(pj, oj);
+			auto dk = _mm_sub_ps(pk, ok);
+			_mm_storeu_ps(&out[n], _mm_add_ps(_mm_add_ps(_mm_mul_ps(di, di), _mm_mul_ps(dj, dj)), _mm_mul_ps(dk, dk)));
+		}
+		DistancesSquaredScalar(origin, &points[n], &out[n], count - n);
+	}
+
+	size_t PointsInBoundsScalar(const Blam::Math::Bounds<RealVector3D> &bounds, const RealVector3D *points, uint8_t *out, size_t count)
+	{
+		auto &lower = bounds.Lower;
+		auto &upper = bounds.Upper;
+
+		size_t inside = 0;
+		for (size_t n = 0; n < count; n++)
+		{
+			auto &p = points[n];
+			auto result = p.I >= lower.I && p.I <= upper.I
+				&& p.J >= lower.J && p.J <= upper.J
+				&& p.K >= lower.K && p.K <= upper.K;
+
+			out[n] = result ? 1 : 0;
+			inside += out[n];
+		}
+		return inside;
+	}
+
+	size_t PointsInBoundsSse(const Blam::Math::Bounds<RealVector3D> &bounds, const RealVector3D *points, uint8_t *out, size_t count)
+	{
+		auto li = _mm_set1_ps(bounds.Lower.I), lj = _mm_set1_ps(bounds.Lower.J), lk = _mm_set1_ps(bounds.Lower.K);
+		auto ui = _mm_set1_ps(bounds.Upper.I), uj = _mm_set1_ps(bounds.Upper.J), uk = _mm_set1_ps(bounds.Upper.K);
+
+		size_t inside = 0;
+		size_t n = 0;
+		for (; n + 4 <= count; n += 4)
+		{
+			__m128 pi, pj, pk;
+			LoadVectors(&points[n], pi, pj, pk);
+
+			auto mask = _mm_and_ps(_mm_cmpge_ps(pi, li), _mm_cmple_ps(pi, ui));
+			mask = _mm_and_ps(mask, _mm_and_ps(_mm_cmpge_ps(pj, lj), _mm_cmple_ps(pj, uj)));
+			mask = _mm_and_ps(mask, _mm_and_ps(_mm_cmpge_ps(pk, lk), _mm_cmple_ps(pk, uk)));
+
+			auto bits = _mm_movemask_ps(mask);
+			for (auto b = 0; b < 4; b++)
+			{
+				out[n + b] = (bits >> b) & 1;
+				inside += out[n + b];
+			}
+		}
+		return inside + PointsInBoundsScalar(bounds, &points[n], &out[n], count - n);
+	}
+}
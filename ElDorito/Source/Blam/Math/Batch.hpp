@@ -0,0 +1,40 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include "Bounds.hpp"
+#include "RealVector3D.hpp"
+
+namespace Blam::Math
+{
+	struct RealMatrix4x3;
+	struct RealQuaternion;
+}
+
+// Operations over arrays of vectors. Each function has a scalar and an SSE
+// implementation, and the SSE one is used if the CPU supports it.
+// Unless stated otherwise, output arrays may alias the input arrays.
+namespace Blam::Math::Batch
+{
+	// Returns whether the CPU supports the SSE implementations.
+	bool IsSseSupported();
+
+	// Enables or disables the SSE implementations. They can't be enabled if they aren't supported.
+	void SetSseEnabled(bool enabled);
+	bool IsSseEnabled();
+
+	// Transforms points by a matrix, including its scale and position.
+	void TransformPoints(const RealMatrix4x3 &matrix, const RealVector3D *points, RealVector3D *out, size_t count);
+
+	// Transforms vectors by a matrix, including its scale but not its position.
+	void TransformVectors(const RealMatrix4x3 &matrix, const RealVector3D *vectors, RealVector3D *out, size_t count);
+
+	// Rotates points by a quaternion and then offsets them, equivalent to RealVector3D::Transform(p, rotation) + translation.
+	void TransformPoints(const RealQuaternion &rotation, const RealVector3D &translation, const RealVector3D *points, RealVector3D *out, size_t count);
+
+	// Computes the squared distance from an origin to each point.
+	void DistancesSquared(const RealVector3D &origin, const RealVector3D *points, float *out, size_t count);
+
+	// Tests whether each point is inside an axis-aligned box (inclusive).
+	// Sets out[i] to 1 if the point is inside and 0 if it isn't, and returns the number of points inside.
+	size_t PointsInBounds(const Bounds<RealVector3D> &bounds, const RealVector3D *points, uint8_t *out, size_t count);
+}
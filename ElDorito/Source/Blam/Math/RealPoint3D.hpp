@@ -40,5 +40,164 @@ namespace Blam::Math
 		RealPoint3D operator/(const float other) const;
 		friend RealPoint3D operator/(const float a, const RealPoint3D &b);
 	};
+
+	inline RealPoint3D::RealPoint3D()
+		: RealPoint3D(0.0f, 0.0f, 0.0f)
+	{
+	}
+
+	inline RealPoint3D::RealPoint3D(const float x, const float y, const float z)
+		: X(x), Y(y), Z(z)
+	{
+	}
+
+	inline bool RealPoint3D::operator==(const RealPoint3D &other) const
+	{
+		return X == other.X
+			&& Y == other.Y
+			&& Z == other.Z;
+	}
+
+	inline bool RealPoint3D::operator!=(const RealPoint3D &other) const
+	{
+		return !(*this == other);
+	}
+
+	inline RealPoint3D::operator const float *() const
+	{
+		return &X;
+	}
+
+	inline RealPoint3D &RealPoint3D::operator+=(const RealPoint3D &other)
+	{
+		X += other.X;
+		Y += other.Y;
+		Z += other.Z;
+
+		return *this;
+	}
+
+	inline RealPoint3D &RealPoint3D::operator+=(const float other)
+	{
+		X += other;
+		Y += other;
+		Z += other;
+
+		return *this;
+	}
+
+	inline RealPoint3D RealPoint3D::operator+(const RealPoint3D &other) const
+	{
+		return RealPoint3D(X + other.X, Y + other.Y, Z + other.Z);
+	}
+
+	inline RealPoint3D RealPoint3D::operator+(const float other) const
+	{
+		return RealPoint3D(X + other, Y + other, Z + other);
+	}
+
+	inline RealPoint3D operator+(const float a, const RealPoint3D &b)
+	{
+		return RealPoint3D(a + b.X, a + b.Y, a + b.Z);
+	}
+
+	inline RealPoint3D &RealPoint3D::operator-=(const RealPoint3D &other)
+	{
+		X -= other.X;
+		Y -= other.Y;
+		Z -= other.Z;
+
+		return *this;
+	}
+
+	inline RealPoint3D &RealPoint3D::operator-=(const float other)
+	{
+		X -= other;
+		Y -= other;
+		Z -= other;
+
+		return *this;
+	}
+
+	inline RealPoint3D RealPoint3D::operator-(const RealPoint3D &other) const
+	{
+		return RealPoint3D(X - other.X, Y - other.Y, Z - other.Z);
+	}
+
+	inline RealPoint3D RealPoint3D::operator-(const float other) const
+	{
+		return RealPoint3D(X - other, Y - other, Z - other);
+	}
+
+	inline RealPoint3D operator-(const float a, const RealPoint3D &b)
+	{
+		return RealPoint3D(a - b.X, a - b.Y, a - b.Z);
+	}
+
+	inline RealPoint3D &RealPoint3D::operator*=(const RealPoint3D &other)
+	{
+		X *= other.X;
+		Y *= other.Y;
+		Z *= other.Z;
+
+		return *this;
+	}
+
+	inline RealPoint3D &RealPoint3D::operator*=(const float other)
+	{
+		X *= other;
+		Y *= other;
+		Z *= other;
+
+		return *this;
+	}
+
+	inline RealPoint3D RealPoint3D::operator*(const RealPoint3D &other) const
+	{
+		return RealPoint3D(X * other.X, Y * other.Y, Z * other.Z);
+	}
+
+	inline RealPoint3D RealPoint3D::operator*(const float other) const
+	{
+		return RealPoint3D(X * other, Y * other, Z * other);
+	}
+
+	inline RealPoint3D operator*(const float a, const RealPoint3D &b)
+	{
+		return RealPoint3D(a * b.X, a * b.Y, a * b.Z);
+	}
+
+	inline RealPoint3D &RealPoint3D::operator/=(const RealPoint3D &other)
+	{
+		X /= other.X;
+		Y /= other.Y;
+		Z /= other.Z;
+
+		return *this;
+	}
+
+	inline RealPoint3D &RealPoint3D::operator/=(const float other)
+	{
+		X /= other;
+		Y /= other;
+		Z /= other;
+
+		return *this;
+	}
+
+	inline RealPoint3D RealPoint3D::operator/(const RealPoint3D &other) const
+	{
+		return RealPoint3D(X / other.X, Y / other.Y, Z / other.Z);
+	}
+
+	inline RealPoint3D RealPoint3D::operator/(const float other) const
+	{
+		return RealPoint3D(X / other, Y / other, Z / other);
+	}
+
+	inline RealPoint3D operator/(const float a, const RealPoint3D &b)
+	{
+		return RealPoint3D(a / b.X, a / b.Y, a / b.Z);
+	}
 }
 
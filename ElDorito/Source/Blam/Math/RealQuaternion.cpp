@@ -4,197 +4,6 @@
 
 namespace Blam::Math
 {
-	RealQuaternion::RealQuaternion()
-		: RealQuaternion(0.0f, 0.0f, 0.0f, 1.0f)
-	{
-	}
-
-	RealQuaternion::RealQuaternion(const float i, const float j, const float k, const float w)
-		: I(i), J(j), K(k), W(w)
-	{
-	}
-
-	bool RealQuaternion::operator==(const RealQuaternion &other) const
-	{
-		return I == other.I
-			&& J == other.J
-			&& K == other.K
-			&& W == other.W;
-	}
-
-	bool RealQuaternion::operator!=(const RealQuaternion &other) const
-	{
-		return !(*this == other);
-	}
-
-	RealQuaternion::operator const float *() const
-	{
-		return &I;
-	}
-
-	RealQuaternion &RealQuaternion::operator+=(const RealQuaternion &other)
-	{
-		I += other.I;
-		J += other.J;
-		K += other.K;
-		W += other.W;
-
-		return *this;
-	}
-
-	RealQuaternion &RealQuaternion::operator+=(const float other)
-	{
-		I += other;
-		J += other;
-		K += other;
-		W += other;
-
-		return *this;
-	}
-
-	RealQuaternion RealQuaternion::operator+(const RealQuaternion &other) const
-	{
-		return RealQuaternion(I + other.I, J + other.J, K + other.K, W + other.W);
-	}
-
-	RealQuaternion RealQuaternion::operator+(const float other) const
-	{
-		return RealQuaternion(I + other, J + other, K + other, W + other);
-	}
-
-	RealQuaternion operator+(const float a, const RealQuaternion &b)
-	{
-		return RealQuaternion(a + b.I, a + b.J, a + b.K, a + b.W);
-	}
-
-	RealQuaternion &RealQuaternion::operator-=(const RealQuaternion &other)
-	{
-		I -= other.I;
-		J -= other.J;
-		K -= other.K;
-		W -= other.W;
-
-		return *this;
-	}
-
-	RealQuaternion &RealQuaternion::operator-=(const float other)
-	{
-		I -= other;
-		J -= other;
-		K -= other;
-		W -= other;
-
-		return *this;
-	}
-
-	RealQuaternion RealQuaternion::operator-(const RealQuaternion &other) const
-	{
-		return RealQuaternion(I - other.I, J - other.J, K - other.K, W - other.W);
-	}
-
-	RealQuaternion RealQuaternion::operator-(const float other) const
-	{
-		return RealQuaternion(I - other, J - other, K - other, W - other);
-	}
-
-	RealQuaternion operator-(const float a, const RealQuaternion &b)
-	{
-		return RealQuaternion(a - b.I, a - b.J, a - b.K, a - b.W);
-	}
-
-	RealQuaternion &RealQuaternion::operator*=(const RealQuaternion &other)
-	{
-		I *= other.I;
-		J *= other.J;
-		K *= other.K;
-		W *= other.W;
-
-		return *this;
-	}
-
-	RealQuaternion &RealQuaternion::operator*=(const float other)
-	{
-		I *= other;
-		J *= other;
-		K *= other;
-		W *= other;
-
-		return *this;
-	}
-
-	RealQuaternion RealQuaternion::operator*(const RealQuaternion &other) const
-	{
-		float q1x = I;
-		float q1y = J;
-		float q1z = K;
-		float q1w = W;
-
-		float q2x = other.I;
-		float q2y = other.J;
-		float q2z = other.K;
-		float q2w = other.W;
-
-		// cross(av, bv)
-		float cx = q1y * q2z - q1z * q2y;
-		float cy = q1z * q2x - q1x * q2z;
-		float cz = q1x * q2y - q1y * q2x;
-
-		float dot = q1x * q2x + q1y * q2y + q1z * q2z;
-
-		return RealQuaternion
-		{
-			q1x * q2w + q2x * q1w + cx,
-			q1y * q2w + q2y * q1w + cy,
-			q1z * q2w + q2z * q1w + cz,
-			q1w * q2w - dot
-		};
-	}
-
-	RealQuaternion RealQuaternion::operator*(const float other) const
-	{
-		return RealQuaternion(I * other, J * other, K * other, W * other);
-	}
-
-	RealQuaternion operator*(const float a, const RealQuaternion &b)
-	{
-		return RealQuaternion(a * b.I, a * b.J, a * b.K, a * b.W);
-	}
-
-	RealQuaternion &RealQuaternion::operator/=(const RealQuaternion &other)
-	{
-		I /= other.I;
-		J /= other.J;
-		K /= other.K;
-		W /= other.W;
-
-		return *this;
-	}
-
-	RealQuaternion &RealQuaternion::operator/=(const float other)
-	{
-		I /= other;
-		J /= other;
-		K /= other;
-		W /= other;
-
-		return *this;
-	}
-
-	RealQuaternion RealQuaternion::operator/(const RealQuaternion &other) const
-	{
-		return RealQuaternion(I / other.I, J / other.J, K / other.K, W / other.W);
-	}
-
-	RealQuaternion RealQuaternion::operator/(const float other) const
-	{
-		return RealQuaternion(I / other, J / other, K / other, W / other);
-	}
-
-	RealQuaternion operator/(const float a, const RealQuaternion &b)
-	{
-		return RealQuaternion(a / b.I, a / b.J, a / b.K, a / b.W);
-	}
-
 	RealQuaternion RealQuaternion::CreateFromRotationMatrix(const RealMatrix4x3& matrix)
 	{
 		float trace = matrix.Forward.I + matrix.Left.J + matrix.Up.K;
@@ -49,7 +49,197 @@ namespace Blam::Math
 
 		static RealQuaternion Slerp(const RealQuaternion& a, const RealQuaternion& b, float t);
 		static RealQuaternion Normalize(const RealQuaternion& q);
-			
 	};
+
+	inline RealQuaternion::RealQuaternion()
+		: RealQuaternion(0.0f, 0.0f, 0.0f, 1.0f)
+	{
+	}
+
+	inline RealQuaternion::RealQuaternion(const float i, const float j, const float k, const float w)
+		: I(i), J(j), K(k), W(w)
+	{
+	}
+
+	inline bool RealQuaternion::operator==(const RealQuaternion &other) const
+	{
+		return I == other.I
+			&& J == other.J
+			&& K == other.K
+			&& W == other.W;
+	}
+
+	inline bool RealQuaternion::operator!=(const RealQuaternion &other) const
+	{
+		return !(*this == other);
+	}
+
+	inline RealQuaternion::operator const float *() const
+	{
+		return &I;
+	}
+
+	inline RealQuaternion &RealQuaternion::operator+=(const RealQuaternion &other)
+	{
+		I += other.I;
+		J += other.J;
+		K += other.K;
+		W += other.W;
+
+		return *this;
+	}
+
+	inline RealQuaternion &RealQuaternion::operator+=(const float other)
+	{
+		I += other;
+		J += other;
+		K += other;
+		W += other;
+
+		return *this;
+	}
+
+	inline RealQuaternion RealQuaternion::operator+(const RealQuaternion &other) const
+	{
+		return RealQuaternion(I + other.I, J + other.J, K + other.K, W + other.W);
+	}
+
+	inline RealQuaternion RealQuaternion::operator+(const float other) const
+	{
+		return RealQuaternion(I + other, J + other, K + other, W + other);
+	}
+
+	inline RealQuaternion operator+(const float a, const RealQuaternion &b)
+	{
+		return RealQuaternion(a + b.I, a + b.J, a + b.K, a + b.W);
+	}
+
+	inline RealQuaternion &RealQuaternion::operator-=(const RealQuaternion &other)
+	{
+		I -= other.I;
+		J -= other.J;
+		K -= other.K;
+		W -= other.W;
+
+		return *this;
+	}
+
+	inline RealQuaternion &RealQuaternion::operator-=(const float other)
+	{
+		I -= other;
+		J -= other;
+		K -= other;
+		W -= other;
+
+		return *this;
+	}
+
+	inline RealQuaternion RealQuaternion::operator-(const RealQuaternion &other) const
+	{
+		return RealQuaternion(I - other.I, J - other.J, K - other.K, W - other.W);
+	}
+
+	inline RealQuaternion RealQuaternion::operator-(const float other) const
+	{
+		return RealQuaternion(I - other, J - other, K - other, W - other);
+	}
+
+	inline RealQuaternion operator-(const float a, const RealQuaternion &b)
+	{
+		return RealQuaternion(a - b.I, a - b.J, a - b.K, a - b.W);
+	}
+
+	inline RealQuaternion &RealQuaternion::operator*=(const RealQuaternion &other)
+	{
+		I *= other.I;
+		J *= other.J;
+		K *= other.K;
+		W *= other.W;
+
+		return *this;
+	}
+
+	inline RealQuaternion &RealQuaternion::operator*=(const float other)
+	{
+		I *= other;
+		J *= other;
+		K *= other;
+		W *= other;
+
+		return *this;
+	}
+
+	inline RealQuaternion RealQuaternion::operator*(const RealQuaternion &other) const
+	{
+		float q1x = I;
+		float q1y = J;
+		float q1z = K;
+		float q1w = W;
+
+		float q2x = other.I;
+		float q2y = other.J;
+		float q2z = other.K;
+		float q2w = other.W;
+
+		// cross(av, bv)
+		float cx = q1y * q2z - q1z * q2y;
+		float cy = q1z * q2x - q1x * q2z;
+		float cz = q1x * q2y - q1y * q2x;
+
+		float dot = q1x * q2x + q1y * q2y + q1z * q2z;
+
+		return RealQuaternion
+		{
+			q1x * q2w + q2x * q1w + cx,
+			q1y * q2w + q2y * q1w + cy,
+			q1z * q2w + q2z * q1w + cz,
+			q1w * q2w - dot
+		};
+	}
+
+	inline RealQuaternion RealQuaternion::operator*(const float other) const
+	{
+		return RealQuaternion(I * other, J * other, K * other, W * other);
+	}
+
+	inline RealQuaternion operator*(const float a, const RealQuaternion &b)
+	{
+		return RealQuaternion(a * b.I, a * b.J, a * b.K, a * b.W);
+	}
+
+	inline RealQuaternion &RealQuaternion::operator/=(const RealQuaternion &other)
+	{
+		I /= other.I;
+		J /= other.J;
+		K /= other.K;
+		W /= other.W;
+
+		return *this;
+	}
+
+	inline RealQuaternion &RealQuaternion::operator/=(const float other)
+	{
+		I /= other;
+		J /= other;
+		K /= other;
+		W /= other;
+
+		return *this;
+	}
+
+	inline RealQuaternion RealQuaternion::operator/(const RealQuaternion &other) const
+	{
+		return RealQuaternion(I / other.I, J / other.J, K / other.K, W / other.W);
+	}
+
+	inline RealQuaternion RealQuaternion::operator/(const float other) const
+	{
+		return RealQuaternion(I / other, J / other, K / other, W / other);
+	}
+
+	inline RealQuaternion operator/(const float a, const RealQuaternion &b)
+	{
+		return RealQuaternion(a / b.I, a / b.J, a / b.K, a / b.W);
+	}
 }
 
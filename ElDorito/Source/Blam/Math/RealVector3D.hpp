@@ -1,4 +1,5 @@
 #pragma once
+#include <cmath>
 
 namespace Blam::Math
 {
@@ -47,5 +48,174 @@ namespace Blam::Math
 		static RealVector3D Cross(const RealVector3D& a, const RealVector3D& b);
 		static RealVector3D Transform(const RealVector3D& value, const RealQuaternion& rotation);
 	};
+
+	inline RealVector3D::RealVector3D()
+		: RealVector3D(0.0f, 0.0f, 0.0f)
+	{
+	}
+
+	inline RealVector3D::RealVector3D(const float i, const float j, const float k)
+		: I(i), J(j), K(k)
+	{
+	}
+
+	inline bool RealVector3D::operator==(const RealVector3D &other) const
+	{
+		return I == other.I
+			&& J == other.J
+			&& K == other.K;
+	}
+
+	inline bool RealVector3D::operator!=(const RealVector3D &other) const
+	{
+		return !(*this == other);
+	}
+
+	inline RealVector3D::operator const float *() const
+	{
+		return &I;
+	}
+
+	inline RealVector3D &RealVector3D::operator+=(const RealVector3D &other)
+	{
+		I += other.I;
+		J += other.J;
+		K += other.K;
+
+		return *this;
+	}
+
+	inline RealVector3D &RealVector3D::operator+=(const float other)
+	{
+		I += other;
+		J += other;
+		K += other;
+
+		return *this;
+	}
+
+	inline RealVector3D RealVector3D::operator+(const RealVector3D &other) const
+	{
+		return RealVector3D(I + other.I, J + other.J, K + other.K);
+	}
+
+	inline RealVector3D RealVector3D::operator+(const float other) const
+	{
+		return RealVector3D(I + other, J + other, K + other);
+	}
+
+	inline RealVector3D operator+(const float a, const RealVector3D &b)
+	{
+		return RealVector3D(a + b.I, a + b.J, a + b.K);
+	}
+
+	inline RealVector3D &RealVector3D::operator-=(const RealVector3D &other)
+	{
+		I -= other.I;
+		J -= other.J;
+		K -= other.K;
+
+		return *this;
+	}
+
+	inline RealVector3D &RealVector3D::operator-=(const float other)
+	{
+		I -= other;
+		J -= other;
+		K -= other;
+
+		return *this;
+	}
+
+	inline RealVector3D RealVector3D::operator-(const RealVector3D &other) const
+	{
+		return RealVector3D(I - other.I, J - other.J, K - other.K);
+	}
+
+	inline RealVector3D RealVector3D::operator-(const float other) const
+	{
+		return RealVector3D(I - other, J - other, K - other);
+	}
+
+	inline RealVector3D operator-(const float a, const RealVector3D &b)
+	{
+		return RealVector3D(a - b.I, a - b.J, a - b.K);
+	}
+
+	inline RealVector3D &RealVector3D::operator*=(const RealVector3D &other)
+	{
+		I *= other.I;
+		J *= other.J;
+		K *= other.K;
+
+		return *this;
+	}
+
+	inline RealVector3D &RealVector3D::operator*=(const float other)
+	{
+		I *= other;
+		J *= other;
+		K *= other;
+
+		return *this;
+	}
+
+	inline RealVector3D RealVector3D::operator*(const RealVector3D &other) const
+	{
+		return RealVector3D(I * other.I, J * other.J, K * other.K);
+	}
+
+	inline RealVector3D RealVector3D::operator*(const float other) const
+	{
+		return RealVector3D(I * other, J * other, K * other);
+	}
+
+	inline RealVector3D operator*(const float a, const RealVector3D &b)
+	{
+		return RealVector3D(a * b.I, a * b.J, a * b.K);
+	}
+
+	inline RealVector3D &RealVector3D::operator/=(const RealVector3D &other)
+	{
+		I /= other.I;
+		J /= other.J;
+		K /= other.K;
+
+		return *this;
+	}
+
+	inline RealVector3D &RealVector3D::operator/=(const float other)
+	{
+		I /= other;
+		J /= other;
+		K /= other;
+
+		return *this;
+	}
+
+	inline RealVector3D RealVector3D::operator/(const RealVector3D &other) const
+	{
+		return RealVector3D(I / other.I, J / other.J, K / other.K);
+	}
+
+	inline RealVector3D RealVector3D::operator/(const float other) const
+	{
+		return RealVector3D(I / other, J / other, K / other);
+	}
+
+	inline RealVector3D operator/(const float a, const RealVector3D &b)
+	{
+		return RealVector3D(a / b.I, a / b.J, a / b.K);
+	}
+
+	inline float RealVector3D::Length2() const
+	{
+		return I * I + J * J + K * K;
+	}
+
+	inline float RealVector3D::Length() const
+	{
+		return std::sqrt(Length2());
+	}
 }
 
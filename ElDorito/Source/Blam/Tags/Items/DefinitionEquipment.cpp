@@ -339,6 +339,7 @@ namespace Blam::Tags
 	{
 		"Equipment", sizeof(Equipment),
 		{
+			{ FieldType::Struct, "Item", &TagGroup<Items::Item::GroupTag>::Definition },
 			{ FieldType::Real, "UseDuration" },
 			{ FieldType::LongInteger, "Unknown8" },
 			{ FieldType::ShortInteger, "NumberOfUses" },
@@ -561,6 +561,7 @@ namespace Blam::Tags
 	{
 		"Weapon", sizeof(Weapon),
 		{
+			{ FieldType::Struct, "Item", &TagGroup<Items::Item::GroupTag>::Definition },
 			{ FieldType::ShortEnum, "WeaponFlags1", &Flags1Enum },
 			{ FieldType::WordFlags, "WeaponFlags2", &Flags2Enum },
 			{ FieldType::StringID, "Unknown6" },
@@ -28,6 +28,7 @@ namespace Blam::Tags
 	{
 		"Item", sizeof(Item),
 		{
+			{ FieldType::Struct, "Object", &TagGroup<Objects::Object::GroupTag>::Definition },
 			{ FieldType::LongFlags, "ItemFlags", &ItemFlagsEnum },
 			{ FieldType::Pad, 2 },
 			{ FieldType::ShortInteger, "SortOrder" },
@@ -855,6 +855,7 @@ namespace Blam::Tags
 	{
 		"Vehicle", sizeof(Vehicle),
 		{
+			{ FieldType::Struct, "Item", &TagGroup<Items::Item::GroupTag>::Definition },
 			{ FieldType::ShortInteger, "MaximumAlternateShotsLoaded" },
 			{ FieldType::WordInteger, "Flags" },
 			{ FieldType::Real, "BoundingRadius" },
@@ -204,6 +204,7 @@ namespace Blam::Tags
 	{
 		"Biped", sizeof(Biped),
 		{
+			{ FieldType::Struct, "Unit", &TagGroup<Objects::Unit::GroupTag>::Definition },
 			{ FieldType::Angle, "MovingTurningSpeed" },
 			{ FieldType::DwordInteger, "Flags4" },
 			{ FieldType::Angle, "StationaryTurningSpeed" },
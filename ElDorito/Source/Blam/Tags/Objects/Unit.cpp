@@ -381,6 +381,7 @@ namespace Blam::Tags
 	{
 		"Unit", sizeof(Unit),
 		{
+			{ FieldType::Struct, "Object", &TagGroup<Objects::Object::GroupTag>::Definition },
 			{ FieldType::DwordInteger, "FlagsWarningHalo4Values" },
 			{ FieldType::ShortEnum, "DefaultTeam" },
 			{ FieldType::ShortEnum, "ConstantSoundVolume" },
@@ -1,6 +1,8 @@
 #include "ChatCommand.hpp"
 #include "ChatCommandMap.hpp"
 #include "../Server/ServerChat.hpp"
+#include "../Server/RateLimiter.hpp"
+#include "../Server/PlayerDirectory.hpp"
 #include "../Modules/ModuleServer.hpp"
 #include "../Utils/Utils.hpp"
 #include "../Eldorito.hpp"
@@ -167,20 +169,9 @@ namespace ChatCommands
 
 	bool KickPlayerCommand::isValidArgument(std::string s, std::string& returnInfo)
 	{
-		int playerToKickIdx = -1;
-
-		auto membership = &Blam::Network::GetActiveSession()->MembershipInfo;
-		for (auto peerIdx = membership->FindFirstPeer(); peerIdx >= 0; peerIdx = membership->FindNextPeer(peerIdx))
-		{
-			auto playerIdx = membership->GetPeerPlayer(peerIdx);
-			if (playerIdx == -1)
-				continue;
-			auto* player = &membership->PlayerSessions[playerIdx];
-			if (Utils::String::ThinString(player->Properties.DisplayName) == s){
-				playerToKickIdx = playerIdx;
-			}
-
-		}
+		auto &directory = Server::PlayerDirectory::Instance();
+		// Players start kick votes, so only an exact name counts, unlike the admin commands
+		int playerToKickIdx = directory.FindByExactName(s);
 
 		if (playerToKickIdx <0)
 		{
@@ -252,7 +243,7 @@ namespace ChatCommands
 		std::string name = Utils::String::ThinString(membership.PlayerSessions[membership.GetPeerPlayer(sender)].Properties.DisplayName);
 
 		//check if this player has recently started a vote
-		if (ChatCommands::addToVoteTimes(uid))
+		if (Server::RateLimiter::Instance().Consume(sender, uid, Server::RateLimitClass::Vote) == Server::RateLimitResult::Allowed)
 		{
 			int numPlayers = findNumberOfPlayersInGame();
 
@@ -4,6 +4,7 @@
 
 #include "ChatCommand.hpp"
 #include "../Server/BanList.hpp"
+#include "../Server/RateLimiter.hpp"
 #include "../Utils/Utils.hpp"
 #include "../Patches/Events.hpp"
 #include "../Blam/BlamEvents.hpp"
@@ -17,7 +18,6 @@ namespace ChatCommands
 {
 	std::vector<AbstractChatCommand *> Commands;
 	bool chatCommandsActive; // they are only allowed in-game, not in the lobby
-	std::map<uint64_t, time_t> voteTimes = std::map<uint64_t, time_t>{};
 
 	KickPlayerCommand kickPlayerCommand;
 	KickIndexCommand kickIndexCommand;
@@ -30,8 +30,8 @@ namespace ChatCommands
 
 		if (event->NameStringId == 262221) //Game Ended event
 		{
-			Server::TempBanList::Instance().decrementDuration();
-			voteTimes.clear();
+			Server::TempBanList::Instance().Expire(std::time(nullptr));
+			Server::RateLimiter::Instance().Reset(Server::RateLimitClass::Vote);
 			chatCommandsActive = false;
 
 			for (auto elem : Commands)
@@ -70,23 +70,6 @@ namespace ChatCommands
 
 	}
 
-	bool addToVoteTimes(uint64_t sender)
-	{
-		time_t curTime;
-		time(&curTime);
-		//check if the person is spamming voting
-		std::map<uint64_t, time_t>::iterator it = voteTimes.find(sender);
-		if (it != voteTimes.end())
-		{
-			//Now we know that the user has started a vote recently. Check to see if it's under 90 seconds ago. 
-			if (curTime - it->second < 90)
-				return false;
-			it->second = curTime;
-		}
-		else
-			voteTimes.insert(std::make_pair(sender, curTime));
-		return true;
-	}
 	void Tick()
 	{
 		auto* session = Blam::Network::GetActiveSession();
@@ -168,9 +151,10 @@ namespace ChatCommands
 			}
 		}
 
-		int numArgs = 0;
-		auto args = Modules::CommandLineToArgvA((PCHAR)line.c_str(), &numArgs);
-		std::string cmd = args[0];
+		Modules::CommandLineArgs args;
+		if (args.Parse(line) == 0)
+			return true;
+		std::string cmd(args[0]);
 		std::transform(cmd.begin(), cmd.end(), cmd.begin(), ::tolower);
 
 		//If we are not already voting, check if the command is initiating one
@@ -187,9 +171,7 @@ namespace ChatCommands
 					return true;
 				}
 				//Now that we know this is the command being invoked, lets prep the argument (if there is one) and pass it in
-				std::vector<std::string> argsVect;
-				for (int i = 1; i < numArgs; i++)
-					argsVect.push_back(args[i]);
+				auto argsVect = args.ToVector(1);
 
 				if (argsVect.size() > 0)
 					elem->processMessage(peer, Utils::String::Join(argsVect));
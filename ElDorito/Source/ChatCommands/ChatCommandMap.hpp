@@ -5,5 +5,4 @@ namespace ChatCommands
 	void Init();
 	void Tick();
 	bool handleChatMessage(const Server::Chat::ChatMessage &message, int peer);
-	bool addToVoteTimes(uint64_t sender);
 }
\ No newline at end of file
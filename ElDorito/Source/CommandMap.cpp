@@ -1,13 +1,22 @@
 #include "CommandMap.hpp"
 #include <algorithm>
+#include <cerrno>
+#include <cstdlib>
 #include <sstream>
 #include "ElDorito.hpp"
 #include "Blam\BlamNetwork.hpp"
 
+namespace
+{
+	// These accept the same input as std::stoul, std::stoull and std::stof, but return false instead of throwing
+	bool ParseUnsigned(const std::string& str, unsigned long* result);
+	bool ParseUnsigned64(const std::string& str, unsigned long long* result);
+	bool ParseFloat(const std::string& str, float* result);
+}
 
 namespace Modules
 {
-	Command::Command() : UpdateEvent(0), ValueInt(0), ValueFloat(0.f), DefaultValueInt(0), DefaultValueFloat(0.f), ValueIntMin(0), ValueIntMax(0), ValueFloatMin(0.f), ValueFloatMax(0.f)
+	Command::Command() : UpdateEvent(0), Version(0), ValueInt(0), ValueFloat(0.f), DefaultValueInt(0), DefaultValueFloat(0.f), ValueIntMin(0), ValueIntMax(0), ValueFloatMin(0.f), ValueFloatMax(0.f)
 	{
 	}
 
@@ -66,9 +75,14 @@ namespace Modules
 	}
 
 	Command* CommandMap::FindCommand(const std::string& name)
+	{
+		return FindCommand(name.c_str());
+	}
+
+	Command* CommandMap::FindCommand(const char* name)
 	{
 		for (auto it = Commands.begin(); it < Commands.end(); it++)
-		if ((it->Name.length() > 0 && !_stricmp(it->Name.c_str(), name.c_str())) || (it->ShortName.length() > 0 && !_stricmp(it->ShortName.c_str(), name.c_str())))
+		if ((it->Name.length() > 0 && !_stricmp(it->Name.c_str(), name)) || (it->ShortName.length() > 0 && !_stricmp(it->ShortName.c_str(), name)))
 			return &(*it);
 
 		return nullptr;
@@ -80,17 +94,26 @@ namespace Modules
 			return nullptr;
 
 		this->Commands.push_back(command);
+		MarkChanged(&this->Commands.back());
 
 		return &this->Commands.back();
 	}
 
+	void CommandMap::MarkChanged(Command* command)
+	{
+		command->Version = ++version;
+	}
+
 	void CommandMap::FinishAddCommands()
 	{
 		for (auto command : Commands)
 		{
 			if (command.Type != eCommandTypeCommand && (command.Flags & eCommandFlagsDontUpdateInitial) != eCommandFlagsDontUpdateInitial)
 				if (command.UpdateEvent)
-					command.UpdateEvent(std::vector<std::string>(), std::string());
+				{
+					std::string returnInfo;
+					command.UpdateEvent(std::vector<std::string>(), returnInfo);
+				}
 		}
 	}
 
@@ -113,17 +136,35 @@ namespace Modules
 	{
 		*output = "";
 
-		int numArgs = 0;
-		auto args = CommandLineToArgvA((PCHAR)command.c_str(), &numArgs);
-
-		if (numArgs <= 0)
+		CommandLineArgs args;
+		if (args.Parse(command) == 0)
 		{
 			*output = "Invalid input";
 			return false;
 		}
 
-		auto cmd = FindCommand(args[0]);
-		if (!cmd || (isUserInput && cmd->Flags & eCommandFlagsInternal))
+		auto cmd = FindCommand(args[0].data());
+		if (!cmd)
+		{
+			*output = "Command/Variable not found";
+			return false;
+		}
+
+		auto argsVect = args.ToVector(1);
+
+		// The command name can have leading whitespace or quotes, so use where the tokenizer found its end
+		std::string rawArguments;
+		if (args.Count() >= 2)
+			rawArguments = command.substr(args.GetFirstArgumentEnd() + 1);
+
+		return ExecuteResolvedCommand(cmd, argsVect, rawArguments, isUserInput, output);
+	}
+
+	bool CommandMap::ExecuteResolvedCommand(Command* cmd, const std::vector<std::string>& arguments, const std::string& rawArguments, bool isUserInput, std::string *output)
+	{
+		*output = "";
+
+		if (isUserInput && cmd->Flags & eCommandFlagsInternal)
 		{
 			*output = "Command/Variable not found";
 			return false;
@@ -131,7 +172,7 @@ namespace Modules
 
 		if ((cmd->Flags & eCommandFlagsRunOnMainMenu) && !ElDorito::Instance().GameHasMenuShown)
 		{
-			queuedCommands.push_back(command);
+			queuedCommands.push_back(rawArguments.empty() ? cmd->Name : cmd->Name + " " + rawArguments);
 			*output = "Command queued until mainmenu shows";
 			return true;
 		}
@@ -147,28 +188,25 @@ namespace Modules
 			}
 		}
 
-		std::vector<std::string> argsVect;
-		if (numArgs > 1)
-			for (int i = 1; i < numArgs; i++)
-				argsVect.push_back(args[i]);
-
 		if (cmd->Type == eCommandTypeCommand && cmd->Flags == eCommandFlagsArgsNoParse)
 		{
-			argsVect.clear();
-			if (numArgs >= 2)
-				argsVect.push_back(command.substr(std::strlen(args[0]) + 1)); //push unparsed arguments after the command
-			return cmd->UpdateEvent(argsVect, *output);
+			std::vector<std::string> unparsedArgs;
+			if (!arguments.empty())
+				unparsedArgs.push_back(rawArguments); //push unparsed arguments after the command
+			return cmd->UpdateEvent(unparsedArgs, *output);
 		}
 
 		if (cmd->Type == eCommandTypeCommand)
-			return cmd->UpdateEvent(argsVect, *output); // if it's a command call it and return
+			return cmd->UpdateEvent(arguments, *output); // if it's a command call it and return
 
-		if (numArgs <= 1)
+		if (arguments.empty())
 		{
 			*output = cmd->ValueString;
 			return true;
 		}
 
+		auto argsVect = arguments;
+
 		std::string previousValue;
 		auto updateRet = SetVariable(cmd, argsVect[0], previousValue);
 		switch (updateRet)
@@ -200,7 +238,10 @@ namespace Modules
 		auto ret = cmd->UpdateEvent(argsVect, *output);
 
 		if (!ret) // error, revert the variable
-			this->SetVariable(cmd, previousValue, std::string());
+		{
+			std::string revertedValue;
+			this->SetVariable(cmd, previousValue, revertedValue);
+		}
 
 		if (output->length() <= 0)
 			*output = previousValue + " -> " + cmd->ValueString;
@@ -270,57 +311,54 @@ namespace Modules
 		if (command->Flags & eCommandFlagsInternal)
 			return eVariableSetReturnValueError;
 
-		try {
-			switch (command->Type)
+		switch (command->Type)
+		{
+		case eCommandTypeVariableString:
+			previousValue = command->ValueString;
+			command->ValueString = value;
+			break;
+		case eCommandTypeVariableInt:
 			{
-			case eCommandTypeVariableString:
-				previousValue = command->ValueString;
-				command->ValueString = value;
+				previousValue = std::to_string(command->ValueInt);
+				unsigned long newValue;
+				if (!ParseUnsigned(value, &newValue))
+					return eVariableSetReturnValueInvalidArgument;
+				if ((command->ValueIntMin || command->ValueIntMax) && (newValue < command->ValueIntMin || newValue > command->ValueIntMax))
+					return eVariableSetReturnValueOutOfRange;
+
+				command->ValueInt = newValue;
+				command->ValueString = std::to_string(command->ValueInt); // set the ValueString too so we can print the value out easier
+				break;
+			}
+		case eCommandTypeVariableInt64:
+			{
+				previousValue = std::to_string(command->ValueInt);
+				unsigned long long newValue;
+				if (!ParseUnsigned64(value, &newValue))
+					return eVariableSetReturnValueInvalidArgument;
+				if ((command->ValueInt64Min || command->ValueInt64Max) && (newValue < command->ValueInt64Min || newValue > command->ValueInt64Max))
+					return eVariableSetReturnValueOutOfRange;
+
+				command->ValueInt64 = newValue;
+				command->ValueString = std::to_string(command->ValueInt64); // set the ValueString too so we can print the value out easier
+				break;
+			}
+		case eCommandTypeVariableFloat:
+			{
+				previousValue = std::to_string(command->ValueFloat);
+				float newValue;
+				if (!ParseFloat(value, &newValue))
+					return eVariableSetReturnValueInvalidArgument;
+				if ((command->ValueFloatMin || command->ValueFloatMax) && (newValue < command->ValueFloatMin || newValue > command->ValueFloatMax))
+					return eVariableSetReturnValueOutOfRange;
+
+				command->ValueFloat = newValue;
+				command->ValueString = std::to_string(command->ValueFloat); // set the ValueString too so we can print the value out easier
 				break;
-			case eCommandTypeVariableInt:
-				{
-					previousValue = std::to_string(command->ValueInt);
-					auto newValue = std::stoul(value, 0, 0);
-					if ((command->ValueIntMin || command->ValueIntMax) && (newValue < command->ValueIntMin || newValue > command->ValueIntMax))
-						return eVariableSetReturnValueOutOfRange;
-
-					command->ValueInt = newValue;
-					command->ValueString = std::to_string(command->ValueInt); // set the ValueString too so we can print the value out easier
-					break;
-				}
-			case eCommandTypeVariableInt64:
-				{
-					previousValue = std::to_string(command->ValueInt);
-					auto newValue = std::stoull(value, 0, 0);
-					if ((command->ValueInt64Min || command->ValueInt64Max) && (newValue < command->ValueInt64Min || newValue > command->ValueInt64Max))
-						return eVariableSetReturnValueOutOfRange;
-
-					command->ValueInt64 = newValue;
-					command->ValueString = std::to_string(command->ValueInt64); // set the ValueString too so we can print the value out easier
-					break;
-				}
-			case eCommandTypeVariableFloat:
-				{
-					previousValue = std::to_string(command->ValueFloat);
-					auto newValue = std::stof(value, 0);
-					if ((command->ValueFloatMin || command->ValueFloatMax) && (newValue < command->ValueFloatMin || newValue > command->ValueFloatMax))
-						return eVariableSetReturnValueOutOfRange;
-
-					command->ValueFloat = newValue;
-					command->ValueString = std::to_string(command->ValueFloat); // set the ValueString too so we can print the value out easier
-					break;
-				}
 			}
-		}
-		catch (std::invalid_argument)
-		{
-			return eVariableSetReturnValueInvalidArgument;
-		}
-		catch (std::out_of_range)
-		{
-			return eVariableSetReturnValueInvalidArgument;
 		}
 
+		MarkChanged(command);
 		return eVariableSetReturnValueSuccess;
 	}
 
@@ -406,88 +444,122 @@ namespace Modules
 
 namespace Modules
 {
-	PCHAR* CommandLineToArgvA(PCHAR CmdLine, int* _argc)
+	CommandLineArgs::CommandLineArgs() : count(0), firstArgumentEnd(0)
 	{
-		PCHAR* argv;
-		PCHAR  _argv;
-		ULONG   len;
-		ULONG   argc;
-		CHAR   a;
-		ULONG   i, j;
-
-		BOOLEAN  in_QM;
-		BOOLEAN  in_TEXT;
-		BOOLEAN  in_SPACE;
-
-		len = strlen(CmdLine);
-		i = ((len + 2) / 2)*sizeof(PVOID)+sizeof(PVOID);
-
-		argv = (PCHAR*)GlobalAlloc(GMEM_FIXED,
-			i + (len + 2)*sizeof(CHAR));
-
-		if (!argv)
-			return 0;
-
-		_argv = (PCHAR)(((PUCHAR)argv) + i);
-
-		argc = 0;
-		argv[argc] = _argv;
-		in_QM = FALSE;
-		in_TEXT = FALSE;
-		in_SPACE = TRUE;
-		i = 0;
-		j = 0;
-
-		while (a = CmdLine[i]) {
-			if (in_QM) {
-				if (a == '\"') {
-					in_QM = FALSE;
-				}
-				else {
-					_argv[j] = a;
-					j++;
-				}
+	}
+
+	size_t CommandLineArgs::Parse(std::string_view commandLine)
+	{
+		count = 0;
+		firstArgumentEnd = 0;
+		heapArgs.clear();
+
+		// Arguments can't be longer than the command line, and each one takes one extra byte for its terminator
+		auto text = inlineText;
+		if (commandLine.length() + 1 > InlineLength)
+		{
+			heapText.resize(commandLine.length() + 1);
+			text = heapText.data();
+		}
+
+		size_t length = 0;
+		size_t argStart = 0;
+		auto inArg = false;
+		auto inQuotes = false;
+		for (size_t i = 0; i < commandLine.length(); i++)
+		{
+			auto ch = commandLine[i];
+			if (inQuotes)
+			{
+				if (ch == '\"')
+					inQuotes = false;
+				else
+					text[length++] = ch;
+				continue;
 			}
-			else {
-				switch (a) {
-				case '\"':
-					in_QM = TRUE;
-					in_TEXT = TRUE;
-					if (in_SPACE) {
-						argv[argc] = _argv + j;
-						argc++;
-					}
-					in_SPACE = FALSE;
-					break;
-				case ' ':
-				case '\t':
-				case '\n':
-				case '\r':
-					if (in_TEXT) {
-						_argv[j] = '\0';
-						j++;
-					}
-					in_TEXT = FALSE;
-					in_SPACE = TRUE;
-					break;
-				default:
-					in_TEXT = TRUE;
-					if (in_SPACE) {
-						argv[argc] = _argv + j;
-						argc++;
-					}
-					_argv[j] = a;
-					j++;
-					in_SPACE = FALSE;
-					break;
+
+			switch (ch)
+			{
+			case ' ':
+			case '\t':
+			case '\n':
+			case '\r':
+				if (inArg)
+				{
+					Push(std::string_view(text + argStart, length - argStart), i);
+					text[length++] = '\0';
 				}
+				inArg = false;
+				break;
+			default:
+				if (!inArg)
+					argStart = length;
+				inArg = true;
+				if (ch == '\"')
+					inQuotes = true; // Quotes in the middle of an argument don't split it
+				else
+					text[length++] = ch;
+				break;
 			}
-			i++;
 		}
-		_argv[j] = '\0';
-		argv[argc] = NULL;
+		if (inArg)
+		{
+			Push(std::string_view(text + argStart, length - argStart), commandLine.length());
+			text[length] = '\0';
+		}
+		return count;
+	}
+
+	std::vector<std::string> CommandLineArgs::ToVector(size_t first) const
+	{
+		std::vector<std::string> result;
+		if (first < count)
+			result.reserve(count - first);
+		for (auto i = first; i < count; i++)
+			result.emplace_back((*this)[i]);
+		return result;
+	}
 
-		(*_argc) = argc;
-		return argv;
+	void CommandLineArgs::Push(std::string_view arg, size_t end)
+	{
+		if (count == 0)
+			firstArgumentEnd = end;
+
+		if (count < InlineCount)
+		{
+			inlineArgs[count++] = arg;
+			return;
+		}
+		if (count == InlineCount)
+			heapArgs.assign(inlineArgs, inlineArgs + InlineCount);
+		heapArgs.push_back(arg);
+		count++;
+	}
+}
+
+namespace
+{
+	bool ParseUnsigned(const std::string& str, unsigned long* result)
+	{
+		char* end;
+		errno = 0;
+		*result = std::strtoul(str.c_str(), &end, 0);
+		return end != str.c_str() && errno != ERANGE;
+	}
+
+	bool ParseUnsigned64(const std::string& str, unsigned long long* result)
+	{
+		char* end;
+		errno = 0;
+		*result = std::strtoull(str.c_str(), &end, 0);
+		return end != str.c_str() && errno != ERANGE;
+	}
+
+	bool ParseFloat(const std::string& str, float* result)
+	{
+		char* end;
+		errno = 0;
+		*result = std::strtof(str.c_str(), &end);
+		return end != str.c_str() && errno != ERANGE;
 	}
 }
\ No newline at end of file
@@ -1,7 +1,10 @@
 #pragma once
 
+#include <atomic>
 #include <vector>
 #include <deque>
+#include <string>
+#include <string_view>
 #include <Windows.h>
 
 #include "Utils/Singleton.hpp"
@@ -33,7 +36,42 @@ typedef bool (*CommandUpdateFunc)(const std::vector<std::string>& Arguments, std
 
 namespace Modules
 {
-	PCHAR* CommandLineToArgvA(PCHAR CmdLine, int* _argc);
+	// Arguments split out of a command line. Arguments are separated by whitespace and can be quoted to include it,
+	// e.g. `Server.Name "My Server"`. The text of the arguments is stored in the object itself, so short command
+	// lines can be parsed on the stack without allocating, and longer ones reuse storage if the object is reused.
+	class CommandLineArgs
+	{
+	public:
+		CommandLineArgs();
+		CommandLineArgs(const CommandLineArgs&) = delete;
+		CommandLineArgs& operator=(const CommandLineArgs&) = delete;
+
+		// Splits a command line and returns the number of arguments. Previous arguments are discarded.
+		size_t Parse(std::string_view commandLine);
+
+		size_t Count() const { return count; }
+
+		// The views stay valid until the next call to Parse, and are null-terminated.
+		std::string_view operator[](size_t index) const { return (count <= InlineCount) ? inlineArgs[index] : heapArgs[index]; }
+
+		std::vector<std::string> ToVector(size_t first = 0) const;
+
+		// Gets the offset in the command line just past the first argument, including any closing quote.
+		size_t GetFirstArgumentEnd() const { return firstArgumentEnd; }
+
+	private:
+		static const size_t InlineLength = 256;
+		static const size_t InlineCount = 16;
+
+		char inlineText[InlineLength];
+		std::string_view inlineArgs[InlineCount];
+		std::vector<char> heapText;
+		std::vector<std::string_view> heapArgs;
+		size_t count;
+		size_t firstArgumentEnd;
+
+		void Push(std::string_view arg, size_t end);
+	};
 
 	enum CommandType
 	{
@@ -57,6 +95,8 @@ namespace Modules
 
 		CommandUpdateFunc UpdateEvent;
 
+		unsigned int Version; // the CommandMap version when this was added or last changed
+
 		unsigned long ValueInt;
 		unsigned long long ValueInt64;
 		float ValueFloat;
@@ -93,11 +133,13 @@ namespace Modules
 		Command* AddCommand(Command command);
 		void FinishAddCommands();
 		Command* FindCommand(const std::string& name);
+		Command* FindCommand(const char* name);
 
 		std::string ExecuteCommand(std::vector<std::string> command, bool isUserInput = false);
 		std::string ExecuteCommand(std::string command, bool isUserInput = false);
 		std::string ExecuteCommands(std::string& commands, bool isUserInput = false);
 		bool ExecuteCommandWithStatus(std::string command, bool isUserInput, std::string *output);
+		bool ExecuteResolvedCommand(Command* cmd, const std::vector<std::string>& arguments, const std::string& rawArguments, bool isUserInput, std::string *output);
 		std::string ExecuteQueue();
 
 		bool GetVariableInt(const std::string& name, unsigned long& value);
@@ -111,7 +153,16 @@ namespace Modules
 		std::string GenerateHelpText(std::string moduleFilter = "");
 
 		std::string SaveVariables();
+
+		// The version is incremented whenever a command is added or a variable changes,
+		// so listings of the commands only need to be rebuilt when it's different.
+		unsigned int GetVersion() const { return version; }
+
+		// Increments the version and stamps it on a command.
+		// Call this after setting a variable's value without using SetVariable.
+		void MarkChanged(Command* command);
 	private:
 		std::vector<std::string> queuedCommands;
+		std::atomic<unsigned int> version{ 0 };
 	};
 }
\ No newline at end of file
@@ -0,0 +1,549 @@
+#include "FieldPath.hpp"
+#include "../Blam/Tags/TagBlock.hpp"
+
+#include <cctype>
+#include <cerrno>
+#include <cstdlib>
+#include <sstream>
+
+namespace
+{
+	using Definitions::FieldDefinition;
+	using Definitions::FieldType;
+	using Definitions::StructDefinition;
+
+	bool NamesMatch(const std::string &fieldName, const std::string &pathName);
+	const FieldDefinition *FindField(const StructDefinition &structDef, const std::string &name, size_t *offset);
+	bool TypeContainsPointers(const FieldType &type, const StructDefinition *structDef);
+	bool FieldContainsPointers(const FieldDefinition &field);
+
+	enum class ComponentType
+	{
+		None,
+		Float,
+		Signed,
+		Unsigned
+	};
+
+	ComponentType GetComponents(const FieldType &type, size_t size, size_t *count);
+	bool ParseComponent(const std::string &text, ComponentType type, size_t size, uint8_t *out);
+}
+
+namespace Definitions
+{
+	size_t GetFieldTypeSize(const FieldType &type)
+	{
+		switch (type)
+		{
+		case FieldType::CharInteger:
+		case FieldType::ByteInteger:
+		case FieldType::CharEnum:
+		case FieldType::ByteFlags:
+		case FieldType::CharBlockIndex:
+			return 1;
+		case FieldType::ShortInteger:
+		case FieldType::WordInteger:
+		case FieldType::ShortEnum:
+		case FieldType::WordFlags:
+		case FieldType::ShortBlockIndex:
+			return 2;
+		case FieldType::Tag:
+		case FieldType::StringID:
+		case FieldType::LongInteger:
+		case FieldType::DwordInteger:
+		case FieldType::LongEnum:
+		case FieldType::LongFlags:
+		case FieldType::LongBlockIndex:
+		case FieldType::Angle:
+		case FieldType::Point2D:
+		case FieldType::RgbColor:
+		case FieldType::ArgbColor:
+		case FieldType::Real:
+		case FieldType::RealFraction:
+		case FieldType::ShortIntegerBounds:
+		case FieldType::PageableResource:
+			return 4;
+		case FieldType::Int64Integer:
+		case FieldType::QwordInteger:
+		case FieldType::Rectangle2D:
+		case FieldType::RealPoint2D:
+		case FieldType::RealVector2D:
+		case FieldType::RealEulerAngles2D:
+		case FieldType::AngleBounds:
+		case FieldType::RealBounds:
+		case FieldType::FractionBounds:
+			return 8;
+		case FieldType::RealPoint3D:
+		case FieldType::RealVector3D:
+		case FieldType::RealEulerAngles3D:
+		case FieldType::RealPlane2D:
+		case FieldType::RealRgbColor:
+		case FieldType::RealHsvColor:
+		case FieldType::Block:
+			return 12;
+		case FieldType::RealQuaternion:
+		case FieldType::RealPlane3D:
+		case FieldType::RealArgbColor:
+		case FieldType::RealAhsvColor:
+		case FieldType::TagReference:
+			return 16;
+		case FieldType::Data:
+			return 20;
+		case FieldType::String:
+			return 32;
+		case FieldType::LongString:
+			return 256;
+		default:
+			return 0;
+		}
+	}
+
+	size_t GetFieldSize(const FieldDefinition &field)
+	{
+		switch (field.Type)
+		{
+		case FieldType::Pad:
+		case FieldType::Skip:
+			return field.Length;
+		case FieldType::Struct:
+			return field.Struct ? field.Struct->Size : 0;
+		case FieldType::Array:
+			if (field.ArrayType == FieldType::Struct)
+				return field.Struct ? field.Length * field.Struct->Size : 0;
+			return field.Length * GetFieldTypeSize(field.ArrayType);
+		default:
+			return GetFieldTypeSize(field.Type);
+		}
+	}
+
+	FieldPath::FieldPath()
+		: field(nullptr), type(FieldType::Skip), offset(0), size(0)
+	{
+	}
+
+	bool FieldPath::Compile(const StructDefinition &root, const std::string &path, FieldPath *result, std::string *error)
+	{
+		FieldPath compiled;
+		compiled.path = path;
+
+		auto current = &root;
+		size_t structOffset = 0;
+		size_t pos = 0;
+		while (true)
+		{
+			auto end = path.find_first_of(".[", pos);
+			if (end == std::string::npos)
+				end = path.length();
+
+			auto name = path.substr(pos, end - pos);
+			if (name.empty())
+			{
+				*error = "Expected a field name at position " + std::to_string(pos) + " in \"" + path + "\"";
+				return false;
+			}
+
+			size_t fieldOffset;
+			auto field = FindField(*current, name, &fieldOffset);
+			if (!field)
+			{
+				*error = current->Name + " does not have a field named \"" + name + "\"";
+				return false;
+			}
+
+			compiled.field = field;
+			compiled.type = field->Type;
+			compiled.size = GetFieldSize(*field);
+			compiled.offset = structOffset + fieldOffset;
+			if (fieldOffset + compiled.size > current->Size)
+			{
+				*error = "The definition of " + current->Name + " is larger than the struct";
+				return false;
+			}
+
+			auto next = (field->Type == FieldType::Struct) ? field->Struct : nullptr;
+			pos = end;
+
+			if (pos < path.length() && path[pos] == '[')
+			{
+				auto close = path.find(']', pos);
+				if (close == std::string::npos || close == pos + 1)
+				{
+					*error = "Invalid index for " + field->Name;
+					return false;
+				}
+
+				size_t index = 0;
+				for (auto i = pos + 1; i < close; i++)
+				{
+					if (!isdigit(static_cast<unsigned char>(path[i])))
+					{
+						*error = "Invalid index for " + field->Name;
+						return false;
+					}
+					index = index * 10 + (path[i] - '0');
+				}
+
+				if (field->Type == FieldType::Block && field->Struct)
+				{
+					compiled.hops.push_back({ compiled.offset, index, field->Struct->Size });
+					compiled.type = FieldType::Struct;
+					compiled.size = field->Struct->Size;
+					compiled.offset = 0;
+					next = field->Struct;
+				}
+				else if (field->Type == FieldType::Array)
+				{
+					if (index >= static_cast<size_t>(field->Length))
+					{
+						*error = field->Name + " only has " + std::to_string(field->Length) + " elements";
+						return false;
+					}
+
+					compiled.type = field->ArrayType;
+					compiled.size /= field->Length;
+					compiled.offset += index * compiled.size;
+					next = (field->ArrayType == FieldType::Struct) ? field->Struct : nullptr;
+				}
+				else
+				{
+					*error = field->Name + " is not a block or an array";
+					return false;
+				}
+				pos = close + 1;
+			}
+
+			if (pos == path.length())
+				break;
+			if (path[pos] != '.' || !next)
+			{
+				*error = "Unexpected \"" + path.substr(pos) + "\" after " + field->Name;
+				return false;
+			}
+
+			pos++;
+			current = next;
+			structOffset = compiled.offset;
+		}
+
+		*result = std::move(compiled);
+		return true;
+	}
+
+	void *FieldPath::Resolve(void *base) const
+	{
+		return const_cast<void *>(Resolve(static_cast<const void *>(base)));
+	}
+
+	const void *FieldPath::Resolve(const void *base) const
+	{
+		auto ptr = static_cast<const uint8_t *>(base);
+		if (!ptr)
+			return nullptr;
+
+		for (auto &hop : hops)
+		{
+			auto block = reinterpret_cast<const Blam::Tags::TagBlock<uint8_t> *>(ptr + hop.Offset);
+			if (!block->Elements || block->Count <= 0 || hop.Index >= static_cast<size_t>(block->Count))
+				return nullptr;
+
+			ptr = block->Elements + hop.Index * hop.ElementSize;
+		}
+		return ptr + offset;
+	}
+
+	bool FormatFieldValue(const FieldPath &path, const void *base, std::string *result)
+	{
+		size_t count;
+		auto type = GetComponents(path.GetType(), path.GetSize(), &count);
+		auto ptr = static_cast<const uint8_t *>(path.Resolve(base));
+		if (type == ComponentType::None || !ptr)
+			return false;
+
+		std::stringstream ss;
+		auto size = path.GetSize() / count;
+		for (size_t i = 0; i < count; i++, ptr += size)
+		{
+			if (i > 0)
+				ss << " ";
+			if (type == ComponentType::Float)
+			{
+				float value;
+				memcpy(&value, ptr, sizeof(value));
+				ss << value;
+			}
+			else if (type == ComponentType::Signed)
+			{
+				int64_t value = 0;
+				memcpy(&value, ptr, size);
+				auto shift = 64 - size * 8;
+				ss << ((value << shift) >> shift);
+			}
+			else
+			{
+				uint64_t value = 0;
+				memcpy(&value, ptr, size);
+				ss << value;
+			}
+		}
+		*result = ss.str();
+		return true;
+	}
+
+	bool ParseFieldValue(const FieldPath &path, void *base, const std::vector<std::string> &values, std::string *error)
+	{
+		size_t count;
+		auto type = GetComponents(path.GetType(), path.GetSize(), &count);
+		if (type == ComponentType::None)
+		{
+			*error = path.GetPath() + " is not a number";
+			return false;
+		}
+		if (values.size() != count)
+		{
+			*error = path.GetPath() + " takes " + std::to_string(count) + (count == 1 ? " value" : " values");
+			return false;
+		}
+
+		auto ptr = path.Resolve(base);
+		if (!ptr)
+		{
+			*error = "A block along " + path.GetPath() + " doesn't have the element";
+			return false;
+		}
+
+		// Parse everything first so an invalid value doesn't leave the field half-written
+		std::vector<uint8_t> parsed(path.GetSize());
+		auto size = path.GetSize() / count;
+		for (size_t i = 0; i < count; i++)
+		{
+			if (!ParseComponent(values[i], type, size, &parsed[i * size]))
+			{
+				*error = "\"" + values[i] + "\" is not a valid value for " + path.GetPath();
+				return false;
+			}
+		}
+		memcpy(ptr, parsed.data(), parsed.size());
+		return true;
+	}
+
+	FieldPathSet::FieldPathSet(const StructDefinition &root)
+		: root(root)
+	{
+	}
+
+	bool FieldPathSet::Add(const std::string &path, std::string *error)
+	{
+		FieldPath compiled;
+		if (!FieldPath::Compile(root, path, &compiled, error))
+			return false;
+
+		// Copying these would make two tags share the same memory
+		auto &field = *compiled.GetField();
+		auto type = compiled.GetType();
+		auto containsPointers = (type == FieldType::Array)
+			? FieldContainsPointers(field)
+			: TypeContainsPointers(type, (type == FieldType::Struct) ? field.Struct : nullptr);
+		if (containsPointers)
+		{
+			*error = path + " points to memory outside of the tag and can't be copied";
+			return false;
+		}
+
+		paths.push_back(std::move(compiled));
+		return true;
+	}
+
+	std::vector<size_t> FieldPathSet::Diff(const void *a, const void *b) const
+	{
+		std::vector<size_t> result;
+		for (size_t i = 0; i < paths.size(); i++)
+		{
+			auto &path = paths[i];
+			auto fieldA = path.Resolve(a);
+			auto fieldB = path.Resolve(b);
+			if (!fieldA && !fieldB)
+				continue;
+			if (!fieldA || !fieldB || memcmp(fieldA, fieldB, path.GetSize()) != 0)
+				result.push_back(i);
+		}
+		return result;
+	}
+
+	size_t FieldPathSet::Apply(const void *source, void *dest) const
+	{
+		size_t copied = 0;
+		for (auto &path : paths)
+		{
+			auto from = path.Resolve(source);
+			auto to = path.Resolve(dest);
+			if (!from || !to)
+				continue;
+
+			memmove(to, from, path.GetSize());
+			copied++;
+		}
+		return copied;
+	}
+}
+
+namespace
+{
+	bool NamesMatch(const std::string &fieldName, const std::string &pathName)
+	{
+		size_t i = 0, j = 0;
+		while (true)
+		{
+			while (i < fieldName.length() && fieldName[i] == '_')
+				i++;
+			while (j < pathName.length() && pathName[j] == '_')
+				j++;
+			if (i == fieldName.length() || j == pathName.length())
+				return i == fieldName.length() && j == pathName.length();
+			if (tolower(static_cast<unsigned char>(fieldName[i])) != tolower(static_cast<unsigned char>(pathName[j])))
+				return false;
+			i++;
+			j++;
+		}
+	}
+
+	const FieldDefinition *FindField(const StructDefinition &structDef, const std::string &name, size_t *offset)
+	{
+		size_t currentOffset = 0;
+		for (auto &field : structDef.Fields)
+		{
+			if (!field.Name.empty() && NamesMatch(field.Name, name))
+			{
+				*offset = currentOffset;
+				return &field;
+			}
+			currentOffset += Definitions::GetFieldSize(field);
+		}
+		return nullptr;
+	}
+
+	bool TypeContainsPointers(const FieldType &type, const StructDefinition *structDef)
+	{
+		switch (type)
+		{
+		case FieldType::Block:
+		case FieldType::Data:
+		case FieldType::PageableResource:
+			return true;
+		case FieldType::Struct:
+			if (!structDef)
+				return false;
+			for (auto &member : structDef->Fields)
+			{
+				if (FieldContainsPointers(member))
+					return true;
+			}
+			return false;
+		default:
+			return false;
+		}
+	}
+
+	bool FieldContainsPointers(const FieldDefinition &field)
+	{
+		if (field.Type == FieldType::Array)
+			return TypeContainsPointers(field.ArrayType, (field.ArrayType == FieldType::Struct) ? field.Struct : nullptr);
+		return TypeContainsPointers(field.Type, (field.Type == FieldType::Struct) ? field.Struct : nullptr);
+	}
+
+	ComponentType GetComponents(const FieldType &type, size_t size, size_t *count)
+	{
+		*count = 1;
+		switch (type)
+		{
+		case FieldType::Angle:
+		case FieldType::Real:
+		case FieldType::RealFraction:
+		case FieldType::RealPoint2D:
+		case FieldType::RealPoint3D:
+		case FieldType::RealVector2D:
+		case FieldType::RealVector3D:
+		case FieldType::RealQuaternion:
+		case FieldType::RealEulerAngles2D:
+		case FieldType::RealEulerAngles3D:
+		case FieldType::RealPlane2D:
+		case FieldType::RealPlane3D:
+		case FieldType::RealRgbColor:
+		case FieldType::RealArgbColor:
+		case FieldType::RealHsvColor:
+		case FieldType::RealAhsvColor:
+		case FieldType::AngleBounds:
+		case FieldType::RealBounds:
+		case FieldType::FractionBounds:
+			*count = size / sizeof(float);
+			return ComponentType::Float;
+		case FieldType::Point2D:
+		case FieldType::Rectangle2D:
+		case FieldType::ShortIntegerBounds:
+			*count = size / sizeof(int16_t);
+			return ComponentType::Signed;
+		case FieldType::CharInteger:
+		case FieldType::ShortInteger:
+		case FieldType::LongInteger:
+		case FieldType::Int64Integer:
+		case FieldType::CharEnum:
+		case FieldType::ShortEnum:
+		case FieldType::LongEnum:
+		case FieldType::CharBlockIndex:
+		case FieldType::ShortBlockIndex:
+		case FieldType::LongBlockIndex:
+			return ComponentType::Signed;
+		case FieldType::ByteInteger:
+		case FieldType::WordInteger:
+		case FieldType::DwordInteger:
+		case FieldType::QwordInteger:
+		case FieldType::ByteFlags:
+		case FieldType::WordFlags:
+		case FieldType::LongFlags:
+		case FieldType::StringID:
+		case FieldType::RgbColor:
+		case FieldType::ArgbColor:
+			return ComponentType::Unsigned;
+		default:
+			return ComponentType::None;
+		}
+	}
+
+	bool ParseComponent(const std::string &text, ComponentType type, size_t size, uint8_t *out)
+	{
+		if (text.empty())
+			return false;
+
+		char *end;
+		errno = 0;
+		if (type == ComponentType::Float)
+		{
+			auto value = strtof(text.c_str(), &end);
+			if (*end || errno == ERANGE)
+				return false;
+			memcpy(out, &value, sizeof(value));
+			return true;
+		}
+
+		auto bits = size * 8;
+		if (type == ComponentType::Signed)
+		{
+			auto value = strtoll(text.c_str(), &end, 0);
+			if (*end || errno == ERANGE)
+				return false;
+			if (bits < 64 && (value < -(1LL << (bits - 1)) || value >= (1LL << (bits - 1))))
+				return false;
+			memcpy(out, &value, size);
+			return true;
+		}
+
+		if (text[0] == '-')
+			return false;
+		auto value = strtoull(text.c_str(), &end, 0);
+		if (*end || errno == ERANGE)
+			return false;
+		if (bits < 64 && value >= (1ULL << bits))
+			return false;
+		memcpy(out, &value, size);
+		return true;
+	}
+}
@@ -0,0 +1,114 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "FieldDefinition.hpp"
+#include "StructDefinition.hpp"
+
+namespace Definitions
+{
+	// Gets the size in bytes of a value of a field type, or 0 if it depends on the field.
+	size_t GetFieldTypeSize(const FieldType &type);
+
+	// Gets the size in bytes of a field.
+	size_t GetFieldSize(const FieldDefinition &field);
+
+	// A path to a field which has been resolved against a struct definition.
+	// Paths are made of field names separated by dots, and blocks and arrays can be indexed,
+	// e.g. "Barrels[0].RoundsPerSecondBounds". Names are matched case-insensitively and
+	// underscores are ignored, so "barrels[0].rounds_per_second_bounds" is the same path.
+	class FieldPath
+	{
+	public:
+		FieldPath();
+
+		// Compiles a path against a struct definition.
+		// Returns false and sets error if the path can't be resolved.
+		static bool Compile(const StructDefinition &root, const std::string &path, FieldPath *result, std::string *error);
+
+		// Gets a pointer to the field inside the struct pointed to by base,
+		// or nullptr if a block along the path doesn't have the indexed element.
+		void *Resolve(void *base) const;
+		const void *Resolve(const void *base) const;
+
+		// Reads or writes the field. Fails if T isn't the size of the field or the field can't be resolved.
+		template <typename T>
+		bool Read(const void *base, T *value) const
+		{
+			auto ptr = (sizeof(T) == size) ? Resolve(base) : nullptr;
+			if (!ptr)
+				return false;
+			memcpy(value, ptr, sizeof(T));
+			return true;
+		}
+
+		template <typename T>
+		bool Write(void *base, const T &value) const
+		{
+			auto ptr = (sizeof(T) == size) ? Resolve(base) : nullptr;
+			if (!ptr)
+				return false;
+			memcpy(ptr, &value, sizeof(T));
+			return true;
+		}
+
+		const std::string &GetPath() const { return path; }
+		const FieldDefinition *GetField() const { return field; }
+		FieldType GetType() const { return type; }
+		size_t GetOffset() const { return offset; }
+		size_t GetSize() const { return size; }
+
+		// Gets the number of tag blocks that have to be followed to reach the field.
+		size_t GetBlockCount() const { return hops.size(); }
+
+	private:
+		// Follows the tag block at Offset and selects element Index.
+		struct BlockHop
+		{
+			size_t Offset;
+			size_t Index;
+			size_t ElementSize;
+		};
+
+		std::string path;
+		std::vector<BlockHop> hops;
+		const FieldDefinition *field;
+		FieldType type;
+		size_t offset;
+		size_t size;
+	};
+
+	// Formats a numeric field as text. Fields with several components, such as vectors and bounds,
+	// are formatted as the components separated by spaces, e.g. "1 2 3".
+	// Returns false if the field isn't numeric or can't be resolved.
+	bool FormatFieldValue(const FieldPath &path, const void *base, std::string *result);
+
+	// Parses one value for each component of a numeric field and writes them to the field.
+	// Returns false and sets error if a value is invalid or out of range, without writing anything.
+	bool ParseFieldValue(const FieldPath &path, void *base, const std::vector<std::string> &values, std::string *error);
+
+	// A list of fields in the same struct definition which can be compared or copied between tags in one call.
+	class FieldPathSet
+	{
+	public:
+		explicit FieldPathSet(const StructDefinition &root);
+
+		// Compiles and adds a path. Fields which point to other memory (blocks, data, resources) can't be added.
+		bool Add(const std::string &path, std::string *error);
+
+		// Gets the indices of the paths whose values differ between two tags.
+		// A path that can only be resolved in one of them counts as different.
+		std::vector<size_t> Diff(const void *a, const void *b) const;
+
+		// Copies every field from source to dest and returns how many were copied.
+		size_t Apply(const void *source, void *dest) const;
+
+		size_t Count() const { return paths.size(); }
+		const FieldPath &Get(const size_t index) const { return paths[index]; }
+
+	private:
+		const StructDefinition &root;
+		std::vector<FieldPath> paths;
+	};
+}
@@ -1,6 +1,7 @@
 #include "DiscordRPC.h"
 
 #include <time.h>
+#include <Windows.h>
 
 #include "../Blam/BlamEvents.hpp"
 #include "../Blam/BlamNetwork.hpp"
@@ -21,8 +22,13 @@
 
 static const char* APPLICATION_ID = "378984448022020112";
 
+// Events can come in bursts (e.g. a kill streak), so presence changes are sent at most this often
+static const uint32_t PRESENCE_UPDATE_INTERVAL_MS = 2000;
+
 namespace
 {
+	using Discord::PresenceState;
+
 	void handleDiscordDisconnected(int errorCode, const char *message)
 	{
 		Utils::Logger::Instance().Log(Utils::LogTypes::Game, Utils::LogLevel::Error, "Discord-RPC: %s", std::string(message));
@@ -60,25 +66,24 @@ namespace
 		Web::Ui::ScreenLayer::Notify("discord-joinrequest", jsonBuffer.GetString(), true);
 	}
 
-	void PresenceUpdate()
+	PresenceState GetPresence()
 	{
-		auto get_multiplayer_scoreboard = (Blam::MutiplayerScoreboard*(*)())(0x00550B80);
-		Discord::DiscordRPC::Instance().detailString.clear();
-		memset(&Discord::DiscordRPC::Instance().discordPresence, 0, sizeof(Discord::DiscordRPC::discordPresence));
+		PresenceState presence;
+		auto mapName = (char*)Pointer(0x22AB018)(0x1A4);
 
 		auto* session = Blam::Network::GetActiveSession();
 		if (session && session->IsEstablished())
 		{
-			if (strcmp((char*)Pointer(0x22AB018)(0x1A4), "mainmenu") == 0)
+			if (strcmp(mapName, "mainmenu") == 0)
 			{
-				Discord::DiscordRPC::Instance().discordPresence.largeImageKey = "default";
-				Discord::DiscordRPC::Instance().discordPresence.largeImageText = "Mainmenu";
-				Discord::DiscordRPC::Instance().discordPresence.details = "In an Online Lobby";
+				presence.LargeImageKey = "default";
+				presence.LargeImageText = "Mainmenu";
+				presence.Details = "In an Online Lobby";
 			}
 			else
 			{
-				Discord::DiscordRPC::Instance().discordPresence.largeImageKey = (char*)Pointer(0x22AB018)(0x1A4);
-				Discord::DiscordRPC::Instance().discordPresence.largeImageText = (char*)Pointer(0x22AB018)(0x1A4);
+				presence.LargeImageKey = mapName;
+				presence.LargeImageText = mapName;
 				auto game = session->Parameters.GameVariant.Get();
 				auto map = session->Parameters.MapVariant.Get();
 
@@ -86,10 +91,9 @@ namespace
 				{
 					std::stringstream ss;
 					ss << Utils::String::ThinString(game->Name) << " on " << Utils::String::ThinString(map->ContentHeader.Name);
-					Discord::DiscordRPC::Instance().detailString = ss.str(); //Need a variable that will stay active
-					Discord::DiscordRPC::Instance().discordPresence.details = Discord::DiscordRPC::Instance().detailString.c_str();
-					Discord::DiscordRPC::Instance().discordPresence.smallImageKey = Blam::GameTypeNames[game->GameType].c_str();
-					Discord::DiscordRPC::Instance().discordPresence.smallImageText = Blam::GameTypeNames[game->GameType].c_str();
+					presence.Details = ss.str();
+					presence.SmallImageKey = Blam::GameTypeNames[game->GameType];
+					presence.SmallImageText = Blam::GameTypeNames[game->GameType];
 				}
 			}
 			int players = 0;
@@ -100,26 +104,58 @@ namespace
 				plyIndex = session->MembershipInfo.FindNextPlayer(plyIndex);
 			}
 
-			Discord::DiscordRPC::Instance().discordPresence.partySize = players;
-			Discord::DiscordRPC::Instance().discordPresence.partyMax = session->MembershipInfo.SessionMaxPlayers;
-			Discord::DiscordRPC::Instance().discordPresence.state = Modules::ModuleServer::Instance().VarServerNameClient->ValueString.c_str();
+			presence.PartySize = players;
+			presence.PartyMax = session->MembershipInfo.SessionMaxPlayers;
+			presence.State = Modules::ModuleServer::Instance().VarServerNameClient->ValueString;
 		}
 		else
 		{
-			Discord::DiscordRPC::Instance().discordPresence.state = "At the Mainmenu";
-			Discord::DiscordRPC::Instance().discordPresence.largeImageKey = "default";
-			Discord::DiscordRPC::Instance().discordPresence.largeImageText = (char*)Pointer(0x22AB018)(0x1A4);
-			Discord::DiscordRPC::Instance().discordPresence.details = "Alone";
-			Discord::DiscordRPC::Instance().discordPresence.partySize = 1;
-			Discord::DiscordRPC::Instance().discordPresence.partyMax = 1;
+			presence.State = "At the Mainmenu";
+			presence.LargeImageKey = "default";
+			presence.LargeImageText = mapName;
+			presence.Details = "Alone";
+			presence.PartySize = 1;
+			presence.PartyMax = 1;
 		}
+		return presence;
+	}
+
+	const char* EmptyToNull(const std::string &str)
+	{
+		return str.empty() ? nullptr : str.c_str();
+	}
+
+	void SendPresence(const PresenceState &presence)
+	{
+		auto &rpc = Discord::DiscordRPC::Instance();
+		rpc.sentPresence = presence;
+
+		auto &discordPresence = rpc.discordPresence;
+		memset(&discordPresence, 0, sizeof(discordPresence));
+		discordPresence.state = EmptyToNull(rpc.sentPresence.State);
+		discordPresence.details = EmptyToNull(rpc.sentPresence.Details);
+		discordPresence.largeImageKey = EmptyToNull(rpc.sentPresence.LargeImageKey);
+		discordPresence.largeImageText = EmptyToNull(rpc.sentPresence.LargeImageText);
+		discordPresence.smallImageKey = EmptyToNull(rpc.sentPresence.SmallImageKey);
+		discordPresence.smallImageText = EmptyToNull(rpc.sentPresence.SmallImageText);
+		discordPresence.partySize = rpc.sentPresence.PartySize;
+		discordPresence.partyMax = rpc.sentPresence.PartyMax;
+		Discord_UpdatePresence(&discordPresence);
+	}
 
-		Discord_UpdatePresence(&Discord::DiscordRPC::Instance().discordPresence);
+	void PresenceUpdate()
+	{
+		Discord::DiscordRPC::Instance().UpdatePresence();
+	}
+
+	uint64_t DefaultClock()
+	{
+		return GetTickCount64();
 	}
 
 	void handleDiscordReady()
 	{
-		PresenceUpdate();
+		Discord::DiscordRPC::Instance().ResendPresence();
 	}
 
 	void MapLoaded(const char* mappath)
@@ -140,14 +176,21 @@ namespace
 
 namespace Discord
 {
-
 	void DiscordRPC::UpdatePresence()
 	{
-		PresenceUpdate();
+		presenceCoalescer.Submit(GetPresence());
 	}
 
-	DiscordRPC::DiscordRPC()
+	void DiscordRPC::ResendPresence()
 	{
+		presenceCoalescer.Reset();
+		UpdatePresence();
+	}
+
+	DiscordRPC::DiscordRPC() : presenceCoalescer(PRESENCE_UPDATE_INTERVAL_MS, DefaultClock, SendPresence)
+	{
+		memset(&discordPresence, 0, sizeof(discordPresence));
+
 		DiscordEventHandlers handlers;
 		memset(&handlers, 0, sizeof(handlers));
 		handlers.ready = handleDiscordReady;
@@ -176,5 +219,7 @@ namespace Discord
 		Discord_UpdateConnection();
 #endif
 		Discord_RunCallbacks();
+
+		presenceCoalescer.Flush();
 	}
 }
\ No newline at end of file
@@ -1,5 +1,8 @@
+#pragma once
+
 #include <discord-rpc.h>
 #include "../Utils/Singleton.hpp"
+#include "PresenceCoalescer.hpp"
 #include <string>
 namespace Discord
 {
@@ -7,11 +10,15 @@ namespace Discord
 	{
 	public:
 		DiscordRichPresence discordPresence;
-		std::string detailString;
+		PresenceState sentPresence; // Holds the strings discordPresence points to
 
 		void Update();
 		void UpdatePresence();
+		void ResendPresence(); // Sends the presence even if it hasn't changed, e.g. after reconnecting to Discord
 		void ReplyToJoinRequest(const char* userId, int reply);
 		DiscordRPC();
+
+	private:
+		PresenceCoalescer presenceCoalescer;
 	};
 }
@@ -0,0 +1,51 @@
+#include "PresenceCoalescer.hpp"
+
+namespace Discord
+{
+	bool PresenceState::operator==(const PresenceState &other) const
+	{
+		return State == other.State && Details == other.Details &&
+			LargeImageKey == other.LargeImageKey && LargeImageText == other.LargeImageText &&
+			SmallImageKey == other.SmallImageKey && SmallImageText == other.SmallImageText &&
+			PartySize == other.PartySize && PartyMax == other.PartyMax;
+	}
+
+	PresenceCoalescer::PresenceCoalescer(uint32_t intervalMs, ClockFunc clock, SendFunc send)
+		: intervalMs(intervalMs), clock(clock), send(send), hasSent(false), hasPending(false), lastSendTime(0)
+	{
+	}
+
+	void PresenceCoalescer::Submit(const PresenceState &state)
+	{
+		if (hasSent && state == lastSent)
+		{
+			// Changed back before the pending state went out, so there's nothing left to send
+			hasPending = false;
+			return;
+		}
+		pending = state;
+		hasPending = true;
+		Flush();
+	}
+
+	void PresenceCoalescer::Flush()
+	{
+		if (!hasPending)
+			return;
+
+		auto now = clock();
+		if (hasSent && now - lastSendTime < intervalMs)
+			return;
+
+		lastSent = pending;
+		hasSent = true;
+		hasPending = false;
+		lastSendTime = now;
+		send(lastSent);
+	}
+
+	void PresenceCoalescer::Reset()
+	{
+		hasSent = false;
+	}
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+
+namespace Discord
+{
+	// The parts of the rich presence which other users can see.
+	struct PresenceState
+	{
+		std::string State;
+		std::string Details;
+		std::string LargeImageKey;
+		std::string LargeImageText;
+		std::string SmallImageKey;
+		std::string SmallImageText;
+		int PartySize;
+		int PartyMax;
+
+		PresenceState() : PartySize(0), PartyMax(0) { }
+
+		bool operator==(const PresenceState &other) const;
+		bool operator!=(const PresenceState &other) const { return !(*this == other); }
+	};
+
+	// Sends presence changes at most once per interval. A state which is the same as the last one sent is dropped,
+	// and a burst of changes within an interval is collapsed into its final state, which is sent once the interval is up.
+	class PresenceCoalescer
+	{
+	public:
+		// Returns the current time in milliseconds.
+		typedef uint64_t(*ClockFunc)();
+
+		// Sends a presence to Discord.
+		typedef std::function<void(const PresenceState&)> SendFunc;
+
+		PresenceCoalescer(uint32_t intervalMs, ClockFunc clock, SendFunc send);
+
+		// Queues a presence and sends it if the interval is up.
+		void Submit(const PresenceState &state);
+
+		// Sends the queued presence if the interval is up. Call this regularly so that the final state goes out.
+		void Flush();
+
+		// Forgets what was last sent, so that the next presence is sent even if it hasn't changed.
+		void Reset();
+
+		bool HasPending() const { return hasPending; }
+
+	private:
+		uint32_t intervalMs;
+		ClockFunc clock;
+		SendFunc send;
+		PresenceState lastSent;
+		PresenceState pending;
+		bool hasSent;
+		bool hasPending;
+		uint64_t lastSendTime;
+	};
+}
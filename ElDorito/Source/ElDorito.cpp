@@ -10,6 +10,7 @@
 #include "Server/BanList.hpp"
 #include "Server/Rcon.hpp"
 #include "Server/Signaling.hpp"
+#include "Server/PlayerDirectory.hpp"
 #include "Patches/Core.hpp"
 #include "Console.hpp"
 #include "Web/Ui/WebScoreboard.hpp"
@@ -110,6 +111,7 @@ void ElDorito::Initialize()
 	Console::Init();
 	Modules::ElModules::Instance();
 	Server::TempBanList::Instance();
+	Patches::Core::OnShutdown([]() { Server::TempBanList::Instance().Flush(); });
 
 	// load variables/commands from cfg file
 	// If instancing is enabled then load the instanced dewrito_prefs.cfg
@@ -248,7 +250,8 @@ void ElDorito::Initialize()
 void ElDorito::Tick()
 {
 	Server::VariableSynchronization::Tick();
-	Server::Chat::Tick();
+	Server::PlayerDirectory::Instance().Sync(Blam::Network::GetActiveSession());
+	Server::TempBanList::Instance().Flush();
 	Patches::Tick();
 	if (!isDedicated) {
 		Web::Ui::ScreenLayer::Tick();
@@ -257,6 +260,7 @@ void ElDorito::Tick()
 	else
 		Server::DedicatedServer::Tick();
 
+	Server::Rcon::Tick();
 	Server::Stats::Tick();
 	Server::Voting::Tick();
 	ChatCommands::Tick();
@@ -20,6 +20,7 @@
 #include "Patches\Events.hpp"
 #include "Patches\LoadingScreen.hpp"
 #include "Patches\Memory.hpp"
+#include "Patches\MemoryTelemetry.hpp"
 #include "Patches\Equipment.hpp"
 #include "Patches\PlayerRepresentation.hpp"
 #include "Patches\Hf2pExperimental.hpp"
@@ -92,6 +93,7 @@ namespace Patches
 
 	void ApplyOnFirstTick()
 	{
+		ContentItems::ApplyOnFirstTick();
 	}
 
 	void ApplyAfterTagsLoaded()
@@ -109,6 +111,7 @@ namespace Patches
 	{
 		Sprint::Tick();
 		Forge::Tick();
+		MemoryTelemetry::Tick();
 
 		static bool appliedFirstTickPatches = false;
 		if (appliedFirstTickPatches)
@@ -1,6 +1,7 @@
 #include "Magnets.hpp"
 #include "../Blam/Math/RealVector3D.hpp"
 #include "../Blam/Math/RealQuaternion.hpp"
+#include "../Blam/Math/Batch.hpp"
 #include "../Blam/BlamPlayers.hpp"
 #include "../Blam/BlamObjects.hpp"
 #include "../Blam/Tags/TagInstance.hpp"
@@ -333,13 +334,13 @@ namespace
 
 		auto markers = std::vector<RealVector3D>();
 		const auto numMarkers = GetObjectMarkers(object->TagIndex, markers);
+		Blam::Math::Batch::TransformPoints(objectRotation, objectTransform.Position, markers.data(), markers.data(), numMarkers);
 		for (auto i = 0; i < numMarkers; i++)
 		{
 			if (m_NumSourceMagnets >= MAX_SOURCE_MAGNETS)
 				return;
 
-			m_SourceMagnets[m_NumSourceMagnets++].Position =
-				RealVector3D::Transform(markers[i], objectRotation) + objectTransform.Position;
+			m_SourceMagnets[m_NumSourceMagnets++].Position = markers[i];
 		}
 	}
 
@@ -355,13 +356,13 @@ namespace
 
 		auto markers = std::vector<RealVector3D>();
 		const auto numMarkers = GetObjectMarkers(object->TagIndex, markers);
+		Blam::Math::Batch::TransformPoints(objectRotation, objectTransform.Position, markers.data(), markers.data(), numMarkers);
 		for (auto i = 0; i < numMarkers; i++)
 		{
 			if (m_NumDestMagnets >= MAX_DEST_MAGNETS)
 				return;
 
-			m_DestMagnets[m_NumDestMagnets++].Position =
-				RealVector3D::Transform(markers[i], objectRotation) + objectTransform.Position;
+			m_DestMagnets[m_NumDestMagnets++].Position = markers[i];
 		}
 	}
 }
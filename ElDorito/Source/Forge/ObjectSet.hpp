@@ -2,43 +2,86 @@
 
 #include <cstdint>
 #include <bitset>
+#include <cstring>
+#include <intrin.h>
 
 namespace Forge
 {
 	class ObjectSet
 	{
 	public:
+		ObjectSet()
+		{
+			Clear();
+		}
+
 		bool Contains(uint32_t objectIndex) const
 		{
-			return objectIndex != -1 && m_Bits.test(objectIndex & 0xFFFF);
+			if (objectIndex == -1)
+				return false;
+			auto index = objectIndex & 0xFFFF;
+			return index < MaxObjects && (m_Words[index >> 5] & (1u << (index & 31))) != 0;
 		}
 
 		int Count() const
 		{
-			return m_Bits.count();
+			auto count = 0;
+			for (auto word : m_Words)
+				count += std::bitset<32>(word).count();
+			return count;
 		}
 
 		bool Any() const
 		{
-			return m_Bits.any();
+			for (auto word : m_Words)
+			{
+				if (word)
+					return true;
+			}
+			return false;
 		}
 
 		void Add(uint32_t objectIndex)
 		{
-			m_Bits.set(objectIndex & 0xFFFF);
+			auto index = objectIndex & 0xFFFF;
+			if (index < MaxObjects)
+				m_Words[index >> 5] |= 1u << (index & 31);
 		}
 
 		void Remove(uint32_t objectIndex)
 		{
-			m_Bits.set(objectIndex & 0xFFFF, false);
+			auto index = objectIndex & 0xFFFF;
+			if (index < MaxObjects)
+				m_Words[index >> 5] &= ~(1u << (index & 31));
 		}
 
 		void Clear()
 		{
-			m_Bits.reset();
+			memset(m_Words, 0, sizeof(m_Words));
+		}
+
+		// Calls a function with the object array index (not the full datum index) of each object in the set,
+		// in ascending order. Only the words with bits set are scanned, so small sets are cheap to walk.
+		template<class Func>
+		void ForEach(Func callback) const
+		{
+			for (auto i = 0; i < WordCount; i++)
+			{
+				auto word = m_Words[i];
+				while (word)
+				{
+					unsigned long bit;
+					_BitScanForward(&bit, word);
+					word &= word - 1;
+					callback(static_cast<uint16_t>((i << 5) | bit));
+				}
+			}
 		}
 
 	private:
-		std::bitset<2048> m_Bits;
+		static const int MaxObjects = 2048;
+		static const int WordCount = MaxObjects / 32;
+
+		uint32_t m_Words[WordCount];
 	};
 }
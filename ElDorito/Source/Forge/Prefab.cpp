@@ -5,46 +5,30 @@
 #include "../Blam/BlamPlayers.hpp"
 #include "../ElDorito.hpp"
 #include "../Modules/ModulePlayer.hpp"
+#include "../Utils/Logger.hpp"
 #include "ForgeUtil.hpp"
 #include "ObjectSet.hpp"
+#include "PrefabBudget.hpp"
+#include "PrefabFormat.hpp"
 #include "Selection.hpp"
 #include <fstream>
 #include <chrono>
+#include <iterator>
 
 using namespace Blam;
 using namespace Blam::Math;
 
 namespace
 {
-	struct PrefabHeader
-	{
-		uint32_t Magic;
-		uint16_t Flags;
-		uint16_t Version;
-		uint64_t DateCreated;
-		char Name[16];
-		char Author[16];
-		uint16_t ObjectCount;
-		uint16_t _Padding;
-	};
-
-	struct PrefabPlacement
-	{
-		uint32_t Flags;
-		uint32_t TagIndex;
-		RealVector3D Position;
-		RealVector3D RightVector;
-		RealVector3D UpVector;
-		Blam::MapVariant::VariantProperties Properties;
-	};
+	void DeleteSpawnedObjects(const Forge::ObjectSet &objects);
 }
 
 namespace Forge::Prefabs
 {
 	bool Save(const std::string& name, const std::string& path)
 	{
-		std::ofstream fs(path, std::ios::binary);
-		if (!fs.is_open())
+		auto mapv = Forge::GetMapVariant();
+		if (!mapv)
 			return false;
 
 		auto& objectSet = Forge::Selection::GetSelection();
@@ -52,19 +36,11 @@ namespace Forge::Prefabs
 		auto& modulePlayer = Modules::ModulePlayer::Instance();
 		auto& playerName = modulePlayer.VarPlayerName->ValueString;
 
-		PrefabHeader header = { 0 };
-		header.Magic = 'prfb';
-		header.DateCreated = std::chrono::system_clock::now().time_since_epoch() / std::chrono::seconds(1);
-		strncpy(header.Name, name.c_str(), sizeof(header.Name));
-		strncpy(header.Author, playerName.c_str(), sizeof(header.Author));
-		header.ObjectCount = objectSet.Count();
-
-		fs.write((char*)&header, sizeof(header));
-
-		auto mapv = Forge::GetMapVariant();
-
-		auto playerIndex = Blam::Players::GetLocalPlayer(0);
-		const auto& crosshairPoint = GetSandboxGlobals().CrosshairPoints[playerIndex.Index()];
+		Prefab prefab;
+		prefab.Flags = 0;
+		prefab.DateCreated = std::chrono::system_clock::now().time_since_epoch() / std::chrono::seconds(1);
+		prefab.Name = name;
+		prefab.Author = playerName;
 
 		for (auto i = 0; i < 640; i++)
 		{
@@ -72,19 +48,23 @@ namespace Forge::Prefabs
 			if (!placement.InUse() || !objectSet.Contains(placement.ObjectIndex))
 				continue;
 
-			PrefabPlacement prefabPlacement = { 0 };
-			prefabPlacement.TagIndex = mapv->Budget[placement.BudgetIndex].TagIndex;
-			prefabPlacement.Position = placement.Position - GetSandboxGlobals().CrosshairPoints[0];
-			prefabPlacement.RightVector = placement.RightVector;
-			prefabPlacement.UpVector = placement.UpVector;
-			prefabPlacement.Properties = placement.Properties;
-
-			fs.write((char*)&prefabPlacement, sizeof(prefabPlacement));
-			if (fs.fail())
-				return false;
+			PrefabObject object = { 0 };
+			object.TagIndex = mapv->Budget[placement.BudgetIndex].TagIndex;
+			object.Position = placement.Position - GetSandboxGlobals().CrosshairPoints[0];
+			object.RightVector = placement.RightVector;
+			object.UpVector = placement.UpVector;
+			object.Properties = placement.Properties;
+			prefab.Objects.push_back(object);
 		}
 
-		return true;
+		// Serialize before opening the file so that a failed save doesn't leave a partial prefab behind
+		auto data = SerializePrefab(prefab);
+
+		std::ofstream fs(path, std::ios::binary);
+		if (!fs.is_open())
+			return false;
+		fs.write(reinterpret_cast<const char*>(data.data()), data.size());
+		return !fs.fail();
 	}
 
 	bool Load(const std::string& path)
@@ -92,41 +72,86 @@ namespace Forge::Prefabs
 		std::ifstream fs(path, std::ios::binary);
 		if (!fs.is_open())
 			return false;
+		std::vector<uint8_t> data((std::istreambuf_iterator<char>(fs)), std::istreambuf_iterator<char>());
+		if (fs.bad())
+			return false;
+
+		Prefab prefab;
+		auto error = DeserializePrefab(data.data(), data.size(), &prefab);
+		if (error != PrefabError::None)
+		{
+			Utils::Logger::Instance().Log(Utils::LogTypes::Game, Utils::LogLevel::Error, "Failed to load prefab %s: %s", path.c_str(), GetPrefabErrorString(error));
+			return false;
+		}
 
 		auto mapv = Forge::GetMapVariant();
 		if (!mapv)
 			return false;
 
+		// Check every tag's item limit and cost up front, so that a prefab which can't fit doesn't spawn half its objects first
+		auto budget = CheckPrefabBudget(prefab, *mapv);
+		switch (budget.Error)
+		{
+		case PrefabBudgetError::None:
+			break;
+		case PrefabBudgetError::NotEnoughPlacements:
+			Utils::Logger::Instance().Log(Utils::LogTypes::Game, Utils::LogLevel::Error, "Failed to load prefab %s: it has %d objects but only %d more can be placed",
+				path.c_str(), static_cast<int>(budget.Needed), static_cast<int>(budget.Available));
+			return false;
+		case PrefabBudgetError::OverItemLimit:
+			Utils::Logger::Instance().Log(Utils::LogTypes::Game, Utils::LogLevel::Error, "Failed to load prefab %s: it has %d of object 0x%X but only %d more can be placed",
+				path.c_str(), static_cast<int>(budget.Needed), budget.TagIndex, static_cast<int>(budget.Available));
+			return false;
+		case PrefabBudgetError::OverBudget:
+			Utils::Logger::Instance().Log(Utils::LogTypes::Game, Utils::LogLevel::Error, "Failed to load prefab %s: it costs %g but only %g of the budget is left",
+				path.c_str(), budget.Needed, budget.Available);
+			return false;
+		case PrefabBudgetError::NotEnoughBudgetEntries:
+			Utils::Logger::Instance().Log(Utils::LogTypes::Game, Utils::LogLevel::Error, "Failed to load prefab %s: it has %d kinds of object which aren't on the map but only %d more kinds can be added",
+				path.c_str(), static_cast<int>(budget.Needed), static_cast<int>(budget.Available));
+			return false;
+		}
+
 		auto playerIndex = Blam::Players::GetLocalPlayer(0);
 		const auto& crosshairPoint = GetSandboxGlobals().CrosshairPoints[playerIndex.Index()];
 
-		auto& objectSet = Forge::Selection::GetSelection();
-		objectSet.Clear();
-
-		PrefabHeader header;
-		fs.read((char*)&header, sizeof(header));
-
-		for (auto i = 0; i < header.ObjectCount; i++)
+		// The whole prefab is spawned or none of it is, and the selection only changes once everything is in
+		ObjectSet spawnedObjects;
+		for (auto& object : prefab.Objects)
 		{
-			PrefabPlacement prefabPlacement;
-			fs.read(reinterpret_cast<char*>(&prefabPlacement), sizeof(prefabPlacement));
-			if (fs.eof())
-				break;
-
-			if (fs.fail())
-				return false;
-
-			auto position = crosshairPoint + prefabPlacement.Position;
+			auto position = crosshairPoint + object.Position;
 
-			auto newObjectIndex = SpawnObject(mapv, prefabPlacement.TagIndex, 0, -1, &position,
-				&prefabPlacement.RightVector, &prefabPlacement.UpVector, -1, -1, &prefabPlacement.Properties, 0);
+			auto newObjectIndex = SpawnObject(mapv, object.TagIndex, 0, -1, &position,
+				&object.RightVector, &object.UpVector, -1, -1, &object.Properties, 0);
 
 			if (newObjectIndex == -1)
+			{
+				Utils::Logger::Instance().Log(Utils::LogTypes::Game, Utils::LogLevel::Error, "Failed to load prefab %s: object 0x%X could not be spawned",
+					path.c_str(), object.TagIndex);
+				DeleteSpawnedObjects(spawnedObjects);
 				return false;
+			}
 
-			objectSet.Add(newObjectIndex);
+			spawnedObjects.Add(newObjectIndex);
 		}
 
+		Forge::Selection::GetSelection() = spawnedObjects;
 		return true;
 	}
 }
+
+namespace
+{
+	void DeleteSpawnedObjects(const Forge::ObjectSet &objects)
+	{
+		auto mapv = Forge::GetMapVariant();
+		auto playerIndex = Blam::Players::GetLocalPlayer(0);
+
+		for (auto i = 0; i < 640; i++)
+		{
+			const auto& placement = mapv->Placements[i];
+			if (placement.InUse() && objects.Contains(placement.ObjectIndex))
+				Forge::DeleteObject(playerIndex.Index(), i);
+		}
+	}
+}
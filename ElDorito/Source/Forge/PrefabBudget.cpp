@@ -0,0 +1,91 @@
+#include "PrefabBudget.hpp"
+#include <algorithm>
+#include <map>
+
+namespace
+{
+	const uint8_t UnlimitedItems = 0xFF;
+
+	bool IsBudgetEntryFree(const Blam::MapVariant::BudgetEntry &budget);
+}
+
+namespace Forge::Prefabs
+{
+	PrefabBudgetCheck CheckPrefabBudget(const Prefab &prefab, const Blam::MapVariant &mapv)
+	{
+		PrefabBudgetCheck result = { PrefabBudgetError::None, 0xFFFFFFFF, 0, 0 };
+
+		auto freePlacements = 0;
+		for (auto i = 0; i < 640; i++)
+		{
+			if (!mapv.Placements[i].InUse())
+				freePlacements++;
+		}
+		if (static_cast<int>(prefab.Objects.size()) > freePlacements)
+		{
+			result.Error = PrefabBudgetError::NotEnoughPlacements;
+			result.Needed = static_cast<float>(prefab.Objects.size());
+			result.Available = static_cast<float>(freePlacements);
+			return result;
+		}
+
+		std::map<uint32_t, int> tagCounts; // Tag index -> objects in the prefab
+		for (auto &object : prefab.Objects)
+			tagCounts[object.TagIndex]++;
+
+		// Entries are appended until the list is full, and then the ones which were freed are reused
+		auto entryCount = std::min<int>(mapv.BudgetEntryCount, 256);
+		auto freeEntries = 256 - entryCount;
+		auto cost = 0.0f;
+		for (auto i = 0; i < entryCount; i++)
+		{
+			auto &budget = mapv.Budget[i];
+			if (IsBudgetEntryFree(budget))
+			{
+				freeEntries++;
+				continue;
+			}
+
+			auto it = tagCounts.find(budget.TagIndex);
+			if (it == tagCounts.end())
+				continue;
+
+			if (budget.DesignTimeMax != UnlimitedItems && budget.CountOnMap + it->second > budget.DesignTimeMax)
+			{
+				result.Error = PrefabBudgetError::OverItemLimit;
+				result.TagIndex = budget.TagIndex;
+				result.Needed = static_cast<float>(it->second);
+				result.Available = static_cast<float>(std::max(budget.DesignTimeMax - budget.CountOnMap, 0));
+				return result;
+			}
+			if (budget.Cost > 0)
+				cost += budget.Cost * it->second;
+			tagCounts.erase(it);
+		}
+
+		if (mapv.MaxBudget > 0 && mapv.CurrentBudget + cost > mapv.MaxBudget)
+		{
+			result.Error = PrefabBudgetError::OverBudget;
+			result.Needed = cost;
+			result.Available = std::max(mapv.MaxBudget - mapv.CurrentBudget, 0.0f);
+			return result;
+		}
+
+		// Whatever is left isn't on the map yet
+		if (static_cast<int>(tagCounts.size()) > freeEntries)
+		{
+			result.Error = PrefabBudgetError::NotEnoughBudgetEntries;
+			result.Needed = static_cast<float>(tagCounts.size());
+			result.Available = static_cast<float>(freeEntries);
+		}
+		return result;
+	}
+}
+
+namespace
+{
+	bool IsBudgetEntryFree(const Blam::MapVariant::BudgetEntry &budget)
+	{
+		return budget.TagIndex == 0xFFFFFFFF;
+	}
+}
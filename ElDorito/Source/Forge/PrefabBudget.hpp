@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstdint>
+#include "PrefabFormat.hpp"
+#include "../Blam/BlamTypes.hpp"
+
+namespace Forge::Prefabs
+{
+	enum class PrefabBudgetError
+	{
+		None,
+		NotEnoughPlacements,   // There aren't enough free placements for every object
+		OverItemLimit,         // A tag would go over the most objects of it a map can have
+		OverBudget,            // The objects would cost more than the map variant's budget has left
+		NotEnoughBudgetEntries // There aren't enough free budget entries for the tags which aren't on the map yet
+	};
+
+	struct PrefabBudgetCheck
+	{
+		PrefabBudgetError Error;
+		uint32_t TagIndex; // The tag which is over its item limit
+		float Needed;      // Placements, objects of the tag, cost or budget entries, depending on the error
+		float Available;
+	};
+
+	// Checks whether every object in a prefab can be spawned in a map variant, by counting the objects of each tag
+	// against its budget entry. Tags which don't have an entry yet get one from the sandbox palette when they're first
+	// spawned, so only a free entry is checked for those.
+	PrefabBudgetCheck CheckPrefabBudget(const Prefab &prefab, const Blam::MapVariant &mapv);
+}
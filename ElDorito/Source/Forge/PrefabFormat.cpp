@@ -0,0 +1,331 @@
+#include "PrefabFormat.hpp"
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+namespace
+{
+	using namespace Forge::Prefabs;
+
+	const uint32_t PrefabMagic = 'prfb';
+
+	// Version 0 is the original format, which is a raw dump of LegacyPrefabHeader followed by LegacyPrefabPlacements.
+	// Version 2 writes every field explicitly and stores the header and object sizes, so fields can be added to the
+	// end of either one without breaking older readers. The whole file, apart from the checksum itself, is covered by a CRC-32.
+	const uint16_t LegacyPrefabVersion = 0;
+	const uint16_t CurrentPrefabVersion = 2;
+
+	struct LegacyPrefabHeader
+	{
+		uint32_t Magic;
+		uint16_t Flags;
+		uint16_t Version;
+		uint64_t DateCreated;
+		char Name[16];
+		char Author[16];
+		uint16_t ObjectCount;
+		uint16_t _Padding;
+	};
+	static_assert(sizeof(LegacyPrefabHeader) == 0x38, "Invalid LegacyPrefabHeader size");
+
+	struct LegacyPrefabPlacement
+	{
+		uint32_t Flags;
+		uint32_t TagIndex;
+		Blam::Math::RealVector3D Position;
+		Blam::Math::RealVector3D RightVector;
+		Blam::Math::RealVector3D UpVector;
+		Blam::MapVariant::VariantProperties Properties;
+	};
+	static_assert(sizeof(LegacyPrefabPlacement) == 0x44, "Invalid LegacyPrefabPlacement size");
+
+	// Magic, Flags, Version, HeaderSize, DateCreated, Name, Author, ObjectCount, ObjectSize, Checksum
+	const uint32_t PrefabHeaderSize = 4 + 2 + 2 + 4 + 8 + 16 + 16 + 4 + 4 + 4;
+	const uint32_t PrefabChecksumOffset = PrefabHeaderSize - 4;
+
+	// Flags, TagIndex, Position, RightVector, UpVector, then the variant properties field by field
+	const uint32_t PrefabObjectSize = 4 + 4 + 12 * 3 + 2 + 1 * 6 + 4 * 4;
+
+	class BufferWriter
+	{
+	public:
+		explicit BufferWriter(std::vector<uint8_t> *buffer) : buffer(buffer) { }
+
+		template<class T>
+		void Write(const T &value)
+		{
+			auto bytes = reinterpret_cast<const uint8_t*>(&value);
+			buffer->insert(buffer->end(), bytes, bytes + sizeof(T));
+		}
+
+		void WriteString(const std::string &str, size_t size)
+		{
+			// Always leave room for a null terminator
+			auto length = std::min(str.length(), size - 1);
+			buffer->insert(buffer->end(), str.begin(), str.begin() + length);
+			buffer->insert(buffer->end(), size - length, 0);
+		}
+
+	private:
+		std::vector<uint8_t> *buffer;
+	};
+
+	class BufferReader
+	{
+	public:
+		explicit BufferReader(const uint8_t *data) : data(data), position(0) { }
+
+		template<class T>
+		T Read()
+		{
+			T result;
+			memcpy(&result, data + position, sizeof(T));
+			position += sizeof(T);
+			return result;
+		}
+
+		std::string ReadString(size_t size)
+		{
+			auto str = reinterpret_cast<const char*>(data + position);
+			position += size;
+			return std::string(str, strnlen(str, size));
+		}
+
+		void Seek(size_t offset) { position = offset; }
+
+	private:
+		const uint8_t *data;
+		size_t position;
+	};
+
+	std::array<uint32_t, 256> BuildCrc32Table();
+	uint32_t Crc32(const uint8_t *data, size_t size, uint32_t crc = 0);
+	uint32_t ComputeChecksum(const uint8_t *data, size_t size);
+	void WriteObject(BufferWriter &writer, const PrefabObject &object);
+	PrefabObject ReadObject(BufferReader &reader);
+	PrefabError DeserializeLegacyPrefab(const uint8_t *data, size_t size, Prefab *result);
+}
+
+namespace Forge::Prefabs
+{
+	const char* GetPrefabErrorString(PrefabError error)
+	{
+		switch (error)
+		{
+		case PrefabError::None:
+			return "No error";
+		case PrefabError::BadMagic:
+			return "Not a prefab file";
+		case PrefabError::UnsupportedVersion:
+			return "The prefab was made with a newer version of the game";
+		case PrefabError::Truncated:
+			return "The prefab file is incomplete";
+		case PrefabError::TrailingData:
+			return "The prefab file has unexpected data at the end";
+		case PrefabError::BadChecksum:
+			return "The prefab file is corrupt";
+		case PrefabError::TooManyObjects:
+			return "The prefab has too many objects";
+		}
+		return "Unknown error";
+	}
+
+	std::vector<uint8_t> SerializePrefab(const Prefab &prefab)
+	{
+		std::vector<uint8_t> result;
+		result.reserve(PrefabHeaderSize + prefab.Objects.size() * PrefabObjectSize);
+
+		BufferWriter writer(&result);
+		writer.Write(PrefabMagic);
+		writer.Write(prefab.Flags);
+		writer.Write(CurrentPrefabVersion);
+		writer.Write(PrefabHeaderSize);
+		writer.Write(prefab.DateCreated);
+		writer.WriteString(prefab.Name, 16);
+		writer.WriteString(prefab.Author, 16);
+		writer.Write(static_cast<uint32_t>(prefab.Objects.size()));
+		writer.Write(PrefabObjectSize);
+		writer.Write(static_cast<uint32_t>(0)); // Checksum, filled in below
+
+		for (auto &object : prefab.Objects)
+			WriteObject(writer, object);
+
+		auto checksum = ComputeChecksum(&result[0], result.size());
+		memcpy(&result[PrefabChecksumOffset], &checksum, sizeof(checksum));
+		return result;
+	}
+
+	PrefabError DeserializePrefab(const uint8_t *data, size_t size, Prefab *result)
+	{
+		// The magic, flags and version are in the same place in every version
+		if (size < 8)
+			return PrefabError::Truncated;
+		BufferReader reader(data);
+		if (reader.Read<uint32_t>() != PrefabMagic)
+			return PrefabError::BadMagic;
+		auto flags = reader.Read<uint16_t>();
+		auto version = reader.Read<uint16_t>();
+		if (version == LegacyPrefabVersion)
+			return DeserializeLegacyPrefab(data, size, result);
+		if (version > CurrentPrefabVersion)
+			return PrefabError::UnsupportedVersion;
+
+		if (size < PrefabHeaderSize)
+			return PrefabError::Truncated;
+		auto headerSize = reader.Read<uint32_t>();
+		if (headerSize < PrefabHeaderSize)
+			return PrefabError::UnsupportedVersion;
+
+		Prefab prefab;
+		prefab.Flags = flags;
+		prefab.DateCreated = reader.Read<uint64_t>();
+		prefab.Name = reader.ReadString(16);
+		prefab.Author = reader.ReadString(16);
+		auto objectCount = reader.Read<uint32_t>();
+		auto objectSize = reader.Read<uint32_t>();
+		auto checksum = reader.Read<uint32_t>();
+
+		if (objectCount > MaxPrefabObjects)
+			return PrefabError::TooManyObjects;
+		if (objectSize < PrefabObjectSize)
+			return PrefabError::UnsupportedVersion;
+
+		// Everything is checked before any objects are read so that a bad file is rejected as a whole
+		auto expectedSize = static_cast<uint64_t>(headerSize) + static_cast<uint64_t>(objectCount) * objectSize;
+		if (size < expectedSize)
+			return PrefabError::Truncated;
+		if (size > expectedSize)
+			return PrefabError::TrailingData;
+		if (ComputeChecksum(data, size) != checksum)
+			return PrefabError::BadChecksum;
+
+		prefab.Objects.reserve(objectCount);
+		for (auto i = 0U; i < objectCount; i++)
+		{
+			// Skip over any fields added after this version
+			reader.Seek(headerSize + i * objectSize);
+			prefab.Objects.push_back(ReadObject(reader));
+		}
+
+		*result = std::move(prefab);
+		return PrefabError::None;
+	}
+}
+
+namespace
+{
+	std::array<uint32_t, 256> BuildCrc32Table()
+	{
+		std::array<uint32_t, 256> table;
+		for (auto i = 0U; i < table.size(); i++)
+		{
+			auto value = i;
+			for (auto bit = 0; bit < 8; bit++)
+				value = (value & 1) ? (value >> 1) ^ 0xEDB88320 : value >> 1;
+			table[i] = value;
+		}
+		return table;
+	}
+
+	uint32_t Crc32(const uint8_t *data, size_t size, uint32_t crc)
+	{
+		static const auto table = BuildCrc32Table();
+		crc = ~crc;
+		for (size_t i = 0; i < size; i++)
+			crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+		return ~crc;
+	}
+
+	// Computes the checksum of a whole file, which covers everything except the checksum field. This includes any
+	// header fields after the checksum which were added in later versions.
+	uint32_t ComputeChecksum(const uint8_t *data, size_t size)
+	{
+		auto checksumEnd = PrefabChecksumOffset + sizeof(uint32_t);
+		return Crc32(data + checksumEnd, size - checksumEnd, Crc32(data, PrefabChecksumOffset));
+	}
+
+	void WriteObject(BufferWriter &writer, const PrefabObject &object)
+	{
+		writer.Write(object.Flags);
+		writer.Write(object.TagIndex);
+		writer.Write(object.Position);
+		writer.Write(object.RightVector);
+		writer.Write(object.UpVector);
+		writer.Write(object.Properties.EngineFlags);
+		writer.Write(object.Properties.ObjectFlags);
+		writer.Write(object.Properties.TeamAffilation);
+		writer.Write(object.Properties.SharedStorage);
+		writer.Write(object.Properties.RespawnTime);
+		writer.Write(object.Properties.ObjectType);
+		writer.Write(object.Properties.ZoneShape);
+		writer.Write(object.Properties.ZoneRadiusWidth);
+		writer.Write(object.Properties.ZoneDepth);
+		writer.Write(object.Properties.ZoneTop);
+		writer.Write(object.Properties.ZoneBottom);
+	}
+
+	PrefabObject ReadObject(BufferReader &reader)
+	{
+		PrefabObject object;
+		object.Flags = reader.Read<uint32_t>();
+		object.TagIndex = reader.Read<uint32_t>();
+		object.Position = reader.Read<Blam::Math::RealVector3D>();
+		object.RightVector = reader.Read<Blam::Math::RealVector3D>();
+		object.UpVector = reader.Read<Blam::Math::RealVector3D>();
+		object.Properties.EngineFlags = reader.Read<uint16_t>();
+		object.Properties.ObjectFlags = reader.Read<uint8_t>();
+		object.Properties.TeamAffilation = reader.Read<uint8_t>();
+		object.Properties.SharedStorage = reader.Read<uint8_t>();
+		object.Properties.RespawnTime = reader.Read<uint8_t>();
+		object.Properties.ObjectType = reader.Read<uint8_t>();
+		object.Properties.ZoneShape = reader.Read<uint8_t>();
+		object.Properties.ZoneRadiusWidth = reader.Read<float>();
+		object.Properties.ZoneDepth = reader.Read<float>();
+		object.Properties.ZoneTop = reader.Read<float>();
+		object.Properties.ZoneBottom = reader.Read<float>();
+		return object;
+	}
+
+	PrefabError DeserializeLegacyPrefab(const uint8_t *data, size_t size, Prefab *result)
+	{
+		if (size < sizeof(LegacyPrefabHeader))
+			return PrefabError::Truncated;
+
+		LegacyPrefabHeader header;
+		memcpy(&header, data, sizeof(header));
+		if (header.ObjectCount > MaxPrefabObjects)
+			return PrefabError::TooManyObjects;
+
+		// The old format wrote the selection count up front, which could be more than the number of placements
+		// that actually followed, so a short file is fine as long as it ends on a whole placement
+		auto placementBytes = size - sizeof(LegacyPrefabHeader);
+		if (placementBytes % sizeof(LegacyPrefabPlacement) != 0)
+			return PrefabError::Truncated;
+		auto placementCount = placementBytes / sizeof(LegacyPrefabPlacement);
+		if (placementCount > header.ObjectCount)
+			return PrefabError::TrailingData;
+
+		Prefab prefab;
+		prefab.Flags = header.Flags;
+		prefab.DateCreated = header.DateCreated;
+		prefab.Name = std::string(header.Name, strnlen(header.Name, sizeof(header.Name)));
+		prefab.Author = std::string(header.Author, strnlen(header.Author, sizeof(header.Author)));
+		prefab.Objects.resize(placementCount);
+		for (size_t i = 0; i < placementCount; i++)
+		{
+			LegacyPrefabPlacement placement;
+			memcpy(&placement, data + sizeof(LegacyPrefabHeader) + i * sizeof(LegacyPrefabPlacement), sizeof(placement));
+
+			auto &object = prefab.Objects[i];
+			object.Flags = placement.Flags;
+			object.TagIndex = placement.TagIndex;
+			object.Position = placement.Position;
+			object.RightVector = placement.RightVector;
+			object.UpVector = placement.UpVector;
+			object.Properties = placement.Properties;
+		}
+
+		*result = std::move(prefab);
+		return PrefabError::None;
+	}
+}
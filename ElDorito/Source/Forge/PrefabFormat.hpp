@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "../Blam/BlamTypes.hpp"
+#include "../Blam/Math/RealVector3D.hpp"
+
+namespace Forge::Prefabs
+{
+	// The most objects a prefab can hold, which is the number of placements in a map variant.
+	const uint32_t MaxPrefabObjects = 640;
+
+	struct PrefabObject
+	{
+		uint32_t Flags;
+		uint32_t TagIndex;
+		Blam::Math::RealVector3D Position; // Relative to where the prefab is placed
+		Blam::Math::RealVector3D RightVector;
+		Blam::Math::RealVector3D UpVector;
+		Blam::MapVariant::VariantProperties Properties;
+	};
+
+	struct Prefab
+	{
+		uint16_t Flags;
+		uint64_t DateCreated;
+		std::string Name;   // At most 15 characters are saved
+		std::string Author; // At most 15 characters are saved
+		std::vector<PrefabObject> Objects;
+	};
+
+	enum class PrefabError
+	{
+		None,
+		BadMagic,
+		UnsupportedVersion,
+		Truncated,      // The file is shorter than its header says it should be
+		TrailingData,   // The file is longer than its header says it should be
+		BadChecksum,
+		TooManyObjects,
+	};
+
+	// Gets a description of a prefab error.
+	const char* GetPrefabErrorString(PrefabError error);
+
+	// Writes a prefab in the current format.
+	std::vector<uint8_t> SerializePrefab(const Prefab &prefab);
+
+	// Reads and validates a whole prefab. Files in the original unversioned format are converted as they're read.
+	PrefabError DeserializePrefab(const uint8_t *data, size_t size, Prefab *result);
+}
@@ -129,6 +129,7 @@ namespace
 			angle = 0;
 
 		moduleForge.VarRotationSnap->ValueFloat = angle;
+		Modules::CommandMap::Instance().MarkChanged(moduleForge.VarRotationSnap);
 
 		wchar_t buff[256];
 		if (angle > 0)
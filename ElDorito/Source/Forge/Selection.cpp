@@ -12,6 +12,13 @@ using namespace Blam::Math;
 namespace
 {
 	Forge::ObjectSet s_SelectedObjects;
+
+	// Rebuilt by the first query after the placements change
+	Forge::SelectionQuery::PlacementGrid s_PlacementGrid;
+	bool s_PlacementGridValid = false;
+
+	const Forge::SelectionQuery::PlacementGrid* GetPlacementGrid();
+	std::vector<uint32_t> RunQuery(const Forge::SelectionQuery::Query& query);
 }
 
 namespace Forge
@@ -77,6 +84,27 @@ namespace Forge
 		}
 	}
 
+	int Selection::SelectWhere(const SelectionQuery::Query& query)
+	{
+		auto objects = RunQuery(query);
+		for (auto objectIndex : objects)
+			s_SelectedObjects.Add(objectIndex);
+		return objects.size();
+	}
+
+	int Selection::DeselectWhere(const SelectionQuery::Query& query)
+	{
+		auto objects = RunQuery(query);
+		for (auto objectIndex : objects)
+			s_SelectedObjects.Remove(objectIndex);
+		return objects.size();
+	}
+
+	void Selection::InvalidateQueries()
+	{
+		s_PlacementGridValid = false;
+	}
+
 	void Selection::Clear()
 	{
 		s_SelectedObjects.Clear();
@@ -207,3 +235,49 @@ namespace Forge
 		}
 	}
 }
+
+namespace
+{
+	const Forge::SelectionQuery::PlacementGrid* GetPlacementGrid()
+	{
+		static const Blam::MapVariant* s_GridMapVariant = nullptr;
+
+		auto mapv = Forge::GetMapVariant();
+		if (!mapv)
+			return nullptr;
+		if (s_PlacementGridValid && s_GridMapVariant == mapv)
+			return &s_PlacementGrid;
+
+		std::vector<Forge::SelectionQuery::PlacementInfo> placements;
+		placements.reserve(640);
+		for (auto i = 0; i < 640; i++)
+		{
+			const auto& placement = mapv->Placements[i];
+			if (!placement.InUse() || placement.ObjectIndex == -1 || placement.BudgetIndex == -1)
+				continue;
+
+			Forge::SelectionQuery::PlacementInfo info;
+			info.ObjectIndex = placement.ObjectIndex;
+			info.TagIndex = mapv->Budget[placement.BudgetIndex].TagIndex;
+			info.Position = placement.Position;
+			info.Team = placement.Properties.TeamAffilation;
+			info.ObjectType = placement.Properties.ObjectType;
+			info.EngineFlags = placement.Properties.EngineFlags;
+			placements.push_back(info);
+		}
+
+		s_PlacementGrid.Build(placements);
+		s_GridMapVariant = mapv;
+		s_PlacementGridValid = true;
+		return &s_PlacementGrid;
+	}
+
+	std::vector<uint32_t> RunQuery(const Forge::SelectionQuery::Query& query)
+	{
+		std::vector<uint32_t> results;
+		auto grid = GetPlacementGrid();
+		if (grid)
+			grid->Run(query, &results);
+		return results;
+	}
+}
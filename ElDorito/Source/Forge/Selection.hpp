@@ -1,5 +1,7 @@
 #pragma once
 
+#include "SelectionQuery.hpp"
+
 namespace Forge
 {
 	class ObjectSet;
@@ -10,6 +12,14 @@ namespace Forge
 		void SelectAll();
 		void DeselectAllOf();
 
+		// Adds or removes every placed object matching a query. Returns the number of objects that matched.
+		int SelectWhere(const SelectionQuery::Query& query);
+		int DeselectWhere(const SelectionQuery::Query& query);
+
+		// Makes the next query rebuild its placement grid. The forge hooks call this whenever a placement is
+		// spawned, deleted, dropped after being moved, or has its properties changed.
+		void InvalidateQueries();
+
 		void Clear();
 		void Delete();
 		bool Clone();
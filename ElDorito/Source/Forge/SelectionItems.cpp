@@ -0,0 +1,102 @@
+#include "SelectionItems.hpp"
+
+using namespace Blam::Math;
+
+namespace
+{
+	bool IsSameObjectState(const Forge::SelectedObject &a, const Forge::SelectedObject &b);
+}
+
+namespace Forge
+{
+	SelectionItemList::SelectionItemList()
+		: items(buffers[0]), count(0)
+	{
+	}
+
+	void SelectionItemList::Update(const ObjectSet &selection, SelectedObjectSource &source)
+	{
+		// Build the new item list in the other buffer so that items for objects which haven't moved can be carried over.
+		// The selection is walked in index order, so the previous items are in the same order and can be merged in one pass.
+		auto previousItems = items;
+		auto previousCount = count;
+		auto previousPos = 0;
+		auto newItems = (items == buffers[0]) ? buffers[1] : buffers[0];
+		auto newCount = 0;
+
+		selection.ForEach([&](uint16_t index)
+		{
+			SelectedObject object;
+			if (newCount >= MaxItems || !source.FindObject(index, &object))
+				return;
+
+			while (previousPos < previousCount && (previousItems[previousPos].Object.ObjectIndex & 0xFFFF) < index)
+				previousPos++;
+
+			auto& item = newItems[newCount];
+			if (previousPos < previousCount && IsSameObjectState(previousItems[previousPos].Object, object))
+			{
+				item = previousItems[previousPos];
+				newCount++;
+				return;
+			}
+
+			auto& boundingBox = GetBoundingBox(object.TagIndex, source);
+			if (!boundingBox.Valid)
+				return;
+
+			RealMatrix4x3 transform;
+			source.GetTransform(object.ObjectIndex, &transform);
+			BuildSelectionItem(object, boundingBox.Box, transform, &item);
+			newCount++;
+		});
+
+		items = newItems;
+		count = newCount;
+	}
+
+	void SelectionItemList::Reset()
+	{
+		boundingBoxes.clear();
+		count = 0;
+	}
+
+	const SelectionItemList::CachedBoundingBox& SelectionItemList::GetBoundingBox(uint32_t tagIndex, SelectedObjectSource &source)
+	{
+		auto it = boundingBoxes.find(tagIndex);
+		if (it != boundingBoxes.end())
+			return it->second;
+
+		CachedBoundingBox result = {};
+		auto boundingBox = source.GetBoundingBox(tagIndex);
+		if (boundingBox)
+		{
+			result.Valid = true;
+			result.Box = *boundingBox;
+		}
+		return boundingBoxes[tagIndex] = result;
+	}
+
+	void BuildSelectionItem(const SelectedObject &object, const AABB &boundingBox, const RealMatrix4x3 &transform, SelectionItem *result)
+	{
+		result->Transform = transform;
+		result->Transform.Forward *= (boundingBox.MaxX - boundingBox.MinX) * 1.01f;
+		result->Transform.Left *= (boundingBox.MaxY - boundingBox.MinY) * 1.01f;
+		result->Transform.Up *= (boundingBox.MaxZ - boundingBox.MinZ) * 1.01f;
+		result->Transform.Position = object.Center;
+
+		result->Width = boundingBox.MaxX - boundingBox.MinX;
+		result->Depth = boundingBox.MaxY - boundingBox.MinY;
+		result->Height = boundingBox.MaxZ - boundingBox.MinZ;
+		result->Object = object;
+	}
+}
+
+namespace
+{
+	bool IsSameObjectState(const Forge::SelectedObject &a, const Forge::SelectedObject &b)
+	{
+		return a.ObjectIndex == b.ObjectIndex && a.TagIndex == b.TagIndex &&
+			a.Center == b.Center && a.Forward == b.Forward && a.Up == b.Up;
+	}
+}
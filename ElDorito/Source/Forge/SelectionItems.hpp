@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include "ForgeUtil.hpp"
+#include "ObjectSet.hpp"
+#include "../Blam/Math/RealMatrix4x3.hpp"
+
+namespace Forge
+{
+	// The parts of a selected object which its highlight box is computed from.
+	struct SelectedObject
+	{
+		uint32_t ObjectIndex;
+		uint32_t TagIndex;
+		Blam::Math::RealVector3D Center;
+		Blam::Math::RealVector3D Forward;
+		Blam::Math::RealVector3D Up;
+	};
+
+	// Where selection items read objects from. The selection renderer reads them from the game.
+	class SelectedObjectSource
+	{
+	public:
+		virtual ~SelectedObjectSource() { }
+
+		// Gets the object at an index in the object array. Returns false if there isn't one.
+		virtual bool FindObject(uint16_t index, SelectedObject *result) = 0;
+
+		// Gets the bounding box of an object tag, or null if it doesn't have one.
+		virtual const AABB* GetBoundingBox(uint32_t tagIndex) = 0;
+
+		// Gets the transformation matrix of an object.
+		virtual void GetTransform(uint32_t objectIndex, Blam::Math::RealMatrix4x3 *result) = 0;
+	};
+
+	struct SelectionItem
+	{
+		Blam::Math::RealMatrix4x3 Transform; // Scaled to the object's bounding box
+		float Width;
+		float Depth;
+		float Height;
+		SelectedObject Object; // What the transform was computed from
+	};
+
+	// Builds the highlight boxes for the selected objects. Bounding boxes are cached per tag, and the item for an
+	// object which hasn't moved since the last update is carried over instead of being recomputed.
+	class SelectionItemList
+	{
+	public:
+		static const int MaxItems = 256;
+
+		SelectionItemList();
+
+		// Rebuilds the items for the objects in a selection, in index order.
+		void Update(const ObjectSet &selection, SelectedObjectSource &source);
+
+		// Forgets the items, but not the cached bounding boxes.
+		void Clear() { count = 0; }
+
+		// Forgets every item and cached bounding box. Tag definitions move when a map is loaded.
+		void Reset();
+
+		const SelectionItem* GetItems() const { return items; }
+		int GetCount() const { return count; }
+
+	private:
+		struct CachedBoundingBox
+		{
+			bool Valid;
+			AABB Box;
+		};
+
+		SelectionItem buffers[2][MaxItems];
+		SelectionItem *items;
+		int count;
+		std::unordered_map<uint32_t, CachedBoundingBox> boundingBoxes; // Tag index -> bounding box
+
+		const CachedBoundingBox& GetBoundingBox(uint32_t tagIndex, SelectedObjectSource &source);
+	};
+
+	// Computes the highlight box for an object from scratch.
+	void BuildSelectionItem(const SelectedObject &object, const AABB &boundingBox, const Blam::Math::RealMatrix4x3 &transform, SelectionItem *result);
+}
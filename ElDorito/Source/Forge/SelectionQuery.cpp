@@ -0,0 +1,184 @@
+#include "SelectionQuery.hpp"
+#include <algorithm>
+#include <cmath>
+
+using namespace Blam::Math;
+
+namespace
+{
+	// Cell coordinates are clamped to 16 bits each so that they can be packed into a single key
+	const int MinCellCoordinate = -32768;
+	const int MaxCellCoordinate = 32767;
+
+	uint32_t MakeCellKey(int x, int y);
+}
+
+namespace Forge::SelectionQuery
+{
+	bool MatchesFilter(const PlacementInfo &placement, const QueryFilter &filter)
+	{
+		if (filter.TagIndex != 0xFFFFFFFF && placement.TagIndex != filter.TagIndex)
+			return false;
+		if (filter.Team != -1 && placement.Team != filter.Team)
+			return false;
+		if (filter.ObjectType != -1 && placement.ObjectType != filter.ObjectType)
+			return false;
+		return (placement.EngineFlags & filter.RequiredEngineFlags) == filter.RequiredEngineFlags;
+	}
+
+	bool IsInShape(const PlacementInfo &placement, const Query &query)
+	{
+		auto &position = placement.Position;
+		switch (query.Shape)
+		{
+		case QueryShape::All:
+			return true;
+		case QueryShape::Box:
+			return position.I >= query.Min.I && position.I <= query.Max.I &&
+				position.J >= query.Min.J && position.J <= query.Max.J &&
+				position.K >= query.Min.K && position.K <= query.Max.K;
+		case QueryShape::Sphere:
+		{
+			auto dx = position.I - query.Center.I;
+			auto dy = position.J - query.Center.J;
+			auto dz = position.K - query.Center.K;
+			return dx * dx + dy * dy + dz * dz <= query.Radius * query.Radius;
+		}
+		case QueryShape::Radius:
+		{
+			auto dx = position.I - query.Center.I;
+			auto dy = position.J - query.Center.J;
+			return dx * dx + dy * dy <= query.Radius * query.Radius;
+		}
+		}
+		return false;
+	}
+
+	PlacementGrid::PlacementGrid(float cellSize)
+		: cellSize(cellSize), minCellX(0), minCellY(0), maxCellX(-1), maxCellY(-1)
+	{
+	}
+
+	void PlacementGrid::Build(const std::vector<PlacementInfo> &newPlacements)
+	{
+		placements = newPlacements;
+		cells.clear();
+		minCellX = minCellY = MaxCellCoordinate;
+		maxCellX = maxCellY = MinCellCoordinate;
+		if (placements.empty())
+		{
+			minCellX = minCellY = 0;
+			maxCellX = maxCellY = -1;
+			return;
+		}
+
+		std::vector<uint32_t> keys(placements.size());
+		for (size_t i = 0; i < placements.size(); i++)
+		{
+			auto x = GetCellCoordinate(placements[i].Position.I);
+			auto y = GetCellCoordinate(placements[i].Position.J);
+			minCellX = std::min(minCellX, x);
+			minCellY = std::min(minCellY, y);
+			maxCellX = std::max(maxCellX, x);
+			maxCellY = std::max(maxCellY, y);
+			keys[i] = MakeCellKey(x, y);
+		}
+
+		// Sort the placements by cell so that each cell is a contiguous range
+		std::vector<uint32_t> order(placements.size());
+		for (size_t i = 0; i < order.size(); i++)
+			order[i] = i;
+		std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return keys[a] < keys[b]; });
+
+		std::vector<PlacementInfo> sorted;
+		sorted.reserve(placements.size());
+		for (auto i : order)
+		{
+			auto key = keys[i];
+			auto it = cells.find(key);
+			if (it == cells.end())
+				cells[key] = { static_cast<uint32_t>(sorted.size()), static_cast<uint32_t>(sorted.size() + 1) };
+			else
+				it->second.End++;
+			sorted.push_back(placements[i]);
+		}
+		placements.swap(sorted);
+	}
+
+	void PlacementGrid::Run(const Query &query, std::vector<uint32_t> *results) const
+	{
+		// Find the columns the query's shape overlaps, limited to the ones that actually have placements
+		int x0, y0, x1, y1;
+		switch (query.Shape)
+		{
+		case QueryShape::Box:
+			x0 = GetCellCoordinate(query.Min.I);
+			y0 = GetCellCoordinate(query.Min.J);
+			x1 = GetCellCoordinate(query.Max.I);
+			y1 = GetCellCoordinate(query.Max.J);
+			break;
+		case QueryShape::Sphere:
+		case QueryShape::Radius:
+			x0 = GetCellCoordinate(query.Center.I - query.Radius);
+			y0 = GetCellCoordinate(query.Center.J - query.Radius);
+			x1 = GetCellCoordinate(query.Center.I + query.Radius);
+			y1 = GetCellCoordinate(query.Center.J + query.Radius);
+			break;
+		default:
+			RunRange(query, { 0, static_cast<uint32_t>(placements.size()) }, results);
+			return;
+		}
+		x0 = std::max(x0, minCellX);
+		y0 = std::max(y0, minCellY);
+		x1 = std::min(x1, maxCellX);
+		y1 = std::min(y1, maxCellY);
+		if (x0 > x1 || y0 > y1)
+			return;
+
+		// Large queries are cheaper to answer by going through the occupied cells than every cell in the range
+		auto rangeCells = static_cast<uint64_t>(x1 - x0 + 1) * static_cast<uint64_t>(y1 - y0 + 1);
+		if (rangeCells >= cells.size())
+		{
+			RunRange(query, { 0, static_cast<uint32_t>(placements.size()) }, results);
+			return;
+		}
+
+		for (auto x = x0; x <= x1; x++)
+		{
+			for (auto y = y0; y <= y1; y++)
+			{
+				auto it = cells.find(MakeCellKey(x, y));
+				if (it != cells.end())
+					RunRange(query, it->second, results);
+			}
+		}
+	}
+
+	int PlacementGrid::GetCellCoordinate(float value) const
+	{
+		auto cell = std::floor(value / cellSize);
+		if (!(cell >= MinCellCoordinate)) // Also catches NaN
+			return MinCellCoordinate;
+		if (cell > MaxCellCoordinate)
+			return MaxCellCoordinate;
+		return static_cast<int>(cell);
+	}
+
+	void PlacementGrid::RunRange(const Query &query, const CellRange &range, std::vector<uint32_t> *results) const
+	{
+		for (auto i = range.Begin; i < range.End; i++)
+		{
+			auto &placement = placements[i];
+			if (IsInShape(placement, query) && MatchesFilter(placement, query.Filter))
+				results->push_back(placement.ObjectIndex);
+		}
+	}
+}
+
+namespace
+{
+	uint32_t MakeCellKey(int x, int y)
+	{
+		return (static_cast<uint32_t>(x - MinCellCoordinate) << 16) | static_cast<uint32_t>(y - MinCellCoordinate);
+	}
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "../Blam/Math/RealVector3D.hpp"
+
+namespace Forge::SelectionQuery
+{
+	// The parts of a map variant placement which queries look at.
+	struct PlacementInfo
+	{
+		uint32_t ObjectIndex;
+		uint32_t TagIndex;
+		Blam::Math::RealVector3D Position;
+		uint8_t Team;
+		uint8_t ObjectType;
+		uint16_t EngineFlags;
+	};
+
+	enum class QueryShape
+	{
+		All,    // Every placement
+		Box,    // Axis-aligned box between Min and Max
+		Sphere, // Within Radius of Center
+		Radius, // Within Radius of Center horizontally, at any height
+	};
+
+	// Limits which placements a query returns. Fields set to -1 match anything.
+	struct QueryFilter
+	{
+		uint32_t TagIndex = 0xFFFFFFFF;
+		int Team = -1;
+		int ObjectType = -1;
+		uint16_t RequiredEngineFlags = 0; // Every one of these flags must be set
+	};
+
+	struct Query
+	{
+		QueryShape Shape = QueryShape::All;
+		Blam::Math::RealVector3D Min;
+		Blam::Math::RealVector3D Max;
+		Blam::Math::RealVector3D Center;
+		float Radius = 0;
+		QueryFilter Filter;
+	};
+
+	// Checks whether a placement passes a filter.
+	bool MatchesFilter(const PlacementInfo &placement, const QueryFilter &filter);
+
+	// Checks whether a placement is inside a query's shape, ignoring its filter.
+	bool IsInShape(const PlacementInfo &placement, const Query &query);
+
+	// Buckets placements into a grid of vertical columns so that spatial queries only look at the columns they overlap.
+	// Forge maps are spread out much more horizontally than vertically, so heights are checked per placement.
+	class PlacementGrid
+	{
+	public:
+		explicit PlacementGrid(float cellSize = 8.0f);
+
+		// Replaces the contents of the grid.
+		void Build(const std::vector<PlacementInfo> &placements);
+
+		// Appends the object index of every placement which matches a query.
+		void Run(const Query &query, std::vector<uint32_t> *results) const;
+
+		size_t GetCount() const { return placements.size(); }
+
+	private:
+		struct CellRange
+		{
+			uint32_t Begin;
+			uint32_t End;
+		};
+
+		float cellSize;
+		std::vector<PlacementInfo> placements; // Sorted by cell
+		std::unordered_map<uint32_t, CellRange> cells;
+		int minCellX, minCellY, maxCellX, maxCellY;
+
+		int GetCellCoordinate(float value) const;
+		void RunRange(const Query &query, const CellRange &range, std::vector<uint32_t> *results) const;
+	};
+}
@@ -5,9 +5,11 @@
 #include "../Forge/ForgeUtil.hpp"
 #include "../Forge/Selection.hpp"
 #include "../Forge/ObjectSet.hpp"
+#include "../Forge/SelectionItems.hpp"
 #include "../Blam/Tags/TagInstance.hpp"
 #include "../Blam/Math/MathUtil.hpp"
 #include "../Patch.hpp"
+#include "../Patches/Core.hpp"
 #include "Geoemetry.hpp"
 #include "Magnets.hpp"
 
@@ -17,24 +19,22 @@ using namespace Forge::SelectionRenderer;
 
 namespace
 {
-	struct SelectionItem
+	// Reads selected objects from the game's object array
+	class GameObjectSource : public Forge::SelectedObjectSource
 	{
-		RealMatrix4x3 Transform;
-		float Radius;
-		float Width;
-		float Depth;
-		float Height;
+	public:
+		bool FindObject(uint16_t index, Forge::SelectedObject *result) override;
+		const Forge::AABB* GetBoundingBox(uint32_t tagIndex) override;
+		void GetTransform(uint32_t objectIndex, RealMatrix4x3 *result) override;
 	};
 
-	const int MAX_ITEMS = 256;
-
 	int s_RendererType = 0;
 	bool s_Enabled = false;
-	int s_NumActiveItems;
 	float s_SelectionOpacity = 0.5f;
 	float s_SelectionColorCounter = 0.0f;
-	SelectionItem s_items[MAX_ITEMS];
+	Forge::SelectionItemList s_Items;
 
+	void MapLoadedCallback(const char *mapPath);
 	void RasterizeImplicitGeometryHook();
 	void SpecialWeaponHUDHook(int a1, uint32_t unitObjectIndex, int a3, uint32_t* objectsInCluster, int16_t objectcount, BYTE* activeSpecialChudTypes);
 }
@@ -45,38 +45,16 @@ namespace Forge
 	{
 		Hook(0x62E760, SpecialWeaponHUDHook, HookFlags::IsCall).Apply();
 		Hook(0x63B409, RasterizeImplicitGeometryHook, HookFlags::IsCall).Apply();
+
+		Patches::Core::OnMapLoaded(MapLoadedCallback);
 	}
 
 	void SelectionRenderer::Update()
 	{
 		if (s_RendererType == eRendererImplicit)
 		{
-			s_NumActiveItems = 0;
-
-			const auto& selection = Forge::Selection::GetSelection();
-			auto& objects = Blam::Objects::GetObjects();
-			for (auto it = objects.begin(); it != objects.end() && s_NumActiveItems < MAX_ITEMS; ++it)
-			{
-				if (!selection.Contains(it.CurrentDatumIndex))
-					continue;
-
-				auto& item = s_items[s_NumActiveItems++];
-
-				auto boundingBox = Forge::GetObjectBoundingBox(it->Data->TagIndex);
-				if (!boundingBox)
-					continue;
-
-				Forge::GetObjectTransformationMatrix(it.CurrentDatumIndex, &item.Transform);
-
-				item.Transform.Forward *= (boundingBox->MaxX - boundingBox->MinX) * 1.01f;
-				item.Transform.Left *= (boundingBox->MaxY - boundingBox->MinY) * 1.01f;
-				item.Transform.Up *= (boundingBox->MaxZ - boundingBox->MinZ) * 1.01f;
-				item.Transform.Position = it->Data->Center;
-
-				item.Width = boundingBox->MaxX - boundingBox->MinX;
-				item.Depth = boundingBox->MaxY - boundingBox->MinY;
-				item.Height = boundingBox->MaxZ - boundingBox->MinZ;
-			}
+			GameObjectSource source;
+			s_Items.Update(Forge::Selection::GetSelection(), source);
 
 			s_SelectionColorCounter += Blam::Time::GetSecondsPerTick() / 1.0f;
 			if (s_SelectionColorCounter > PI * 2.0f)
@@ -88,7 +66,7 @@ namespace Forge
 	{
 		s_Enabled = enabled;
 		if (!enabled)
-			s_NumActiveItems = 0;
+			s_Items.Clear();
 	}
 
 	void SelectionRenderer::SetRendererType(RendererImplementationType type)
@@ -179,9 +157,10 @@ namespace
 		auto shaderDef = Blam::Tags::TagInstance(SHADER_TAGINDEX).GetDefinition<void>();
 		sub_A3CA60(SHADER_TAGINDEX, shaderDef, 20, 0, PT_TRIANGLESTRIP, 1);
 
-		for (auto i = 0; i < s_NumActiveItems; i++)
+		auto items = s_Items.GetItems();
+		for (auto i = 0; i < s_Items.GetCount(); i++)
 		{
-			const auto& item = s_items[i];
+			const auto& item = items[i];
 
 			float m[12];
 			m[0] = item.Transform.Forward.I;
@@ -231,4 +210,38 @@ namespace
 
 		RenderImplicit();
 	}
+
+	bool GameObjectSource::FindObject(uint16_t index, Forge::SelectedObject *result)
+	{
+		auto& objects = Blam::Objects::GetObjects();
+		if (index >= objects.MaxCount)
+			return false;
+
+		auto& header = objects[Blam::DatumIndex(0, index)];
+		if (header.IsNull() || !header.Data)
+			return false;
+
+		auto object = header.Data;
+		result->ObjectIndex = Blam::DatumIndex(header.GetSalt(), index).Handle;
+		result->TagIndex = object->TagIndex;
+		result->Center = object->Center;
+		result->Forward = object->Forward;
+		result->Up = object->Up;
+		return true;
+	}
+
+	const Forge::AABB* GameObjectSource::GetBoundingBox(uint32_t tagIndex)
+	{
+		return Forge::GetObjectBoundingBox(tagIndex);
+	}
+
+	void GameObjectSource::GetTransform(uint32_t objectIndex, RealMatrix4x3 *result)
+	{
+		Forge::GetObjectTransformationMatrix(objectIndex, result);
+	}
+
+	void MapLoadedCallback(const char *mapPath)
+	{
+		s_Items.Reset();
+	}
 }
@@ -0,0 +1,106 @@
+#include "CommandBindings.hpp"
+#include <algorithm>
+#include <cctype>
+
+namespace
+{
+	std::string ToLower(std::string str);
+}
+
+namespace Modules
+{
+	CommandBindings::CommandBindings(size_t keyCount)
+		: bindings(keyCount), resolvedCommandCount(0)
+	{
+	}
+
+	void CommandBindings::Bind(size_t key, const std::string &command, const std::string &arguments, bool isHold)
+	{
+		Unbind(key);
+
+		auto binding = &bindings[key];
+		binding->isHold = isHold;
+		binding->active = false;
+		binding->command.push_back(command);
+		binding->command.push_back(arguments);
+		Resolve(binding);
+		keysByCommand[ToLower(command)].push_back(key);
+	}
+
+	void CommandBindings::Unbind(size_t key)
+	{
+		auto binding = &bindings[key];
+		if (binding->command.size() == 0)
+			return;
+
+		auto it = keysByCommand.find(ToLower(binding->command[0]));
+		if (it != keysByCommand.end())
+		{
+			auto &keys = it->second;
+			keys.erase(std::remove(keys.begin(), keys.end(), key), keys.end());
+			if (keys.empty())
+				keysByCommand.erase(it);
+		}
+		*binding = CommandBinding();
+	}
+
+	const std::vector<size_t>* CommandBindings::FindKeys(const std::string &command) const
+	{
+		auto it = keysByCommand.find(ToLower(command));
+		return (it != keysByCommand.end()) ? &it->second : nullptr;
+	}
+
+	void CommandBindings::ResolvePending()
+	{
+		auto commandCount = CommandMap::Instance().Commands.size();
+		if (commandCount == resolvedCommandCount)
+			return;
+		resolvedCommandCount = commandCount;
+
+		for (auto &&binding : bindings)
+		{
+			if (binding.command.size() > 0 && !binding.target)
+				Resolve(&binding);
+		}
+	}
+
+	bool CommandBindings::Execute(size_t key, bool down, std::string *output)
+	{
+		auto binding = &bindings[key];
+		if (!binding->target)
+		{
+			*output = "Command/Variable not found";
+			return false;
+		}
+
+		if (!binding->isHold)
+			return CommandMap::Instance().ExecuteResolvedCommand(binding->target, binding->arguments, binding->command[1], true, output);
+
+		// The command is a hold binding - append an argument depending
+		// on whether it was pressed or released
+		auto state = down ? "1" : "0";
+		auto arguments = binding->arguments;
+		arguments.push_back(state);
+		auto rawArguments = binding->command[1].empty() ? state : binding->command[1] + " " + state;
+		binding->active = down;
+		return CommandMap::Instance().ExecuteResolvedCommand(binding->target, arguments, rawArguments, true, output);
+	}
+
+	void CommandBindings::Resolve(CommandBinding *binding)
+	{
+		binding->target = CommandMap::Instance().FindCommand(binding->command[0]);
+
+		CommandLineArgs args;
+		args.Parse(binding->command[1]);
+		binding->arguments = args.ToVector();
+	}
+}
+
+namespace
+{
+	std::string ToLower(std::string str)
+	{
+		std::transform(str.begin(), str.end(), str.begin(), ::tolower);
+		return str;
+	}
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "../CommandMap.hpp"
+
+namespace Modules
+{
+	// Holds information about a command bound to a key
+	struct CommandBinding
+	{
+		std::vector<std::string> command; // The command name and its raw arguments. If this is empty, no command is bound
+		bool isHold; // True if the command binds to a boolean variable
+		bool active; // True if this is a hold command and the key is down
+
+		Command* target; // The resolved command, or null if it isn't registered (yet)
+		std::vector<std::string> arguments; // Pre-tokenized arguments
+
+		CommandBinding() : isHold(false), active(false), target(nullptr) { }
+	};
+
+	// The commands bound to each key. Bindings are resolved to a command and
+	// their arguments are tokenized when they're set, so pressing a key
+	// doesn't have to look anything up, and keys are indexed by command so
+	// finding where a command is bound doesn't have to check every key.
+	class CommandBindings
+	{
+	public:
+		explicit CommandBindings(size_t keyCount);
+
+		// Binds a command to a key, replacing its previous binding.
+		void Bind(size_t key, const std::string &command, const std::string &arguments, bool isHold);
+
+		// Removes the binding for a key.
+		void Unbind(size_t key);
+
+		const CommandBinding& Get(size_t key) const { return bindings[key]; }
+		size_t GetKeyCount() const { return bindings.size(); }
+
+		// Gets the keys a command is bound to, or null if it isn't bound. Case-insensitive.
+		const std::vector<size_t>* FindKeys(const std::string &command) const;
+
+		// Re-resolves bindings to commands which weren't registered at the
+		// time they were bound. Does nothing unless commands were added.
+		void ResolvePending();
+
+		// Runs the command bound to a key. Hold bindings get "1" or "0"
+		// appended depending on whether the key is down.
+		bool Execute(size_t key, bool down, std::string *output);
+
+	private:
+		std::vector<CommandBinding> bindings;
+		std::unordered_map<std::string, std::vector<size_t>> keysByCommand; // Lowercase command name -> keys
+		size_t resolvedCommandCount; // Number of registered commands when the bindings were last resolved
+
+		void Resolve(CommandBinding *binding);
+	};
+}
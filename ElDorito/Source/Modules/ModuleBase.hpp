@@ -1,6 +1,7 @@
 #pragma once
 
 #include "../CommandMap.hpp"
+#include "VariableHandle.hpp"
 
 namespace Modules
 {
@@ -13,6 +14,13 @@ namespace Modules
 		bool GetVariableFloat(const std::string& name, float& value);
 		bool GetVariableString(const std::string& name, std::string& value);
 
+		// Looks up a variable in this module once, for code which reads it too often to search by name each time.
+		template <typename T>
+		VariableHandle<T> GetVariableHandle(const std::string& name)
+		{
+			return VariableHandle<T>(CommandMap::Instance().FindCommand(moduleName.empty() ? name : moduleName + "." + name));
+		}
+
 	protected:
 		Command* AddCommand(const std::string& name, const std::string& shortName, const std::string& description, CommandFlags flags, CommandUpdateFunc updateEvent, std::initializer_list<std::string> arguments = {});
 		Command* AddVariableInt(const std::string& name, const std::string& shortName, const std::string& description, CommandFlags flags, unsigned long defaultValue = 0, CommandUpdateFunc updateEvent = 0);
@@ -21,8 +21,10 @@ namespace
 	// determine which camera definitions are editable based on the current camera mode
 	bool __stdcall IsCameraDefinitionEditable(CameraDefinitionType definition)
 	{
-		auto mode = Utils::String::ToLower(Modules::ModuleCamera::Instance().VarCameraMode->ValueString);
-		if (!mode.compare("first") || !mode.compare("third"))
+		// called every frame, so the mode is looked up once and compared without copying it
+		static auto modeVar = Modules::ModuleCamera::Instance().GetVariableHandle<std::string>("Mode");
+		auto mode = modeVar.Get().c_str();
+		if (!_stricmp(mode, "first") || !_stricmp(mode, "third"))
 		{
 			if (definition == CameraDefinitionType::PositionShift ||
 				definition == CameraDefinitionType::LookShift ||
@@ -31,7 +33,7 @@ namespace
 				return true;
 			}
 		}
-		else if (!mode.compare("flying") || !mode.compare("static"))
+		else if (!_stricmp(mode, "flying") || !_stricmp(mode, "static"))
 		{
 			return true;
 		}
@@ -398,16 +400,17 @@ namespace Modules
 
 	void ModuleCamera::UpdatePosition()
 	{
-		auto mode = Utils::String::ToLower(Modules::ModuleCamera::Instance().VarCameraMode->ValueString);
+		static auto mode = GetVariableHandle<std::string>("Mode");
+		static auto speed = GetVariableHandle<float>("Speed");
 
 		// only allow camera input while flying
-		if (mode.compare("flying"))
+		if (_stricmp(mode.Get().c_str(), "flying"))
 			return;
 
 		Pointer &directorGlobalsPtr = ElDorito::GetMainTls(GameGlobals::Director::TLSOffset)[0];
 		Pointer &playerControlGlobalsPtr = ElDorito::GetMainTls(GameGlobals::Input::TLSOffset)[0];
 
-		float moveDelta = Modules::ModuleCamera::Instance().VarCameraSpeed->ValueFloat;
+		float moveDelta = speed.Get();
 		float lookDelta = 0.01f;	// not used yet
 
 		// current values
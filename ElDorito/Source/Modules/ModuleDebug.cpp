@@ -2,6 +2,8 @@
 #include "../ElDorito.hpp"
 #include "../Patch.hpp"
 #include "../Utils/Logger.hpp"
+#include "../Patches/Memory.hpp"
+#include "../Patches/MemoryTelemetry.hpp"
 
 namespace
 {
@@ -82,6 +84,23 @@ namespace
 
 		return true;
 	}
+
+	bool CommandMemoryStats(const std::vector<std::string>& Arguments, std::string& returnInfo)
+	{
+		auto &profile = Patches::Memory::GetMemoryProfile();
+		auto &plan = Patches::Memory::GetMemoryMapPlan();
+
+		std::stringstream ss;
+		ss << "Cache increase: " << profile.CacheIncreaseMB << "MB, cached object render states: " << profile.CachedObjectRenderStates
+			<< ", runtime state globals expanded: " << (profile.ExpandRuntimeStateGlobals ? "yes" : "no") << std::endl;
+		ss << std::hex << std::uppercase << "Global data: 0x" << plan.GlobalDataSize << ", global cache: 0x" << plan.GlobalCacheSize
+			<< ", game state globals: 0x" << plan.GameStateGlobalsSize << ", runtime state globals: 0x" << plan.RuntimeGlobalsSize << std::dec << std::endl << std::endl;
+
+		std::string filter = Arguments.empty() ? "" : Arguments[0];
+		ss << Patches::MemoryTelemetry::FormatArenaStats(Patches::MemoryTelemetry::GetArenaStats(), filter);
+		returnInfo = ss.str();
+		return true;
+	}
 }
 
 namespace Modules
@@ -96,5 +115,7 @@ namespace Modules
 		Hook(0x7EF260, Debug_MemcpyHook).Apply();
 		Hook(0x7EF2E0, Debug_MemsetHook).Apply();
 #endif
+
+		AddCommand("MemoryStats", "memory_stats", "Lists the game's global memory arenas and how much of each is in use", eCommandFlagsNone, CommandMemoryStats, { "name(string) Only list arenas whose names contain this" });
 	}
 }
\ No newline at end of file
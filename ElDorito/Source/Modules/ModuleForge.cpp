@@ -5,10 +5,12 @@
 #include "../ThirdParty/rapidjson/writer.h"
 #include "../Forge/Selection.hpp"
 #include "../Forge/ForgeUtil.hpp"
+#include "../Blam/BlamPlayers.hpp"
 #include "../Blam/Tags/TagReference.hpp"
 #include "../Blam/Tags/TagBlock.hpp"
 #include "../Blam/Tags/TagInstance.hpp"
 #include "../Blam/Tags/Objects/Object.hpp"
+#include <algorithm>
 #include <unordered_map>
 
 namespace
@@ -249,6 +251,152 @@ namespace
 		Patches::Forge::SetPrematchCamera();
 		return true;
 	}
+
+	bool TryParseFloats(const std::vector<std::string>& Arguments, size_t start, size_t count, float* values)
+	{
+		if (start + count > Arguments.size())
+			return false;
+
+		for (auto i = 0U; i < count; i++)
+		{
+			auto c_str = Arguments[start + i].c_str();
+			char* endp;
+			values[i] = std::strtof(c_str, &endp);
+			if (endp == c_str || *endp)
+				return false;
+		}
+		return true;
+	}
+
+	// <all|box|sphere|radius> [shape arguments] [tag=<tag index>] [team=<team>] [type=<object type>]
+	// box takes two opposite corners. sphere and radius take a radius and an optional center,
+	// which is the crosshair point by default. radius ignores height.
+	bool TryParseSelectionQuery(const std::vector<std::string>& Arguments, Forge::SelectionQuery::Query* query, std::string& returnInfo)
+	{
+		using Forge::SelectionQuery::QueryShape;
+
+		if (Arguments.empty())
+		{
+			returnInfo = "expected all, box, sphere or radius";
+			return false;
+		}
+
+		size_t next = 1;
+		auto& shape = Arguments[0];
+		if (shape == "all")
+		{
+			query->Shape = QueryShape::All;
+		}
+		else if (shape == "box")
+		{
+			float corners[6];
+			if (!TryParseFloats(Arguments, next, 6, corners))
+			{
+				returnInfo = "expected box corners: x1 y1 z1 x2 y2 z2";
+				return false;
+			}
+			next += 6;
+
+			query->Shape = QueryShape::Box;
+			query->Min = Blam::Math::RealVector3D(std::min(corners[0], corners[3]), std::min(corners[1], corners[4]), std::min(corners[2], corners[5]));
+			query->Max = Blam::Math::RealVector3D(std::max(corners[0], corners[3]), std::max(corners[1], corners[4]), std::max(corners[2], corners[5]));
+		}
+		else if (shape == "sphere" || shape == "radius")
+		{
+			if (!TryParseFloats(Arguments, next, 1, &query->Radius) || query->Radius < 0)
+			{
+				returnInfo = "expected a radius";
+				return false;
+			}
+			next++;
+
+			float center[3];
+			if (TryParseFloats(Arguments, next, 3, center))
+			{
+				query->Center = Blam::Math::RealVector3D(center[0], center[1], center[2]);
+				next += 3;
+			}
+			else
+			{
+				auto playerIndex = Blam::Players::GetLocalPlayer(0);
+				if (playerIndex == Blam::DatumIndex::Null)
+				{
+					returnInfo = "expected a center: x y z";
+					return false;
+				}
+				query->Center = Forge::GetSandboxGlobals().CrosshairPoints[playerIndex.Index()];
+			}
+			query->Shape = shape == "sphere" ? QueryShape::Sphere : QueryShape::Radius;
+		}
+		else
+		{
+			returnInfo = "unknown shape " + shape;
+			return false;
+		}
+
+		for (; next < Arguments.size(); next++)
+		{
+			auto& argument = Arguments[next];
+			auto separator = argument.find('=');
+			if (separator == std::string::npos)
+			{
+				returnInfo = "unexpected argument " + argument;
+				return false;
+			}
+
+			auto key = argument.substr(0, separator);
+			auto value = argument.substr(separator + 1);
+			if (key == "tag")
+			{
+				if (!TryParseTagIndex(value, &query->Filter.TagIndex))
+				{
+					returnInfo = "invalid tag index " + value;
+					return false;
+				}
+			}
+			else if (key == "team" || key == "type")
+			{
+				auto c_str = value.c_str();
+				char* endp;
+				auto number = static_cast<int>(std::strtol(c_str, &endp, 10));
+				if (endp == c_str || *endp || number < 0 || number > 255)
+				{
+					returnInfo = "invalid " + key + " " + value;
+					return false;
+				}
+				if (key == "team")
+					query->Filter.Team = number;
+				else
+					query->Filter.ObjectType = number;
+			}
+			else
+			{
+				returnInfo = "unknown filter " + key;
+				return false;
+			}
+		}
+		return true;
+	}
+
+	bool CommandSelect(const std::vector<std::string>& Arguments, std::string& returnInfo)
+	{
+		Forge::SelectionQuery::Query query;
+		if (!TryParseSelectionQuery(Arguments, &query, returnInfo))
+			return false;
+
+		returnInfo = "selected " + std::to_string(Forge::Selection::SelectWhere(query)) + " objects";
+		return true;
+	}
+
+	bool CommandDeselect(const std::vector<std::string>& Arguments, std::string& returnInfo)
+	{
+		Forge::SelectionQuery::Query query;
+		if (!TryParseSelectionQuery(Arguments, &query, returnInfo))
+			return false;
+
+		returnInfo = "deselected " + std::to_string(Forge::Selection::DeselectWhere(query)) + " objects";
+		return true;
+	}
 }
 
 namespace Modules
@@ -280,6 +428,10 @@ namespace Modules
 		AddCommand("SelectAll", "forge_select_all", "Select all objects that are the same as the object under the crosshair", eCommandFlagsNone, CommandSelectAll);
 		AddCommand("DeselectAll", "forge_deselect_all", "Deselect all selected objects", eCommandFlagsNone, CommandDeselectAll);
 		AddCommand("DeselectAllOf", "forge_deselect_all_of", "Deselect all selected objects that are the same as the object under the crosshair", eCommandFlagsNone, CommandDeselectAllOf);
+		AddCommand("Select", "forge_select", "Select objects in a box, sphere or radius, optionally filtered by tag, team and type", eCommandFlagsNone, CommandSelect,
+			{ "shape(string) all, box x1 y1 z1 x2 y2 z2, sphere r [x y z], or radius r [x y z]", "filters(string) tag=<index> team=<team> type=<object type>" });
+		AddCommand("Deselect", "forge_deselect", "Deselect objects in a box, sphere or radius, optionally filtered by tag, team and type", eCommandFlagsNone, CommandDeselect,
+			{ "shape(string) all, box x1 y1 z1 x2 y2 z2, sphere r [x y z], or radius r [x y z]", "filters(string) tag=<index> team=<team> type=<object type>" });
 		AddCommand("SavePrefab", "forge_prefab_save", "Save prefab to a file", eCommandFlagsNone, CommandSavePrefab);
 		AddCommand("LoadPrefab", "forge_prefab_load", "Load prefab from a file", eCommandFlagsNone, CommandLoadPrefab);
 		AddCommand("DumpPrefabs", "forge_prefab_dump", "Dump a list of saved prefabs in json", eCommandFlagsNone, CommandDumpPrefabs);
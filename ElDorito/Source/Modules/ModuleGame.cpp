@@ -68,49 +68,50 @@ namespace
 
 	bool CommandGameLogTypes(const std::vector<std::string>& Arguments, std::string& returnInfo)
 	{
+		// Type names can appear anywhere in an argument, e.g. "game|network"
+		static const std::pair<std::string, Utils::LogTypes> typeNames[] =
+		{
+			{ "all", Utils::All },
+			{ "none", Utils::None },
+			{ "game", Utils::Game },
+			{ "network", Utils::Network },
+			{ "graphics", Utils::Graphics },
+			{ "memory", Utils::Memory },
+			{ "sound", Utils::Sound },
+			{ "input", Utils::Input },
+			{ "debug", Utils::Debug },
+		};
+		static const Utils::MultiPatternMatcher typeMatcher([]
+		{
+			std::vector<std::string> names;
+			for (auto &&typeName : typeNames)
+				names.push_back(typeName.first);
+			return names;
+		}());
+
 		uint32_t types = Utils::Logger::Instance().Types;
 
 		for (auto arg : Arguments)
 		{
-			if (arg.find("all") != std::string::npos)
+			uint32_t found = 0;
+			typeMatcher.ForEachMatch(arg.c_str(), [&](size_t index) { found |= 1 << index; });
+
+			if (found & 1) // all
 			{
 				types = Utils::All;
 				break;
 			}
-			else if (arg.find("none") != std::string::npos)
+			else if (found & 2) // none
 			{
 				types = Utils::None;
 				break;
 			}
-			else types = Utils::None;
 
-			if (arg.find("game") != std::string::npos)
-			{
-				types |= Utils::Game;
-			}
-			if (arg.find("network") != std::string::npos)
-			{
-				types |= Utils::Network;
-			}
-			if (arg.find("graphics") != std::string::npos)
+			types = Utils::None;
+			for (size_t i = 2; i < _countof(typeNames); i++)
 			{
-				types |= Utils::Graphics;
-			}
-			if (arg.find("memory") != std::string::npos)
-			{
-				types |= Utils::Memory;
-			}
-			if (arg.find("sound") != std::string::npos)
-			{
-				types |= Utils::Sound;
-			}
-			if (arg.find("input") != std::string::npos)
-			{
-				types |= Utils::Input;
-			}
-			if (arg.find("debug") != std::string::npos)
-			{
-				types |= Utils::Debug;
+				if (found & (1 << i))
+					types |= typeNames[i].second;
 			}
 		}
 
@@ -149,6 +150,8 @@ namespace
 				vect->push_back(str);
 				ss << "Added \"" << str << "\" to " << (exclude ? "exclude" : "include") << " filters list" << std::endl << std::endl;
 			}
+
+			Utils::Logger::Instance().SetFilters(Modules::ModuleGame::Instance().FiltersInclude, Modules::ModuleGame::Instance().FiltersExclude);
 		}
 
 		ss << "Include filters (message must contain these strings):";
@@ -1098,12 +1101,13 @@ namespace
 	{
 		// arguments are only passed to variable update funcs in case they need them for something
 		// CommandMap already updated the value of the variable so we'll just use that
-		std::string name;
-		if (!Modules::ModuleGame::Instance().GetVariableString("Name", name))
-			// we could also call Modules::CommandMap::Instance()->GetVariableString("Game.Name", name);
+		// look the variable up once instead of by name every time
+		// (Modules::CommandMap::Instance().FindCommand("Game.Name") would also work)
+		static auto name = Modules::ModuleGame::Instance().GetVariableHandle<std::string>("Name");
+		if (!name.IsValid())
 			return ""; // should never happen
 
-		return std::string("Our name is ") + name;
+		return std::string("Our name is ") + name.Get();
 	}*/
 }
 
@@ -6,6 +6,7 @@
 #include "../Console.hpp"
 #include "../Blam/BlamInput.hpp"
 #include "../Utils/NameValueTable.hpp"
+#include "CommandBindings.hpp"
 
 #include "../ThirdParty/rapidjson/writer.h"
 #include "../ThirdParty/rapidjson/stringbuffer.h"
@@ -23,16 +24,8 @@ namespace
 	// The bindings to redirect preferences.dat reads to
 	BindingsTable bindings;
 
-	// Holds information about a command bound to a key
-	struct CommandBinding
-	{
-		std::vector<std::string> command; // If this is empty, no command is bound
-		bool isHold; // True if the command binds to a boolean variable
-		bool active; // True if this is a hold command and the key is down
-	};
-
 	// Bindings for each key
-	CommandBinding commandBindings[eKeyCode_Count];
+	Modules::CommandBindings commandBindings(eKeyCode_Count);
 
 	void CopyBinding(GameAction sourceAction, GameAction destAction)
 	{
@@ -281,21 +274,16 @@ namespace
 			}
 		}
 
-		auto binding = &commandBindings[keyCode];
-
 		// If no command was specified, unset the binding
 		if (command.length() == 0)
 		{
-			binding->command.clear();
+			commandBindings.Unbind(keyCode);
 			returnInfo = "Binding cleared.";
 			return true;
 		}
 
 		// Set the binding
-		binding->isHold = isHold;
-		binding->command.clear();
-		binding->command.push_back(command);
-		binding->command.push_back(std::string(partStart, rawArguments.end()));
+		commandBindings.Bind(keyCode, command, std::string(partStart, rawArguments.end()), isHold);
 
 		returnInfo = "Binding set.";
 		return true;
@@ -303,10 +291,12 @@ namespace
 
 	void KeyboardUpdated()
 	{
+		commandBindings.ResolvePending();
+
 		for (auto i = 0; i < eKeyCode_Count; i++)
 		{
-			const auto binding = &commandBindings[i];
-			if (binding->command.size() == 0)
+			const auto &binding = commandBindings.Get(i);
+			if (binding.command.size() == 0)
 				continue; // Key is not bound
 
 			// Read the key
@@ -315,23 +305,12 @@ namespace
 
 			// We're only interested in the key if it was just pressed or if
 			// this is a hold binding and it was just released
-			if (keyTicks > 1 || (keyTicks == 0 && !(binding->isHold && binding->active)))
+			if (keyTicks > 1 || (keyTicks == 0 && !(binding.isHold && binding.active)))
 				continue;
 
-			auto command = binding->command;
-			if (binding->isHold)
-			{
-				// The command is a hold binding - append an argument depending
-				// on whether it was pressed or released
-				if (keyTicks == 1)
-					command.push_back("1");
-				else if (keyTicks == 0)
-					command.push_back("0");
-				binding->active = (keyTicks > 0);
-			}
-
-			// Execute the command and print its result
-			auto result = Modules::CommandMap::Instance().ExecuteCommand(command, true);
+			// Print the command's result
+			std::string result;
+			commandBindings.Execute(i, keyTicks > 0, &result);
 			Console::WriteLine(result);
 		}
 	}
@@ -587,24 +566,18 @@ namespace
 			returnInfo = "Not enough arguments";
 			return false;
 		}
-		std::string search_for = Arguments[0];
-		std::transform(search_for.begin(), search_for.end(), search_for.begin(), ::tolower);
 		rapidjson::StringBuffer buffer;
 		rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
 
 		writer.StartArray();
-		for (int i = 0; i < eKeyCode_Count; i++)
+		auto keys = commandBindings.FindKeys(Arguments[0]);
+		if (keys)
 		{
-			for (int k = 0; k < commandBindings[i].command.size(); k++)
+			for (auto keyCode : *keys)
 			{
-				std::string command_part = commandBindings[i].command[k];
-				std::transform(command_part.begin(), command_part.end(), command_part.begin(), ::tolower);
-				if (command_part.compare(search_for) == 0)
-				{
-					std::string key;
-					keyCodes.FindName((Blam::Input::KeyCode)i, &key);
-					writer.String(key.c_str());
-				}
+				std::string key;
+				keyCodes.FindName(static_cast<KeyCode>(keyCode), &key);
+				writer.String(key.c_str());
 			}
 		}
 		writer.EndArray();
@@ -776,7 +749,7 @@ namespace Modules
 
 		for (auto i = 0; i < eKeyCode_Count; i++)
 		{
-			const auto binding = &commandBindings[i];
+			const auto binding = &commandBindings.Get(i);
 			if (binding->command.size() == 0)
 				continue; // Key is not bound
 			std::string key_name;
@@ -797,17 +770,7 @@ namespace Modules
 	}
 	bool ModuleInput::IsCommandBound(std::string command)
 	{
-		for (int i = 0; i < eKeyCode_Count; i++)
-		{
-			const auto binding = &commandBindings[i];
-			if (binding->command.size() == 0)
-				continue; // Key is not bound
-			std::string bound_command = binding->command[0];
-			std::transform(bound_command.begin(), bound_command.end(), bound_command.begin(), ::tolower);
-			if (command.compare(bound_command) == 0)
-				return true;
-		}
-		return false;
+		return commandBindings.FindKeys(command) != nullptr;
 	}
 }
 
@@ -9,6 +9,7 @@
 #include <random>
 #include <iomanip>
 #include "../ElDorito.hpp"
+#include "../Patches/Core.hpp"
 #include "../Patches/Network.hpp"
 #include "../Patches/PlayerUid.hpp"
 
@@ -26,6 +27,8 @@
 #include "../Patches/BottomlessClip.hpp"
 #include "../Server/BanList.hpp"
 #include "../Server/ServerChat.hpp"
+#include "../Server/RateLimiter.hpp"
+#include "../Server/PlayerDirectory.hpp"
 #include "ModulePlayer.hpp"
 #include "../Server/Voting.hpp"
 #include "../Utils/Logger.hpp"
@@ -72,6 +75,19 @@ namespace
 		return true;
 	}
 
+	// Server.TempBanDuration used to be the length of a temporary ban in games.
+	// Configs which still set it are converted to Server.TempBanMinutes.
+	bool VariableTempBanDurationUpdate(const std::vector<std::string>& Arguments, std::string& returnInfo)
+	{
+		const auto minutesPerGame = 15;
+		auto &serverVars = Modules::ModuleServer::Instance();
+		auto minutes = std::to_string(serverVars.VarTempBanDuration->ValueInt * minutesPerGame);
+		std::string previousValue;
+		Modules::CommandMap::Instance().SetVariable(serverVars.VarTempBanMinutes, minutes, previousValue);
+		returnInfo = "Server.TempBanDuration is deprecated, use Server.TempBanMinutes instead. Temporary bans now last " + minutes + " minutes.";
+		return true;
+	}
+
 	// retrieves master server endpoints from dewrito.json
 	void GetEndpoints(std::vector<std::string>& destVect, std::string endpointType)
 	{
@@ -449,41 +465,35 @@ namespace
 		auto* session = Blam::Network::GetActiveSession();
 		if (!session || !session->IsEstablished() || !session->IsHost())
 			return -1;
-		auto membership = &session->MembershipInfo;
-		for (auto peerIdx = membership->FindFirstPeer(); peerIdx >= 0; peerIdx = membership->FindNextPeer(peerIdx))
-		{
-			auto playerIdx = session->MembershipInfo.GetPeerPlayer(peerIdx);
-			if (playerIdx == -1)
-				continue;
-			auto* player = &membership->PlayerSessions[playerIdx];
-			if (Utils::String::ThinString(player->Properties.DisplayName) == name) {
-				if (findPeer)
-					return peerIdx;
-				else
-					return playerIdx;
-			}
-
-		}
-		return -1;
+		auto &directory = Server::PlayerDirectory::Instance();
+		auto playerIdx = directory.FindFirstByName(name);
+		if (playerIdx < 0 || !findPeer)
+			return playerIdx;
+		return directory.Get(playerIdx)->PeerIndex;
 	}
 
 	std::vector<int> FindPlayersByUid(uint64_t uid)
 	{
-		std::vector<int> indices;
 		auto* session = Blam::Network::GetActiveSession();
 		if (!session || !session->IsEstablished() || !session->IsHost())
-			return indices;
-		auto membership = &session->MembershipInfo;
-		for (auto peerIdx = membership->FindFirstPeer(); peerIdx >= 0; peerIdx = membership->FindNextPeer(peerIdx))
-		{
-			auto playerIdx = session->MembershipInfo.GetPeerPlayer(peerIdx);
-			if (playerIdx == -1)
-				continue;
-			auto* player = &membership->PlayerSessions[playerIdx];
-			if (player->Properties.Uid == uid)
-				indices.push_back(playerIdx);
-		}
-		return indices;
+			return std::vector<int>();
+		return Server::PlayerDirectory::Instance().FindByUid(uid);
+	}
+
+	// Builds a "not found" message which suggests players with similar names
+	std::string GetPlayerNotFoundMessage(const std::string &name)
+	{
+		auto &directory = Server::PlayerDirectory::Instance();
+		auto suggestions = directory.FindByNamePrefix(name);
+		if (suggestions.empty())
+			suggestions = directory.FindByFuzzyName(name, 2);
+
+		auto message = "Player \"" + name + "\" not found.";
+		for (size_t i = 0; i < suggestions.size() && i < 3; i++)
+			message += (i == 0 ? " Did you mean \"" : ", \"") + directory.Get(suggestions[i])->Name + "\"";
+		if (!suggestions.empty())
+			message += "?";
+		return message;
 	}
 
 	void BanIp(const std::string &ip)
@@ -497,11 +507,17 @@ namespace
 		Server::TempBanList::Instance().AddIp(ip);
 	}
 
+	bool UnbanUid(uint64_t uid)
+	{
+		return Server::TempBanList::Instance().RemoveUid(uid);
+	}
+
 	bool UnbanIp(const std::string &ip)
 	{
+		auto tempBanned = Server::TempBanList::Instance().RemoveIp(ip);
 		auto banList = Server::LoadDefaultBanList();
 		if (!banList.RemoveIp(ip))
-			return false;
+			return tempBanned;
 		Server::SaveDefaultBanList(banList);
 		return true;
 	}
@@ -530,7 +546,7 @@ namespace
 		auto playerIdx = FindPlayerByName(kickPlayerName);
 		if (playerIdx < 0)
 		{
-			returnInfo = "Player \"" + kickPlayerName + "\" not found.";
+			returnInfo = GetPlayerNotFoundMessage(kickPlayerName);
 			return false;
 		}
 		auto peer = session->MembershipInfo.GetPlayerPeer(playerIdx);
@@ -601,6 +617,11 @@ namespace
 			returnInfo = "Player with UID " + Arguments[0] + " not found.";
 			return false;
 		}
+		if (type == KickType::TempBan)
+		{
+			Server::TempBanList::Instance().AddUid(uid);
+			returnInfo = "Added UID " + Arguments[0] + " to the temp ban list\n";
+		}
 		auto success = false;
 		for (auto playerIdx : indices)
 		{
@@ -619,7 +640,7 @@ namespace
 			else if (type == KickType::TempBan)
 			{
 				TempBanIP(ip);
-				returnInfo = "Added IP " + ip + " to the temp ban list\n";
+				returnInfo += "Added IP " + ip + " to the temp ban list\n";
 			}
 			returnInfo += "Issued kick request for player " + kickPlayerName + " (" + std::to_string(playerIdx) + ")\n";
 			success = true;
@@ -753,6 +774,22 @@ namespace
 			returnInfo = "Removed IP " + ip + " from the ban list";
 			return true;
 		}
+		if (banType == "uid")
+		{
+			uint64_t uid;
+			if (!Patches::PlayerUid::ParseUid(Arguments[1], &uid))
+			{
+				returnInfo = "Invalid UID";
+				return false;
+			}
+			if (!UnbanUid(uid))
+			{
+				returnInfo = "UID " + Arguments[1] + " is not temporarily banned";
+				return false;
+			}
+			returnInfo = "Removed UID " + Arguments[1] + " from the temp ban list";
+			return true;
+		}
 		returnInfo = "Unsupported ban type " + banType;
 		return false;
 	}
@@ -794,6 +831,51 @@ namespace
 		return true;
 	}
 
+	bool CommandServerFindPlayer(const std::vector<std::string>& Arguments, std::string& returnInfo)
+	{
+		if (Arguments.size() <= 0)
+		{
+			returnInfo = "Invalid arguments";
+			return false;
+		}
+		auto* session = Blam::Network::GetActiveSession();
+		if (!session || !session->IsEstablished() || !session->IsHost())
+		{
+			returnInfo = "You must be hosting a game to use this command";
+			return false;
+		}
+
+		// Try the query as a UID and an IP first, then as part of a name
+		auto query = Utils::String::Join(Arguments);
+		auto &directory = Server::PlayerDirectory::Instance();
+		std::vector<int> indices;
+		uint64_t uid;
+		if (Patches::PlayerUid::ParseUid(query, &uid))
+			indices = directory.FindByUid(uid);
+		if (indices.empty())
+			indices = directory.FindByIp(query);
+		if (indices.empty())
+			indices = directory.FindByNamePrefix(query);
+		if (indices.empty())
+			indices = directory.FindByFuzzyName(query, 2);
+		if (indices.empty())
+		{
+			returnInfo = "No players match \"" + query + "\"";
+			return false;
+		}
+
+		std::stringstream ss;
+		for (auto playerIdx : indices)
+		{
+			auto player = directory.Get(playerIdx);
+			char uidStr[17];
+			Blam::Players::FormatUid(uidStr, player->Uid);
+			ss << "[" << playerIdx << "] \"" << player->Name << "\" (uid: " << uidStr << ", ip: " << player->Ip << ")" << std::endl;
+		}
+		returnInfo = ss.str();
+		return true;
+	}
+
 	bool CommandServerListPlayersJSON(const std::vector<std::string>& Arguments, std::string& returnInfo)
 	{
 		rapidjson::StringBuffer buffer;
@@ -1091,6 +1173,32 @@ namespace
 		Patches::Assassination::Enable(enabled);
 		return true;
 	}
+	bool RateLimitsChanged(const std::vector<std::string>& Arguments, std::string& returnInfo)
+	{
+		auto &serverModule = Modules::ModuleServer::Instance();
+		auto &rateLimiter = Server::RateLimiter::Instance();
+
+		// Chat buckets refill by 1 point each second, and a timeout starts once the timeout score is reached
+		Server::RateLimit chatLimit;
+		chatLimit.Burst = std::max(serverModule.VarFloodTimeoutScore->ValueInt, 1UL) - 1;
+		chatLimit.IntervalMs = 1000;
+		chatLimit.TimeoutMs = serverModule.VarFloodTimeoutSeconds->ValueInt * 1000;
+		chatLimit.TimeoutResetMs = serverModule.VarFloodTimeoutResetSeconds->ValueInt * 1000;
+		rateLimiter.SetLimit(Server::RateLimitClass::Chat, chatLimit);
+
+		Server::RateLimit voteLimit = {};
+		voteLimit.Burst = 1;
+		voteLimit.IntervalMs = serverModule.VarVoteStartCooldown->ValueInt * 1000;
+		rateLimiter.SetLimit(Server::RateLimitClass::Vote, voteLimit);
+
+		Server::RateLimit rconLimit = {};
+		auto rconRate = serverModule.VarRconRateLimit->ValueInt;
+		rconLimit.Burst = rconRate;
+		rconLimit.IntervalMs = rconRate ? 1000 / rconRate : 0;
+		rateLimiter.SetLimit(Server::RateLimitClass::Rcon, rconLimit);
+		return true;
+	}
+
 	bool CommandServerSubmitVote(const std::vector<std::string>& Arguments, std::string& returnInfo)
 	{
 
@@ -1167,7 +1275,7 @@ namespace
 		auto peer = FindPlayerByName(playerName, true);
 		if (peer < 0)
 		{
-			returnInfo = "Player \"" + playerName + "\" not found.";
+			returnInfo = GetPlayerNotFoundMessage(playerName);
 			return false;
 		}
 		Server::Chat::SendServerMessage("(PM) " + message, peer);
@@ -1269,6 +1377,16 @@ namespace
 		returnInfo = ss.str();
 		return true;
 	}
+
+	// Gets server.json's write time as a FILETIME, or 0 if it doesn't exist.
+	// st_mtime only has a resolution of one second, which can miss the file being saved twice in a row.
+	uint64_t GetServerJsonWriteTime()
+	{
+		WIN32_FILE_ATTRIBUTE_DATA attributes;
+		if (!GetFileAttributesExW(L"mods/server/server.json", GetFileExInfoStandard, &attributes))
+			return 0;
+		return (static_cast<uint64_t>(attributes.ftLastWriteTime.dwHighDateTime) << 32) | attributes.ftLastWriteTime.dwLowDateTime;
+	}
 }
 
 namespace Modules
@@ -1319,15 +1437,16 @@ namespace Modules
 
 		AddCommand("KickUid", "ku", "Kicks players from the game by UID (host only)", eCommandFlagsHostOnly, CommandServerKickPlayerUid, { "uid The UID of the players to kick" });
 		AddCommand("KickBanUid", "kbu", "Kicks and IP bans players from the game by UID (host only)", eCommandFlagsHostOnly, CommandServerBanPlayerUid, { "uid The UID of the players to ban" });
-		AddCommand("KickTempBanUid", "ktbu", "Kicks and temporarily IP bans players from the game by UID (host only)", eCommandFlagsHostOnly, CommandServerTempBanPlayerUid, { "uid The UID of the players to ban" });
+		AddCommand("KickTempBanUid", "ktbu", "Kicks and temporarily bans players from the game by UID and IP (host only)", eCommandFlagsHostOnly, CommandServerTempBanPlayerUid, { "uid The UID of the players to ban" });
 
 		AddCommand("KickIndex", "ki", "Kicks a player from the game by index (host only)", eCommandFlagsHostOnly, CommandServerKickPlayerIndex, { "index The index of the player to kick" });
 		AddCommand("KickBanIndex", "kbi", "Kicks and IP bans a player from the game by index (host only)", eCommandFlagsHostOnly, CommandServerBanPlayerIndex, { "index The index of the player to ban" });
 
 		AddCommand("AddBan", "addban", "Adds to the ban list (does NOT kick anyone)", eCommandFlagsNone, CommandServerBan, { "type The ban type (only \"ip\" is supported for now)", "val The value to add to the ban list" });
-		AddCommand("Unban", "unban", "Removes from the ban list", eCommandFlagsNone, CommandServerUnban, { "type The ban type (only \"ip\" is supported for now)", "val The value to remove from the ban list" });
+		AddCommand("Unban", "unban", "Removes from the ban list", eCommandFlagsNone, CommandServerUnban, { "type The ban type (\"ip\", or \"uid\" for temporary bans)", "val The value to remove from the ban list" });
 
 		AddCommand("ListPlayers", "list", "Lists players in the game", eCommandFlagsNone, CommandServerListPlayers);
+		AddCommand("FindPlayer", "find", "Finds players by UID, IP, or the start of or a close match to their name (host only)", eCommandFlagsHostOnly, CommandServerFindPlayer, { "query The UID, IP or name to search for" });
 		AddCommand("ListPlayersJSON", "listjson", "Returns JSON with data about the players in the game. Intended for server browser use only.", eCommandFlagsHidden, CommandServerListPlayersJSON);
 
 		AddCommand("Ping", "ping", "Ping a server", eCommandFlagsNone, CommandServerPing, { "[ip] The IP address of the server to ping. Omit to ping the host." });
@@ -1377,14 +1496,21 @@ namespace Modules
 
 		// TODO: Fine-tune these default values
 		VarFloodFilterEnabled = AddVariableInt("FloodFilterEnabled", "floodfilter", "Controls whether chat flood filtering is enabled", eCommandFlagsArchived, 1);
-		VarFloodMessageScoreShort = AddVariableInt("FloodMessageScoreShort", "floodscoreshort", "Sets the flood filter score for short messages", eCommandFlagsArchived, 2);
-		VarFloodMessageScoreLong = AddVariableInt("FloodMessageScoreLong", "floodscorelong", "Sets the flood filter score for long messages", eCommandFlagsArchived, 5);
-		VarFloodTimeoutScore = AddVariableInt("FloodTimeoutScore", "floodscoremax", "Sets the flood filter score that triggers a timeout", eCommandFlagsArchived, 10);
-		VarFloodTimeoutSeconds = AddVariableInt("FloodTimeoutSeconds", "floodtimeout", "Sets the timeout period in seconds before a spammer can send messages again", eCommandFlagsArchived, 120);
-		VarFloodTimeoutResetSeconds = AddVariableInt("FloodTimeoutResetSeconds", "floodtimeoutreset", "Sets the period in seconds before a spammer's next timeout is reset", eCommandFlagsArchived, 1800);
+		VarFloodMessageScoreShort = AddVariableInt("FloodMessageScoreShort", "floodscoreshort", "Sets the flood filter score for short messages", eCommandFlagsArchived, 2, RateLimitsChanged);
+		VarFloodMessageScoreLong = AddVariableInt("FloodMessageScoreLong", "floodscorelong", "Sets the flood filter score for long messages", eCommandFlagsArchived, 5, RateLimitsChanged);
+		VarFloodTimeoutScore = AddVariableInt("FloodTimeoutScore", "floodscoremax", "Sets the flood filter score that triggers a timeout", eCommandFlagsArchived, 10, RateLimitsChanged);
+		VarFloodTimeoutSeconds = AddVariableInt("FloodTimeoutSeconds", "floodtimeout", "Sets the timeout period in seconds before a spammer can send messages again", eCommandFlagsArchived, 120, RateLimitsChanged);
+		VarFloodTimeoutResetSeconds = AddVariableInt("FloodTimeoutResetSeconds", "floodtimeoutreset", "Sets the period in seconds before a spammer's next timeout is reset", eCommandFlagsArchived, 1800, RateLimitsChanged);
+		VarVoteStartCooldown = AddVariableInt("VoteStartCooldown", "vote_start_cooldown", "Sets the number of seconds a player must wait before starting another chat command vote", eCommandFlagsArchived, 90, RateLimitsChanged);
 
 		VarChatLogEnabled = AddVariableInt("ChatLogEnabled", "chatlog", "Controls whether chat logging is enabled", eCommandFlagsArchived, 1);
 		VarChatLogFile = AddVariableString("ChatLogFile", "chatlogfile", "Sets the name of the file to log chat to", eCommandFlagsArchived, "chat.log");
+		VarChatLogMaxSize = AddVariableInt("ChatLogMaxSize", "chatlogmaxsize", "Sets the size in KB at which the chat log is rotated to a dated file (0 = no limit)", eCommandFlagsArchived, 10240);
+		VarChatLogMaxSize->ValueIntMin = 0;
+		VarChatLogMaxSize->ValueIntMax = 1024 * 1024;
+		VarChatLogRotateDaily = AddVariableInt("ChatLogRotateDaily", "chatlogrotatedaily", "Controls whether the chat log is rotated to a dated file when the UTC date changes", eCommandFlagsArchived, 0);
+		VarChatLogRotateDaily->ValueIntMin = 0;
+		VarChatLogRotateDaily->ValueIntMax = 1;
 
 		VarServerVotingEnabled = AddVariableInt("VotingEnabled", "voting_enabled", "Controls whether the map voting system is enabled on this server. ", static_cast<CommandFlags>(eCommandFlagsArchived | eCommandFlagsHostOnly), 0);
 		VarServerVotingEnabled->ValueIntMin = 0;
@@ -1403,6 +1529,9 @@ namespace Modules
 		VarServerNumberOfVotingOptions->ValueIntMax = 4;
 
 		VarRconPassword = AddVariableString("RconPassword", "rconpassword", "Password for the remote console", eCommandFlagsArchived, "");
+		VarRconRateLimit = AddVariableInt("RconRateLimit", "rcon_rate_limit", "Sets the maximum number of remote console commands executed per second (0 = unlimited)", eCommandFlagsArchived, 0, RateLimitsChanged);
+		VarRconRateLimit->ValueIntMin = 0;
+		VarRconRateLimit->ValueIntMax = 1000;
 		VarChatCommandKickPlayerEnabled = AddVariableInt("ChatCommandKickPlayerEnabled", "chat_command_kick_player_enabled", "Controls whether or not players can vote to kick someone. ", eCommandFlagsArchived, 1);
 		VarChatCommandKickPlayerEnabled->ValueIntMin = 0;
 		VarChatCommandKickPlayerEnabled->ValueIntMax = 1;
@@ -1423,7 +1552,11 @@ namespace Modules
 		VarServerVotePassPercentage->ValueIntMin = 0;
 		VarServerVotePassPercentage->ValueIntMax = 100;
 
-		VarTempBanDuration = AddVariableInt("TempBanDuration", "temp_ban_duration", "Duration of a temporary ban (in games)", eCommandFlagsArchived, 2);
+		VarTempBanMinutes = AddVariableInt("TempBanMinutes", "temp_ban_minutes", "Duration of a temporary ban (in minutes)", eCommandFlagsArchived, 30);
+		VarTempBanMinutes->ValueIntMin = 1;
+		VarTempBanMinutes->ValueIntMax = 10080;
+
+		VarTempBanDuration = AddVariableInt("TempBanDuration", "temp_ban_duration", "Deprecated, use Server.TempBanMinutes. Sets the duration of a temporary ban in games of 15 minutes", eCommandFlagsHidden, 2, VariableTempBanDurationUpdate);
 		VarTempBanDuration->ValueIntMin = 1;
 		VarTempBanDuration->ValueIntMax = 10;
 
@@ -1439,6 +1572,16 @@ namespace Modules
 		VarServerVotingDuplicationLevel->ValueIntMin = 0;
 		VarServerVotingDuplicationLevel->ValueIntMax = 2;
 
+		VarServerVotingRankedChoice = AddVariableInt("VotingRankedChoice", "voting_ranked_choice", "Controls whether players rank the voting options in order of preference, with the winner found by instant runoff", static_cast<CommandFlags>(eCommandFlagsArchived | eCommandFlagsHostOnly), 0);
+		VarServerVotingRankedChoice->ValueIntMin = 0;
+		VarServerVotingRankedChoice->ValueIntMax = 1;
+
+		VarServerVotingSeed = AddVariableInt("VotingSeed", "voting_seed", "Seed used to pick voting options, so that a sequence of votes can be reproduced (0 = seed from the time)", eCommandFlagsHostOnly, 0);
+
+		VarServerVotingRecentWinners = AddVariableInt("VotingRecentWinners", "voting_recent_winners", "Controls how many recent winners are kept out of new voting options when there are enough others to choose from", static_cast<CommandFlags>(eCommandFlagsArchived | eCommandFlagsHostOnly), 3);
+		VarServerVotingRecentWinners->ValueIntMin = 0;
+		VarServerVotingRecentWinners->ValueIntMax = 20;
+
 		VarServerTeamShuffleEnabled = AddVariableInt("TeamShuffleEnabled", "team_shuffle_enabled", "Controls whether the rematch feature is enabled on this server. ", static_cast<CommandFlags>(eCommandFlagsHostOnly | eCommandFlagsArchived), 1);
 		VarServerTeamShuffleEnabled->ValueIntMin = 0;
 		VarServerTeamShuffleEnabled->ValueIntMax = 1;
@@ -1490,14 +1633,19 @@ namespace Modules
 
 		PingId = Patches::Network::OnPong(PongReceived);
 		refreshNonAllowedNames();
+
+		// Checking server.json on every join would hit the disk for each player, so edits apply from the next map
+		Patches::Core::OnMapLoaded([](const char *mapPath) { Modules::ModuleServer::Instance().refreshNonAllowedNamesIfChanged(); });
 	}
 
 	void ModuleServer::refreshNonAllowedNames() {
 
-		NonAllowedNames.clear();
+		Server::NamePolicyRules rules;
 		std::ifstream in("mods/server/server.json", std::ios::in | std::ios::binary);
 		if (in && in.is_open())
 		{
+			NonAllowedNamesWriteTime = GetServerJsonWriteTime();
+
 			std::string contents;
 			in.seekg(0, std::ios::end);
 			contents.resize((unsigned int)in.tellg());
@@ -1508,19 +1656,26 @@ namespace Modules
 			rapidjson::Document json;
 			if (!json.Parse<0>(contents.c_str()).HasParseError() && json.IsObject())
 			{
-				if (json.HasMember("nonAllowedNames"))
+				auto readNames = [&json](const char *key, std::vector<std::string> *names)
 				{
-					auto& namesArray = json["nonAllowedNames"];
+					if (!json.HasMember(key) || !json[key].IsArray())
+						return;
+					auto& namesArray = json[key];
 					for (rapidjson::SizeType i = 0; i < namesArray.Size(); i++)
 					{
-						std::string name = namesArray[i].GetString();
-						std::transform(name.begin(), name.end(), name.begin(), ::tolower);
-						NonAllowedNames.insert(name);
+						if (namesArray[i].IsString())
+							names->push_back(namesArray[i].GetString());
 					}
-				}
+				};
+				readNames("nonAllowedNames", &rules.Substrings);
+				readNames("nonAllowedExactNames", &rules.ExactNames);
+				readNames("nonAllowedNamePatterns", &rules.Patterns);
 			}
+			NonAllowedNames.Compile(rules);
 		}
 		else {
+			NonAllowedNames.Compile(rules);
+
 			//need to create file
 			std::ofstream outFile("mods/server/server.json", std::ios::out | std::ios::binary);
 			if (outFile.fail())
@@ -1534,11 +1689,25 @@ namespace Modules
 			writer.Key("nonAllowedNames");
 			writer.StartArray();
 			writer.EndArray();
+			writer.Key("nonAllowedExactNames");
+			writer.StartArray();
+			writer.EndArray();
+			writer.Key("nonAllowedNamePatterns");
+			writer.StartArray();
+			writer.EndArray();
 			writer.EndObject();
 
 			outFile << s.GetString();
+			outFile.close();
 
+			NonAllowedNamesWriteTime = GetServerJsonWriteTime();
 		}
 
 	}
+
+	void ModuleServer::refreshNonAllowedNamesIfChanged() {
+		auto writeTime = GetServerJsonWriteTime();
+		if (writeTime != 0 && writeTime != NonAllowedNamesWriteTime)
+			refreshNonAllowedNames();
+	}
 }
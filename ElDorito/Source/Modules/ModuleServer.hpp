@@ -1,8 +1,8 @@
 #pragma once
 
 #include "ModuleBase.hpp"
+#include "../Server/NamePolicy.hpp"
 #include <cstdint>
-#include <unordered_set>
 
 namespace Modules
 {
@@ -38,17 +38,25 @@ namespace Modules
 		Command* VarFloodTimeoutScore;
 		Command* VarFloodTimeoutSeconds;
 		Command* VarFloodTimeoutResetSeconds;
+		Command* VarVoteStartCooldown;
 		Command* VarChatLogEnabled;
 		Command* VarChatLogFile;
+		Command* VarChatLogMaxSize;
+		Command* VarChatLogRotateDaily;
 		Command* VarServerMapVotingTime;
 		Command* VarServerVotingEnabled;
 		Command* VarServerNumberOfRevotesAllowed;
 		Command* VarServerNumberOfVotingOptions;
 		Command* VarRconPassword;
+		Command* VarRconRateLimit;
 		Command* VarServerTeamShuffleEnabled;
 		Command* VarServerTimeBetweenVoteEndAndGameStart;
 		Command* VarServerVotingDuplicationLevel;
+		Command* VarServerVotingRankedChoice;
+		Command* VarServerVotingSeed;
+		Command* VarServerVotingRecentWinners;
 		Command* VarServerVotePassPercentage;
+		Command* VarTempBanMinutes;
 		Command* VarTempBanDuration;
 		Command* VarChatCommandKickPlayerEnabled;
 		Command* VarChatCommandEndGameEnabled;
@@ -70,8 +78,11 @@ namespace Modules
 		Command* VarVotingJsonPath;
 		Command* VarVetoJsonPath;
 
-		std::unordered_set<std::string> NonAllowedNames = std::unordered_set<std::string>{};
+		Server::NamePolicy NonAllowedNames;
+		uint64_t NonAllowedNamesWriteTime = 0; // As a FILETIME
 		void refreshNonAllowedNames();
+		// Recompiles the name policy if server.json was changed since it was last loaded
+		void refreshNonAllowedNamesIfChanged();
 
 		uint8_t SyslinkData[0x176];
 
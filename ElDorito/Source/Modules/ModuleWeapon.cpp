@@ -5,8 +5,10 @@
 #include "../Blam/Cache/StringIdCache.hpp"
 #include "../Blam/Math/RealVector3D.hpp"
 #include "../Blam/Tags/Items/DefinitionWeapon.hpp"
+#include "../Definitions/FieldPath.hpp"
 #include "../ThirdParty/rapidjson/writer.h"
 #include "../ThirdParty/rapidjson/stringbuffer.h"
+#include <unordered_map>
 
 namespace
 {
@@ -17,6 +19,11 @@ namespace
 
 	auto IsMainMenu = (bool(*)())(0x531E90);
 
+	// Field paths used with Weapon.Field, compiled against the weapon definition the first time they're used
+	std::unordered_map<std::string, Definitions::FieldPath> compiledFieldPaths;
+
+	bool FindWeapon(const std::string &name, std::string *weaponName, uint16_t *weaponIndex, std::string *error);
+
 	bool CommandWeaponOffset(const std::vector<std::string>& Arguments, std::string& returnInfo)
 	{
 		if (Arguments.size() < 1) {
@@ -490,6 +497,107 @@ namespace
 		return true;
 	}
 	
+	bool CommandWeaponField(const std::vector<std::string>& Arguments, std::string& returnInfo)
+	{
+		if (Arguments.size() < 2) {
+			returnInfo = "Usage: Weapon.Field <weapon name|equipped> <field path> [values]";
+			return false;
+		}
+
+		std::string weaponName;
+		uint16_t weaponIndex;
+		if (!FindWeapon(Arguments[0], &weaponName, &weaponIndex, &returnInfo))
+			return false;
+
+		auto pathKey = Utils::String::ToLower(Arguments[1]);
+		auto it = compiledFieldPaths.find(pathKey);
+		if (it == compiledFieldPaths.end())
+		{
+			Definitions::FieldPath path;
+			if (!Definitions::FieldPath::Compile(Weapon::Definition, Arguments[1], &path, &returnInfo))
+				return false;
+			it = compiledFieldPaths.emplace(pathKey, std::move(path)).first;
+		}
+
+		auto &path = it->second;
+		auto *weapon = TagInstance(weaponIndex).GetDefinition<Weapon>();
+		if (Arguments.size() > 2)
+		{
+			std::vector<std::string> values(Arguments.begin() + 2, Arguments.end());
+			if (!Definitions::ParseFieldValue(path, weapon, values, &returnInfo))
+				return false;
+		}
+
+		std::string value;
+		if (!Definitions::FormatFieldValue(path, weapon, &value))
+		{
+			returnInfo = Arguments[1] + " is not a number or doesn't exist in " + weaponName;
+			return false;
+		}
+
+		returnInfo = "Weapon: " + weaponName + ", " + Arguments[1] + ": " + value;
+		return true;
+	}
+
+	bool CommandWeaponCopyFields(const std::vector<std::string>& Arguments, std::string& returnInfo)
+	{
+		if (Arguments.size() < 3) {
+			returnInfo = "Usage: Weapon.CopyFields <source weapon> <destination weapon> <field paths...>";
+			return false;
+		}
+
+		std::string sourceName, destName;
+		uint16_t sourceIndex, destIndex;
+		if (!FindWeapon(Arguments[0], &sourceName, &sourceIndex, &returnInfo) || !FindWeapon(Arguments[1], &destName, &destIndex, &returnInfo))
+			return false;
+
+		Definitions::FieldPathSet fields(Weapon::Definition);
+		for (size_t i = 2; i < Arguments.size(); i++)
+		{
+			if (!fields.Add(Arguments[i], &returnInfo))
+				return false;
+		}
+
+		auto *source = TagInstance(sourceIndex).GetDefinition<Weapon>();
+		auto *dest = TagInstance(destIndex).GetDefinition<Weapon>();
+
+		std::stringstream ss;
+		auto changed = fields.Diff(source, dest);
+		for (auto index : changed)
+			ss << fields.Get(index).GetPath() << std::endl;
+		auto copied = fields.Apply(source, dest);
+		ss << "Copied " << copied << " of " << fields.Count() << " fields from " << sourceName << " to " << destName << ", " << changed.size() << " changed";
+
+		returnInfo = ss.str();
+		return true;
+	}
+
+	bool FindWeapon(const std::string &name, std::string *weaponName, uint16_t *weaponIndex, std::string *error)
+	{
+		if (Utils::String::ToLower(name) == "equipped")
+		{
+			if (IsMainMenu())
+			{
+				*error = "There is no equipped weapon on the main menu";
+				return false;
+			}
+			*weaponName = Patches::Weapon::GetEquippedWeaponName();
+			*weaponIndex = Patches::Weapon::GetEquippedWeaponIndex();
+		}
+		else
+		{
+			*weaponName = name;
+			*weaponIndex = Patches::Weapon::GetIndex(*weaponName);
+		}
+
+		if (*weaponIndex == 0xFFFF)
+		{
+			*error = "Invalid weapon name";
+			return false;
+		}
+		return true;
+	}
+
 	bool CommandListWeaponsJSON(const std::vector<std::string>& arguments, std::string& returnInfo)
 	{
 		Patches::Weapon::Config::CreateList();
@@ -518,5 +626,7 @@ namespace Modules
 		AddCommand("JSON.List", "weap_json_list", "This lists all available weapon offset configs.", (CommandFlags)(eCommandFlagsOmitValueInList | eCommandFlagsHidden), CommandListWeaponsJSON);
 		AddCommand("List", "weap_list", "Lists all weapons available in the mulg tag.", eCommandFlagsNone, CommandWeaponList);
 		AddCommand("Equipped", "weap_equipped", "Gives info on the currently equipped weapon.", eCommandFlagsNone, CommandGetEquippedWeaponInfo, { "Format: null, json, csv" });
+		AddCommand("Field", "weap_field", "Gets or sets a field in a weapon's tag by its path, e.g. Barrels[0].RoundsPerSecondBounds.", eCommandFlagsCheat, CommandWeaponField, { "Weapon Name", "Field Path", "Values" });
+		AddCommand("CopyFields", "weap_copy_fields", "Copies fields from one weapon's tag to another's.", eCommandFlagsCheat, CommandWeaponCopyFields, { "Source Weapon Name", "Destination Weapon Name", "Field Paths" });
 	}
 }
\ No newline at end of file
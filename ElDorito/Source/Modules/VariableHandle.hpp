@@ -0,0 +1,77 @@
+#pragma once
+
+#include <string>
+#include "../CommandMap.hpp"
+
+namespace Modules
+{
+	template <typename T>
+	struct VariableTraits;
+
+	template <>
+	struct VariableTraits<unsigned long>
+	{
+		static const CommandType Type = eCommandTypeVariableInt;
+		static unsigned long &Value(Command &command) { return command.ValueInt; }
+	};
+
+	template <>
+	struct VariableTraits<unsigned long long>
+	{
+		static const CommandType Type = eCommandTypeVariableInt64;
+		static unsigned long long &Value(Command &command) { return command.ValueInt64; }
+	};
+
+	template <>
+	struct VariableTraits<float>
+	{
+		static const CommandType Type = eCommandTypeVariableFloat;
+		static float &Value(Command &command) { return command.ValueFloat; }
+	};
+
+	template <>
+	struct VariableTraits<std::string>
+	{
+		static const CommandType Type = eCommandTypeVariableString;
+		static std::string &Value(Command &command) { return command.ValueString; }
+	};
+
+	// A variable which has been looked up once so that its value can be accessed without searching for it by name.
+	// Commands are stored in a deque which is only ever appended to, so handles stay valid as more are added.
+	template <typename T>
+	class VariableHandle
+	{
+	public:
+		VariableHandle() : command(nullptr) { }
+
+		// The handle is invalid if the command isn't a variable of type T.
+		explicit VariableHandle(Command* command)
+			: command((command && command->Type == VariableTraits<T>::Type) ? command : nullptr) { }
+
+		bool IsValid() const { return command != nullptr; }
+		Command* GetCommand() const { return command; }
+
+		const T& Get() const { return VariableTraits<T>::Value(*command); }
+
+		// Sets the value without checking its range or running the variable's update event,
+		// the same as assigning to the Command directly.
+		void Set(const T& value)
+		{
+			VariableTraits<T>::Value(*command) = value;
+			UpdateValueString(value);
+			CommandMap::Instance().MarkChanged(command);
+		}
+
+	private:
+		Command* command;
+
+		template <typename U>
+		void UpdateValueString(const U& value) { command->ValueString = std::to_string(value); }
+		void UpdateValueString(const std::string&) { } // ValueString is the value
+	};
+
+	typedef VariableHandle<unsigned long> IntVariable;
+	typedef VariableHandle<unsigned long long> Int64Variable;
+	typedef VariableHandle<float> FloatVariable;
+	typedef VariableHandle<std::string> StringVariable;
+}
@@ -0,0 +1,250 @@
+#include "ContentItemIndex.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <fstream>
+#include <thread>
+#include <sys/stat.h>
+#include <Windows.h>
+
+#include "../ThirdParty/dirent.h"
+#include "../Utils/String.hpp"
+
+namespace
+{
+	using namespace Patches::ContentItems;
+
+	const uint32_t IndexMagic = 0x78696365; // "ecix"
+	const uint32_t IndexVersion = 2;
+
+	// A file found while scanning.
+	struct FoundFile
+	{
+		std::string Path;
+		uint64_t Size;
+		int64_t ModifiedTime;
+	};
+
+	void FindFiles(const std::string &path, std::vector<FoundFile> *result)
+	{
+		struct dirent *entry;
+		DIR *dp;
+		dp = opendir(path.c_str());
+		if (dp == NULL)
+			return;
+
+		while ((entry = readdir(dp)))
+		{
+			if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0)
+				continue;
+
+			std::string filePath = path + std::string("\\") + std::string(entry->d_name);
+
+			if (S_ISDIR(entry->d_type)) // if it's a folder, recurse through it
+			{
+				FindFiles(filePath, result);
+			}
+			else if (S_ISREG(entry->d_type))
+			{
+				// st_mtime only has a resolution of one second, which can miss a file being saved twice in a row
+				WIN32_FILE_ATTRIBUTE_DATA attributes;
+				if (!GetFileAttributesExW(Utils::String::WidenString(filePath).c_str(), GetFileExInfoStandard, &attributes))
+					continue;
+				auto size = (static_cast<uint64_t>(attributes.nFileSizeHigh) << 32) | attributes.nFileSizeLow;
+				auto writeTime = (static_cast<uint64_t>(attributes.ftLastWriteTime.dwHighDateTime) << 32) | attributes.ftLastWriteTime.dwLowDateTime;
+				result->push_back({ filePath, size, static_cast<int64_t>(writeTime) });
+			}
+		}
+
+		closedir(dp);
+	}
+
+	template<class T>
+	bool ReadValue(std::istream &stream, T *value)
+	{
+		stream.read(reinterpret_cast<char*>(value), sizeof(T));
+		return !stream.fail();
+	}
+
+	template<class T>
+	void WriteValue(std::ostream &stream, const T &value)
+	{
+		stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+	}
+}
+
+namespace Patches::ContentItems
+{
+	bool ContentItemIndex::Load(const std::string &path)
+	{
+		items.clear();
+
+		std::ifstream stream(path, std::ios::binary);
+		if (!stream)
+			return false;
+
+		uint32_t magic, version, count;
+		if (!ReadValue(stream, &magic) || magic != IndexMagic)
+			return false;
+		if (!ReadValue(stream, &version) || version != IndexVersion)
+			return false;
+		if (!ReadValue(stream, &count))
+			return false;
+
+		for (auto i = 0U; i < count; i++)
+		{
+			IndexedContentItem item;
+			uint16_t pathLength;
+			if (!ReadValue(stream, &pathLength))
+				break;
+			item.Path.resize(pathLength);
+			stream.read(&item.Path[0], pathLength);
+
+			uint8_t isContent;
+			if (!ReadValue(stream, &item.Size) || !ReadValue(stream, &item.ModifiedTime) || !ReadValue(stream, &isContent))
+				break;
+			item.IsContent = isContent != 0;
+			if (item.IsContent)
+				stream.read(reinterpret_cast<char*>(item.Header), ContentHeaderSize);
+			else
+				memset(item.Header, 0, ContentHeaderSize);
+			if (stream.fail())
+				break;
+
+			items[item.Path] = item;
+		}
+
+		// A truncated index is still usable, anything missing will just be read again
+		return true;
+	}
+
+	bool ContentItemIndex::Save(const std::string &path) const
+	{
+		std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+		if (!stream)
+			return false;
+
+		WriteValue(stream, IndexMagic);
+		WriteValue(stream, IndexVersion);
+		WriteValue(stream, static_cast<uint32_t>(items.size()));
+		for (auto &&it : items)
+		{
+			auto &item = it.second;
+			WriteValue(stream, static_cast<uint16_t>(item.Path.length()));
+			stream.write(item.Path.c_str(), item.Path.length());
+			WriteValue(stream, item.Size);
+			WriteValue(stream, item.ModifiedTime);
+			WriteValue(stream, static_cast<uint8_t>(item.IsContent ? 1 : 0));
+			if (item.IsContent)
+				stream.write(reinterpret_cast<const char*>(item.Header), ContentHeaderSize);
+		}
+		return !stream.fail();
+	}
+
+	std::vector<IndexedContentItem> ContentItemIndex::Update(const std::vector<std::string> &directories, unsigned int threadCount)
+	{
+		std::vector<FoundFile> files;
+		for (auto &&directory : directories)
+			FindFiles(directory, &files);
+
+		// Reuse index entries for files which haven't changed, and queue up the rest to be read
+		std::vector<IndexedContentItem> results(files.size());
+		std::vector<size_t> pending;
+		std::vector<char> failed(files.size()); // Files which couldn't be read, and shouldn't be cached
+		for (auto i = 0U; i < files.size(); i++)
+		{
+			auto &file = files[i];
+			auto it = items.find(file.Path);
+			if (it != items.end() && it->second.Size == file.Size && it->second.ModifiedTime == file.ModifiedTime)
+			{
+				results[i] = it->second;
+				continue;
+			}
+			results[i].Path = file.Path;
+			results[i].Size = file.Size;
+			results[i].ModifiedTime = file.ModifiedTime;
+			pending.push_back(i);
+		}
+		readCount = pending.size();
+
+		if (!pending.empty())
+		{
+			if (!threadCount)
+				threadCount = std::max(std::thread::hardware_concurrency(), 1U);
+			threadCount = std::min(threadCount, static_cast<unsigned int>(pending.size()));
+
+			// Each thread pulls the next pending file until there are none left
+			std::atomic<size_t> nextPending(0);
+			auto readPending = [&]()
+			{
+				size_t index;
+				while ((index = nextPending++) < pending.size())
+				{
+					auto &item = results[pending[index]];
+					if (!ReadContentHeader(item.Path, &item))
+						failed[pending[index]] = true;
+				}
+			};
+
+			std::vector<std::thread> threads;
+			for (auto i = 1U; i < threadCount; i++)
+				threads.push_back(std::thread(readPending));
+			readPending();
+			for (auto &&thread : threads)
+				thread.join();
+		}
+
+		// Rebuild the index so that deleted files are dropped, and files which couldn't be read are tried again next time
+		items.clear();
+		std::vector<IndexedContentItem> contentItems;
+		for (auto i = 0U; i < results.size(); i++)
+		{
+			auto &item = results[i];
+			if (!failed[i])
+				items[item.Path] = item;
+			if (item.IsContent)
+				contentItems.push_back(item);
+		}
+		return contentItems;
+	}
+
+	bool ReadContentHeader(const std::string &path, IndexedContentItem *item)
+	{
+		item->IsContent = false;
+		memset(item->Header, 0, ContentHeaderSize);
+
+		// need to convert path from ASCII to unicode now
+		auto unicodePath = Utils::String::WidenString(path);
+
+		FILE* file;
+		if (_wfopen_s(&file, unicodePath.c_str(), L"rb") != 0 || !file)
+			return false;
+
+		fseek(file, 0, SEEK_END);
+		long fileSize = ftell(file);
+		fseek(file, 0, SEEK_SET);
+		if (fileSize < 0x40)
+		{
+			// too small to be a BLF
+			fclose(file);
+			return true;
+		}
+
+		uint32_t magic;
+		fread(&magic, 4, 1, file);
+		if (magic != 0x5F626C66 && magic != 0x666C625F)
+		{
+			// not a BLF
+			fclose(file);
+			return true;
+		}
+
+		fseek(file, 0x40, SEEK_SET);
+		auto readSize = fread(item->Header, 1, ContentHeaderSize, file);
+		fclose(file);
+
+		item->IsContent = readSize == ContentHeaderSize;
+		return true;
+	}
+}
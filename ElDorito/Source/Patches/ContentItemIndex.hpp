@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Patches::ContentItems
+{
+	// The size of the content header stored in a BLF file.
+	const size_t ContentHeaderSize = 0xF8;
+
+	// A file in the content item index.
+	struct IndexedContentItem
+	{
+		// The path to the file.
+		std::string Path;
+
+		// The size of the file in bytes.
+		uint64_t Size;
+
+		// The time that the file was last modified, as a FILETIME.
+		int64_t ModifiedTime;
+
+		// True if the file is a BLF file and Header is valid.
+		bool IsContent;
+
+		// The content header read from the file.
+		uint8_t Header[ContentHeaderSize];
+	};
+
+	// Caches the content headers of the files in a set of directories, keyed
+	// by path, size and modification time, so that only new or changed
+	// files need to be read. Files which can't be read aren't cached.
+	class ContentItemIndex
+	{
+	public:
+		// Loads the index from a file. Returns false if the file is missing or invalid.
+		bool Load(const std::string &path);
+
+		// Saves the index to a file. Returns true if successful.
+		bool Save(const std::string &path) const;
+
+		// Recursively scans directories for content items and updates the
+		// index. New or changed files are read in parallel using up to
+		// threadCount threads (0 = one per hardware thread), and files which
+		// no longer exist are removed. Returns the content items found.
+		std::vector<IndexedContentItem> Update(const std::vector<std::string> &directories, unsigned int threadCount = 0);
+
+		// Gets the number of files which had to be read during the last update.
+		size_t GetReadCount() const { return readCount; }
+
+	private:
+		std::unordered_map<std::string, IndexedContentItem> items;
+		size_t readCount = 0;
+	};
+
+	// Reads the content header from a BLF file. Returns false if the file
+	// could not be read, and sets item->IsContent to false if the file isn't
+	// a BLF file.
+	bool ReadContentHeader(const std::string &path, IndexedContentItem *item);
+}
@@ -3,9 +3,9 @@
 #include "../ElDorito.hpp"
 #include "../Patch.hpp"
 #include "../Blam/BlamData.hpp"
+#include "ContentItemIndex.hpp"
 
-#include "../ThirdParty/dirent.h"
-
+#include <future>
 #include <ShlObj.h>
 
 namespace
@@ -48,6 +48,7 @@ namespace
 		long *CompletionStatus;
 	};
 
+	void StartContentScan();
 	bool IsProfileAvailable();
 	bool __fastcall c_content_item__init_hook(c_content_item *thisptr, void *unused, int contentType, c_content_catalog *catalog,
 		wchar_t *name, wchar_t *dashMetadata, int a5, int a6, int a7);
@@ -137,6 +138,12 @@ namespace Patches::ContentItems
 		Hook(0x127500, malloc, HookFlags::IsCall).Apply();
 		Hook(0x1275E0, free, HookFlags::IsCall).Apply();
 	}
+
+	void ApplyOnFirstTick()
+	{
+		// Start indexing content in the background so the first enumeration doesn't have to wait on the file system
+		StartContentScan();
+	}
 }
 
 namespace
@@ -144,37 +151,40 @@ namespace
 	uint8_t* contentItemsGlobal = 0;
 	bool enumerated = false;
 
-	bool AddContentItem(wchar_t* itemPath)
-	{
-		uint8_t fileData[0xF8];
+	// Path to the content item index, relative to the game directory
+	const char* ContentIndexPath = "mods\\content.idx";
 
-		FILE* file;
-		if (_wfopen_s(&file, itemPath, L"rb") != 0 || !file)
-			return false;
+	std::future<std::vector<Patches::ContentItems::IndexedContentItem>> contentScan;
 
-		fseek(file, 0, SEEK_END);
-		long fileSize = ftell(file);
-		fseek(file, 0, SEEK_SET);
-		if (fileSize < 0x40)
-		{
-			// too small to be a BLF
-			fclose(file);
-			return false;
-		}
+	void StartContentScan()
+	{
+		if (contentScan.valid())
+			return;
 
-		uint32_t magic;
-		fread(&magic, 4, 1, file);
-		if (magic != 0x5F626C66 && magic != 0x666C625F)
+		contentScan = std::async(std::launch::async, []()
 		{
-			// not a BLF
-			fclose(file);
-			return false;
-		}
+			// TODO: change this to use unicode instead of ASCII
 
-		fseek(file, 0x40, SEEK_SET);
-		fread(fileData, 1, 0xF8, file);
-		fclose(file);
+			char currentDir[256];
+			memset(currentDir, 0, 256);
+			GetCurrentDirectoryA(256, currentDir);
+
+			std::vector<std::string> directories =
+			{
+				std::string(currentDir) + std::string("\\mods\\variants"),
+				std::string(currentDir) + std::string("\\mods\\maps"),
+			};
+
+			Patches::ContentItems::ContentItemIndex index;
+			index.Load(ContentIndexPath);
+			auto items = index.Update(directories);
+			index.Save(ContentIndexPath);
+			return items;
+		});
+	}
 
+	void AddContentItem(const uint8_t *contentHeader)
+	{
 		const auto sub_525330 = (signed int(*)(int a1))(0x525330);
 
 		typedef int(__cdecl *GlobalsArrayPushFunc)(void* globalArrayPtr);
@@ -187,19 +197,11 @@ namespace
 		const auto content_catalog_get = (c_content_catalog *(*)(int localProfileIndex))(0x005A5600);
 
 		auto contentCatalog = content_catalog_get(0);
-		auto contentType = sub_525330(*(uint32_t*)(fileData + 0xB8));
+		auto contentType = sub_525330(*(uint32_t*)(contentHeader + 0xB8));
 		contentItem->Unknown04 = 0x11;
 		contentItem->ContentType = contentType;
 		contentItem->Catalog = contentCatalog;
-		memcpy(contentItem->ContentHeader, fileData, 0xF8);
-		return true;
-	}
-
-	bool AddContentItem(std::string itemPath)
-	{
-		// need to convert path from ASCII to unicode now
-		std::wstring unicode = Utils::String::WidenString(itemPath);
-		return AddContentItem((wchar_t*)unicode.c_str());
+		memcpy(contentItem->ContentHeader, contentHeader, 0xF8);
 	}
 
 	void GetFilePathForItem(wchar_t* dest, size_t MaxCount, wchar_t* variantName, int variantType)
@@ -225,30 +227,6 @@ namespace
 		}
 	}
 
-	void AddAllBLFContentItems(std::string path)
-	{
-		struct dirent *entry;
-		DIR *dp;
-		dp = opendir(path.c_str());
-		if (dp == NULL)
-			return;
-
-		while ((entry = readdir(dp)))
-		{
-			if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0)
-				continue;
-
-			std::string filePath = path + std::string("\\") + std::string(entry->d_name);
-
-			if (S_ISDIR(entry->d_type)) // if it's a folder, recurse through it
-				AddAllBLFContentItems(filePath);
-			else if (S_ISREG(entry->d_type)) // otherwise if it's a file try adding it as a BLF
-				AddContentItem(filePath);
-		}
-
-		closedir(dp);
-	}
-
 	char CallsXEnumerateHook()
 	{
 		if (!contentItemsGlobal)
@@ -256,17 +234,10 @@ namespace
 		if (enumerated)
 			return 1;
 
-		// TODO: change this to use unicode instead of ASCII
-
-		char currentDir[256];
-		memset(currentDir, 0, 256);
-		GetCurrentDirectoryA(256, currentDir);
-
-		std::string variantPath = std::string(currentDir) + std::string("\\mods\\variants");
-		std::string mapsPath = std::string(currentDir) + std::string("\\mods\\maps");
-
-		AddAllBLFContentItems(variantPath);
-		AddAllBLFContentItems(mapsPath);
+		// Only waits if the background scan hasn't finished yet
+		StartContentScan();
+		for (auto &&item : contentScan.get())
+			AddContentItem(item.Header);
 
 		enumerated = true;
 		return 1;
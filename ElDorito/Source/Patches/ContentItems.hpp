@@ -3,4 +3,8 @@
 namespace Patches::ContentItems
 {
 	void ApplyAll();
+
+	// Starts indexing content in the background. This can't be done from ApplyAll,
+	// which runs under the loader lock, where starting a thread can deadlock.
+	void ApplyOnFirstTick();
 }
@@ -249,8 +249,8 @@ namespace Patches::Forge
 	{
 		s_SandboxTickCommandQueue.push([=]()
 		{
-			::Forge::Prefabs::Load(path);
-			GrabSelection(Blam::Players::GetLocalPlayer(0));
+			if (::Forge::Prefabs::Load(path))
+				GrabSelection(Blam::Players::GetLocalPlayer(0));
 		});
 
 		return true;
@@ -294,6 +294,7 @@ namespace
 		Forge::Magnets::Shutdown();
 
 		Forge::Selection::Clear();
+		Forge::Selection::InvalidateQueries();
 		Forge::SelectionRenderer::SetEnabled(false);
 	}
 
@@ -596,6 +597,7 @@ namespace
 	void __fastcall SandboxEngineObjectDisposeHook(void* thisptr, void* unused, uint32_t objectIndex)
 	{
 		Forge::Selection::GetSelection().Remove(objectIndex);
+		Forge::Selection::InvalidateQueries();
 
 		static auto SandboxEngineObjectDispose = (void(__thiscall*)(void* thisptr, uint32_t objectIndex))(0x0059BC70);
 		SandboxEngineObjectDispose(thisptr, objectIndex);
@@ -677,6 +679,7 @@ namespace
 		auto playerIndex = GetPlayerHoldingObject(droppedObjectIndex);
 
 		ObjectDropped(placementIndex, throwForce, a3);
+		Forge::Selection::InvalidateQueries();
 
 		auto droppedObject = Blam::Objects::Get(droppedObjectIndex);
 		if (!droppedObject)
@@ -772,6 +775,7 @@ namespace
 		}
 
 		ObjectDelete(placementIndex, playerIndex);
+		Forge::Selection::InvalidateQueries();
 
 		Forge::GetSandboxGlobals().HeldObjectDistances[playerIndex & 0xFFFF] = *(float*)0x018A157C;
 	}
@@ -786,12 +790,14 @@ namespace
 			s_GrabOffset = RealVector3D(0, 0, 0);
 
 		ObjectSpawned(tagIndex, playerIndex, position);
+		Forge::Selection::InvalidateQueries();
 	}
 
 	void __cdecl ObjectPropertiesChangeHook(uint32_t playerIndex, uint16_t placementIndex, MapVariant::VariantProperties* properties)
 	{
 		static auto ObjectPropertiesChange = (void(__cdecl*)(uint32_t playerIndex, uint16_t placementIndex, MapVariant::VariantProperties* properties))(0x0059B5F0);
 		ObjectPropertiesChange(playerIndex, placementIndex, properties);
+		Forge::Selection::InvalidateQueries();
 
 		auto mapv = GetMapVariant();
 		auto changedObjectIndex = mapv->Placements[placementIndex].ObjectIndex;
@@ -1117,6 +1123,7 @@ namespace
 		const auto sub_59A620 = (void(__cdecl *)(int objectIndex, char a2))(0x59A620);
 
 		MapVariant_SyncObjectProperties(thisptr, properties, objectIndex);
+		Forge::Selection::InvalidateQueries();
 
 		auto object = Blam::Objects::Get(objectIndex);
 		if (!object)
@@ -1149,6 +1156,7 @@ namespace
 		auto oldZoneShape = mpProperties->Shape;
 
 		MapVariant_SyncObjectProperties(thisptr, properties, objectIndex);
+		Forge::Selection::InvalidateQueries();
 
 		if (oldZoneShape != properties->ZoneShape)
 		{
@@ -1729,6 +1737,7 @@ namespace
 	{
 		const auto MapVariant_UpdateObjectVariantProperties = (void(*)(Blam::MapVariant::VariantPlacement *a1))(0x00586680);
 		MapVariant_UpdateObjectVariantProperties(placement);
+		Forge::Selection::InvalidateQueries();
 
 		auto object = Blam::Objects::Get(placement->ObjectIndex);
 		if (!object)
@@ -1962,5 +1971,6 @@ namespace
 		const auto c_game_engine_object_runtime_manager__on_object_spawned = (void(__thiscall*)(void *thisptr, int16_t placementIndex, uint32_t objectIndex))(0x00590600);
 		if (!CanThemeObject(objectIndex)) // ignore reforge
 			c_game_engine_object_runtime_manager__on_object_spawned(thisptr, placementIndex, objectIndex);
+		Forge::Selection::InvalidateQueries();
 	}
 }
@@ -7,6 +7,7 @@
 #include "../Blam/BlamMemory.hpp"
 #include "../Utils/Logger.hpp"
 #include "Core.hpp"
+#include "MemoryTelemetry.hpp"
 
 namespace
 {
@@ -295,6 +296,7 @@ namespace
 
 		Utils::Logger::Instance().Log(Utils::LogTypes::Memory, Utils::LogLevel::Info, "AllocateGlobalStruct - Address: 0x%08X, Allocator: 0x%08X, Type: %d, Unk2: %d, Unk3: %d, Unk4: %d, Name1: %s, Name2: %s, Size: %d",
 			address, allocator, type, unk2, unk3, unk4, name1, name2, size);
+		Patches::MemoryTelemetry::RecordStruct(name1, address, size);
 
 		return unk;
 	}
@@ -322,6 +324,7 @@ namespace
 		dataArray->IsValid = false;
 		dataArray->ActiveIndices = reinterpret_cast<uint32_t*>(activeIndies);
 		dataArray->HeaderSize = data - reinterpret_cast<char*>(dataArray);
+		Patches::MemoryTelemetry::RecordArray(name, dataArray, Blam::CalculateDatumArraySize(maxCount, datumSize, alignmentBits));
 		return memset(activeIndies, 0, 4 * ((maxCount + 31) >> 5));
 	}
 
@@ -343,6 +346,7 @@ namespace
 		dataPool->Unknown56 = 0;
 		dataPool->Unknown60 = 0;
 		dataPool->Unknown63 = 0;
+		Patches::MemoryTelemetry::RecordPool(name, dataPool, size);
 
 		return size;
 	}
@@ -368,6 +372,7 @@ namespace
 		lruvCache->Unk68 = 1;
 		lruvCache->Unk52 = 0;
 		lruvCache->Allocator = allocator;
+		Patches::MemoryTelemetry::RecordCache(name, lruvCache);
 		return allocator;
 	}
 
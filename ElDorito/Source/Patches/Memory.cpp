@@ -1,161 +1,229 @@
 #include "Memory.hpp"
 #include <cstdint>
-#include "../Blam/BlamData.hpp"
+#include <fstream>
+#include <sstream>
+#include "../Utils/Logger.hpp"
+#include "../ThirdParty/rapidjson/document.h"
 
 namespace
 {
-	size_t globalCachIncrease = 100;
-}
+	using Patches::Memory::MemoryProfile;
+	using Patches::Memory::MemoryMapPlan;
 
-namespace Patches::Memory
-{
 	const uint32_t origGlobalDataSize = 0xAE00000;
 	const uint32_t origGlobalCacheSize = 0x24B00000;
+	const uint32_t origRuntimeGlobalsSize = 0x380000;
+	const uint32_t origGameStateGlobalsSize = 0x1280000;
+	const uint32_t origGameStateSubAllocation4Size = 0x2D0000;
+
+	const uint32_t MaxCacheIncreaseMB = 512;
+	const uint32_t origCachedObjectRenderStatesCount = 384;
+	const uint32_t MaxCachedObjectRenderStatesCount = 4096;
+	const uint32_t cachedObjectRenderStatesSize = 0x4D8;
 
-	// TODO: map out everything else in here so we don't have to waste previous padding space
-	int ExpandRuntimeStateGlobals()
+	// Arrays in the runtime state globals which are expanded by ExpandRuntimeStateGlobals
+	struct RuntimeArrayExpansion
 	{
-		const uint32_t origRuntimeGlobalsSize = 0x380000;
-		uint32_t extraSize = 0;
-
-		// expand xbox sound
-		uint32_t oldXboxSoundCount = 8192;
-		uint32_t newXboxSoundCount = oldXboxSoundCount * 2;
-		uint32_t xboxSoundSize = 12;
-		*reinterpret_cast<uint32_t*>(0x66009A + 1) = newXboxSoundCount;
-		extraSize += Blam::CalculateDatumArraySize(newXboxSoundCount, xboxSoundSize, 0) - 
-			Blam::CalculateDatumArraySize(oldXboxSoundCount, xboxSoundSize, 0);
-
-		// expand sound sources
-		uint32_t oldSoundSourceCount = 384;
-		uint32_t newSoundSourceCount = oldSoundSourceCount * 2;
-		uint32_t soundSourceSize = 200;
-		*reinterpret_cast<uint32_t*>(0x517AEC + 1) = newSoundSourceCount;
-		extraSize += Blam::CalculateDatumArraySize(newSoundSourceCount, soundSourceSize, 0) -
-			Blam::CalculateDatumArraySize(oldSoundSourceCount, soundSourceSize, 0);
-
-		// sound playback controllers
-		uint8_t oldSoundPlaybackControllersCount = 64;
-		uint8_t newSoundPlaybackControllersCount = 120;	// NOTE: max of 127 unless we hook it
-		uint32_t soundPlaybackControllerSize = 28;
-		*reinterpret_cast<uint8_t*>(0x669712 + 1) = newSoundPlaybackControllersCount;
-		extraSize += Blam::CalculateDatumArraySize(newSoundPlaybackControllersCount, soundPlaybackControllerSize, 0) -
-			Blam::CalculateDatumArraySize(oldSoundPlaybackControllersCount, soundPlaybackControllerSize, 0);
-
-		// expand looping sounds
-		uint32_t oldLoopingSoundCount = 128;
-		uint32_t newLoopingSoundCount = oldLoopingSoundCount * 2;
-		uint32_t loopingSoundSize = 296;
-		*reinterpret_cast<uint32_t*>(0x664745 + 1) = newLoopingSoundCount;
-		extraSize += Blam::CalculateDatumArraySize(newLoopingSoundCount, loopingSoundSize, 0) -
-			Blam::CalculateDatumArraySize(oldLoopingSoundCount, loopingSoundSize, 0);
-
-		// sounds effects
-		uint32_t oldSoundEffectsCount = 16;
-		uint32_t newSoundEffectsCount = oldSoundEffectsCount * 2;	// NOTE: max of 127 unless we hook it
-		uint32_t soundEffectsSize = 100;
-		*reinterpret_cast<uint8_t*>(0x6689B2 + 1) = newSoundEffectsCount;
-		extraSize += Blam::CalculateDatumArraySize(newSoundEffectsCount, soundEffectsSize, 0) -
-			Blam::CalculateDatumArraySize(oldSoundEffectsCount, soundEffectsSize, 0);
-
-		// sound tracker data
-		uint32_t oldSoundTrackerDataCount = 384;
-		uint32_t newSoundTrackerDataCount = oldSoundTrackerDataCount * 2;
-		uint32_t soundTrackerDataSize = 64;
-		*reinterpret_cast<uint32_t*>(0x66A312 + 1) = newSoundTrackerDataCount;
-		extraSize += Blam::CalculateDatumArraySize(newSoundTrackerDataCount, soundTrackerDataSize, 0) -
-			Blam::CalculateDatumArraySize(oldSoundTrackerDataCount, soundTrackerDataSize, 0);
+		uint32_t CountAddress;
+		uint32_t OldCount;
+		uint32_t NewCount;
+		uint32_t DatumSize;
+		bool ByteCount; // NOTE: max of 127 unless we hook it
+	};
+	const RuntimeArrayExpansion runtimeArrayExpansions[] =
+	{
+		{ 0x66009A + 1, 8192, 8192 * 2, 12, false }, // xbox sound
+		{ 0x517AEC + 1, 384, 384 * 2, 200, false }, // sound sources
+		{ 0x669712 + 1, 64, 120, 28, true }, // sound playback controllers
+		{ 0x664745 + 1, 128, 128 * 2, 296, false }, // looping sounds
+		{ 0x6689B2 + 1, 16, 16 * 2, 100, true }, // sound effects
+		{ 0x66A312 + 1, 384, 384 * 2, 64, false }, // sound tracker data
+	};
+
+	MemoryProfile profile;
+	MemoryMapPlan plan;
+
+	uint32_t DatumArrayGrowth(uint32_t oldCount, uint32_t newCount, uint32_t datumSize);
+	uint32_t Align(uint32_t size, uint32_t alignment);
+	void LoadMemoryProfile();
+	void ExpandRuntimeStateGlobals();
+	void ExpandGameStateGlobals();
+	void ExpandMainGlobalMemoryMap();
+}
 
-		// expand memory map allocation
-		uint32_t newRuntimeGlobalsSize = origRuntimeGlobalsSize + extraSize + 0xFFFF & 0xFFFF0000;
-		*reinterpret_cast<uint32_t*>(0x509F30 + 1) = newRuntimeGlobalsSize;
-		*reinterpret_cast<uint32_t*>(0x509CD6 + 1) = newRuntimeGlobalsSize;
-		*reinterpret_cast<uint32_t*>(0x509D69 + 1) = newRuntimeGlobalsSize;
-		*reinterpret_cast<uint32_t*>(0x509E62 + 1) = newRuntimeGlobalsSize;
-		*reinterpret_cast<uint32_t*>(0x509EC6 + 1) = newRuntimeGlobalsSize;
-
-		return newRuntimeGlobalsSize - origRuntimeGlobalsSize;
+namespace Patches::Memory
+{
+	MemoryProfile ParseMemoryProfile(const std::string &json, std::vector<std::string> *errors)
+	{
+		MemoryProfile result;
+
+		rapidjson::Document document;
+		if (document.Parse(json.c_str()).HasParseError() || !document.IsObject())
+		{
+			errors->push_back("The memory profile is not a valid JSON object");
+			return result;
+		}
+
+		auto cacheIncrease = document.FindMember("cacheIncreaseMB");
+		if (cacheIncrease != document.MemberEnd())
+		{
+			if (cacheIncrease->value.IsUint() && cacheIncrease->value.GetUint() <= MaxCacheIncreaseMB)
+				result.CacheIncreaseMB = cacheIncrease->value.GetUint();
+			else
+				errors->push_back("cacheIncreaseMB must be between 0 and " + std::to_string(MaxCacheIncreaseMB));
+		}
+
+		auto renderStates = document.FindMember("cachedObjectRenderStates");
+		if (renderStates != document.MemberEnd())
+		{
+			if (renderStates->value.IsUint() && renderStates->value.GetUint() >= origCachedObjectRenderStatesCount && renderStates->value.GetUint() <= MaxCachedObjectRenderStatesCount)
+				result.CachedObjectRenderStates = renderStates->value.GetUint();
+			else
+				errors->push_back("cachedObjectRenderStates must be between " + std::to_string(origCachedObjectRenderStatesCount) + " and " + std::to_string(MaxCachedObjectRenderStatesCount));
+		}
+
+		auto runtimeState = document.FindMember("expandRuntimeStateGlobals");
+		if (runtimeState != document.MemberEnd())
+		{
+			if (runtimeState->value.IsBool())
+				result.ExpandRuntimeStateGlobals = runtimeState->value.GetBool();
+			else
+				errors->push_back("expandRuntimeStateGlobals must be true or false");
+		}
+
+		return result;
 	}
 
-	int ExpandGameStateGlobals()
+	MemoryMapPlan PlanMemoryMap(const MemoryProfile &profile)
 	{
-		uint32_t subAllocation4ExtraSize = 0;
+		MemoryMapPlan result;
 
-		uint32_t oldCachedObjectRenderStatesCount = 384;
-		uint32_t newCachedObjectRenderStatesCount = 1000;
-		uint32_t cachedObjectRenderStatesSize = 0x4D8;
-		*reinterpret_cast<uint32_t*>(0xA452BC + 1) = newCachedObjectRenderStatesCount;
-		subAllocation4ExtraSize += Blam::CalculateDatumArraySize(newCachedObjectRenderStatesCount, cachedObjectRenderStatesSize, 0) -
-			Blam::CalculateDatumArraySize(oldCachedObjectRenderStatesCount, cachedObjectRenderStatesSize, 0);
+		// TODO: map out everything else in the runtime state globals so we don't have to waste previous padding space
+		uint32_t runtimeExtraSize = 0;
+		if (profile.ExpandRuntimeStateGlobals)
+		{
+			for (auto &expansion : runtimeArrayExpansions)
+				runtimeExtraSize += DatumArrayGrowth(expansion.OldCount, expansion.NewCount, expansion.DatumSize);
+		}
+		result.RuntimeGlobalsSize = Align(origRuntimeGlobalsSize + runtimeExtraSize, 0x10000);
 
 		// research by xbox7887
-		// expand unknown game state sub-allocations
-		auto extraGlobalsSize = 0;
-		uint32_t origUnknownSubAllocationSize = 0x4B000;
-		uint32_t newUnknownSubAllocationSize = origUnknownSubAllocationSize;
-		*reinterpret_cast<uint32_t*>(0x510A6D + 1) = newUnknownSubAllocationSize;
-		*reinterpret_cast<uint32_t*>(0x510A80 + 6) = newUnknownSubAllocationSize;
-		extraGlobalsSize += newUnknownSubAllocationSize - origUnknownSubAllocationSize;
-		uint32_t origUnknownSubAllocation2Size = 0x30000;
-		uint32_t newUnknownSubAllocation2Size = origUnknownSubAllocation2Size;
-		*reinterpret_cast<uint32_t*>(0x510AD5 + 1) = newUnknownSubAllocation2Size;
-		*reinterpret_cast<uint32_t*>(0x510AF1 + 2) = newUnknownSubAllocation2Size;
-		extraGlobalsSize += newUnknownSubAllocation2Size - origUnknownSubAllocation2Size;
-		uint32_t origUnknownSubAllocation3Size = 0x200000;
-		uint32_t newUnknownSubAllocation3Size = origUnknownSubAllocation3Size;
-		*reinterpret_cast<uint32_t*>(0x510AEC + 1) = newUnknownSubAllocation3Size;
-		*reinterpret_cast<uint32_t*>(0x510B09 + 2) = newUnknownSubAllocation3Size;
-		extraGlobalsSize += newUnknownSubAllocation3Size - origUnknownSubAllocation3Size;
-		uint32_t origUnknownSubAllocation4Size = 0x2D0000;
-		uint32_t newUnknownSubAllocation4Size = origUnknownSubAllocation4Size + (subAllocation4ExtraSize + 0xFFFF & 0xFFFF0000);
-		*reinterpret_cast<uint32_t*>(0x510B04 + 1) = newUnknownSubAllocation4Size;
-		*reinterpret_cast<uint32_t*>(0x510B21 + 2) = newUnknownSubAllocation4Size;
-		extraGlobalsSize += newUnknownSubAllocation4Size - origUnknownSubAllocation4Size;
-		uint32_t origUnknownSubAllocation5Size = 0x480000;
-		uint32_t newUnknownSubAllocation5Size = origUnknownSubAllocation5Size;
-		*reinterpret_cast<uint32_t*>(0x510B1C + 1) = newUnknownSubAllocation5Size;
-		*reinterpret_cast<uint32_t*>(0x510B34 + 1) = newUnknownSubAllocation5Size;
-		*reinterpret_cast<uint32_t*>(0x510B39 + 2) = newUnknownSubAllocation5Size;
-		*reinterpret_cast<uint32_t*>(0x510B4C + 1) = newUnknownSubAllocation5Size;
-		*reinterpret_cast<uint32_t*>(0x510B51 + 2) = newUnknownSubAllocation5Size;
-		extraGlobalsSize += newUnknownSubAllocation5Size - origUnknownSubAllocation5Size;
+		// the other game state sub-allocations are left at their original sizes
+		auto subAllocation4ExtraSize = DatumArrayGrowth(origCachedObjectRenderStatesCount, profile.CachedObjectRenderStates, cachedObjectRenderStatesSize);
+		result.GameStateSubAllocation4Size = origGameStateSubAllocation4Size + Align(subAllocation4ExtraSize, 0x10000);
+		auto gameStateExtraSize = result.GameStateSubAllocation4Size - origGameStateSubAllocation4Size;
+		result.GameStateGlobalsSize = Align(origGameStateGlobalsSize + gameStateExtraSize, 0x10000);
 
-		// expand game state globals
-		// TODO: .text:00510A15                 push    980000h
-		const uint32_t origGameStateGlobalsSize = 0x1280000;
-		const uint32_t newGameStateGlobalsSize = origGameStateGlobalsSize + extraGlobalsSize + 0xFFFF & 0xFFFF0000;
-		*reinterpret_cast<uint32_t*>(0x50FDC6 + 1) = newGameStateGlobalsSize;
-		*reinterpret_cast<uint32_t*>(0x510336 + 1) = newGameStateGlobalsSize;
-		*reinterpret_cast<uint32_t*>(0x510A1A + 1) = newGameStateGlobalsSize;
-		*reinterpret_cast<uint32_t*>(0x510A2A + 2) = newGameStateGlobalsSize;
-
-		return newGameStateGlobalsSize - origGameStateGlobalsSize;
-	}
-
-	void ExpandMainGlobalMemoryMap()
-	{
-		size_t dataSizeIncrease = 0;
-		size_t cacheSizeIncrease = 1024 * 1024 * globalCachIncrease;
-		dataSizeIncrease += ExpandGameStateGlobals();
-		//dataSizeIncrease += ExpandRuntimeStateGlobals();
 		// TODO: other allocations
-
-		size_t newDataSize = origGlobalDataSize + dataSizeIncrease + 0xFFFFF & 0xFFF00000;
-		size_t newCacheSize = origGlobalCacheSize + cacheSizeIncrease + 0xFFFFF & 0xFFF00000;
-		*reinterpret_cast<uint32_t*>(0x51D6AF + 2) = newDataSize;
-		*reinterpret_cast<uint32_t*>(0x51DB64 + 3) = newCacheSize;
-		*reinterpret_cast<uint32_t*>(0x51D699 + 1) = newDataSize + newCacheSize;
+		auto dataSizeIncrease = result.GameStateGlobalsSize - origGameStateGlobalsSize;
+		if (profile.ExpandRuntimeStateGlobals)
+			dataSizeIncrease += result.RuntimeGlobalsSize - origRuntimeGlobalsSize;
+		result.GlobalDataSize = Align(origGlobalDataSize + dataSizeIncrease, 0x100000);
+		result.GlobalCacheSize = Align(origGlobalCacheSize + profile.CacheIncreaseMB * 1024 * 1024, 0x100000);
+		return result;
 	}
 
 	void SetGlobalCacheIncrease(size_t size)
 	{
 		// TODO: more mapping and testing is required before this is ready for prime time
-		globalCachIncrease = size;
+		if (size > MaxCacheIncreaseMB)
+		{
+			Utils::Logger::Instance().Log(Utils::LogTypes::Memory, Utils::LogLevel::Warning, "Cache memory increase of %uMB is too large, using %uMB", size, MaxCacheIncreaseMB);
+			size = MaxCacheIncreaseMB;
+		}
+		profile.CacheIncreaseMB = size;
 		ExpandMainGlobalMemoryMap();
 	}
 
 	void ApplyAll()
 	{
+		LoadMemoryProfile();
+		ExpandGameStateGlobals();
+		if (profile.ExpandRuntimeStateGlobals)
+			ExpandRuntimeStateGlobals();
 		ExpandMainGlobalMemoryMap();
 	}
-}
\ No newline at end of file
+
+	const MemoryProfile &GetMemoryProfile()
+	{
+		return profile;
+	}
+
+	const MemoryMapPlan &GetMemoryMapPlan()
+	{
+		return plan;
+	}
+}
+
+namespace
+{
+	uint32_t DatumArrayGrowth(uint32_t oldCount, uint32_t newCount, uint32_t datumSize)
+	{
+		// The array header doesn't depend on the count, so only the data and the active index bits grow
+		auto ArraySize = [=](uint32_t count) { return count * datumSize + 4 * ((count + 31) >> 5); };
+		return newCount > oldCount ? ArraySize(newCount) - ArraySize(oldCount) : 0;
+	}
+
+	uint32_t Align(uint32_t size, uint32_t alignment)
+	{
+		return (size + alignment - 1) & ~(alignment - 1);
+	}
+
+	void LoadMemoryProfile()
+	{
+		std::ifstream file(Patches::Memory::DefaultMemoryProfilePath, std::ios::in | std::ios::binary);
+		if (file)
+		{
+			std::stringstream json;
+			json << file.rdbuf();
+
+			std::vector<std::string> errors;
+			profile = Patches::Memory::ParseMemoryProfile(json.str(), &errors);
+			for (auto &error : errors)
+				Utils::Logger::Instance().Log(Utils::LogTypes::Memory, Utils::LogLevel::Warning, "%s: %s", Patches::Memory::DefaultMemoryProfilePath.c_str(), error.c_str());
+		}
+		plan = Patches::Memory::PlanMemoryMap(profile);
+	}
+
+	void ExpandRuntimeStateGlobals()
+	{
+		for (auto &expansion : runtimeArrayExpansions)
+		{
+			if (expansion.ByteCount)
+				*reinterpret_cast<uint8_t*>(expansion.CountAddress) = static_cast<uint8_t>(expansion.NewCount);
+			else
+				*reinterpret_cast<uint32_t*>(expansion.CountAddress) = expansion.NewCount;
+		}
+
+		// expand memory map allocation
+		*reinterpret_cast<uint32_t*>(0x509F30 + 1) = plan.RuntimeGlobalsSize;
+		*reinterpret_cast<uint32_t*>(0x509CD6 + 1) = plan.RuntimeGlobalsSize;
+		*reinterpret_cast<uint32_t*>(0x509D69 + 1) = plan.RuntimeGlobalsSize;
+		*reinterpret_cast<uint32_t*>(0x509E62 + 1) = plan.RuntimeGlobalsSize;
+		*reinterpret_cast<uint32_t*>(0x509EC6 + 1) = plan.RuntimeGlobalsSize;
+	}
+
+	void ExpandGameStateGlobals()
+	{
+		*reinterpret_cast<uint32_t*>(0xA452BC + 1) = profile.CachedObjectRenderStates;
+
+		// expand unknown game state sub-allocations
+		*reinterpret_cast<uint32_t*>(0x510B04 + 1) = plan.GameStateSubAllocation4Size;
+		*reinterpret_cast<uint32_t*>(0x510B21 + 2) = plan.GameStateSubAllocation4Size;
+
+		// expand game state globals
+		// TODO: .text:00510A15                 push    980000h
+		*reinterpret_cast<uint32_t*>(0x50FDC6 + 1) = plan.GameStateGlobalsSize;
+		*reinterpret_cast<uint32_t*>(0x510336 + 1) = plan.GameStateGlobalsSize;
+		*reinterpret_cast<uint32_t*>(0x510A1A + 1) = plan.GameStateGlobalsSize;
+		*reinterpret_cast<uint32_t*>(0x510A2A + 2) = plan.GameStateGlobalsSize;
+	}
+
+	void ExpandMainGlobalMemoryMap()
+	{
+		plan = Patches::Memory::PlanMemoryMap(profile);
+		*reinterpret_cast<uint32_t*>(0x51D6AF + 2) = plan.GlobalDataSize;
+		*reinterpret_cast<uint32_t*>(0x51DB64 + 3) = plan.GlobalCacheSize;
+		*reinterpret_cast<uint32_t*>(0x51D699 + 1) = plan.GlobalDataSize + plan.GlobalCacheSize;
+	}
+}
@@ -1,7 +1,41 @@
 #pragma once
 
+#include <cstdint>
+#include <string>
+#include <vector>
+
 namespace Patches::Memory
 {
+	// Settings for how much the game's global memory map is expanded, loaded from mods/memory.json.
+	struct MemoryProfile
+	{
+		uint32_t CacheIncreaseMB = 100;             // Extra space for the tag cache
+		uint32_t CachedObjectRenderStates = 1000;   // Originally 384
+		bool ExpandRuntimeStateGlobals = false;     // Experimental, doubles most of the sound arrays
+	};
+
+	// Sizes in the global memory map after expansion.
+	struct MemoryMapPlan
+	{
+		uint32_t RuntimeGlobalsSize;
+		uint32_t GameStateSubAllocation4Size;
+		uint32_t GameStateGlobalsSize;
+		uint32_t GlobalDataSize;
+		uint32_t GlobalCacheSize;
+	};
+
+	const std::string DefaultMemoryProfilePath = "mods/memory.json";
+
+	// Loads a memory profile from JSON. Missing values keep their defaults, and invalid values are replaced
+	// with their defaults and described in errors.
+	MemoryProfile ParseMemoryProfile(const std::string &json, std::vector<std::string> *errors);
+
+	// Works out the memory map sizes for a profile without changing anything.
+	MemoryMapPlan PlanMemoryMap(const MemoryProfile &profile);
+
 	void ApplyAll();
 	void SetGlobalCacheIncrease(size_t size);
+
+	const MemoryProfile &GetMemoryProfile();
+	const MemoryMapPlan &GetMemoryMapPlan();
 }
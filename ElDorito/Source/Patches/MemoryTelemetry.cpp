@@ -0,0 +1,206 @@
+#include "MemoryTelemetry.hpp"
+
+#include <iomanip>
+#include <mutex>
+#include <sstream>
+#include <Windows.h>
+
+#include "../Blam/BlamData.hpp"
+
+namespace
+{
+	using namespace Patches::MemoryTelemetry;
+
+	const DWORD SampleIntervalMs = 1000;
+
+	ArenaTracker tracker;
+	std::mutex trackerMutex;
+	DWORD lastSampleTime = 0;
+
+	void Record(ArenaType type, const char *name, void *address, uint32_t reserved);
+	uint32_t ReadUsage(const ArenaStats &arena, bool *valid);
+}
+
+namespace Patches::MemoryTelemetry
+{
+	void ArenaTracker::RecordInit(ArenaType type, const std::string &name, uintptr_t address, uint32_t reserved)
+	{
+		auto it = arenasByAddress.find(address);
+		if (it == arenasByAddress.end())
+		{
+			arenasByAddress[address] = arenas.size();
+			arenas.push_back({ name, type, address, reserved, 0, 0, 1 });
+			return;
+		}
+
+		auto &arena = arenas[it->second];
+		if (arena.Type == type && arena.Name == name)
+		{
+			arena.InitCount++;
+		}
+		else
+		{
+			arena.Name = name;
+			arena.Type = type;
+			arena.PeakUsed = 0;
+			arena.InitCount = 1;
+		}
+		arena.Reserved = reserved;
+		arena.Used = 0;
+	}
+
+	bool ArenaTracker::RecordUsage(uintptr_t address, uint32_t used)
+	{
+		auto it = arenasByAddress.find(address);
+		if (it == arenasByAddress.end())
+			return false;
+
+		auto &arena = arenas[it->second];
+		arena.Used = used;
+		if (used > arena.PeakUsed)
+			arena.PeakUsed = used;
+		return true;
+	}
+
+	uint64_t ArenaTracker::GetTotalReserved(ArenaType type) const
+	{
+		uint64_t total = 0;
+		for (auto &arena : arenas)
+		{
+			if (arena.Type == type)
+				total += arena.Reserved;
+		}
+		return total;
+	}
+
+	void ArenaTracker::Clear()
+	{
+		arenas.clear();
+		arenasByAddress.clear();
+	}
+
+	const char* GetArenaTypeName(ArenaType type)
+	{
+		switch (type)
+		{
+		case ArenaType::Array:
+			return "array";
+		case ArenaType::Pool:
+			return "pool";
+		case ArenaType::Cache:
+			return "cache";
+		case ArenaType::Struct:
+			return "struct";
+		}
+		return "unknown";
+	}
+
+	std::string FormatArenaStats(const std::vector<ArenaStats> &arenas, const std::string &filter)
+	{
+		std::stringstream ss;
+		ss << std::left << std::setw(32) << "Name" << std::setw(8) << "Type" << std::right
+			<< std::setw(12) << "Reserved" << std::setw(12) << "Used" << std::setw(12) << "Peak" << std::setw(7) << "Inits" << std::endl;
+
+		uint64_t totalReserved = 0, totalUsed = 0;
+		for (auto &arena : arenas)
+		{
+			if (!filter.empty() && arena.Name.find(filter) == std::string::npos)
+				continue;
+
+			ss << std::left << std::setw(32) << arena.Name << std::setw(8) << GetArenaTypeName(arena.Type) << std::right
+				<< std::setw(12) << arena.Reserved << std::setw(12) << arena.Used << std::setw(12) << arena.PeakUsed << std::setw(7) << arena.InitCount << std::endl;
+			totalReserved += arena.Reserved;
+			totalUsed += arena.Used;
+		}
+
+		ss << std::left << std::setw(40) << "Total" << std::right << std::setw(12) << totalReserved << std::setw(12) << totalUsed;
+		return ss.str();
+	}
+
+	void RecordArray(const char *name, void *address, int size)
+	{
+		Record(ArenaType::Array, name, address, static_cast<uint32_t>(size));
+	}
+
+	void RecordPool(const char *name, void *address, int size)
+	{
+		Record(ArenaType::Pool, name, address, static_cast<uint32_t>(size));
+	}
+
+	void RecordCache(const char *name, void *address)
+	{
+		// The cache's storage is allocated separately and its layout is mostly unknown, so only the header is counted
+		Record(ArenaType::Cache, name, address, sizeof(Blam::LruvCacheBase));
+	}
+
+	void RecordStruct(const char *name, void *address, int size)
+	{
+		Record(ArenaType::Struct, name, address, static_cast<uint32_t>(size));
+
+		// Structs are always fully used
+		std::lock_guard<std::mutex> lock(trackerMutex);
+		tracker.RecordUsage(reinterpret_cast<uintptr_t>(address), static_cast<uint32_t>(size));
+	}
+
+	void Sample()
+	{
+		std::lock_guard<std::mutex> lock(trackerMutex);
+		for (auto &arena : tracker.GetArenas())
+		{
+			auto valid = false;
+			auto used = ReadUsage(arena, &valid);
+			if (valid)
+				tracker.RecordUsage(arena.Address, used);
+		}
+	}
+
+	void Tick()
+	{
+		auto now = GetTickCount();
+		if (now - lastSampleTime < SampleIntervalMs)
+			return;
+
+		Sample();
+		lastSampleTime = now;
+	}
+
+	std::vector<ArenaStats> GetArenaStats()
+	{
+		Sample();
+
+		std::lock_guard<std::mutex> lock(trackerMutex);
+		return tracker.GetArenas();
+	}
+}
+
+namespace
+{
+	void Record(ArenaType type, const char *name, void *address, uint32_t reserved)
+	{
+		std::lock_guard<std::mutex> lock(trackerMutex);
+		tracker.RecordInit(type, name ? name : "", reinterpret_cast<uintptr_t>(address), reserved);
+	}
+
+	uint32_t ReadUsage(const ArenaStats &arena, bool *valid)
+	{
+		// Only read from arenas whose headers still look intact, in case the memory has been reused
+		switch (arena.Type)
+		{
+		case ArenaType::Array:
+		{
+			auto dataArray = reinterpret_cast<const Blam::DataArrayBase*>(arena.Address);
+			*valid = dataArray->Signature == 'd@t@' && dataArray->ActualCount >= 0 && dataArray->ActualCount <= dataArray->MaxCount;
+			return *valid ? static_cast<uint32_t>(dataArray->ActualCount * dataArray->DatumSize) : 0;
+		}
+		case ArenaType::Pool:
+		{
+			auto dataPool = reinterpret_cast<const Blam::DataPoolBase*>(arena.Address);
+			*valid = dataPool->Signature == 'pool' && dataPool->FreeSize >= 0 && dataPool->FreeSize <= dataPool->Size;
+			return *valid ? static_cast<uint32_t>(dataPool->Size - dataPool->FreeSize) : 0;
+		}
+		default:
+			*valid = false;
+			return 0;
+		}
+	}
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Patches::MemoryTelemetry
+{
+	enum class ArenaType
+	{
+		Array,
+		Pool,
+		Cache,
+		Struct,
+	};
+
+	struct ArenaStats
+	{
+		std::string Name;
+		ArenaType Type;
+		uintptr_t Address;
+		uint32_t Reserved;  // Bytes set aside for the arena
+		uint32_t Used;      // Bytes in use as of the last sample
+		uint32_t PeakUsed;  // Most bytes ever seen in use
+		uint32_t InitCount; // Number of times the arena has been initialized
+	};
+
+	// Aggregates arena allocation and usage events into per-arena stats.
+	// This doesn't touch game memory, so a recorded allocation trace can be replayed into it.
+	class ArenaTracker
+	{
+	public:
+		// Records an arena being initialized. Re-initializing an arena at the same address with the same name
+		// keeps its peak usage, otherwise the arena at that address is replaced.
+		void RecordInit(ArenaType type, const std::string &name, uintptr_t address, uint32_t reserved);
+
+		// Records how many bytes an arena is using. Returns false if there is no arena at the address.
+		bool RecordUsage(uintptr_t address, uint32_t used);
+
+		// Gets the stats for every arena, in the order they were first initialized.
+		const std::vector<ArenaStats> &GetArenas() const { return arenas; }
+
+		// Gets the total number of bytes reserved for arenas of a type.
+		uint64_t GetTotalReserved(ArenaType type) const;
+
+		void Clear();
+
+	private:
+		std::vector<ArenaStats> arenas;
+		std::unordered_map<uintptr_t, size_t> arenasByAddress;
+	};
+
+	// Gets a short name for an arena type, e.g. "array".
+	const char* GetArenaTypeName(ArenaType type);
+
+	// Formats a table of arena stats. Only arenas whose names contain filter are listed.
+	std::string FormatArenaStats(const std::vector<ArenaStats> &arenas, const std::string &filter);
+
+	// Called by the global data hooks in Logging.cpp.
+	void RecordArray(const char *name, void *address, int size);
+	void RecordPool(const char *name, void *address, int size);
+	void RecordCache(const char *name, void *address);
+	void RecordStruct(const char *name, void *address, int size);
+
+	// Reads the current usage of every array and pool from game memory.
+	void Sample();
+
+	// Samples usage about once a second.
+	void Tick();
+
+	// Samples usage and returns a copy of every arena's stats.
+	std::vector<ArenaStats> GetArenaStats();
+}
@@ -705,13 +705,9 @@ namespace
 		RegisterPacketPtr RegisterPacket = reinterpret_cast<RegisterPacketPtr>(0x4801B0);
 		RegisterPacket(thisPtr, packetId, packetName, arg8, newSize, newSize, serializeFunc, deserializeFunc, arg1C, arg20);
 	}
-	bool IsNameNotAllowed(std::string name)
+	bool IsNameNotAllowed(const wchar_t *name)
 	{
-		for (std::string s : Modules::ModuleServer::Instance().NonAllowedNames) {
-			if (name.find(s) != std::string::npos)
-				return true;
-		}
-		return false;
+		return Modules::ModuleServer::Instance().NonAllowedNames.IsBlocked(name);
 	}
 	void SanitizePlayerName(wchar_t *name)
 	{
@@ -741,12 +737,8 @@ namespace
 		memset(&name[dest], 0, (16 - dest) * sizeof(wchar_t));
 		if (dest == 0)
 			wcscpy_s(name, 16, L"Forgot");
-		else {
-			std::string lowercasename = Utils::String::ThinString(name);
-			std::transform(lowercasename.begin(), lowercasename.end(), lowercasename.begin(), ::tolower);
-			if (IsNameNotAllowed(lowercasename))
-				wcscpy_s(name, 16, L"Filtered");
-		}
+		else if (IsNameNotAllowed(name))
+			wcscpy_s(name, 16, L"Filtered");
 			
 		
 	}
@@ -842,6 +834,13 @@ namespace
 		// Apply the extended properties
 		Patches::Network::PlayerPropertiesExtender::Instance().ApplyData(playerIndex, properties, data + PlayerPropertiesSize);
 
+		// The UID isn't known when the join request is checked against the ban list, so temporary UID bans are checked here
+		if (isNewMember && session->IsHost() && !thisPtr->Peers[thisPtr->HostPeerIndex].OwnsPlayer(playerIndex) &&
+			Server::TempBanList::Instance().ContainsUid(properties->Uid))
+		{
+			Utils::Logger::Instance().Log(Utils::LogTypes::Network, Utils::LogLevel::Info, "Kicking temporarily banned UID %016llx", properties->Uid);
+			Blam::Network::BootPlayer(playerIndex, 4);
+		}
 	}
 
 	bool __fastcall Network_leader_request_boot_machineHook(void* thisPtr, void* unused, Blam::Network::PeerInfo* peer, int reason)
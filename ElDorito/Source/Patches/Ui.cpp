@@ -1,4 +1,5 @@
 #include "Ui.hpp"
+#include "UiTagData.hpp"
 
 #include "../ElDorito.hpp"
 #include "../Patch.hpp"
@@ -97,12 +98,6 @@ namespace
 	int GetBrokenChudStateFlags33Values();
 	void MenuSelectedMapIDChangedHook();
 
-	void FindUiTagIndices();
-	void FindVoiceChatSpeakingPlayerTagData();
-	void FindHUDDistortionTagData();
-	void FindHUDResolutionTagData();
-	void FindMapImages();
-
 	void ToggleHUDDistortion(bool enabled);
 
 	void c_gui_screen_pregame_lobby_switch_network_hook();
@@ -114,53 +109,18 @@ namespace
 	static auto IsMapLoading = (bool(*)())(0x005670E0);
 	static auto IsMainMenu = (bool(*)())(0x00531E90);
 
-	uint32_t hudMessagesUnicIndex;
-	uint32_t spartanChdtIndex;
-	//uint32_t eliteChdtIndex; //Uncomment as needed.
-	//uint32_t monitorChdtIndex;
-	uint32_t scoreboardChdtIndex;
-	uint32_t chgdIndex;
-	uint32_t pttLsndIndex;
-
-	bool tagsInitiallyLoaded = false;
-	const std::string SPEAKING_PLAYER_STRING_NAME = "speaking_player";
-	int32_t speakingPlayerStringID;
-
 	int localDesiredTeam = -1;
 	int teamChangeTicks = 0;
 
-	bool foundMapImages = false;
-	int multiplayerPlaceholderIndex;
-	std::unordered_map<int, int> mapImages = std::unordered_map<int, int>();
-
-	int HUDResolutionWidth = 0;
-	int HUDResolutionHeight = 0;
-	float HUDResolutionScaleX = 0;
-	float HUDResolutionScaleY = 0;
-	float HUDMotionSensorOffsetX = 0;
-	float HUDBottomVisorOffsetY = 0;
-
-	bool firstHUDDistortionUpdate = true;
-	bool validHUDDistortionTags = false;
 	bool lastDistortionEnabledValue = true;
-	//Distortion direction for spartan, monitor, elite.
-	//If more are added, this needs to be increased or stored differently.
-	float hudDistortionDirection[3]{ 0,0,0 };
-
-	bool speakingPlayerStringFound = false;
-	uint32_t speakingPlayerOffset; //The offset of speaker_name in memory.
 }
 
 namespace Patches::Ui
 {
 	void ApplyAfterTagsLoaded()
 	{
-		if (!tagsInitiallyLoaded)
-		{
-			FindUiTagData();
-		}
-
-		tagsInitiallyLoaded = true;
+		if (!GetUiTagData().Resolved)
+			ResolveUiTagData();
 
 		UpdateSpeakingPlayerWidget(true);
 
@@ -312,15 +272,6 @@ namespace Patches::Ui
 
 	//Functions that interact with Tags
 
-	void FindUiTagData()
-	{
-		FindUiTagIndices(); //Call me first.
-		FindVoiceChatSpeakingPlayerTagData();
-		FindHUDDistortionTagData();
-		FindHUDResolutionTagData();
-		FindMapImages();
-	}
-
 	bool isPttSoundPlaying;
 	void TogglePTTSound(bool enabled)
 	{
@@ -337,6 +288,7 @@ namespace Patches::Ui
 		static auto Sound_LoopingSound_Start = (void(*)(uint32_t sndTagIndex, int a2, int a3, int a4, char a5))(0x5DC530);
 
 		//Make sure the sound exists before playing
+		auto pttLsndIndex = GetUiTagData().PttLsndIndex;
 		if (Blam::Tags::TagInstance::IsLoaded('lsnd', pttLsndIndex))
 		{
 			if(enabled)
@@ -374,20 +326,18 @@ namespace Patches::Ui
 		if ((IsMapLoading() || IsMainMenu()) && !mapLoaded)
 			return;
 
-		if (!tagsInitiallyLoaded)
-			return;
-
-		if (!speakingPlayerStringFound)
+		auto &tagData = GetUiTagData();
+		if (!tagData.SpeakingPlayerStringFound)
 			return;
 
 		using Blam::Tags::TagInstance;
 		using Blam::Tags::UI::MultilingualUnicodeStringList;
 		using Blam::Tags::UI::ChudDefinition;
 
-		if (!TagInstance::IsLoaded('unic', hudMessagesUnicIndex))
+		if (!TagInstance::IsLoaded('unic', tagData.HudMessagesUnicIndex))
 			return;
 
-		auto *unic = Blam::Tags::TagInstance(hudMessagesUnicIndex).GetDefinition<Blam::Tags::UI::MultilingualUnicodeStringList>();
+		auto *unic = Blam::Tags::TagInstance(tagData.HudMessagesUnicIndex).GetDefinition<Blam::Tags::UI::MultilingualUnicodeStringList>();
 
 		std::string newName;
 
@@ -428,46 +378,47 @@ namespace Patches::Ui
 			int tmpValue = 0;
 			hexStringStream >> tmpValue;
 
-			if (unic->Data.Size < (dataIndex + speakingPlayerOffset) - 1)
+			if (unic->Data.Size < (dataIndex + tagData.SpeakingPlayerOffset) - 1)
 				return;
 
-			unic->Data.Elements[dataIndex + speakingPlayerOffset] = static_cast<unsigned char>(tmpValue);
+			unic->Data.Elements[dataIndex + tagData.SpeakingPlayerOffset] = static_cast<unsigned char>(tmpValue);
 		}
 	}
 
 	void ApplyUIResolution()
 	{
 		if (Modules::ModuleGraphics::Instance().VarUIScaling->ValueInt == 1) {
-			if (!tagsInitiallyLoaded)
+			auto &tagData = GetUiTagData();
+			if (!tagData.HudResolutionFound)
 				return;
 
 			using Blam::Tags::TagInstance;
 			using Blam::Tags::UI::ChudGlobalsDefinition;
 			using Blam::Tags::UI::ChudDefinition;
 
-			if (!TagInstance::IsLoaded('chgd', chgdIndex))
+			if (!TagInstance::IsLoaded('chgd', tagData.ChgdIndex))
 				return;
-			else if (!TagInstance::IsLoaded('chdt', spartanChdtIndex))
+			else if (!TagInstance::IsLoaded('chdt', tagData.SpartanChdtIndex))
 				return;
 
 			auto *gameResolution = reinterpret_cast<int *>(0x19106C0);
-			auto *globals = TagInstance(chgdIndex).GetDefinition<ChudGlobalsDefinition>();
-			auto *spartanChud = Blam::Tags::TagInstance(spartanChdtIndex).GetDefinition<Blam::Tags::UI::ChudDefinition>();
+			auto *globals = TagInstance(tagData.ChgdIndex).GetDefinition<ChudGlobalsDefinition>();
+			auto *spartanChud = Blam::Tags::TagInstance(tagData.SpartanChdtIndex).GetDefinition<Blam::Tags::UI::ChudDefinition>();
 			if (!globals || !spartanChud || globals->HudGlobals.Count == 0 || globals->HudGlobals[0].HudAttributes.Count == 0)
 				return;
 
 			// Make UI match it's original width of 1920 pixels on non-widescreen monitors.
 			// Fixes the visor getting cut off.
-			globals->HudGlobals[0].HudAttributes[0].ResolutionWidth = HUDResolutionWidth;
+			globals->HudGlobals[0].HudAttributes[0].ResolutionWidth = tagData.HudResolutionWidth;
 
 			// H3UI Resolution
 			int* UIResolution = reinterpret_cast<int*>(0x19106C8);
 
 			if (((float)gameResolution[0] / (float)gameResolution[1] >  16.0f / 9.0f)) {
 				// On aspect ratios with a greater width than 16:9 center the UI on the screen
-				globals->HudGlobals[0].HudAttributes[0].ResolutionHeight = HUDResolutionHeight;
-				globals->HudGlobals[0].HudAttributes[0].HorizontalScale = (globals->HudGlobals[0].HudAttributes[0].ResolutionWidth / (float)gameResolution[0]) * HUDResolutionScaleX;
-				globals->HudGlobals[0].HudAttributes[0].VerticalScale = (globals->HudGlobals[0].HudAttributes[0].ResolutionHeight / (float)gameResolution[1]) * HUDResolutionScaleY;
+				globals->HudGlobals[0].HudAttributes[0].ResolutionHeight = tagData.HudResolutionHeight;
+				globals->HudGlobals[0].HudAttributes[0].HorizontalScale = (globals->HudGlobals[0].HudAttributes[0].ResolutionWidth / (float)gameResolution[0]) * tagData.HudResolutionScaleX;
+				globals->HudGlobals[0].HudAttributes[0].VerticalScale = (globals->HudGlobals[0].HudAttributes[0].ResolutionHeight / (float)gameResolution[1]) * tagData.HudResolutionScaleY;
 
 				UIResolution[0] = (int)(((float)gameResolution[0] / (float)gameResolution[1]) * 640);;
 				UIResolution[1] = 640;
@@ -475,15 +426,15 @@ namespace Patches::Ui
 			else
 			{
 				globals->HudGlobals[0].HudAttributes[0].ResolutionHeight = (int)(((float)gameResolution[1] / (float)gameResolution[0]) * globals->HudGlobals[0].HudAttributes[0].ResolutionWidth);
-				globals->HudGlobals[0].HudAttributes[0].HorizontalScale = HUDResolutionScaleX;
-				globals->HudGlobals[0].HudAttributes[0].VerticalScale = HUDResolutionScaleY;
+				globals->HudGlobals[0].HudAttributes[0].HorizontalScale = tagData.HudResolutionScaleX;
+				globals->HudGlobals[0].HudAttributes[0].VerticalScale = tagData.HudResolutionScaleY;
 
 				UIResolution[0] = 1152;//1152 x 640 resolution
 				UIResolution[1] = (int)(((float)gameResolution[1] / (float)gameResolution[0]) * 1152);
 			}
 
 			// Adjust motion sensor blip to match the UI resolution
-			globals->HudGlobals[0].HudAttributes[0].MotionSensorOffsetX = HUDMotionSensorOffsetX;
+			globals->HudGlobals[0].HudAttributes[0].MotionSensorOffsetX = tagData.HudMotionSensorOffsetX;
 			globals->HudGlobals[0].HudAttributes[0].MotionSensorOffsetY = (float)(globals->HudGlobals[0].HudAttributes[0].ResolutionHeight - (globals->HudGlobals[0].HudAttributes[0].MotionSensorRadius - globals->HudGlobals[0].HudAttributes[0].MotionSensorScale));
 
 			// Search for the visor bottom and fix it if found
@@ -491,7 +442,7 @@ namespace Patches::Ui
 			{
 				if (widget.NameStringID == 0x2ABD) // in_helmet_bottom_new
 				{
-					widget.PlacementData[0].OffsetY = (((float)globals->HudGlobals[0].HudAttributes[0].ResolutionHeight - HUDResolutionHeight) / 2) + HUDBottomVisorOffsetY;
+					widget.PlacementData[0].OffsetY = (((float)globals->HudGlobals[0].HudAttributes[0].ResolutionHeight - tagData.HudResolutionHeight) / 2) + tagData.HudBottomVisorOffsetY;
 					break;
 				}
 			}
@@ -500,7 +451,7 @@ namespace Patches::Ui
 
 	void UpdateHUDDistortion()
 	{
-		if (!validHUDDistortionTags)
+		if (!GetUiTagData().HudDistortionFound)
 			return;
 
 		Pointer &directorPtr = ElDorito::GetMainTls(GameGlobals::Director::TLSOffset)[0];
@@ -561,230 +512,10 @@ namespace Patches::Ui
 
 namespace
 {
-	void FindUiTagIndices()
-	{
-		using Blam::Tags::Globals::CacheFileGlobalTags;
-		using Blam::Tags::Game::Globals;
-		using Blam::Tags::TagInstance;
-		using Blam::Tags::Objects::Biped;
-		using Blam::Tags::UI::ChudGlobalsDefinition;
-		using Blam::Tags::Game::MultiplayerGlobals;
-
-		auto cfgtInstances = TagInstance::GetInstancesInGroup('cfgt');
-		for (auto &cfgtInstance : cfgtInstances)
-		{
-			auto *cfgtDefinition = cfgtInstance.GetDefinition<CacheFileGlobalTags>();
-			for (size_t globalsTagIndex = 0; globalsTagIndex < cfgtDefinition->GlobalsTags.Count; globalsTagIndex++)
-			{
-				if (cfgtDefinition->GlobalsTags[globalsTagIndex].Tag.GroupTag == 'matg')
-				{
-					auto matgDefinition = TagInstance(cfgtDefinition->GlobalsTags[globalsTagIndex].Tag.TagIndex).GetDefinition<Globals>();
-
-					for (size_t interfaceTagsIndex = 0; interfaceTagsIndex < matgDefinition->InterfaceTags.Count; interfaceTagsIndex++)
-					{
-						if (matgDefinition->InterfaceTags[interfaceTagsIndex].HudGlobals.TagIndex != NULL &&
-							matgDefinition->InterfaceTags[interfaceTagsIndex].HudGlobals.GroupTag == 'chgd')
-						{
-							chgdIndex = matgDefinition->InterfaceTags[interfaceTagsIndex].HudGlobals.TagIndex;
-
-							if (!TagInstance::IsLoaded('chgd', chgdIndex))
-								continue;
-
-							auto *chgd = TagInstance(chgdIndex).GetDefinition<ChudGlobalsDefinition>();
-
-							if (chgd->HudGlobals.Count > 1) {
-								if (chgd->HudGlobals[0].ScoreboardHud.TagIndex != NULL)
-									scoreboardChdtIndex = chgd->HudGlobals[0].ScoreboardHud.TagIndex;
-								if (chgd->HudGlobals[0].HudStrings.TagIndex != NULL)
-									hudMessagesUnicIndex = chgd->HudGlobals[0].HudStrings.TagIndex;
-							}
-
-							//Can't break out of all these loops without setting an unnecessary variable.
-							//So if a chgd is found, move to the next loop.
-							goto findBipedChdts;
-						}
-					}
-
-				findBipedChdts:
-
-					for (size_t playerRepresentationIndex = 0; playerRepresentationIndex < matgDefinition->PlayerRepresentation.Count; playerRepresentationIndex++)
-					{
-						if (matgDefinition->PlayerRepresentation[playerRepresentationIndex].ThirdPersonUnit.TagIndex == NULL)
-							continue;
-
-						uint32_t bipdIndex = matgDefinition->PlayerRepresentation[playerRepresentationIndex].ThirdPersonUnit.TagIndex;
-
-						if (!TagInstance::IsLoaded('bipd', bipdIndex))
-							continue;
-
-						auto *bipd = TagInstance(bipdIndex).GetDefinition<Biped>();
-
-						if (bipd->Unit.HudInterfaces.Count < 1)
-							continue;
-
-						switch (matgDefinition->PlayerRepresentation[playerRepresentationIndex].Name)
-						{
-						case 4376: //mp_spartan
-							spartanChdtIndex = bipd->Unit.HudInterfaces[0].UnitHudInterface.TagIndex;
-							break;
-							//case 4377: //mp_elite
-							//	eliteChdtIndex = bipd->HudInterfaces[0].UnitHudInterface.TagIndex;
-							//	break;
-							//case 4379: //monitor
-							//	monitorChdtIndex = bipd->HudInterfaces[0].UnitHudInterface.TagIndex;
-							//	break;
-						default:
-							continue;
-						}
-
-						//If all the tag indices are found, move on.
-						if (spartanChdtIndex != NULL /*&& eliteChdtIndex != NULL && monitorChdtIndex != NULL*/)
-							goto findPttLsnd;
-					}
-
-				findPttLsnd:
-
-					if (matgDefinition->MultiplayerGlobals.TagIndex == NULL)
-						return;
-					if (!TagInstance::IsLoaded('mulg', matgDefinition->MultiplayerGlobals.TagIndex))
-						return;
-
-					auto *mulg = TagInstance(matgDefinition->MultiplayerGlobals.TagIndex).GetDefinition<MultiplayerGlobals>();
-
-					if (mulg->Runtime.Count < 1 || mulg->Runtime[0].LoopingSounds.Count < 1 || mulg->Runtime[0].LoopingSounds[0].LoopingSound.TagIndex == NULL)
-						return;
-
-					pttLsndIndex = mulg->Runtime[0].LoopingSounds[0].LoopingSound.TagIndex;
-
-					return;
-				}
-			}
-		}
-	}
-
-	void FindMapImages()
-	{
-		using Blam::Tags::TagInstance;
-		using Blam::Tags::UI::GfxTexturesList;
-
-		auto gfxtInstances = TagInstance::GetInstancesInGroup('gfxt');
-		for (auto &gfxtInstance : gfxtInstances)
-		{
-			//mapID|BitmapIndex
-			std::unordered_map<int, int> tempMapImages = std::unordered_map<int, int>();
-
-			auto *gfxtDefinition = gfxtInstance.GetDefinition<GfxTexturesList>();
-			for each (GfxTexturesList::Texture texture in gfxtDefinition->Textures)
-			{
-				char *output = strstr(texture.FileName, "placeholder");
-
-				if (output)
-				{
-					multiplayerPlaceholderIndex = texture.Bitmap.TagIndex;
-					continue;
-				}
-
-				try
-				{
-					int mapID = std::stoi(texture.FileName);
-					tempMapImages.insert(std::pair<int, int>(mapID, texture.Bitmap.TagIndex));
-					continue;
-				}
-				catch (...)
-				{
-					goto invalid_gfxt;
-				}
-			}
-
-			mapImages = tempMapImages;
-			foundMapImages = true;
-			return;
-
-		invalid_gfxt:
-			continue;
-		}
-	}
-
-	void FindVoiceChatSpeakingPlayerTagData()
-	{
-		using Blam::Tags::TagInstance;
-		using Blam::Tags::UI::MultilingualUnicodeStringList;
-
-		if (!TagInstance::IsLoaded('unic', hudMessagesUnicIndex))
-			return;
-
-		auto *unic = Blam::Tags::TagInstance(hudMessagesUnicIndex).GetDefinition<Blam::Tags::UI::MultilingualUnicodeStringList>();
-
-		//go through string blocks backwards to find speaking_player, as it should be at the end.
-		for (int stringBlockIndex = unic->Strings.Count - 1; stringBlockIndex > -1; stringBlockIndex--)
-			if (SPEAKING_PLAYER_STRING_NAME == (std::string)unic->Strings[stringBlockIndex].StringIDStr)
-			{
-				speakingPlayerOffset = unic->Strings[stringBlockIndex].Offsets[0]; //read the english offset,
-				speakingPlayerStringID = unic->Strings[stringBlockIndex].StringID;
-				break;
-			}
-
-		//If the speaking_player string cannot be found, RIP. This shouldn't happen unless tags don't have correct modifications.
-		if (speakingPlayerOffset != NULL)
-			speakingPlayerStringFound = true;
-		else
-			speakingPlayerStringFound = false;
-	}
-
-	void FindHUDDistortionTagData()
-	{
-		using Blam::Tags::UI::ChudGlobalsDefinition;
-		using Blam::Tags::TagInstance;
-
-		if (!TagInstance::IsLoaded('chgd', chgdIndex))
-			return;
-
-		auto *chgd = Blam::Tags::TagInstance(chgdIndex).GetDefinition<ChudGlobalsDefinition>();
-
-		for each (ChudGlobalsDefinition::HudGlobal hudGlobal in chgd->HudGlobals)
-		{
-			if (hudGlobal.HudAttributes.Count < 1)
-				continue;
-
-			hudDistortionDirection[hudGlobal.Biped] = hudGlobal.HudAttributes[0].WarpDirection;
-		}
-		firstHUDDistortionUpdate = false;
-		validHUDDistortionTags = true;
-	}
-
-	void FindHUDResolutionTagData()
-	{
-		using Blam::Tags::TagInstance;
-		using Blam::Tags::UI::ChudGlobalsDefinition;
-		using Blam::Tags::UI::ChudDefinition;
-
-		if (!TagInstance::IsLoaded('chgd', chgdIndex))
-			return;
-		else if (!TagInstance::IsLoaded('chdt', spartanChdtIndex))
-			return;
-
-		auto *globals = TagInstance(chgdIndex).GetDefinition<ChudGlobalsDefinition>();
-		auto *spartanChud = Blam::Tags::TagInstance(spartanChdtIndex).GetDefinition<Blam::Tags::UI::ChudDefinition>();
-
-		// Store initial HUD resolution values the first time the resolution is changed.
-		HUDResolutionWidth = globals->HudGlobals[0].HudAttributes[0].ResolutionWidth;
-		HUDResolutionHeight = globals->HudGlobals[0].HudAttributes[0].ResolutionHeight;
-		HUDResolutionScaleX = globals->HudGlobals[0].HudAttributes[0].HorizontalScale;
-		HUDResolutionScaleY = globals->HudGlobals[0].HudAttributes[0].VerticalScale;
-		HUDMotionSensorOffsetX = globals->HudGlobals[0].HudAttributes[0].MotionSensorOffsetX;
-		// Store bottom visor offset
-		for (auto &widget : spartanChud->HudWidgets)
-		{
-			if (widget.NameStringID == 0x2ABD) // in_helmet_bottom_new
-			{
-				HUDBottomVisorOffsetY = widget.PlacementData[0].OffsetY;
-			}
-		}
-	}
-
 	void ToggleHUDDistortion(bool enabled)
 	{
-		if (!validHUDDistortionTags)
+		auto &tagData = GetUiTagData();
+		if (!tagData.HudDistortionFound)
 			return;
 
 		if (enabled == lastDistortionEnabledValue)
@@ -794,17 +525,18 @@ namespace
 		using Blam::Tags::TagInstance;
 
 		//Return if the tag cant be found, happens during loading.
-		if (!TagInstance::IsLoaded('chgd', chgdIndex))
+		if (!TagInstance::IsLoaded('chgd', tagData.ChgdIndex))
 			return;
 
-		auto *chgd = Blam::Tags::TagInstance(chgdIndex).GetDefinition<ChudGlobalsDefinition>();
+		auto *chgd = Blam::Tags::TagInstance(tagData.ChgdIndex).GetDefinition<ChudGlobalsDefinition>();
 
-		for (size_t hudGlobalsIndex = 0; hudGlobalsIndex < chgd->HudGlobals.Count; hudGlobalsIndex++)
+		for (auto &hudGlobal : chgd->HudGlobals)
 		{
-			if (chgd->HudGlobals[hudGlobalsIndex].HudAttributes.Count < 1)
+			auto biped = static_cast<size_t>(hudGlobal.Biped);
+			if (hudGlobal.HudAttributes.Count < 1 || biped >= _countof(tagData.HudDistortionDirection))
 				continue;
 
-			chgd->HudGlobals[hudGlobalsIndex].HudAttributes[0].WarpDirection = enabled ? hudDistortionDirection[chgd->HudGlobals[hudGlobalsIndex].Biped] : 0;
+			hudGlobal.HudAttributes[0].WarpDirection = enabled ? tagData.HudDistortionDirection[biped] : 0;
 		}
 		lastDistortionEnabledValue = enabled;
 	}
@@ -1013,7 +745,8 @@ namespace
 		auto name = Pointer(thisptr)(0x40).Read<uint32_t>();
 		c_gui_bitmap_widget_get_render_data(thisptr, renderData, a3, a4, a5, a6, a7);
 
-		if (!foundMapImages)
+		auto &tagData = GetUiTagData();
+		if (!tagData.MapImagesFound)
 			return;
 
 		if (name != 67196 && name != 67149) // unknown_film_image, woohoo!
@@ -1035,14 +768,7 @@ namespace
 		}
 
 
-		try
-		{
-			bitmapIndex = mapImages.at(mapID);
-		}
-		catch (...)
-		{
-			bitmapIndex = multiplayerPlaceholderIndex;
-		}
+		bitmapIndex = tagData.GetMapImage(mapID);
 
 
 		if (!Blam::Tags::TagInstance::IsLoaded('bitm', bitmapIndex))
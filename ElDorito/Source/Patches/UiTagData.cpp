@@ -0,0 +1,233 @@
+#include "UiTagData.hpp"
+
+#include <cstdlib>
+#include <cstring>
+
+#include "../Blam/Tags/TagInstance.hpp"
+#include "../Blam/Tags/UI/ChudGlobalsDefinition.hpp"
+#include "../Blam/Tags/UI/ChudDefinition.hpp"
+#include "../Blam/Tags/UI/MultilingualUnicodeStringList.hpp"
+#include "../Blam/Tags/UI/GfxTexturesList.hpp"
+#include "../Blam/Tags/Globals/CacheFileGlobalTags.hpp"
+#include "../Blam/Tags/Game/Globals.hpp"
+#include "../Blam/Tags/Game/MultiplayerGlobals.hpp"
+#include "../Blam/Tags/Objects/Biped.hpp"
+
+namespace
+{
+	const char SpeakingPlayerStringName[] = "speaking_player";
+	const int32_t BottomVisorWidgetName = 0x2ABD; // in_helmet_bottom_new
+	const int32_t SpartanRepresentationName = 4376; // mp_spartan
+
+	Patches::Ui::UiTagData uiTagData;
+
+	void ResolveGlobalsTagIndices(const Blam::Tags::Game::Globals &matg, Patches::Ui::UiTagData *data);
+}
+
+namespace Patches::Ui
+{
+	uint32_t UiTagData::GetMapImage(int mapId) const
+	{
+		auto it = MapImages.find(mapId);
+		return it != MapImages.end() ? it->second : MapPlaceholderIndex;
+	}
+
+	void ResolveUiTagData()
+	{
+		using Blam::Tags::TagInstance;
+		using Blam::Tags::Globals::CacheFileGlobalTags;
+		using Blam::Tags::Game::Globals;
+		using Blam::Tags::UI::ChudGlobalsDefinition;
+		using Blam::Tags::UI::ChudDefinition;
+		using Blam::Tags::UI::MultilingualUnicodeStringList;
+		using Blam::Tags::UI::GfxTexturesList;
+
+		UiTagData data;
+
+		// Only the first matg referenced by a cfgt is used
+		for (auto &cfgtInstance : TagInstance::GetInstancesInGroup('cfgt'))
+		{
+			auto *cfgt = cfgtInstance.GetDefinition<CacheFileGlobalTags>();
+			if (!cfgt)
+				continue;
+
+			auto matgFound = false;
+			for (auto &globalsTag : cfgt->GlobalsTags)
+			{
+				if (globalsTag.Tag.GroupTag != 'matg')
+					continue;
+
+				auto *matg = TagInstance(globalsTag.Tag.TagIndex).GetDefinition<Globals>();
+				if (matg)
+					ResolveGlobalsTagIndices(*matg, &data);
+				matgFound = true;
+				break;
+			}
+			if (matgFound)
+				break;
+		}
+
+		if (TagInstance::IsLoaded('chgd', data.ChgdIndex))
+		{
+			ResolveHudGlobals(*TagInstance(data.ChgdIndex).GetDefinition<ChudGlobalsDefinition>(), &data);
+
+			// The visor offset is only meaningful alongside the resolution values
+			if (data.HudResolutionFound && TagInstance::IsLoaded('chdt', data.SpartanChdtIndex))
+				ResolveBottomVisorOffset(*TagInstance(data.SpartanChdtIndex).GetDefinition<ChudDefinition>(), &data);
+			else
+				data.HudResolutionFound = false;
+		}
+
+		if (TagInstance::IsLoaded('unic', data.HudMessagesUnicIndex))
+			ResolveSpeakingPlayerString(*TagInstance(data.HudMessagesUnicIndex).GetDefinition<MultilingualUnicodeStringList>(), &data);
+
+		for (auto &gfxtInstance : TagInstance::GetInstancesInGroup('gfxt'))
+		{
+			if (ResolveMapImages(*gfxtInstance.GetDefinition<GfxTexturesList>(), &data))
+				break;
+		}
+
+		data.Resolved = true;
+		uiTagData = std::move(data);
+	}
+
+	const UiTagData &GetUiTagData()
+	{
+		return uiTagData;
+	}
+
+	void ResolveHudGlobals(const Blam::Tags::UI::ChudGlobalsDefinition &chgd, UiTagData *data)
+	{
+		if (chgd.HudGlobals.Count > 1)
+		{
+			if (chgd.HudGlobals[0].ScoreboardHud.TagIndex != 0)
+				data->ScoreboardChdtIndex = chgd.HudGlobals[0].ScoreboardHud.TagIndex;
+			if (chgd.HudGlobals[0].HudStrings.TagIndex != 0)
+				data->HudMessagesUnicIndex = chgd.HudGlobals[0].HudStrings.TagIndex;
+		}
+
+		for (auto &hudGlobal : chgd.HudGlobals)
+		{
+			auto biped = static_cast<size_t>(hudGlobal.Biped);
+			if (hudGlobal.HudAttributes.Count < 1 || biped >= _countof(data->HudDistortionDirection))
+				continue;
+
+			data->HudDistortionDirection[biped] = hudGlobal.HudAttributes[0].WarpDirection;
+		}
+		data->HudDistortionFound = true;
+
+		if (chgd.HudGlobals.Count < 1 || chgd.HudGlobals[0].HudAttributes.Count < 1)
+			return;
+
+		auto &attributes = chgd.HudGlobals[0].HudAttributes[0];
+		data->HudResolutionWidth = attributes.ResolutionWidth;
+		data->HudResolutionHeight = attributes.ResolutionHeight;
+		data->HudResolutionScaleX = attributes.HorizontalScale;
+		data->HudResolutionScaleY = attributes.VerticalScale;
+		data->HudMotionSensorOffsetX = attributes.MotionSensorOffsetX;
+		data->HudResolutionFound = true;
+	}
+
+	void ResolveBottomVisorOffset(const Blam::Tags::UI::ChudDefinition &chdt, UiTagData *data)
+	{
+		for (auto &widget : chdt.HudWidgets)
+		{
+			if (widget.NameStringID == BottomVisorWidgetName && widget.PlacementData.Count > 0)
+			{
+				data->HudBottomVisorOffsetY = widget.PlacementData[0].OffsetY;
+				break;
+			}
+		}
+	}
+
+	void ResolveSpeakingPlayerString(const Blam::Tags::UI::MultilingualUnicodeStringList &unic, UiTagData *data)
+	{
+		// Go through string blocks backwards to find speaking_player, as it should be at the end.
+		for (auto i = unic.Strings.Count - 1; i >= 0; i--)
+		{
+			auto &str = unic.Strings[i];
+			if (strncmp(str.StringIDStr, SpeakingPlayerStringName, sizeof(str.StringIDStr)) != 0)
+				continue;
+
+			data->SpeakingPlayerOffset = str.Offsets[0]; // English
+			data->SpeakingPlayerStringID = str.StringID;
+			break;
+		}
+
+		// If the speaking_player string cannot be found, RIP. This shouldn't happen unless tags don't have correct modifications.
+		data->SpeakingPlayerStringFound = data->SpeakingPlayerOffset != 0;
+	}
+
+	bool ResolveMapImages(const Blam::Tags::UI::GfxTexturesList &gfxt, UiTagData *data)
+	{
+		std::unordered_map<int, uint32_t> mapImages;
+		auto placeholderIndex = data->MapPlaceholderIndex;
+
+		for (auto &texture : gfxt.Textures)
+		{
+			if (strstr(texture.FileName, "placeholder"))
+			{
+				placeholderIndex = texture.Bitmap.TagIndex;
+				continue;
+			}
+
+			// Every other texture has to be named after a map ID, otherwise this isn't the list we want
+			char *end;
+			auto mapId = strtol(texture.FileName, &end, 10);
+			if (end == texture.FileName)
+				return false;
+
+			mapImages.emplace(static_cast<int>(mapId), texture.Bitmap.TagIndex);
+		}
+
+		data->MapImages = std::move(mapImages);
+		data->MapPlaceholderIndex = placeholderIndex;
+		data->MapImagesFound = true;
+		return true;
+	}
+}
+
+namespace
+{
+	void ResolveGlobalsTagIndices(const Blam::Tags::Game::Globals &matg, Patches::Ui::UiTagData *data)
+	{
+		using Blam::Tags::TagInstance;
+		using Blam::Tags::Objects::Biped;
+		using Blam::Tags::Game::MultiplayerGlobals;
+
+		for (auto &interfaceTags : matg.InterfaceTags)
+		{
+			if (interfaceTags.HudGlobals.TagIndex == 0 || interfaceTags.HudGlobals.GroupTag != 'chgd')
+				continue;
+			if (!TagInstance::IsLoaded('chgd', interfaceTags.HudGlobals.TagIndex))
+				continue;
+
+			data->ChgdIndex = interfaceTags.HudGlobals.TagIndex;
+			break;
+		}
+
+		for (auto &representation : matg.PlayerRepresentation)
+		{
+			if (representation.Name != SpartanRepresentationName || representation.ThirdPersonUnit.TagIndex == 0)
+				continue;
+			if (!TagInstance::IsLoaded('bipd', representation.ThirdPersonUnit.TagIndex))
+				continue;
+
+			auto *bipd = TagInstance(representation.ThirdPersonUnit.TagIndex).GetDefinition<Biped>();
+			if (bipd->Unit.HudInterfaces.Count < 1)
+				continue;
+
+			data->SpartanChdtIndex = bipd->Unit.HudInterfaces[0].UnitHudInterface.TagIndex;
+			break;
+		}
+
+		if (matg.MultiplayerGlobals.TagIndex == 0 || !TagInstance::IsLoaded('mulg', matg.MultiplayerGlobals.TagIndex))
+			return;
+
+		auto *mulg = TagInstance(matg.MultiplayerGlobals.TagIndex).GetDefinition<MultiplayerGlobals>();
+		if (mulg->Runtime.Count < 1 || mulg->Runtime[0].LoopingSounds.Count < 1)
+			return;
+
+		data->PttLsndIndex = mulg->Runtime[0].LoopingSounds[0].LoopingSound.TagIndex;
+	}
+}
@@ -0,0 +1,66 @@
+#pragma once
+#include <cstdint>
+#include <unordered_map>
+
+namespace Blam::Tags::UI
+{
+	struct ChudGlobalsDefinition;
+	struct ChudDefinition;
+	struct MultilingualUnicodeStringList;
+	struct GfxTexturesList;
+}
+
+namespace Patches::Ui
+{
+	// Tag data used by the UI patches, resolved in a single pass after tags are loaded.
+	struct UiTagData
+	{
+		// True once the tags have been scanned at least once.
+		bool Resolved = false;
+
+		uint32_t ChgdIndex = 0;
+		uint32_t ScoreboardChdtIndex = 0;
+		uint32_t HudMessagesUnicIndex = 0;
+		uint32_t SpartanChdtIndex = 0;
+		uint32_t PttLsndIndex = 0;
+
+		// The offset of speaking_player in the HUD message string data.
+		bool SpeakingPlayerStringFound = false;
+		uint32_t SpeakingPlayerOffset = 0;
+		int32_t SpeakingPlayerStringID = 0;
+
+		// Distortion direction for spartan, monitor, elite.
+		// If more are added, this needs to be increased or stored differently.
+		bool HudDistortionFound = false;
+		float HudDistortionDirection[3]{ 0, 0, 0 };
+
+		// Initial HUD resolution values, before UI scaling is applied.
+		bool HudResolutionFound = false;
+		int HudResolutionWidth = 0;
+		int HudResolutionHeight = 0;
+		float HudResolutionScaleX = 0;
+		float HudResolutionScaleY = 0;
+		float HudMotionSensorOffsetX = 0;
+		float HudBottomVisorOffsetY = 0;
+
+		// mapID|BitmapIndex
+		bool MapImagesFound = false;
+		uint32_t MapPlaceholderIndex = 0;
+		std::unordered_map<int, uint32_t> MapImages;
+
+		// Gets the bitmap tag index for a map ID, or the placeholder image if there isn't one.
+		uint32_t GetMapImage(int mapId) const;
+	};
+
+	// Scans the loaded tags and rebuilds the UI tag data.
+	void ResolveUiTagData();
+
+	// Gets the UI tag data resolved by the last call to ResolveUiTagData().
+	const UiTagData &GetUiTagData();
+
+	// Individual resolvers which only read the tag definitions they are given.
+	void ResolveHudGlobals(const Blam::Tags::UI::ChudGlobalsDefinition &chgd, UiTagData *data);
+	void ResolveBottomVisorOffset(const Blam::Tags::UI::ChudDefinition &chdt, UiTagData *data);
+	void ResolveSpeakingPlayerString(const Blam::Tags::UI::MultilingualUnicodeStringList &unic, UiTagData *data);
+	bool ResolveMapImages(const Blam::Tags::UI::GfxTexturesList &gfxt, UiTagData *data);
+}
@@ -429,6 +429,7 @@ namespace Patches::Weapon
 			CreateList();
 
 			Modules::ModuleWeapon::Instance().VarWeaponJSON->ValueString = Name;
+			Modules::CommandMap::Instance().MarkChanged(Modules::ModuleWeapon::Instance().VarWeaponJSON);
 
 			bool IsCreated = false;
 			for each (std::string offsetName in Modules::ModuleWeapon::Instance().WeaponsJSONList)
@@ -1,5 +1,6 @@
 #include "BanList.hpp"
 
+#include <cstdlib>
 #include <fstream>
 #include <iomanip>
 #include "../Utils/String.hpp"
@@ -8,37 +9,288 @@
 
 namespace Server
 {
-	//Adds an ip to the list if it's not already in it. If it is already in it, then it extends the ban duration. 
-	void TempBanList::AddIp(const std::string ip)
+	TempBanList::TempBanList()
 	{
-		std::map<std::string, int>::iterator it = ipAddresses.find(ip);
-		if (it != ipAddresses.end())
+		std::ifstream stream(DefaultTempBanListPath);
+		if (stream)
+			Read(stream);
+	}
+
+	TempBanList::~TempBanList()
+	{
+		Flush();
+	}
+
+	void TempBanList::AddIp(const std::string &ip, std::time_t expiry)
+	{
+		Add({ ip, 0, expiry });
+	}
+
+	//Bans an ip if it's not already banned. If it is already banned, then it extends the ban duration.
+	void TempBanList::AddIp(const std::string &ip)
+	{
+		TempBan ban{ ip, 0, 0 };
+		ban.Expiry = GetExtendedExpiry(ban);
+		Add(ban);
+	}
+
+	bool TempBanList::ContainsIp(const std::string &ip, std::time_t now)
+	{
+		Expire(now);
+		return ipIndices.find(ip) != ipIndices.end();
+	}
+
+	bool TempBanList::ContainsIp(const std::string &ip)
+	{
+		return ContainsIp(ip, std::time(nullptr));
+	}
+
+	bool TempBanList::RemoveIp(const std::string &ip)
+	{
+		auto it = ipIndices.find(ip);
+		if (it == ipIndices.end())
+			return false;
+		RemoveAt(it->second);
+		dirty = true;
+		return true;
+	}
+
+	void TempBanList::AddUid(uint64_t uid, std::time_t expiry)
+	{
+		Add({ "", uid, expiry });
+	}
+
+	void TempBanList::AddUid(uint64_t uid)
+	{
+		TempBan ban{ "", uid, 0 };
+		ban.Expiry = GetExtendedExpiry(ban);
+		Add(ban);
+	}
+
+	bool TempBanList::ContainsUid(uint64_t uid, std::time_t now)
+	{
+		Expire(now);
+		return uidIndices.find(uid) != uidIndices.end();
+	}
+
+	bool TempBanList::ContainsUid(uint64_t uid)
+	{
+		return ContainsUid(uid, std::time(nullptr));
+	}
+
+	bool TempBanList::RemoveUid(uint64_t uid)
+	{
+		auto it = uidIndices.find(uid);
+		if (it == uidIndices.end())
+			return false;
+		RemoveAt(it->second);
+		dirty = true;
+		return true;
+	}
+
+	void TempBanList::Expire(std::time_t now)
+	{
+		while (!bans.empty() && bans[0].Expiry <= now)
+			RemoveAt(0);
+	}
+
+	void TempBanList::ClearList()
+	{
+		bans.clear();
+		ipIndices.clear();
+		uidIndices.clear();
+		dirty = true;
+	}
+
+	void TempBanList::Flush()
+	{
+		if (!dirty)
+			return;
+		Save();
+		dirty = false;
+	}
+
+	void TempBanList::Add(const TempBan &ban)
+	{
+		size_t pos;
+		if (Find(ban, &pos))
 		{
-			//Now we know that the user is currently banned. Extend the ban duration.
-			it->second += Modules::ModuleServer::Instance().VarTempBanDuration->ValueInt;
+			if (ban.Expiry > bans[pos].Expiry)
+			{
+				bans[pos].Expiry = ban.Expiry;
+				SiftDown(pos);
+				dirty = true;
+			}
 		}
 		else
-			ipAddresses.insert(std::make_pair(ip, Modules::ModuleServer::Instance().VarTempBanDuration->ValueInt));
+		{
+			bans.push_back(ban);
+			SetIndex(bans.size() - 1);
+			SiftUp(bans.size() - 1);
+			dirty = true;
+		}
+	}
+
+	// Gets when a ban for the duration set by Server.TempBanMinutes would expire,
+	// starting from the end of the existing ban if there is one
+	std::time_t TempBanList::GetExtendedExpiry(const TempBan &ban) const
+	{
+		auto now = std::time(nullptr);
+		auto duration = static_cast<std::time_t>(Modules::ModuleServer::Instance().VarTempBanMinutes->ValueInt) * 60;
+
+		size_t pos;
+		auto start = (Find(ban, &pos) && bans[pos].Expiry > now) ? bans[pos].Expiry : now;
+		return start + duration;
 	}
-	
-	//Decrements the ban duration of everyone in the list by 1 game
-	void TempBanList::decrementDuration(){
-		auto it = ipAddresses.begin();
-		while (it != ipAddresses.end())
+
+	bool TempBanList::Find(const TempBan &ban, size_t *pos) const
+	{
+		if (!ban.Ip.empty())
 		{
-			if (it->second < 2)
-			{
-				//remove this Ip if its duration has finished.
-				it = ipAddresses.erase(it);
-			}
-			else
-			{
-				it->second--;
-				++it;
-			}
+			auto it = ipIndices.find(ban.Ip);
+			if (it == ipIndices.end())
+				return false;
+			*pos = it->second;
+			return true;
 		}
+		auto it = uidIndices.find(ban.Uid);
+		if (it == uidIndices.end())
+			return false;
+		*pos = it->second;
+		return true;
+	}
 
+	void TempBanList::SetIndex(size_t pos)
+	{
+		if (!bans[pos].Ip.empty())
+			ipIndices[bans[pos].Ip] = pos;
+		else
+			uidIndices[bans[pos].Uid] = pos;
 	}
+
+	void TempBanList::EraseIndex(size_t pos)
+	{
+		if (!bans[pos].Ip.empty())
+			ipIndices.erase(bans[pos].Ip);
+		else
+			uidIndices.erase(bans[pos].Uid);
+	}
+
+	void TempBanList::SiftUp(size_t pos)
+	{
+		while (pos > 0)
+		{
+			auto parent = (pos - 1) / 2;
+			if (bans[parent].Expiry <= bans[pos].Expiry)
+				break;
+			Swap(pos, parent);
+			pos = parent;
+		}
+	}
+
+	void TempBanList::SiftDown(size_t pos)
+	{
+		while (true)
+		{
+			auto smallest = pos;
+			auto left = pos * 2 + 1;
+			auto right = left + 1;
+			if (left < bans.size() && bans[left].Expiry < bans[smallest].Expiry)
+				smallest = left;
+			if (right < bans.size() && bans[right].Expiry < bans[smallest].Expiry)
+				smallest = right;
+			if (smallest == pos)
+				break;
+			Swap(pos, smallest);
+			pos = smallest;
+		}
+	}
+
+	void TempBanList::Swap(size_t a, size_t b)
+	{
+		std::swap(bans[a], bans[b]);
+		SetIndex(a);
+		SetIndex(b);
+	}
+
+	void TempBanList::RemoveAt(size_t pos)
+	{
+		EraseIndex(pos);
+
+		auto last = bans.size() - 1;
+		if (pos != last)
+		{
+			bans[pos] = std::move(bans[last]);
+			SetIndex(pos);
+		}
+		bans.pop_back();
+
+		// The ban moved into the hole can belong either above or below it
+		if (pos < bans.size())
+		{
+			SiftUp(pos);
+			SiftDown(pos);
+		}
+	}
+
+	void TempBanList::Read(std::istream &stream)
+	{
+		auto now = std::time(nullptr);
+		while (true)
+		{
+			std::string line;
+			std::getline(stream, line);
+			if (stream.fail())
+				break;
+
+			auto commentStart = line.find('#');
+			if (commentStart != std::string::npos)
+				line = line.substr(0, commentStart);
+
+			line = Utils::String::Trim(Utils::String::Trim(line, false), true);
+			auto components = Utils::String::SplitString(line);
+			if (components.size() < 3)
+				continue;
+
+			TempBan ban{ "", 0, static_cast<std::time_t>(std::strtoll(components[2].c_str(), nullptr, 10)) };
+			if (components[0] == "ip")
+				ban.Ip = components[1];
+			else if (components[0] != "uid" || !Patches::PlayerUid::ParseUid(components[1], &ban.Uid))
+				continue;
+
+			size_t pos;
+			if (ban.Expiry <= now || Find(ban, &pos))
+				continue;
+
+			bans.push_back(ban);
+			SetIndex(bans.size() - 1);
+			SiftUp(bans.size() - 1);
+		}
+	}
+
+	void TempBanList::Save() const
+	{
+		std::ofstream stream(DefaultTempBanListPath, std::ios::trunc);
+		stream << "# ElDewrito server temporary ban list\n";
+		stream << "# Players matching the filters in this file will not be allowed to connect to your server until their ban expires.\n\n";
+
+		stream << "# IPv4 address bans\n";
+		stream << "# Format: ip XXX.XXX.XXX.XXX <expiry time in seconds since 1970-01-01 UTC>\n";
+		for (auto &ban : bans)
+		{
+			if (!ban.Ip.empty())
+				stream << "ip " << ban.Ip << ' ' << static_cast<long long>(ban.Expiry) << '\n';
+		}
+
+		stream << "\n# UID bans\n";
+		stream << "# Format: uid XXXXXXXXXXXXXXXX <expiry time in seconds since 1970-01-01 UTC>\n";
+		for (auto &ban : bans)
+		{
+			if (ban.Ip.empty())
+				stream << "uid " << std::hex << std::setw(16) << std::setfill('0') << ban.Uid << std::dec << ' ' << static_cast<long long>(ban.Expiry) << '\n';
+		}
+	}
+
 	BanList::BanList(const std::string &path)
 	{
 		std::ifstream stream(path);
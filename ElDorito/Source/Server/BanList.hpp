@@ -1,11 +1,13 @@
 #pragma once
 
 #include <string>
+#include <unordered_map>
 #include <unordered_set>
+#include <vector>
 #include <cstdint>
+#include <ctime>
 #include <istream>
-#include <map>
-#include "../Utils/Utils.hpp"
+#include "../Utils/Singleton.hpp"
 
 namespace Server
 {
@@ -14,32 +16,87 @@ namespace Server
 	/*
 	* - Temporary Ban List
 	*
-	* - This is a temporary ban list that ban players for a specified amount of games.
-	* - The amound of games is configurable via server variable.
+	* - This is a ban list where each ban expires at a set time.
+	* - The length of a ban is configurable via server variable, and bans are saved so they last across restarts.
+	* - Bans can be by IP address or by UID, and both are indexed.
 	*/
 	class TempBanList : public Utils::Singleton<TempBanList>
 	{
 	public:
-		TempBanList() { }
-		// Adds an IP address to the ban list.
-		void AddIp(const std::string ip);
-		// Returns whether an IP address is in the ban list.
-		inline bool ContainsIp(std::string ip)
-		{
-			return ipAddresses.find(ip) != ipAddresses.end();
-		}
-		inline bool RemoveIp(const std::string &ip)
-		{
-			return ipAddresses.erase(ip) == 1;
-		}
-		void decrementDuration();
-		// Clears ban list. Returns true if successful.
-		inline void ClearList()
-		{
-			ipAddresses.clear();
-		}
+		// Loads the temporary ban list file.
+		TempBanList();
+
+		// Writes any unsaved changes.
+		~TempBanList();
+
+		// Bans an IP address until a time. If it's already banned, the ban is extended.
+		void AddIp(const std::string &ip, std::time_t expiry);
+
+		// Bans an IP address for the duration set by Server.TempBanMinutes.
+		void AddIp(const std::string &ip);
+
+		// Returns whether an IP address is banned at a time.
+		bool ContainsIp(const std::string &ip, std::time_t now);
+		bool ContainsIp(const std::string &ip);
+
+		// Removes an IP address from the ban list. Returns true if successful.
+		bool RemoveIp(const std::string &ip);
+
+		// Bans a UID until a time. If it's already banned, the ban is extended.
+		void AddUid(uint64_t uid, std::time_t expiry);
+
+		// Bans a UID for the duration set by Server.TempBanMinutes.
+		void AddUid(uint64_t uid);
+
+		// Returns whether a UID is banned at a time.
+		bool ContainsUid(uint64_t uid, std::time_t now);
+		bool ContainsUid(uint64_t uid);
+
+		// Removes a UID from the ban list. Returns true if successful.
+		bool RemoveUid(uint64_t uid);
+
+		// Removes every ban which expires at or before a time.
+		// Only bans which are removed are looked at, so this is cheap to call often.
+		// Expired bans are skipped when the file is loaded, so this doesn't need to write it.
+		void Expire(std::time_t now);
+
+		// Clears ban list.
+		void ClearList();
+
+		// Writes the ban list file if bans were added or removed since it was last written.
+		// Changes aren't written straight away because lookups run while players join.
+		void Flush();
+
+		size_t Count() const { return bans.size(); }
+
 	private:
-		std::map<std::string, int> ipAddresses = std::map<std::string, int>{};
+		// A ban is by IP address if Ip is non-empty, and by UID otherwise
+		struct TempBan
+		{
+			std::string Ip;
+			uint64_t Uid;
+			std::time_t Expiry;
+		};
+
+		// A min-heap of bans ordered by expiry time, with indices from each IP and UID to its position in the heap
+		std::vector<TempBan> bans;
+		std::unordered_map<std::string, size_t> ipIndices;
+		std::unordered_map<uint64_t, size_t> uidIndices;
+		bool dirty = false;
+
+		void Add(const TempBan &ban);
+		std::time_t GetExtendedExpiry(const TempBan &ban) const;
+		bool Find(const TempBan &ban, size_t *pos) const;
+		void SetIndex(size_t pos);
+		void EraseIndex(size_t pos);
+
+		void SiftUp(size_t pos);
+		void SiftDown(size_t pos);
+		void Swap(size_t a, size_t b);
+		void RemoveAt(size_t pos);
+
+		void Read(std::istream &stream);
+		void Save() const;
 	};
 
 	class BanList
@@ -106,6 +163,7 @@ namespace Server
 	};
 
 	const std::string DefaultBanListPath = "mods/server/banlist.txt";
+	const std::string DefaultTempBanListPath = "mods/server/tempbans.txt";
 
 	// Loads the default ban list file.
 	// If it does not exist, an empty ban list will be returned.
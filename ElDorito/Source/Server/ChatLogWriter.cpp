@@ -0,0 +1,194 @@
+#include "ChatLogWriter.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <sys/stat.h>
+
+namespace
+{
+	const time_t SecondsPerDay = 24 * 60 * 60;
+
+	bool GetFileInfo(const std::string &path, uint64_t *size, time_t *modifiedTime);
+	std::string FormatDay(int day);
+}
+
+namespace Server::Chat
+{
+	ChatLogWriter::ChatLogWriter(size_t maxQueuedLines, uint32_t flushIntervalMs)
+		: maxQueuedLines(maxQueuedLines), flushIntervalMs(flushIntervalMs), droppedCount(0), unloggedDropCount(0), stopping(false), fileSize(0), fileDay(0)
+	{
+	}
+
+	ChatLogWriter::~ChatLogWriter()
+	{
+		Stop();
+	}
+
+	bool ChatLogWriter::Queue(const ChatLogOptions &options, const std::string &line, time_t time)
+	{
+		std::lock_guard<std::mutex> lock(queueMutex);
+		if (queue.size() >= maxQueuedLines)
+		{
+			droppedCount++;
+			unloggedDropCount++;
+			return false;
+		}
+
+		if (!thread.joinable())
+			thread = std::thread(&ChatLogWriter::Run, this);
+
+		queue.push_back({ options, line, time });
+
+		// Don't wait for the interval if the queue is filling up
+		if (queue.size() >= maxQueuedLines / 2)
+			queueCondition.notify_one();
+		return true;
+	}
+
+	void ChatLogWriter::Stop()
+	{
+		{
+			std::lock_guard<std::mutex> lock(queueMutex);
+			if (!thread.joinable())
+				return;
+			stopping = true;
+		}
+		queueCondition.notify_one();
+		thread.join();
+
+		// Write anything that was queued while the thread was finishing up
+		std::vector<Line> lines;
+		{
+			std::lock_guard<std::mutex> lock(queueMutex);
+			TakeQueue(lines);
+			stopping = false;
+		}
+		WriteLines(lines);
+		file.close();
+		filePath.clear();
+	}
+
+	void ChatLogWriter::Run()
+	{
+		std::vector<Line> lines;
+		while (true)
+		{
+			bool done;
+			{
+				std::unique_lock<std::mutex> lock(queueMutex);
+				queueCondition.wait_for(lock, std::chrono::milliseconds(flushIntervalMs), [this]
+				{
+					return stopping || (!queue.empty() && queue.size() >= maxQueuedLines / 2);
+				});
+				TakeQueue(lines);
+				done = stopping;
+			}
+
+			WriteLines(lines);
+			lines.clear();
+			if (done)
+				break;
+		}
+	}
+
+	void ChatLogWriter::TakeQueue(std::vector<Line> &lines)
+	{
+		lines.swap(queue);
+
+		// Lines are only dropped while the queue is full, so they came after everything that was in it
+		if (unloggedDropCount > 0 && !lines.empty())
+		{
+			auto &last = lines.back();
+			auto text = "*** " + std::to_string(unloggedDropCount) + " lines were dropped because the chat log could not keep up ***";
+			lines.push_back({ last.Options, text, last.Time });
+			unloggedDropCount = 0;
+		}
+	}
+
+	void ChatLogWriter::WriteLines(std::vector<Line> &lines)
+	{
+		if (lines.empty())
+			return;
+
+		for (auto &line : lines)
+		{
+			if (!file.is_open() || line.Options.Path != filePath)
+			{
+				if (!OpenFile(line.Options.Path, line.Time))
+					continue;
+			}
+
+			auto lineSize = line.Text.length() + 1;
+			auto day = static_cast<int>(line.Time / SecondsPerDay);
+			if ((line.Options.RotateDaily && day != fileDay) ||
+				(line.Options.MaxFileSize && fileSize > 0 && fileSize + lineSize > line.Options.MaxFileSize))
+			{
+				RotateFile(line.Time);
+				if (!file.is_open())
+					continue;
+			}
+
+			file << line.Text << '\n';
+			fileSize += lineSize;
+		}
+		file.flush();
+	}
+
+	bool ChatLogWriter::OpenFile(const std::string &path, time_t time)
+	{
+		file.close();
+		filePath = path;
+
+		// Pick up where an existing log left off so that it still gets rotated at the right time
+		time_t modifiedTime;
+		if (!GetFileInfo(path, &fileSize, &modifiedTime))
+		{
+			fileSize = 0;
+			modifiedTime = time;
+		}
+		fileDay = static_cast<int>((fileSize > 0 ? modifiedTime : time) / SecondsPerDay);
+
+		file.open(path, std::ios::app);
+		return file.is_open();
+	}
+
+	void ChatLogWriter::RotateFile(time_t time)
+	{
+		file.close();
+
+		auto rotatedPath = filePath + "." + FormatDay(fileDay);
+		uint64_t size;
+		time_t modifiedTime;
+		for (auto i = 1; GetFileInfo(rotatedPath, &size, &modifiedTime); i++)
+			rotatedPath = filePath + "." + FormatDay(fileDay) + "." + std::to_string(i);
+		std::rename(filePath.c_str(), rotatedPath.c_str());
+
+		fileSize = 0;
+		fileDay = static_cast<int>(time / SecondsPerDay);
+		file.open(filePath, std::ios::app);
+	}
+}
+
+namespace
+{
+	bool GetFileInfo(const std::string &path, uint64_t *size, time_t *modifiedTime)
+	{
+		struct _stat64 fileStat;
+		if (_stat64(path.c_str(), &fileStat) != 0)
+			return false;
+		*size = static_cast<uint64_t>(fileStat.st_size);
+		*modifiedTime = static_cast<time_t>(fileStat.st_mtime);
+		return true;
+	}
+
+	std::string FormatDay(int day)
+	{
+		auto time = static_cast<time_t>(day) * SecondsPerDay;
+		struct tm gmTime;
+		gmtime_s(&gmTime, &time);
+
+		char result[16];
+		strftime(result, sizeof(result), "%Y-%m-%d", &gmTime);
+		return result;
+	}
+}
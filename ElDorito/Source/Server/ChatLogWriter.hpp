@@ -0,0 +1,75 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <ctime>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Server::Chat
+{
+	// Where chat is logged to and when the log is rotated.
+	struct ChatLogOptions
+	{
+		std::string Path;
+		uint64_t MaxFileSize; // Rotate once the file would grow past this many bytes (0 = never)
+		bool RotateDaily;     // Rotate when the UTC date changes
+	};
+
+	// Writes chat log lines on a background thread which keeps the log file open and writes in batches.
+	// Queueing a line never waits on the file system. If the queue is full, the line is dropped and counted instead,
+	// and a line saying how many were dropped is written to the log after the lines which made it in.
+	// Rotated files are renamed to "<path>.<YYYY-MM-DD>", with ".<n>" added if that name is taken.
+	class ChatLogWriter
+	{
+	public:
+		ChatLogWriter(size_t maxQueuedLines, uint32_t flushIntervalMs);
+		~ChatLogWriter();
+
+		// Queues a line to be written. The line should not end with a newline.
+		// Returns false if the queue is full and the line was dropped.
+		bool Queue(const ChatLogOptions &options, const std::string &line, time_t time);
+
+		// Writes everything that has been queued and stops the writer thread.
+		// Lines queued afterwards start the thread again.
+		void Stop();
+
+		// Gets the number of lines which have been dropped because the queue was full.
+		uint64_t GetDroppedCount() const { return droppedCount; }
+
+	private:
+		struct Line
+		{
+			ChatLogOptions Options;
+			std::string Text;
+			time_t Time;
+		};
+
+		size_t maxQueuedLines;
+		uint32_t flushIntervalMs;
+
+		std::mutex queueMutex;
+		std::condition_variable queueCondition;
+		std::vector<Line> queue;
+		std::atomic<uint64_t> droppedCount;
+		uint64_t unloggedDropCount; // Dropped lines which haven't been noted in the log yet
+		bool stopping;
+		std::thread thread;
+
+		// Only used by the writer thread
+		std::ofstream file;
+		std::string filePath;
+		uint64_t fileSize;
+		int fileDay; // Days since the epoch (UTC) when the file was started
+
+		void Run();
+		void TakeQueue(std::vector<Line> &lines); // queueMutex must be held
+		void WriteLines(std::vector<Line> &lines);
+		bool OpenFile(const std::string &path, time_t time);
+		void RotateFile(time_t time);
+	};
+}
@@ -0,0 +1,251 @@
+#include "NamePolicy.hpp"
+#include "../Utils/String.hpp"
+#include <algorithm>
+#include <cwctype>
+
+namespace
+{
+	// Marks a character which is dropped from skeletons
+	const wchar_t Drop = 0xFFFF;
+
+	struct Confusable
+	{
+		wchar_t From;
+		wchar_t To;
+	};
+
+	// Greek and Cyrillic letters which look like Latin letters, sorted by From. Uppercase letters are listed too because
+	// towlower() only handles ASCII in some locales.
+	const Confusable Confusables[] =
+	{
+		{ 0x0391, 'a' }, { 0x0392, 'b' }, { 0x0395, 'e' }, { 0x0396, 'z' }, { 0x0397, 'h' }, { 0x0399, 'i' }, { 0x039A, 'k' },
+		{ 0x039C, 'm' }, { 0x039D, 'n' }, { 0x039F, 'o' }, { 0x03A1, 'p' }, { 0x03A4, 't' }, { 0x03A5, 'y' }, { 0x03A7, 'x' },
+		{ 0x03B1, 'a' }, { 0x03B3, 'y' }, { 0x03B5, 'e' }, { 0x03B9, 'i' }, { 0x03BA, 'k' }, { 0x03BD, 'v' }, { 0x03BF, 'o' },
+		{ 0x03C1, 'p' }, { 0x03C4, 't' }, { 0x03C5, 'u' }, { 0x03C7, 'x' },
+		{ 0x0401, 'e' }, { 0x0405, 's' }, { 0x0406, 'i' }, { 0x0408, 'j' }, { 0x0410, 'a' }, { 0x0412, 'b' }, { 0x0415, 'e' },
+		{ 0x041A, 'k' }, { 0x041C, 'm' }, { 0x041D, 'h' }, { 0x041E, 'o' }, { 0x0420, 'p' }, { 0x0421, 'c' }, { 0x0422, 't' },
+		{ 0x0423, 'y' }, { 0x0425, 'x' },
+		{ 0x0430, 'a' }, { 0x0435, 'e' }, { 0x043A, 'k' }, { 0x043E, 'o' }, { 0x0440, 'p' }, { 0x0441, 'c' }, { 0x0443, 'y' },
+		{ 0x0445, 'x' }, { 0x0451, 'e' }, { 0x0455, 's' }, { 0x0456, 'i' }, { 0x0457, 'i' }, { 0x0458, 'j' }, { 0x04BB, 'h' },
+		{ 0x0501, 'd' }, { 0x051B, 'q' }, { 0x051D, 'w' },
+	};
+
+	// Base letters for U+00E0 to U+00FF and U+0100 to U+017F. Spaces are characters which are left alone.
+	const char Latin1Bases[] = "aaaaaa ceeeeiiiidnooooo ouuuuy y";
+	const char LatinExtendedABases[] =
+		"aaaaaaccccccccddddeeeeeeeeeegggggggghhhhiiiiiiiiii  jjkkkllllllllllnnnnnn nnoooooo  rrrrrrssssssssttttttuuuuuuuuuuuuwwyyyzzzzzzs";
+	static_assert(sizeof(Latin1Bases) == 0x20 + 1, "Invalid Latin-1 base table size");
+	static_assert(sizeof(LatinExtendedABases) == 0x80 + 1, "Invalid Latin Extended-A base table size");
+
+	wchar_t FoldCharacter(wchar_t ch, bool mergeSimilar);
+	std::wstring FoldName(const std::wstring &name, bool mergeSimilar);
+	bool MatchWildcards(const wchar_t *pattern, const wchar_t *text);
+	std::wstring GetLongestLiteral(const std::wstring &pattern);
+}
+
+namespace Server
+{
+	NamePolicy::NamePolicy()
+	{
+	}
+
+	void NamePolicy::Compile(const NamePolicyRules &rules)
+	{
+		exactNames.clear();
+		for (auto &name : rules.ExactNames)
+		{
+			auto skeleton = GetNameSkeleton(Utils::String::WidenString(name));
+			if (!skeleton.empty())
+				exactNames.insert(skeleton);
+		}
+
+		std::vector<std::string> substringSkeletons;
+		for (auto &substring : rules.Substrings)
+		{
+			// An empty substring would block every name
+			auto skeleton = GetSubstringSkeleton(Utils::String::WidenString(substring));
+			if (!skeleton.empty())
+				substringSkeletons.push_back(skeleton);
+		}
+		substrings.Compile(substringSkeletons);
+
+		patterns.clear();
+		literalPatterns.clear();
+		wildcardPatterns.clear();
+		std::vector<std::string> literals;
+		for (auto &pattern : rules.Patterns)
+		{
+			// Patterns stay wide so that '?' matches a whole character rather than one byte of it
+			auto skeleton = FoldName(Utils::String::WidenString(pattern), true);
+			if (skeleton.empty())
+				continue;
+
+			auto index = static_cast<uint32_t>(patterns.size());
+			patterns.push_back(skeleton);
+			auto literal = GetLongestLiteral(skeleton);
+			if (literal.empty())
+			{
+				wildcardPatterns.push_back(index);
+			}
+			else
+			{
+				literals.push_back(Utils::String::ThinString(literal));
+				literalPatterns.push_back(index);
+			}
+		}
+		patternLiterals.Compile(literals);
+	}
+
+	bool NamePolicy::IsBlocked(const std::wstring &name) const
+	{
+		auto wideSkeleton = FoldName(name, true);
+		auto skeleton = Utils::String::ThinString(wideSkeleton);
+		if (exactNames.find(skeleton) != exactNames.end())
+			return true;
+		if (substrings.PatternCount() > 0 && substrings.MatchesAny(GetSubstringSkeleton(name).c_str()))
+			return true;
+
+		auto blocked = false;
+		patternLiterals.ForEachMatch(skeleton.c_str(), [&](size_t literal)
+		{
+			if (!blocked && MatchWildcards(patterns[literalPatterns[literal]].c_str(), wideSkeleton.c_str()))
+				blocked = true;
+		});
+		for (auto i = 0U; !blocked && i < wildcardPatterns.size(); i++)
+			blocked = MatchWildcards(patterns[wildcardPatterns[i]].c_str(), wideSkeleton.c_str());
+		return blocked;
+	}
+
+	std::string GetNameSkeleton(const std::wstring &name)
+	{
+		return Utils::String::ThinString(FoldName(name, true));
+	}
+
+	std::string GetSubstringSkeleton(const std::wstring &name)
+	{
+		return Utils::String::ThinString(FoldName(name, false));
+	}
+}
+
+namespace
+{
+	wchar_t FoldCharacter(wchar_t ch, bool mergeSimilar)
+	{
+		// Fullwidth ASCII
+		if (ch >= 0xFF01 && ch <= 0xFF5E)
+			ch = static_cast<wchar_t>(ch - 0xFEE0);
+
+		// Combining marks and zero-width characters
+		if ((ch >= 0x0300 && ch <= 0x036F) || (ch >= 0x200B && ch <= 0x200D) || ch == 0xFEFF)
+			return Drop;
+
+		if (ch >= 0x00C0 && ch <= 0x00DE && ch != 0x00D7)
+			ch = static_cast<wchar_t>(ch + 0x20);
+		else
+			ch = static_cast<wchar_t>(towlower(ch));
+		if (ch >= 0x00E0 && ch <= 0x00FF && Latin1Bases[ch - 0x00E0] != ' ')
+			ch = Latin1Bases[ch - 0x00E0];
+		else if (ch >= 0x0100 && ch <= 0x017F && LatinExtendedABases[ch - 0x0100] != ' ')
+			ch = LatinExtendedABases[ch - 0x0100];
+		else if (ch >= 0x0370 && ch < 0x0530)
+		{
+			auto confusable = std::lower_bound(std::begin(Confusables), std::end(Confusables), ch, [](const Confusable &c, wchar_t value) { return c.From < value; });
+			if (confusable != std::end(Confusables) && confusable->From == ch)
+				ch = confusable->To;
+		}
+
+		switch (ch)
+		{
+		case '0':
+			return 'o';
+		case '1':
+		case '!':
+		case '|':
+		case 'i':
+			return mergeSimilar ? 'l' : 'i';
+		case '3':
+			return 'e';
+		case '4':
+		case '@':
+			return 'a';
+		case '5':
+		case '$':
+			return 's';
+		case '7':
+			return 't';
+		case ' ':
+		case '_':
+		case '-':
+		case '.':
+		case ',':
+		case '\'':
+		case '(':
+		case ')':
+		case '[':
+		case ']':
+			return mergeSimilar ? Drop : ch;
+		default:
+			return ch;
+		}
+	}
+
+	std::wstring FoldName(const std::wstring &name, bool mergeSimilar)
+	{
+		std::wstring skeleton;
+		for (auto ch : name)
+		{
+			auto folded = FoldCharacter(ch, mergeSimilar);
+			if (folded != Drop)
+				skeleton += folded;
+		}
+		return skeleton;
+	}
+
+	bool MatchWildcards(const wchar_t *pattern, const wchar_t *text)
+	{
+		// Greedy matching which backtracks to the last '*'
+		const wchar_t *star = nullptr;
+		const wchar_t *starText = nullptr;
+		while (*text)
+		{
+			if (*pattern == '?' || (*pattern != '*' && *pattern == *text))
+			{
+				pattern++;
+				text++;
+			}
+			else if (*pattern == '*')
+			{
+				star = pattern++;
+				starText = text;
+			}
+			else if (star)
+			{
+				pattern = star + 1;
+				text = ++starText;
+			}
+			else
+			{
+				return false;
+			}
+		}
+		while (*pattern == '*')
+			pattern++;
+		return *pattern == '\0';
+	}
+
+	std::wstring GetLongestLiteral(const std::wstring &pattern)
+	{
+		std::wstring longest;
+		size_t start = 0;
+		while (start <= pattern.length())
+		{
+			auto end = pattern.find_first_of(L"*?", start);
+			if (end == std::wstring::npos)
+				end = pattern.length();
+			if (end - start > longest.length())
+				longest = pattern.substr(start, end - start);
+			start = end + 1;
+		}
+		return longest;
+	}
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_set>
+#include <vector>
+#include "../Utils/MultiPatternMatcher.hpp"
+
+namespace Server
+{
+	// The names a server doesn't allow, as listed in server.json.
+	struct NamePolicyRules
+	{
+		// Names which are blocked if they match the whole name.
+		std::vector<std::string> ExactNames;
+
+		// Names which are blocked if they appear anywhere in a name.
+		std::vector<std::string> Substrings;
+
+		// Wildcard patterns which are blocked if they match the whole name.
+		// '*' matches any number of characters and '?' matches one. Patterns
+		// are matched against the wide skeleton, so '?' also matches one
+		// non-Latin character (but a character outside the BMP counts as two).
+		std::vector<std::string> Patterns;
+	};
+
+	// Checks player names against a compiled set of rules. Names and rules
+	// are both reduced to a skeleton first (see GetNameSkeleton), so look-alike
+	// spellings of a blocked name are blocked too. Substrings use a lighter
+	// skeleton (see GetSubstringSkeleton), because dropping spaces and merging
+	// 'i' with 'l' would let a short substring match across words.
+	//
+	// A check costs about the same however many rules there are: exact names
+	// are hashed, substrings are found in one pass by an Aho-Corasick matcher,
+	// and patterns are only tried if their longest literal part was found.
+	class NamePolicy
+	{
+	public:
+		NamePolicy();
+
+		// Replaces the rules. Rules which reduce to an empty skeleton are ignored.
+		void Compile(const NamePolicyRules &rules);
+
+		// Returns true if a name is blocked by any rule.
+		bool IsBlocked(const std::wstring &name) const;
+
+		// Gets the number of rules which were compiled.
+		size_t RuleCount() const { return exactNames.size() + substrings.PatternCount() + patterns.size(); }
+
+	private:
+		std::unordered_set<std::string> exactNames;
+		Utils::MultiPatternMatcher substrings;
+
+		std::vector<std::wstring> patterns;
+		Utils::MultiPatternMatcher patternLiterals; // The longest literal part of each pattern that has one
+		std::vector<uint32_t> literalPatterns;      // Maps patternLiterals indices to patterns indices
+		std::vector<uint32_t> wildcardPatterns;     // Patterns with no literal part, which always have to be tried
+	};
+
+	// Reduces a name to a skeleton for comparisons: letters are lowercased,
+	// accents and zero-width characters are dropped, fullwidth, Cyrillic and
+	// Greek look-alikes become their Latin counterparts, characters that look
+	// like letters (0, 1, !, |, 3, 4, @, 5, $, 7) become those letters, 'i'
+	// becomes 'l', and spaces and punctuation between letters are dropped.
+	std::string GetNameSkeleton(const std::wstring &name);
+
+	// Reduces a name to the skeleton used for substring rules. This is the
+	// same as GetNameSkeleton, except that spaces and punctuation are kept,
+	// 'i' and 'l' stay distinct, and 1, ! and | become 'i'.
+	std::string GetSubstringSkeleton(const std::wstring &name);
+}
@@ -0,0 +1,272 @@
+#include "PlayerDirectory.hpp"
+#include "../Utils/String.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <cwchar>
+#include <cwctype>
+
+namespace
+{
+	const uint64_t UnsyncedAddress = UINT64_MAX;
+
+	template<typename Map, typename Key>
+	void EraseIndex(Map &map, const Key &key, int playerIndex);
+
+	template<typename Map, typename Key>
+	std::vector<int> FindIndices(const Map &map, const Key &key);
+
+	int GetEditDistance(const std::string &a, const std::string &b, int maxDistance);
+}
+
+namespace Server
+{
+	PlayerDirectory::PlayerDirectory()
+		: count(0)
+	{
+		std::fill(std::begin(active), std::end(active), false);
+		std::fill(std::begin(peerPlayers), std::end(peerPlayers), -1);
+		std::fill(std::begin(syncedAddresses), std::end(syncedAddresses), UnsyncedAddress);
+	}
+
+	void PlayerDirectory::Sync(const Blam::Network::Session *session)
+	{
+		if (!session || !session->IsEstablished())
+		{
+			if (count > 0)
+				Clear();
+			return;
+		}
+
+		bool seen[Blam::Network::MaxPlayers] = {};
+		auto &membership = session->MembershipInfo;
+		for (auto peerIdx = membership.FindFirstPeer(); peerIdx >= 0; peerIdx = membership.FindNextPeer(peerIdx))
+		{
+			auto playerIdx = membership.GetPeerPlayer(peerIdx);
+			if (playerIdx < 0 || playerIdx >= Blam::Network::MaxPlayers)
+				continue;
+			seen[playerIdx] = true;
+
+			// Most ticks nothing changes, so compare against the cached slot before building a new record
+			auto &properties = membership.PlayerSessions[playerIdx].Properties;
+			auto address = session->GetPeerAddress(peerIdx);
+			auto &existing = players[playerIdx];
+			if (active[playerIdx] && existing.PeerIndex == peerIdx && existing.Uid == properties.Uid && syncedAddresses[playerIdx] == address.Address.IPv4 &&
+				existing.DisplayName.compare(0, std::wstring::npos, properties.DisplayName, wcsnlen(properties.DisplayName, 16)) == 0)
+			{
+				continue;
+			}
+
+			PlayerRecord record;
+			record.PlayerIndex = playerIdx;
+			record.PeerIndex = peerIdx;
+			record.Uid = properties.Uid;
+			record.DisplayName.assign(properties.DisplayName, wcsnlen(properties.DisplayName, 16));
+			record.Name = Utils::String::ThinString(record.DisplayName);
+			record.Ip = address.ToString();
+			Join(record);
+			syncedAddresses[playerIdx] = address.Address.IPv4;
+		}
+
+		for (auto i = 0; i < Blam::Network::MaxPlayers; i++)
+		{
+			if (active[i] && !seen[i])
+				Leave(i);
+		}
+	}
+
+	void PlayerDirectory::Join(const PlayerRecord &record)
+	{
+		auto playerIdx = record.PlayerIndex;
+		if (playerIdx < 0 || playerIdx >= Blam::Network::MaxPlayers)
+			return;
+		Leave(playerIdx);
+
+		// A peer only has one player, so whoever had the peer before is gone
+		if (record.PeerIndex >= 0 && record.PeerIndex < Blam::Network::MaxPeers && peerPlayers[record.PeerIndex] >= 0)
+			Leave(peerPlayers[record.PeerIndex]);
+
+		auto &player = players[playerIdx];
+		player = record;
+		player.FoldedName = FoldPlayerName(record.Name);
+		active[playerIdx] = true;
+		syncedAddresses[playerIdx] = UnsyncedAddress;
+		count++;
+
+		if (player.PeerIndex >= 0 && player.PeerIndex < Blam::Network::MaxPeers)
+			peerPlayers[player.PeerIndex] = playerIdx;
+		byName.emplace(player.FoldedName, playerIdx);
+		byUid.emplace(player.Uid, playerIdx);
+		byIp.emplace(player.Ip, playerIdx);
+	}
+
+	void PlayerDirectory::Leave(int playerIndex)
+	{
+		if (playerIndex < 0 || playerIndex >= Blam::Network::MaxPlayers || !active[playerIndex])
+			return;
+
+		auto &player = players[playerIndex];
+		if (player.PeerIndex >= 0 && player.PeerIndex < Blam::Network::MaxPeers && peerPlayers[player.PeerIndex] == playerIndex)
+			peerPlayers[player.PeerIndex] = -1;
+		EraseIndex(byName, player.FoldedName, playerIndex);
+		EraseIndex(byUid, player.Uid, playerIndex);
+		EraseIndex(byIp, player.Ip, playerIndex);
+
+		player = PlayerRecord();
+		active[playerIndex] = false;
+		count--;
+	}
+
+	void PlayerDirectory::Clear()
+	{
+		for (auto i = 0; i < Blam::Network::MaxPlayers; i++)
+		{
+			players[i] = PlayerRecord();
+			active[i] = false;
+		}
+		std::fill(std::begin(peerPlayers), std::end(peerPlayers), -1);
+		byName.clear();
+		byUid.clear();
+		byIp.clear();
+		count = 0;
+	}
+
+	const PlayerRecord* PlayerDirectory::Get(int playerIndex) const
+	{
+		if (playerIndex < 0 || playerIndex >= Blam::Network::MaxPlayers || !active[playerIndex])
+			return nullptr;
+		return &players[playerIndex];
+	}
+
+	int PlayerDirectory::FindByPeer(int peerIndex) const
+	{
+		if (peerIndex < 0 || peerIndex >= Blam::Network::MaxPeers)
+			return -1;
+		return peerPlayers[peerIndex];
+	}
+
+	std::vector<int> PlayerDirectory::FindByName(const std::string &name) const
+	{
+		return FindIndices(byName, FoldPlayerName(name));
+	}
+
+	int PlayerDirectory::FindByExactName(const std::string &name) const
+	{
+		for (auto playerIdx : FindByName(name))
+		{
+			if (players[playerIdx].Name == name)
+				return playerIdx;
+		}
+		return -1;
+	}
+
+	int PlayerDirectory::FindFirstByName(const std::string &name) const
+	{
+		auto exact = FindByExactName(name);
+		if (exact >= 0)
+			return exact;
+		auto indices = FindByName(name);
+		return indices.empty() ? -1 : indices[0];
+	}
+
+	std::vector<int> PlayerDirectory::FindByNamePrefix(const std::string &prefix) const
+	{
+		std::vector<int> result;
+		auto folded = FoldPlayerName(prefix);
+		for (auto it = byName.lower_bound(folded); it != byName.end() && it->first.compare(0, folded.length(), folded) == 0; ++it)
+			result.push_back(it->second);
+		std::sort(result.begin(), result.end());
+		return result;
+	}
+
+	std::vector<int> PlayerDirectory::FindByFuzzyName(const std::string &name, int maxDistance) const
+	{
+		std::vector<std::pair<int, int>> matches; // (distance, player index)
+		auto folded = FoldPlayerName(name);
+		for (auto i = 0; i < Blam::Network::MaxPlayers; i++)
+		{
+			if (!active[i])
+				continue;
+			auto distance = GetEditDistance(folded, players[i].FoldedName, maxDistance);
+			if (distance <= maxDistance)
+				matches.emplace_back(distance, i);
+		}
+		std::sort(matches.begin(), matches.end());
+
+		std::vector<int> result;
+		for (auto &match : matches)
+			result.push_back(match.second);
+		return result;
+	}
+
+	std::vector<int> PlayerDirectory::FindByUid(uint64_t uid) const
+	{
+		return FindIndices(byUid, uid);
+	}
+
+	std::vector<int> PlayerDirectory::FindByIp(const std::string &ip) const
+	{
+		return FindIndices(byIp, ip);
+	}
+
+	std::string FoldPlayerName(const std::string &name)
+	{
+		auto wide = Utils::String::WidenString(name);
+		std::transform(wide.begin(), wide.end(), wide.begin(), ::towlower);
+		return Utils::String::ThinString(wide);
+	}
+}
+
+namespace
+{
+	template<typename Map, typename Key>
+	void EraseIndex(Map &map, const Key &key, int playerIndex)
+	{
+		auto range = map.equal_range(key);
+		for (auto it = range.first; it != range.second; ++it)
+		{
+			if (it->second == playerIndex)
+			{
+				map.erase(it);
+				return;
+			}
+		}
+	}
+
+	template<typename Map, typename Key>
+	std::vector<int> FindIndices(const Map &map, const Key &key)
+	{
+		std::vector<int> result;
+		auto range = map.equal_range(key);
+		for (auto it = range.first; it != range.second; ++it)
+			result.push_back(it->second);
+		std::sort(result.begin(), result.end());
+		return result;
+	}
+
+	// Levenshtein distance, stopping early once it must be over maxDistance
+	int GetEditDistance(const std::string &a, const std::string &b, int maxDistance)
+	{
+		auto lengthDifference = static_cast<int>(a.length()) - static_cast<int>(b.length());
+		if (std::abs(lengthDifference) > maxDistance)
+			return maxDistance + 1;
+
+		std::vector<int> previous(b.length() + 1), current(b.length() + 1);
+		for (size_t j = 0; j <= b.length(); j++)
+			previous[j] = static_cast<int>(j);
+		for (size_t i = 1; i <= a.length(); i++)
+		{
+			current[0] = static_cast<int>(i);
+			auto rowMin = current[0];
+			for (size_t j = 1; j <= b.length(); j++)
+			{
+				auto substitution = previous[j - 1] + (a[i - 1] == b[j - 1] ? 0 : 1);
+				current[j] = std::min({ previous[j] + 1, current[j - 1] + 1, substitution });
+				rowMin = std::min(rowMin, current[j]);
+			}
+			if (rowMin > maxDistance)
+				return maxDistance + 1;
+			std::swap(previous, current);
+		}
+		return previous[b.length()];
+	}
+}
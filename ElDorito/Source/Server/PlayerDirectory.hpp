@@ -0,0 +1,102 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "../Blam/BlamNetwork.hpp"
+#include "../Utils/Singleton.hpp"
+
+namespace Server
+{
+	// A player in the directory.
+	struct PlayerRecord
+	{
+		int PlayerIndex;
+		int PeerIndex;
+		uint64_t Uid;
+		std::wstring DisplayName; // As it appears in the membership data
+		std::string Name;
+		std::string FoldedName;   // Lowercase, for case-insensitive lookups
+		std::string Ip;
+	};
+
+	// Indexes the players in the session by name, UID, IP and peer so that
+	// admin commands don't have to walk the membership data for every
+	// lookup. The directory is kept in sync with the session once per tick,
+	// and only slots whose player changed are re-indexed. Checking a slot
+	// only compares raw values, so a tick where nothing changed doesn't
+	// build any strings.
+	//
+	// Queries return player indices in ascending order unless noted.
+	class PlayerDirectory : public Utils::Singleton<PlayerDirectory>
+	{
+	public:
+		PlayerDirectory();
+
+		// Updates the directory to match a session's membership. If the
+		// session is null or not established, the directory is cleared.
+		void Sync(const Blam::Network::Session *session);
+
+		// Adds a player, replacing anyone already in their slot.
+		void Join(const PlayerRecord &record);
+
+		// Removes a player. Does nothing if the slot is empty.
+		void Leave(int playerIndex);
+
+		// Removes every player.
+		void Clear();
+
+		// Gets the number of players in the directory.
+		int GetCount() const { return count; }
+
+		// Gets the player in a slot, or null if the slot is empty.
+		const PlayerRecord* Get(int playerIndex) const;
+
+		// Gets the player using a peer, or -1 if none.
+		int FindByPeer(int peerIndex) const;
+
+		// Finds players whose name matches, ignoring case.
+		std::vector<int> FindByName(const std::string &name) const;
+
+		// Finds a player whose name matches exactly, including case.
+		// Returns -1 if nobody matches.
+		int FindByExactName(const std::string &name) const;
+
+		// Finds a player by name, preferring an exact match over one which
+		// only differs in case. Returns -1 if nobody matches.
+		int FindFirstByName(const std::string &name) const;
+
+		// Finds players whose name starts with a prefix, ignoring case.
+		std::vector<int> FindByNamePrefix(const std::string &prefix) const;
+
+		// Finds players whose name is within an edit distance of a name,
+		// ignoring case. Results are sorted by distance, closest first.
+		std::vector<int> FindByFuzzyName(const std::string &name, int maxDistance) const;
+
+		// Finds players with a UID.
+		std::vector<int> FindByUid(uint64_t uid) const;
+
+		// Finds players connecting from an IP address.
+		std::vector<int> FindByIp(const std::string &ip) const;
+
+	private:
+		PlayerRecord players[Blam::Network::MaxPlayers];
+		bool active[Blam::Network::MaxPlayers];
+		int peerPlayers[Blam::Network::MaxPeers];
+		int count;
+
+		// The raw IPv4 address each player's Ip was formatted from by Sync, or
+		// UnsyncedAddress if the player was added some other way
+		uint64_t syncedAddresses[Blam::Network::MaxPlayers];
+
+		// Sorted so that prefix queries can use a range
+		std::multimap<std::string, int> byName;
+		std::unordered_multimap<uint64_t, int> byUid;
+		std::unordered_multimap<std::string, int> byIp;
+	};
+
+	// Folds a name for case-insensitive comparisons.
+	std::string FoldPlayerName(const std::string &name);
+}
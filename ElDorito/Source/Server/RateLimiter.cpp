@@ -0,0 +1,98 @@
+#include "RateLimiter.hpp"
+
+#include <cstring>
+#include <Windows.h>
+
+namespace
+{
+	uint64_t DefaultClock()
+	{
+		return GetTickCount64();
+	}
+}
+
+namespace Server
+{
+	RateLimiter::RateLimiter() : clock(DefaultClock)
+	{
+		memset(limits, 0, sizeof(limits));
+		Reset();
+	}
+
+	void RateLimiter::SetClock(ClockFunc clock)
+	{
+		this->clock = clock ? clock : DefaultClock;
+		Reset();
+	}
+
+	void RateLimiter::SetLimit(RateLimitClass type, const RateLimit &limit)
+	{
+		limits[static_cast<int>(type)] = limit;
+	}
+
+	const RateLimit& RateLimiter::GetLimit(RateLimitClass type) const
+	{
+		return limits[static_cast<int>(type)];
+	}
+
+	RateLimitResult RateLimiter::Consume(int slot, uint64_t uid, RateLimitClass type, uint32_t cost, uint32_t *timeoutRemainingMs)
+	{
+		if (slot < 0 || slot >= MaxRateLimitSlots || type >= RateLimitClass::Count)
+			return RateLimitResult::Limited;
+
+		auto &limit = limits[static_cast<int>(type)];
+		if (!limit.IntervalMs)
+			return RateLimitResult::Allowed;
+
+		auto now = clock();
+		auto &bucket = buckets[slot][static_cast<int>(type)];
+		if (bucket.Uid != uid)
+		{
+			// A different player is using the slot now
+			memset(&bucket, 0, sizeof(bucket));
+			bucket.Uid = uid;
+		}
+
+		if (now < bucket.TimeoutEndMs)
+		{
+			if (timeoutRemainingMs)
+				*timeoutRemainingMs = static_cast<uint32_t>(bucket.TimeoutEndMs - now);
+			return RateLimitResult::TimedOut;
+		}
+
+		// The bucket is tracked as the time at which it will be full again,
+		// so refilling doesn't need to be done periodically
+		auto debtEnd = (bucket.DebtEndMs > now ? bucket.DebtEndMs : now) + static_cast<uint64_t>(cost) * limit.IntervalMs;
+		if (debtEnd - now <= static_cast<uint64_t>(limit.Burst) * limit.IntervalMs)
+		{
+			bucket.DebtEndMs = debtEnd;
+			return RateLimitResult::Allowed;
+		}
+
+		if (!limit.TimeoutMs)
+			return RateLimitResult::Limited;
+
+		// If the sender had a previous timeout that hasn't been reset yet, double it, otherwise start with the default
+		if (bucket.NextTimeoutMs > 0 && now < bucket.TimeoutResetMs)
+			bucket.NextTimeoutMs *= 2;
+		else
+			bucket.NextTimeoutMs = limit.TimeoutMs;
+
+		bucket.TimeoutEndMs = now + bucket.NextTimeoutMs;
+		bucket.TimeoutResetMs = bucket.TimeoutEndMs + limit.TimeoutResetMs;
+		if (timeoutRemainingMs)
+			*timeoutRemainingMs = bucket.NextTimeoutMs;
+		return RateLimitResult::TimedOut;
+	}
+
+	void RateLimiter::Reset(RateLimitClass type)
+	{
+		for (auto slot = 0; slot < MaxRateLimitSlots; slot++)
+			memset(&buckets[slot][static_cast<int>(type)], 0, sizeof(Bucket));
+	}
+
+	void RateLimiter::Reset()
+	{
+		memset(buckets, 0, sizeof(buckets));
+	}
+}
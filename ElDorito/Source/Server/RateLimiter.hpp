@@ -0,0 +1,99 @@
+#pragma once
+
+#include <cstdint>
+#include "../Blam/BlamNetwork.hpp"
+#include "../Utils/Singleton.hpp"
+
+namespace Server
+{
+	// Classes of messages which are rate limited separately.
+	enum class RateLimitClass
+	{
+		Chat, // Team and global chat share a bucket
+		Vote,
+		Rcon,
+
+		Count
+	};
+
+	// The result of trying to spend tokens from a bucket.
+	enum class RateLimitResult
+	{
+		// The message is allowed.
+		Allowed,
+
+		// The message would exceed the limit and should be thrown out.
+		Limited,
+
+		// The sender is timed out and the message should be thrown out.
+		TimedOut,
+	};
+
+	// Rate limit settings for a message class.
+	struct RateLimit
+	{
+		// The maximum number of tokens which can be spent in a burst.
+		uint32_t Burst;
+
+		// The number of milliseconds it takes to regain one token. 0 disables the limit.
+		uint32_t IntervalMs;
+
+		// The length of the first timeout when the limit is exceeded. 0 disables timeouts.
+		uint32_t TimeoutMs;
+
+		// The time after a timeout ends before the next timeout length is reset.
+		uint32_t TimeoutResetMs;
+	};
+
+	// The bucket slot which rcon connections share.
+	const int RconRateLimitSlot = Blam::Network::MaxPeers;
+
+	// The number of bucket slots: one per peer plus the rcon slot.
+	const int MaxRateLimitSlots = Blam::Network::MaxPeers + 1;
+
+	// Token bucket rate limiter with fixed-size buckets indexed by slot and
+	// message class. A bucket is reset whenever the UID using its slot
+	// changes, so a peer index being reused doesn't inherit the previous
+	// player's state. Checks are O(1) and never allocate.
+	class RateLimiter : public Utils::Singleton<RateLimiter>
+	{
+	public:
+		// Returns the current time in milliseconds.
+		typedef uint64_t(*ClockFunc)();
+
+		RateLimiter();
+
+		// Overrides the clock used to refill buckets.
+		void SetClock(ClockFunc clock);
+
+		// Sets the rate limit for a message class.
+		void SetLimit(RateLimitClass type, const RateLimit &limit);
+
+		// Gets the rate limit for a message class.
+		const RateLimit& GetLimit(RateLimitClass type) const;
+
+		// Tries to spend tokens from a slot's bucket. If the sender is timed
+		// out, timeoutRemainingMs receives the time until they can send again.
+		RateLimitResult Consume(int slot, uint64_t uid, RateLimitClass type, uint32_t cost = 1, uint32_t *timeoutRemainingMs = nullptr);
+
+		// Resets every bucket of a message class.
+		void Reset(RateLimitClass type);
+
+		// Resets every bucket.
+		void Reset();
+
+	private:
+		struct Bucket
+		{
+			uint64_t Uid;             // The UID which owns the bucket.
+			uint64_t DebtEndMs;       // The time at which the bucket will be full again.
+			uint64_t TimeoutEndMs;    // The time at which the current timeout ends.
+			uint64_t TimeoutResetMs;  // The time at which the next timeout length is reset.
+			uint32_t NextTimeoutMs;   // The length of the next timeout (0 = default).
+		};
+
+		ClockFunc clock;
+		RateLimit limits[static_cast<int>(RateLimitClass::Count)];
+		Bucket buckets[MaxRateLimitSlots][static_cast<int>(RateLimitClass::Count)];
+	};
+}
@@ -3,8 +3,12 @@
 #pragma warning (disable : 4996)
 
 #include "Rcon.hpp"
+#include "RateLimiter.hpp"
 
 #include <algorithm>
+#include <atomic>
+#include <deque>
+#include <mutex>
 #include <set>
 #include <websocketpp/server.hpp>
 #include <Windows.h>
@@ -30,15 +34,31 @@ namespace
 	void ProcessCommand(server* rconServer, websocketpp::connection_hdl hdl, server::message_ptr msg);
 	void ProcessPassword(server* rconServer, websocketpp::connection_hdl hdl, server::message_ptr msg);
 	void OnClose(server* rconServer, websocketpp::connection_hdl hdl);
-	void OnTimer(server* rconServer, websocketpp::lib::error_code const & ec);
+	void SendToConnection(websocketpp::connection_hdl hdl, const std::string &message);
+	void FlushOutboundMessages();
 	std::set<websocketpp::connection_hdl, std::owner_less<websocketpp::connection_hdl>> authenticatedConnections;
-	std::vector<std::string> sendThroughWebsocket = std::vector <std::string>{};
+	std::atomic<bool> serverRunning(false);
 
+	// Commands received on the rcon thread, waiting to be run on the game thread
+	struct PendingCommand
+	{
+		websocketpp::connection_hdl Connection;
+		std::string Command;
+	};
+	std::mutex commandMutex;
+	std::deque<PendingCommand> pendingCommands;
+	const size_t MaxPendingCommands = 64;
+
+	// Messages for every authenticated client, sent from the rcon thread
+	std::mutex outboundMutex;
+	std::vector<std::string> outboundMessages;
+	bool outboundFlushPending = false;
 
 	const int DefaultPasswordLength = 32;
 	const char* ProtocolName = "dew-rcon";
 	const char* AcceptMessage = "accept";
 	const char* DenyMessage = "deny";
+	const char* QueueFullMessage = "Command queue is full";
 }
 
 namespace Server::Rcon
@@ -54,8 +74,43 @@ namespace Server::Rcon
 		}
 		CreateThread(nullptr, 0, RconThread, nullptr, 0, nullptr);
 	}
-	void SendMessageToClients(std::string message) {
-		sendThroughWebsocket.push_back(message);
+
+	void Tick()
+	{
+		std::deque<PendingCommand> commands;
+		{
+			std::lock_guard<std::mutex> lock(commandMutex);
+			commands.swap(pendingCommands);
+		}
+
+		for (auto &command : commands)
+		{
+			std::string output;
+			if (Server::RateLimiter::Instance().Consume(Server::RconRateLimitSlot, 0, Server::RateLimitClass::Rcon) != Server::RateLimitResult::Allowed)
+				output = "Rate limit exceeded";
+			else
+				output = Modules::CommandMap::Instance().ExecuteCommand(command.Command, true);
+
+			// Replies are sent from the rcon thread so they stay in order with other outgoing messages
+			auto hdl = command.Connection;
+			rconServer.get_io_service().post([hdl, output]() { SendToConnection(hdl, output); });
+		}
+	}
+
+	void SendMessageToClients(std::string message)
+	{
+		if (!serverRunning)
+			return;
+
+		std::lock_guard<std::mutex> lock(outboundMutex);
+		outboundMessages.push_back(std::move(message));
+
+		// Only one flush needs to be queued at a time, it will pick up anything added before it runs
+		if (!outboundFlushPending)
+		{
+			outboundFlushPending = true;
+			rconServer.get_io_service().post(FlushOutboundMessages);
+		}
 	}
 }
 
@@ -83,12 +138,13 @@ namespace
 			rconServer.set_validate_handler(websocketpp::lib::bind(OnValidate, &rconServer, _1));
 			rconServer.set_message_handler(websocketpp::lib::bind(OnMessage, &rconServer, _1, _2));
 			rconServer.set_close_handler(websocketpp::lib::bind(OnClose, &rconServer, _1));
-			rconServer.set_timer(1000, websocketpp::lib::bind(OnTimer, &rconServer, _1));
 
 			auto port = Modules::ModuleGame::Instance().VarRconPort->ValueInt;
 			rconServer.listen(static_cast<uint16_t>(port));
 			rconServer.start_accept();
+			serverRunning = true;
 			rconServer.run();
+			serverRunning = false;
 		}
 		catch (websocketpp::exception const& e)
 		{
@@ -123,22 +179,43 @@ namespace
 			Utils::Logger::Instance().Log(Utils::LogTypes::Network, Utils::LogLevel::Error, "websocketpp: %s", e.message());
 		}
 	}
-	void OnTimer(server* rconServer, websocketpp::lib::error_code const & ec)
-	{
 
-		for (auto it : authenticatedConnections) {
-			for (auto m : sendThroughWebsocket) {
-				rconServer->send(it, m, websocketpp::frame::opcode::text);
+	void ProcessCommand(server* rconServer, websocketpp::connection_hdl hdl, server::message_ptr msg)
+	{
+		// Commands can't be run here because the game thread could be using the same state,
+		// so they're queued up for Server::Rcon::Tick() instead
+		{
+			std::lock_guard<std::mutex> lock(commandMutex);
+			if (pendingCommands.size() < MaxPendingCommands)
+			{
+				pendingCommands.push_back({ hdl, msg->get_payload() });
+				return;
 			}
 		}
-		sendThroughWebsocket.clear();
-		
-		rconServer->set_timer(1000, websocketpp::lib::bind(OnTimer, rconServer, _1));
+		rconServer->send(hdl, QueueFullMessage, websocketpp::frame::opcode::TEXT);
 	}
-	void ProcessCommand(server* rconServer, websocketpp::connection_hdl hdl, server::message_ptr msg)
+
+	void SendToConnection(websocketpp::connection_hdl hdl, const std::string &message)
 	{
-		auto output = Modules::CommandMap::Instance().ExecuteCommand(msg->get_payload(), true);
-		rconServer->send(hdl, output, websocketpp::frame::opcode::TEXT);
+		// The connection may have been closed while the message was waiting
+		websocketpp::lib::error_code ec;
+		rconServer.send(hdl, message, websocketpp::frame::opcode::TEXT, ec);
+	}
+
+	void FlushOutboundMessages()
+	{
+		std::vector<std::string> messages;
+		{
+			std::lock_guard<std::mutex> lock(outboundMutex);
+			messages.swap(outboundMessages);
+			outboundFlushPending = false;
+		}
+
+		for (auto &connection : authenticatedConnections)
+		{
+			for (auto &message : messages)
+				SendToConnection(connection, message);
+		}
 	}
 
 	void ProcessPassword(server* rconServer, websocketpp::connection_hdl hdl, server::message_ptr msg)
@@ -4,4 +4,7 @@ namespace Server::Rcon
 {
 	void SendMessageToClients(std::string message);
 	void Initialize();
+
+	// Runs commands received from rcon clients. Must be called from the game thread.
+	void Tick();
 }
@@ -2,12 +2,14 @@
 
 #include "ServerChat.hpp"
 #include "Rcon.hpp"
+#include "RateLimiter.hpp"
+#include "ChatLogWriter.hpp"
+#include "../Patches/Core.hpp"
 #include "../Patches/CustomPackets.hpp"
 #include "../Modules/ModuleServer.hpp"
 #include "../Modules/ModuleGame.hpp"
 #include "../Utils/String.hpp"
-#include <unordered_map>
-#include <fstream>
+#include "../Utils/Logger.hpp"
 #include <chrono>
 #include <iomanip>
 #include <Windows.h>
@@ -21,25 +23,15 @@ namespace
 
 	std::shared_ptr<ChatMessagePacketSender> PacketSender;
 
+	// Lines beyond this are dropped rather than making the game wait on the disk
+	const size_t MaxQueuedChatLogLines = 4096;
+	const uint32_t ChatLogFlushIntervalMs = 1000;
+	ChatLogWriter ChatLog(MaxQueuedChatLogLines, ChatLogFlushIntervalMs);
+	bool ChatLogOverflowing = false;
+
 	bool HostReceivedMessage(Blam::Network::Session *session, int peer, const ChatMessage &message);
 	void ClientReceivedMessage(const ChatMessage &message);
 
-	struct ClientSpamStats
-	{
-		ClientSpamStats() : SpamScore(0), TimeoutSeconds(0), NextTimeoutSeconds(0), TimeoutResetSeconds(0) {}
-
-		int SpamScore;           // Decreased by 1 each second.
-		int TimeoutSeconds;      // The number of seconds that the client is timed out for.
-		int NextTimeoutSeconds;  // The length of the next timeout period in seconds (0 = default).
-		int TimeoutResetSeconds; // The number of seconds remaining before the next timeout length is reset.
-	};
-
-	// Maps IP addresses to spam statistics.
-	std::unordered_map<uint32_t, ClientSpamStats> SpamStats;
-
-	DWORD LastTimeMs;   // The time, in milliseconds, of the last tick.
-	DWORD SpamUpdateMs; // Number of milliseconds since the last spam score decrement.
-
 	// Packet handler for chat messages.
 	class ChatMessagePacketHandler: public Patches::CustomPackets::PacketHandler<ChatMessage>
 	{
@@ -193,7 +185,7 @@ namespace
 	}
 
 	// Calculates the spam score of a message.
-	int CalculateSpamScore(uint32_t ip, ClientSpamStats *stats, const ChatMessage &message)
+	int CalculateSpamScore(const ChatMessage &message)
 	{
 		// Compute a score between the short and long scores based on the message length
 		// Messages which are closer to the maximum length will have a score closer to the maximum score
@@ -206,41 +198,23 @@ namespace
 	// Checks a message against the flood filter and returns true if it should be thrown out.
 	bool FloodFilterMessage(Blam::Network::Session *session, int peer, const ChatMessage &message)
 	{
-		// Increase the IP's spam score and put it in timeout if it exceeds the maximum
-		auto ip = session->GetPeerAddress(peer).Address.IPv4;
-		auto spamIt = SpamStats.find(ip);
-		if (spamIt == SpamStats.end())
-			spamIt = SpamStats.insert({ ip, ClientSpamStats() }).first;
-		if (spamIt->second.TimeoutSeconds <= 0)
-		{
-			// Calculate the message's spam score and add it to the IP's total score
-			auto score = CalculateSpamScore(ip, &spamIt->second, message);
-			spamIt->second.SpamScore += score;
+		uint64_t uid = 0;
+		auto playerIndex = session->MembershipInfo.GetPeerPlayer(peer);
+		if (playerIndex >= 0)
+			uid = session->MembershipInfo.PlayerSessions[playerIndex].Properties.Uid;
 
-			// If the total score reached the timeout score, then start a timeout
-			auto &serverModule = Modules::ModuleServer::Instance();
-			if (spamIt->second.SpamScore >= static_cast<int>(serverModule.VarFloodTimeoutScore->ValueInt))
-			{
-				// If the IP had a previous timeout that hasn't been reset yet, double it, otherwise start with the default
-				if (spamIt->second.NextTimeoutSeconds > 0)
-					spamIt->second.NextTimeoutSeconds *= 2;
-				else
-					spamIt->second.NextTimeoutSeconds = serverModule.VarFloodTimeoutSeconds->ValueInt;
-
-				spamIt->second.TimeoutSeconds = spamIt->second.NextTimeoutSeconds;
-				spamIt->second.TimeoutResetSeconds = serverModule.VarFloodTimeoutResetSeconds->ValueInt;
-			}
-		}
+		// Spend the message's spam score from the player's bucket, which refills by 1 each second
+		uint32_t timeoutMs = 0;
+		auto result = Server::RateLimiter::Instance().Consume(peer, uid, Server::RateLimitClass::Chat, CalculateSpamScore(message), &timeoutMs);
+		if (result == Server::RateLimitResult::Allowed)
+			return false;
 
-		// If the IP is in a timeout state, send an error and return
-		if (spamIt->second.TimeoutSeconds > 0)
-		{
-			PeerBitSet targetPeers;
-			targetPeers.set(peer);
-			SendServerMessage("You have exceeded the server's spam limit. You can chat again in " + std::to_string(spamIt->second.TimeoutSeconds) + " second(s).", targetPeers);
-			return true;
-		}
-		return false;
+		// If the player is in a timeout state, send an error and return
+		if (result == Server::RateLimitResult::TimedOut)
+			SendServerMessage("You have exceeded the server's spam limit. You can chat again in " + std::to_string((timeoutMs + 999) / 1000) + " second(s).", peer);
+		else
+			SendServerMessage("You have exceeded the server's spam limit.", peer);
+		return true;
 	}
 
 	// Writes a message to the log file.
@@ -283,14 +257,20 @@ namespace
 		if (!serverModule.VarChatLogEnabled->ValueInt)
 			return;
 
-		// Try to open the log file for appending
-		auto chatLogFile = Modules::ModuleServer::Instance().VarChatLogFile->ValueString;
-		std::ofstream logFile(chatLogFile, std::ios::app);
-		if (!logFile)
-			return;
-
-		logFile << GetLogString(session,peer, message) << "\n";
-
+		ChatLogOptions options;
+		options.Path = serverModule.VarChatLogFile->ValueString;
+		options.MaxFileSize = static_cast<uint64_t>(serverModule.VarChatLogMaxSize->ValueInt) * 1024;
+		options.RotateDaily = serverModule.VarChatLogRotateDaily->ValueInt != 0;
+		if (ChatLog.Queue(options, GetLogString(session, peer, message), std::time(nullptr)))
+		{
+			ChatLogOverflowing = false;
+		}
+		else if (!ChatLogOverflowing)
+		{
+			// Only warn once each time the queue fills up. The log itself notes how many lines were lost.
+			Utils::Logger::Instance().Log(Utils::LogTypes::Game, Utils::LogLevel::Warning, "Chat log queue is full, dropping lines");
+			ChatLogOverflowing = true;
+		}
 	}
 
 	// Callback for when a message is received as the host.
@@ -365,50 +345,12 @@ namespace Server::Chat
 {
 	void Initialize()
 	{
-		LastTimeMs = timeGetTime();
-
 		// Register custom packet type
 		auto handler = std::make_shared<ChatMessagePacketHandler>();
 		PacketSender = Patches::CustomPackets::RegisterPacket<ChatMessage>("eldewrito-text-chat", handler);
-	}
-
-	void Tick()
-	{
-		// Compute the time delta (the game also uses timeGetTime in its various subsystems to do this)
-		auto currentTimeMs = timeGetTime();
-		auto timeDeltaMs = currentTimeMs - LastTimeMs;
-		LastTimeMs = currentTimeMs;
-
-		// Update the flood filter for each second that has passed since the last flood filter update
-		SpamUpdateMs += timeDeltaMs;
-		while (SpamUpdateMs >= 1000)
-		{
-			SpamUpdateMs -= 1000;
-
-			// Decrease each spam score and timeout, and remove empty structures to save memory
-			auto it = SpamStats.begin();
-			while (it != SpamStats.end())
-			{
-				auto nextIt = it;
-				++nextIt;
-
-				if (it->second.SpamScore > 0)
-					it->second.SpamScore--;
 
-				if (it->second.TimeoutSeconds > 0)
-					it->second.TimeoutSeconds--;
-				else if (it->second.TimeoutResetSeconds > 0)
-					it->second.TimeoutResetSeconds--; // Only decrement the timeout reset if no timeout is active
-
-				if (it->second.TimeoutResetSeconds == 0)
-					it->second.NextTimeoutSeconds = 0;
-
-				if (it->second.TimeoutSeconds <= 0 && it->second.SpamScore <= 0 && it->second.TimeoutResetSeconds <= 0)
-					SpamStats.erase(it);
-
-				it = nextIt;
-			}
-		}
+		// Make sure the chat log is written out before the game exits
+		Patches::Core::OnShutdown([]() { ChatLog.Stop(); });
 	}
 
 	bool SendGlobalMessage(const std::string &body)
@@ -1,6 +1,8 @@
 #include <WS2tcpip.h>
 #include <fstream>
 #include "Stats.hpp"
+#include "StatsSnapshot.hpp"
+#include "StatsSpool.hpp"
 #include "../Blam/BlamEvents.hpp"
 #include "../Blam/BlamNetwork.hpp"
 #include "../Patches/Events.hpp"
@@ -13,7 +15,9 @@
 #include "../ThirdParty/HttpRequest.hpp"
 #include "../ThirdParty/rapidjson/document.h"
 #include "../Patches/Network.hpp"
+#include <cwchar>
 #include <iomanip>
+#include <sstream>
 
 
 namespace Server::Stats
@@ -22,6 +26,9 @@ namespace Server::Stats
 	//If we wait for the submit-stats lifecycle state to fire, some of the scores are already reset to 0.
 	time_t sendStatsTime = 0;
 
+	//Submissions wait here until the stats servers have accepted them
+	const char STATS_SPOOL_DIR[] = "mods/server/stats/";
+
 	std::string playersInfoEndpoint;
 	int numberOfRounds = 1;
 	// retrieves master server endpoints from dewrito.json
@@ -161,6 +168,7 @@ namespace Server::Stats
 				return false;
 			}
 			Modules::ModuleServer::Instance().VarPlayersInfo->ValueString = resp;
+			Modules::CommandMap::Instance().MarkChanged(Modules::ModuleServer::Instance().VarPlayersInfo);
 
 		}
 		catch (...)
@@ -171,44 +179,43 @@ namespace Server::Stats
 		return true;
 	}
 
-	DWORD WINAPI CommandServerAnnounceStats_Thread(LPVOID lpParam)
+	//Sends a stats submission and checks whether the server accepted it
+	StatsSpool::SendResult SendStats(const std::string &url, const std::string &body)
 	{
+		HttpRequest req(L"ElDewrito/" + Utils::String::WidenString(Utils::Version::GetVersionString()), L"", L"");
+		if (!req.SendRequest(Utils::String::WidenString(url), L"POST", L"", L"", L"Content-Type: application/json\r\n", (void*)body.c_str(), body.length()))
+		{
+			Utils::Logger::Instance().Log(Utils::LogTypes::Network, Utils::LogLevel::Info, "Unable to connect to stats server " + url);
+			return StatsSpool::SendResult::Retry;
+		}
 
-		auto* session = Blam::Network::GetActiveSession();
-		if (Blam::Network::GetLobbyType() != 2 || Blam::Network::GetNetworkMode() != 3)
-			return false;
+		// The status line looks like "HTTP/1.1 200 OK"
+		auto statusStart = req.responseHeader.find(L' ');
+		auto status = statusStart != std::wstring::npos ? static_cast<int>(std::wcstol(req.responseHeader.c_str() + statusStart + 1, nullptr, 10)) : 0;
+		auto result = GetSendResult(status);
+		if (result != StatsSpool::SendResult::Delivered)
+			Utils::Logger::Instance().Log(Utils::LogTypes::Network, Utils::LogLevel::Info, "Stats server " + url + " returned status " + std::to_string(status));
+		return result;
+	}
 
-		std::vector<std::string> statsEndpoints;
-		GetStatsEndpoints(statsEndpoints);
+	StatsSpool spool(STATS_SPOOL_DIR, SendStats, 5 * 1000, 10 * 60 * 1000, 200);
 
-		if (statsEndpoints.size() == 0) {
+	//Reads everything that gets submitted to the stats servers out of game memory. This has to run on the game thread.
+	bool CaptureSnapshot(GameSnapshot *snapshot)
+	{
+		auto* session = Blam::Network::GetActiveSession();
+		if (Blam::Network::GetLobbyType() != 2 || Blam::Network::GetNetworkMode() != 3)
 			return false;
-		}
-		
 
-		rapidjson::StringBuffer s;
-		rapidjson::Writer<rapidjson::StringBuffer> writer(s);
-		writer.StartObject();
-		writer.Key("gameVersion");
-		writer.String(Utils::Version::GetVersionString().c_str());
-		writer.Key("serverName");
-		writer.String(Modules::ModuleServer::Instance().VarServerName->ValueString.c_str());
-		writer.Key("serverPort");
-		writer.Int(Modules::ModuleServer::Instance().VarServerPort->ValueInt);
-		writer.Key("port");
-		writer.Int(Pointer(0x1860454).Read<uint32_t>());
-		writer.Key("hostPlayer");
-		writer.String(Modules::ModulePlayer::Instance().VarPlayerName->ValueString.c_str());
-
-		writer.Key("game");
-		writer.StartObject();
+		snapshot->GameVersion = Utils::Version::GetVersionString();
+		snapshot->ServerName = Modules::ModuleServer::Instance().VarServerName->ValueString;
+		snapshot->ServerPort = Modules::ModuleServer::Instance().VarServerPort->ValueInt;
+		snapshot->Port = Pointer(0x1860454).Read<uint32_t>();
+		snapshot->HostPlayer = Modules::ModulePlayer::Instance().VarPlayerName->ValueString;
 
-		writer.Key("sprintEnabled");
-		writer.Bool(Modules::ModuleServer::Instance().VarServerSprintEnabled->ValueInt != 0);
-		writer.Key("sprintUnlimitedEnabled");
-		writer.Bool(Modules::ModuleServer::Instance().VarServerSprintUnlimited->ValueInt != 0);
-		writer.Key("maxPlayers");
-		writer.Int(Modules::ModuleServer::Instance().VarServerMaxPlayers->ValueInt);
+		snapshot->SprintEnabled = Modules::ModuleServer::Instance().VarServerSprintEnabled->ValueInt != 0;
+		snapshot->SprintUnlimitedEnabled = Modules::ModuleServer::Instance().VarServerSprintUnlimited->ValueInt != 0;
+		snapshot->MaxPlayers = Modules::ModuleServer::Instance().VarServerMaxPlayers->ValueInt;
 
 		std::string mapName((char*)Pointer(0x22AB018)(0x1A4));
 		std::wstring mapVariantName((wchar_t*)Pointer(0x1863ACA));
@@ -227,25 +234,17 @@ namespace Server::Stats
 			}
 		}
 
-		writer.Key("mapName");
-		writer.String(Utils::String::ThinString(mapVariantName).c_str());
-		writer.Key("mapFile");
-		writer.String(mapName.c_str());
-		writer.Key("variant");
-		writer.String(Utils::String::ThinString(variantName).c_str());
+		snapshot->MapName = Utils::String::ThinString(mapVariantName);
+		snapshot->MapFile = mapName;
+		snapshot->Variant = Utils::String::ThinString(variantName);
 		if (variantType >= 0 && variantType < Blam::GameTypeCount)
-		{
-			writer.Key("variantType");
-			writer.String(Blam::GameTypeNames[variantType].c_str());
-		}
-		uint32_t TeamMode = Pointer(0x019A6210).Read<uint32_t>();
-		writer.Key("teamGame");
-		writer.Bool(TeamMode != 0);
-		
-		if (TeamMode == 1){
-			writer.Key("teamScores");
-			writer.StartArray();
+			snapshot->VariantType = Blam::GameTypeNames[variantType];
 
+		uint32_t TeamMode = Pointer(0x019A6210).Read<uint32_t>();
+		snapshot->TeamGame = TeamMode != 0;
+		snapshot->HasTeamScores = TeamMode == 1;
+		if (TeamMode == 1)
+		{
 			auto engineGlobalsPtr = ElDorito::GetMainTls(0x48);
 			if (engineGlobalsPtr)
 			{
@@ -254,209 +253,127 @@ namespace Server::Stats
 				{
 					auto teamscore = engineGobals(t * 0x1A).Read<Blam::TEAM_SCORE>();
 					if (numberOfRounds > 1)
-						writer.Int(teamscore.TotalScore);
+						snapshot->TeamScores.push_back(teamscore.TotalScore);
 					else
-						writer.Int(teamscore.Score);
+						snapshot->TeamScores.push_back(teamscore.Score);
 				}
 			}
-			writer.EndArray();
 		}
-		writer.EndObject();
+
 		uint32_t playerInfoBase = 0x2162E08;
 		Pointer p(0x023F1724);
-		writer.Key("players");
-		writer.StartArray();
+		Pointer pvpBase(0x23F5A98);
 		int peerIdx = session->MembershipInfo.FindFirstPeer();
 		while (peerIdx != -1)
 		{
 			int playerIdx = session->MembershipInfo.GetPeerPlayer(peerIdx);
 			if (playerIdx != -1)
 			{
-
 				auto playerStats = Blam::Players::GetStats(playerIdx);
-				writer.StartObject();
 				auto* player = &session->MembershipInfo.PlayerSessions[playerIdx];
 
+				PlayerSnapshot playerSnapshot;
+
 				struct in_addr inAddr;
 				inAddr.S_un.S_addr = session->GetPeerAddress(peerIdx).ToInAddr();
 				char ipStr[INET_ADDRSTRLEN];
 				inet_ntop(AF_INET, &inAddr, ipStr, sizeof(ipStr));
 
-				uint16_t team = Pointer(playerInfoBase + (5696 * playerIdx) + 32).Read<uint16_t>();
-
 				char uid[17];
 				Blam::Players::FormatUid(uid, player->Properties.Uid);
 
-				Pointer pvpBase(0x23F5A98);
-
-				writer.Key("name");
-				writer.String(Utils::String::ThinString(player->Properties.DisplayName).c_str());
-				writer.Key("clientName");
-				writer.String(Utils::String::ThinString(player->Properties.ClientProperties.DisplayName).c_str());
-				writer.Key("serviceTag");
-				writer.String(Utils::String::ThinString(player->Properties.ServiceTag).c_str());
-				writer.Key("ip");
-				writer.String(ipStr);
-				writer.Key("team");
-				writer.Int(team);
-				writer.Key("playerIndex");
-				writer.Int(playerIdx);
-				writer.Key("uid");
-				writer.String(uid);
 				std::stringstream color;
 				color << "#" << std::setw(6) << std::setfill('0') << std::hex << player->Properties.Customization.Colors[Blam::Players::ColorIndices::Primary];
-				writer.Key("primaryColor");
-				writer.String(color.str().c_str());
-				writer.Key("playerGameStats");
-				writer.StartObject();
-				writer.Key("score");
-				writer.Int(playerStats.Score);
-				writer.Key("kills");
-				writer.Int(playerStats.Kills);
-				writer.Key("assists");
-				writer.Int(playerStats.Assists);
-				writer.Key("deaths");
-				writer.Int(playerStats.Deaths);
-				writer.Key("betrayals");
-				writer.Int(playerStats.Betrayals);
-				writer.Key("timeSpentAlive");
-				writer.Int(playerStats.TimeSpentAlive);
-				writer.Key("suicides");
-				writer.Int(playerStats.Suicides);
-				writer.Key("bestStreak");
-				writer.Int(playerStats.BestStreak);
-				writer.EndObject();
 
-				//MEDALS
-				writer.Key("playerMedals");
-				writer.StartArray();
+				playerSnapshot.Name = Utils::String::ThinString(player->Properties.DisplayName);
+				playerSnapshot.ClientName = Utils::String::ThinString(player->Properties.ClientProperties.DisplayName);
+				playerSnapshot.ServiceTag = Utils::String::ThinString(player->Properties.ServiceTag);
+				playerSnapshot.Ip = ipStr;
+				playerSnapshot.Team = Pointer(playerInfoBase + (5696 * playerIdx) + 32).Read<uint16_t>();
+				playerSnapshot.PlayerIndex = playerIdx;
+				playerSnapshot.Uid = uid;
+				playerSnapshot.PrimaryColor = color.str();
+
+				playerSnapshot.Score = playerStats.Score;
+				playerSnapshot.Kills = playerStats.Kills;
+				playerSnapshot.Assists = playerStats.Assists;
+				playerSnapshot.Deaths = playerStats.Deaths;
+				playerSnapshot.Betrayals = playerStats.Betrayals;
+				playerSnapshot.TimeSpentAlive = playerStats.TimeSpentAlive;
+				playerSnapshot.Suicides = playerStats.Suicides;
+				playerSnapshot.BestStreak = playerStats.BestStreak;
 
+				//MEDALS
 				for (int i = 0; i < Blam::Tags::Objects::MedalType::MedalCount; i++)
 				{
 					if (playerStats.Medals[i] > 0)
-					{
-						writer.StartObject();
-						writer.Key("medalName");
-						writer.String(Blam::Tags::Objects::MedalTypeNames[i].c_str());
-						writer.Key("count");
-						writer.Int(playerStats.Medals[i]);
-						writer.EndObject();
-					}
+						playerSnapshot.Medals.push_back({ Blam::Tags::Objects::MedalTypeNames[i], playerStats.Medals[i] });
 				}
 				//The sniper headshots medal is broken, so lets get it manually by grabbing the headshots from each sniper
 				uint16_t SniperRifleHeadshots = p((playerIdx * 0x438) + 0x1F6).Read<uint16_t>();
 				uint16_t BeamRifleHeadshots = p((playerIdx * 0x438) + 0x202).Read<uint16_t>();
-
-				writer.StartObject();
-				writer.Key("medalName");
-				writer.String("SniperHeadshots");
-				writer.Key("count");
-				writer.Int(SniperRifleHeadshots + BeamRifleHeadshots);
-				writer.EndObject();
-
-				writer.EndArray();
+				playerSnapshot.Medals.push_back({ "SniperHeadshots", SniperRifleHeadshots + BeamRifleHeadshots });
 
 				//WEAPONS
-				writer.Key("playerWeapons");
-				writer.StartArray();
 				for (int i = 0; i < Blam::Tags::Objects::DamageReportingType::DamageCount; i++)
 				{
-					if (playerStats.WeaponStats[i].Initialized == 1)
+					auto &weaponStats = playerStats.WeaponStats[i];
+					if (weaponStats.Initialized == 1)
 					{
-						writer.StartObject();
-						writer.Key("weaponName");
-						writer.String(Blam::Tags::Objects::DamageReportingTypeNames[i].c_str());
-						writer.Key("weaponIndex");
-						writer.Int(i + 1);
-						writer.Key("kills");
-						writer.Int(playerStats.WeaponStats[i].Kills);
-						writer.Key("killedBy");
-						writer.Int(playerStats.WeaponStats[i].KilledBy);
-						writer.Key("betrayalsWith");
-						writer.Int(playerStats.WeaponStats[i].BetrayalsWith);
-						writer.Key("suicidesWith");
-						writer.Int(playerStats.WeaponStats[i].SuicidesWith);
-						writer.Key("headshotsWith");
-						writer.Int(playerStats.WeaponStats[i].HeadshotsWith);
-
-						writer.EndObject();
+						playerSnapshot.Weapons.push_back({ Blam::Tags::Objects::DamageReportingTypeNames[i], i + 1, weaponStats.Kills, weaponStats.KilledBy,
+							weaponStats.BetrayalsWith, weaponStats.SuicidesWith, weaponStats.HeadshotsWith });
 					}
-
 				}
-				writer.EndArray();
-
-				writer.Key("otherStats");
-				writer.StartObject();
 
 				int nemesisIdx = 0;
 				uint16_t nemesisKills = 0;
-				int currentLocation = 0x02;
 				for (int loc = 0; loc < 16; loc++)
 				{
-					uint16_t currKills = pvpBase((playerIdx * 0x40) + currentLocation).Read<uint16_t>();
+					uint16_t currKills = pvpBase((playerIdx * 0x40) + (loc * 0x04) + 0x02).Read<uint16_t>();
 					if (currKills > nemesisKills)
 					{
 						nemesisKills = currKills;
 						nemesisIdx = loc;
 					}
-					currentLocation += 0x04;
+					playerSnapshot.VersusPlayerKills[loc] = pvpBase((playerIdx * 0x40) + (loc * 0x04)).Read<uint16_t>();
 				}
 
-				writer.Key("nemesisIndex");
-				writer.Int(nemesisIdx);
-
-				writer.Key("kingsKilled");
-				writer.Int(playerStats.KingsKilled);
-				writer.Key("humansInfected");
-				writer.Int(playerStats.HumansInfected);
-				writer.Key("zombiesKilled");
-				writer.Int(playerStats.ZombiesKilled);
-				writer.Key("timeInHill");
-				writer.Int(playerStats.TimeInHill);
-				writer.Key("timeControllingHill");
-				writer.Int(playerStats.TimeControllingHill);
-				writer.EndObject();
-
-				writer.Key("playerVersusPlayerKills");
-				writer.StartArray();
+				playerSnapshot.NemesisIndex = nemesisIdx;
+				playerSnapshot.KingsKilled = playerStats.KingsKilled;
+				playerSnapshot.HumansInfected = playerStats.HumansInfected;
+				playerSnapshot.ZombiesKilled = playerStats.ZombiesKilled;
+				playerSnapshot.TimeInHill = playerStats.TimeInHill;
+				playerSnapshot.TimeControllingHill = playerStats.TimeControllingHill;
 
-				int pvpIndex = 0x00;
-				for (int loc = 0; loc < 16; loc++)
-				{
-					writer.Int(pvpBase((playerIdx * 0x40) + pvpIndex).Read<uint16_t>());
-					pvpIndex += 0x04;
-				}
-
-				writer.EndArray();
-				writer.EndObject();
+				snapshot->Players.push_back(std::move(playerSnapshot));
 			}
 			peerIdx = session->MembershipInfo.FindNextPeer(peerIdx);
 		}
-		writer.EndArray();
-		writer.EndObject();
-
 
-		for (auto server : statsEndpoints)
-		{
-			HttpRequest req(L"ElDewrito/" + Utils::String::WidenString(Utils::Version::GetVersionString()), L"", L"");
+		snapshot->MatchId = GetMatchId(static_cast<int64_t>(sendStatsTime), snapshot->Port);
+		return true;
+	}
 
-			try
-			{
-				std::string sendObject = s.GetString();
-				if (!req.SendRequest(Utils::String::WidenString(server), L"POST", L"", L"", L"Content-Type: application/json\r\n", (void*)sendObject.c_str(), sendObject.length()))
-				{
-					Utils::Logger::Instance().Log(Utils::LogTypes::Network, Utils::LogLevel::Info, "Unable to connect to stats server");
-				}
-			}
-			catch (...)
-			{
-				Utils::Logger::Instance().Log(Utils::LogTypes::Network, Utils::LogLevel::Info, "Exception while sending stats to server");
-			}
+	//Captures the stats for the game that just ended and queues them for every stats server
+	void SubmitStats()
+	{
+		std::vector<std::string> statsEndpoints;
+		GetStatsEndpoints(statsEndpoints);
+		if (statsEndpoints.size() == 0)
+			return;
 
-		}		
+		GameSnapshot snapshot;
+		if (!CaptureSnapshot(&snapshot))
+			return;
 
-		return true;
+		//Serializing and writing to disk happen on the spool's sender thread
+		auto matchId = snapshot.MatchId;
+		spool.AddDeferred(matchId, statsEndpoints, [snapshot = std::move(snapshot)]()
+		{
+			return SerializeSnapshot(snapshot);
+		});
 	}
+
 	void LifeCycleStateChanged(Blam::Network::LifeCycleState newState)
 	{
 		auto* session = Blam::Network::GetActiveSession();
@@ -507,7 +424,9 @@ namespace Server::Stats
 		Patches::Network::OnLifeCycleStateChanged(LifeCycleStateChanged);
 		Patches::Events::OnEvent(OnEvent);
 		Patches::Core::OnGameStart(OnGameStart);
+		Patches::Core::OnShutdown([]() { spool.Stop(); });
 		getPlayersInfoEndpoint();
+		spool.Start();
 	}
 	void Tick()
 	{
@@ -526,7 +445,7 @@ namespace Server::Stats
 			auto elapsed = curTime1 - sendStatsTime;
 			if (elapsed > 1)
 			{
-				auto thread = CreateThread(NULL, 0, CommandServerAnnounceStats_Thread, (LPVOID)"", 0, NULL);
+				SubmitStats();
 				sendStatsTime = 0;
 			}
 		}
@@ -0,0 +1,181 @@
+#include "StatsSnapshot.hpp"
+#include "../ThirdParty/rapidjson/stringbuffer.h"
+#include "../ThirdParty/rapidjson/writer.h"
+
+namespace
+{
+	typedef rapidjson::Writer<rapidjson::StringBuffer> JsonWriter;
+
+	void SerializePlayer(JsonWriter &writer, const Server::Stats::PlayerSnapshot &player);
+}
+
+namespace Server::Stats
+{
+	std::string SerializeSnapshot(const GameSnapshot &snapshot)
+	{
+		rapidjson::StringBuffer buffer;
+		JsonWriter writer(buffer);
+		writer.StartObject();
+		writer.Key("matchId");
+		writer.String(snapshot.MatchId.c_str());
+		writer.Key("gameVersion");
+		writer.String(snapshot.GameVersion.c_str());
+		writer.Key("serverName");
+		writer.String(snapshot.ServerName.c_str());
+		writer.Key("serverPort");
+		writer.Int(snapshot.ServerPort);
+		writer.Key("port");
+		writer.Int(snapshot.Port);
+		writer.Key("hostPlayer");
+		writer.String(snapshot.HostPlayer.c_str());
+
+		writer.Key("game");
+		writer.StartObject();
+		writer.Key("sprintEnabled");
+		writer.Bool(snapshot.SprintEnabled);
+		writer.Key("sprintUnlimitedEnabled");
+		writer.Bool(snapshot.SprintUnlimitedEnabled);
+		writer.Key("maxPlayers");
+		writer.Int(snapshot.MaxPlayers);
+		writer.Key("mapName");
+		writer.String(snapshot.MapName.c_str());
+		writer.Key("mapFile");
+		writer.String(snapshot.MapFile.c_str());
+		writer.Key("variant");
+		writer.String(snapshot.Variant.c_str());
+		if (!snapshot.VariantType.empty())
+		{
+			writer.Key("variantType");
+			writer.String(snapshot.VariantType.c_str());
+		}
+		writer.Key("teamGame");
+		writer.Bool(snapshot.TeamGame);
+		if (snapshot.HasTeamScores)
+		{
+			writer.Key("teamScores");
+			writer.StartArray();
+			for (auto score : snapshot.TeamScores)
+				writer.Int(score);
+			writer.EndArray();
+		}
+		writer.EndObject();
+
+		writer.Key("players");
+		writer.StartArray();
+		for (auto &player : snapshot.Players)
+			SerializePlayer(writer, player);
+		writer.EndArray();
+		writer.EndObject();
+
+		return buffer.GetString();
+	}
+
+	std::string GetMatchId(int64_t endTime, int port)
+	{
+		// The end time and port are enough to tell games from the same server apart
+		return std::to_string(endTime) + "-" + std::to_string(port);
+	}
+}
+
+namespace
+{
+	void SerializePlayer(JsonWriter &writer, const Server::Stats::PlayerSnapshot &player)
+	{
+		writer.StartObject();
+		writer.Key("name");
+		writer.String(player.Name.c_str());
+		writer.Key("clientName");
+		writer.String(player.ClientName.c_str());
+		writer.Key("serviceTag");
+		writer.String(player.ServiceTag.c_str());
+		writer.Key("ip");
+		writer.String(player.Ip.c_str());
+		writer.Key("team");
+		writer.Int(player.Team);
+		writer.Key("playerIndex");
+		writer.Int(player.PlayerIndex);
+		writer.Key("uid");
+		writer.String(player.Uid.c_str());
+		writer.Key("primaryColor");
+		writer.String(player.PrimaryColor.c_str());
+
+		writer.Key("playerGameStats");
+		writer.StartObject();
+		writer.Key("score");
+		writer.Int(player.Score);
+		writer.Key("kills");
+		writer.Int(player.Kills);
+		writer.Key("assists");
+		writer.Int(player.Assists);
+		writer.Key("deaths");
+		writer.Int(player.Deaths);
+		writer.Key("betrayals");
+		writer.Int(player.Betrayals);
+		writer.Key("timeSpentAlive");
+		writer.Int(player.TimeSpentAlive);
+		writer.Key("suicides");
+		writer.Int(player.Suicides);
+		writer.Key("bestStreak");
+		writer.Int(player.BestStreak);
+		writer.EndObject();
+
+		writer.Key("playerMedals");
+		writer.StartArray();
+		for (auto &medal : player.Medals)
+		{
+			writer.StartObject();
+			writer.Key("medalName");
+			writer.String(medal.Name.c_str());
+			writer.Key("count");
+			writer.Int(medal.Count);
+			writer.EndObject();
+		}
+		writer.EndArray();
+
+		writer.Key("playerWeapons");
+		writer.StartArray();
+		for (auto &weapon : player.Weapons)
+		{
+			writer.StartObject();
+			writer.Key("weaponName");
+			writer.String(weapon.Name.c_str());
+			writer.Key("weaponIndex");
+			writer.Int(weapon.Index);
+			writer.Key("kills");
+			writer.Int(weapon.Kills);
+			writer.Key("killedBy");
+			writer.Int(weapon.KilledBy);
+			writer.Key("betrayalsWith");
+			writer.Int(weapon.BetrayalsWith);
+			writer.Key("suicidesWith");
+			writer.Int(weapon.SuicidesWith);
+			writer.Key("headshotsWith");
+			writer.Int(weapon.HeadshotsWith);
+			writer.EndObject();
+		}
+		writer.EndArray();
+
+		writer.Key("otherStats");
+		writer.StartObject();
+		writer.Key("nemesisIndex");
+		writer.Int(player.NemesisIndex);
+		writer.Key("kingsKilled");
+		writer.Int(player.KingsKilled);
+		writer.Key("humansInfected");
+		writer.Int(player.HumansInfected);
+		writer.Key("zombiesKilled");
+		writer.Int(player.ZombiesKilled);
+		writer.Key("timeInHill");
+		writer.Int(player.TimeInHill);
+		writer.Key("timeControllingHill");
+		writer.Int(player.TimeControllingHill);
+		writer.EndObject();
+
+		writer.Key("playerVersusPlayerKills");
+		writer.StartArray();
+		for (auto kills : player.VersusPlayerKills)
+			writer.Int(kills);
+		writer.EndArray();
+		writer.EndObject();
+	}
+}
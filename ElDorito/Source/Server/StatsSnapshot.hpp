@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Server::Stats
+{
+	struct MedalSnapshot
+	{
+		std::string Name;
+		int Count;
+	};
+
+	struct WeaponSnapshot
+	{
+		std::string Name;
+		int Index; // Damage reporting type + 1
+		int Kills;
+		int KilledBy;
+		int BetrayalsWith;
+		int SuicidesWith;
+		int HeadshotsWith;
+	};
+
+	struct PlayerSnapshot
+	{
+		std::string Name;
+		std::string ClientName;
+		std::string ServiceTag;
+		std::string Ip;
+		int Team;
+		int PlayerIndex;
+		std::string Uid;
+		std::string PrimaryColor; // #RRGGBB
+
+		int Score;
+		int Kills;
+		int Assists;
+		int Deaths;
+		int Betrayals;
+		int TimeSpentAlive;
+		int Suicides;
+		int BestStreak;
+
+		std::vector<MedalSnapshot> Medals;
+		std::vector<WeaponSnapshot> Weapons;
+
+		int NemesisIndex;
+		int KingsKilled;
+		int HumansInfected;
+		int ZombiesKilled;
+		int TimeInHill;
+		int TimeControllingHill;
+
+		int VersusPlayerKills[16];
+	};
+
+	// Everything that gets submitted to stats servers at the end of a game. This is captured from game memory on
+	// the game thread as soon as the game ends, so it can be serialized and sent later from anywhere.
+	struct GameSnapshot
+	{
+		std::string MatchId; // Identifies the game so that servers can ignore submissions they've already received
+
+		std::string GameVersion;
+		std::string ServerName;
+		int ServerPort;
+		int Port;
+		std::string HostPlayer;
+
+		bool SprintEnabled;
+		bool SprintUnlimitedEnabled;
+		int MaxPlayers;
+		std::string MapName;
+		std::string MapFile;
+		std::string Variant;
+		std::string VariantType; // Empty if the variant type is unknown
+		bool TeamGame;
+		bool HasTeamScores;
+		std::vector<int> TeamScores;
+
+		std::vector<PlayerSnapshot> Players;
+	};
+
+	// Serializes a snapshot to the JSON format stats servers expect.
+	std::string SerializeSnapshot(const GameSnapshot &snapshot);
+
+	// Builds the match ID for a game from the time it ended and the game port. Capturing the same game again gives
+	// the same ID, so the spool replaces the earlier submission instead of sending both.
+	std::string GetMatchId(int64_t endTime, int port);
+}
@@ -0,0 +1,352 @@
+#include "StatsSpool.hpp"
+#include "../Utils/Logger.hpp"
+#include <boost/filesystem.hpp>
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <fstream>
+#include <iterator>
+#include <set>
+#include <vector>
+
+namespace
+{
+	const char SubmissionExtension[] = ".json";
+
+	// How long the sender sleeps when nothing is waiting to be retried
+	const uint32_t IdleIntervalMs = 60 * 1000;
+
+	std::string GetSubmissionName(const std::string &matchId, const std::string &url);
+	bool ReadSubmission(const boost::filesystem::path &path, std::string *url, std::string *body);
+	bool WriteSubmission(const boost::filesystem::path &path, const std::string &url, const std::string &body);
+	std::vector<boost::filesystem::path> ListSubmissions(const std::string &directory);
+}
+
+namespace Server::Stats
+{
+	StatsSpool::StatsSpool(const std::string &directory, SendFunc send, uint32_t minRetryMs, uint32_t maxRetryMs, size_t maxSubmissions)
+		: directory(directory), send(send), minRetryMs(minRetryMs), maxRetryMs(maxRetryMs), maxSubmissions(maxSubmissions),
+		nextAttempt(0), stopping(false), wake(false)
+	{
+	}
+
+	StatsSpool::~StatsSpool()
+	{
+		Stop();
+	}
+
+	bool StatsSpool::Add(const std::string &matchId, const std::string &url, const std::string &body)
+	{
+		{
+			std::lock_guard<std::mutex> lock(spoolMutex);
+			boost::system::error_code error;
+			boost::filesystem::create_directories(directory, error);
+
+			auto name = GetSubmissionName(matchId, url);
+			auto path = boost::filesystem::path(directory) / name;
+
+			// Make room by dropping the oldest submissions, unless this one is replacing an existing one
+			auto submissions = ListSubmissions(directory);
+			if (!boost::filesystem::exists(path, error) && submissions.size() >= maxSubmissions)
+			{
+				std::sort(submissions.begin(), submissions.end(), [](const boost::filesystem::path &a, const boost::filesystem::path &b)
+				{
+					boost::system::error_code error;
+					return boost::filesystem::last_write_time(a, error) < boost::filesystem::last_write_time(b, error);
+				});
+				for (size_t i = 0; i + maxSubmissions <= submissions.size() && i < submissions.size(); i++)
+				{
+					Utils::Logger::Instance().Log(Utils::LogTypes::Network, Utils::LogLevel::Warning, "Stats spool is full, dropping %s", submissions[i].filename().string().c_str());
+					boost::filesystem::remove(submissions[i], error);
+					retries.erase(submissions[i].filename().string());
+				}
+			}
+
+			if (!WriteSubmission(path, url, body))
+			{
+				Utils::Logger::Instance().Log(Utils::LogTypes::Network, Utils::LogLevel::Error, "Unable to write stats submission %s", path.string().c_str());
+				return false;
+			}
+
+			// A replaced submission shouldn't inherit the old one's backoff
+			retries.erase(name);
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(threadMutex);
+			wake = true;
+		}
+		threadCondition.notify_one();
+		return true;
+	}
+
+	void StatsSpool::AddDeferred(const std::string &matchId, const std::vector<std::string> &urls, BuildFunc build)
+	{
+		auto queued = false;
+		{
+			std::lock_guard<std::mutex> lock(threadMutex);
+			if (thread.joinable())
+			{
+				deferred.push_back({ matchId, urls, build });
+				wake = true;
+				queued = true;
+			}
+		}
+		if (queued)
+		{
+			threadCondition.notify_one();
+			return;
+		}
+
+		auto body = build();
+		for (auto &url : urls)
+			Add(matchId, url, body);
+	}
+
+	void StatsSpool::Start()
+	{
+		std::lock_guard<std::mutex> lock(threadMutex);
+		if (thread.joinable())
+			return;
+		stopping = false;
+		wake = true;
+		thread = std::thread(&StatsSpool::Run, this);
+	}
+
+	void StatsSpool::Stop()
+	{
+		{
+			std::lock_guard<std::mutex> lock(threadMutex);
+			if (!thread.joinable())
+				return;
+			stopping = true;
+		}
+		threadCondition.notify_one();
+		thread.join();
+
+		// Write anything that was deferred while the thread was finishing up
+		std::vector<DeferredSubmission> submissions;
+		{
+			std::lock_guard<std::mutex> lock(threadMutex);
+			submissions.swap(deferred);
+		}
+		WriteDeferred(submissions);
+	}
+
+	size_t StatsSpool::Drain(uint64_t now)
+	{
+		std::vector<boost::filesystem::path> due;
+		{
+			std::lock_guard<std::mutex> lock(spoolMutex);
+
+			// Forget about submissions which are gone, e.g. because they were dropped
+			auto submissions = ListSubmissions(directory);
+			std::set<std::string> names;
+			for (auto &path : submissions)
+				names.insert(path.filename().string());
+			for (auto it = retries.begin(); it != retries.end();)
+			{
+				if (names.find(it->first) == names.end())
+					it = retries.erase(it);
+				else
+					++it;
+			}
+
+			for (auto &path : submissions)
+			{
+				auto it = retries.find(path.filename().string());
+				if (it == retries.end() || it->second.NextAttempt <= now)
+					due.push_back(path);
+			}
+		}
+
+		size_t delivered = 0;
+		for (auto &path : due)
+		{
+			std::string url, body;
+			{
+				std::lock_guard<std::mutex> lock(spoolMutex);
+				if (!ReadSubmission(path, &url, &body))
+				{
+					Utils::Logger::Instance().Log(Utils::LogTypes::Network, Utils::LogLevel::Error, "Discarding unreadable stats submission %s", path.string().c_str());
+					boost::system::error_code error;
+					boost::filesystem::remove(path, error);
+					continue;
+				}
+			}
+
+			// Don't hold the lock during the request so that games can still be spooled
+			auto result = SendResult::Retry;
+			try
+			{
+				result = send(url, body);
+			}
+			catch (...)
+			{
+			}
+
+			std::lock_guard<std::mutex> lock(spoolMutex);
+			auto name = path.filename().string();
+			if (result != SendResult::Retry)
+			{
+				if (result == SendResult::Rejected)
+					Utils::Logger::Instance().Log(Utils::LogTypes::Network, Utils::LogLevel::Warning, "Stats server %s rejected %s, discarding it", url.c_str(), name.c_str());
+
+				// Only remove the file if it wasn't replaced while it was being sent
+				std::string currentUrl, currentBody;
+				if (ReadSubmission(path, &currentUrl, &currentBody) && currentUrl == url && currentBody == body)
+				{
+					boost::system::error_code error;
+					boost::filesystem::remove(path, error);
+				}
+				retries.erase(name);
+				if (result == SendResult::Delivered)
+					delivered++;
+			}
+			else
+			{
+				auto &state = retries[name];
+				auto delay = std::min<uint64_t>(static_cast<uint64_t>(minRetryMs) << std::min<uint32_t>(state.Attempts, 20), maxRetryMs);
+				state.Attempts++;
+				state.NextAttempt = now + delay;
+			}
+		}
+
+		std::lock_guard<std::mutex> lock(spoolMutex);
+		nextAttempt = now + IdleIntervalMs;
+		for (auto &retry : retries)
+			nextAttempt = std::min(nextAttempt, retry.second.NextAttempt);
+		return delivered;
+	}
+
+	size_t StatsSpool::GetPendingCount()
+	{
+		std::lock_guard<std::mutex> lock(spoolMutex);
+		return ListSubmissions(directory).size();
+	}
+
+	void StatsSpool::Run()
+	{
+		std::vector<DeferredSubmission> submissions;
+		while (true)
+		{
+			bool done;
+			{
+				std::unique_lock<std::mutex> lock(threadMutex);
+				uint64_t waitTime;
+				{
+					std::lock_guard<std::mutex> spoolLock(spoolMutex);
+					auto now = GetSpoolTime();
+					waitTime = nextAttempt > now ? nextAttempt - now : 0;
+				}
+				threadCondition.wait_for(lock, std::chrono::milliseconds(waitTime), [this] { return stopping || wake; });
+				submissions.swap(deferred);
+				done = stopping;
+				wake = false;
+			}
+
+			WriteDeferred(submissions);
+			submissions.clear();
+			if (done)
+				break;
+			Drain(GetSpoolTime());
+		}
+	}
+
+	void StatsSpool::WriteDeferred(std::vector<DeferredSubmission> &submissions)
+	{
+		for (auto &submission : submissions)
+		{
+			auto body = submission.Build();
+			for (auto &url : submission.Urls)
+				Add(submission.MatchId, url, body);
+		}
+	}
+
+	uint64_t GetSpoolTime()
+	{
+		return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	StatsSpool::SendResult GetSendResult(int status)
+	{
+		if (status >= 200 && status < 300)
+			return StatsSpool::SendResult::Delivered;
+
+		// Sending the same thing again won't fix a client error, unless the server timed out or is rate limiting
+		if (status >= 400 && status < 500 && status != 408 && status != 429)
+			return StatsSpool::SendResult::Rejected;
+		return StatsSpool::SendResult::Retry;
+	}
+}
+
+namespace
+{
+	std::string GetSubmissionName(const std::string &matchId, const std::string &url)
+	{
+		// FNV-1a, just to tell URLs apart in file names
+		uint32_t hash = 2166136261;
+		for (auto c : url)
+		{
+			hash ^= static_cast<uint8_t>(c);
+			hash *= 16777619;
+		}
+
+		std::string name;
+		for (auto c : matchId)
+		{
+			if (isalnum(static_cast<unsigned char>(c)) || c == '-' || c == '_')
+				name += c;
+		}
+
+		char hashStr[9];
+		sprintf_s(hashStr, "%08x", hash);
+		return name + "-" + hashStr + SubmissionExtension;
+	}
+
+	bool ReadSubmission(const boost::filesystem::path &path, std::string *url, std::string *body)
+	{
+		std::ifstream file(path.string(), std::ios::binary);
+		if (!file.is_open() || !std::getline(file, *url) || url->empty())
+			return false;
+		body->assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+		return !file.bad();
+	}
+
+	bool WriteSubmission(const boost::filesystem::path &path, const std::string &url, const std::string &body)
+	{
+		// Write to a temporary file first so that the sender never sees a partial submission
+		auto tempPath = path;
+		tempPath += ".tmp";
+		{
+			std::ofstream file(tempPath.string(), std::ios::binary | std::ios::trunc);
+			if (!file.is_open())
+				return false;
+			file << url << '\n' << body;
+			if (file.fail())
+				return false;
+		}
+
+		boost::system::error_code error;
+		boost::filesystem::rename(tempPath, path, error);
+		if (error)
+		{
+			boost::filesystem::remove(tempPath, error);
+			return false;
+		}
+		return true;
+	}
+
+	std::vector<boost::filesystem::path> ListSubmissions(const std::string &directory)
+	{
+		std::vector<boost::filesystem::path> result;
+		boost::system::error_code error;
+		for (boost::filesystem::directory_iterator it(directory, error), end; !error && it != end; it.increment(error))
+		{
+			auto &path = it->path();
+			if (path.extension() == SubmissionExtension && boost::filesystem::is_regular_file(path, error))
+				result.push_back(path);
+		}
+		return result;
+	}
+}
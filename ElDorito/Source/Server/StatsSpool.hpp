@@ -0,0 +1,108 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Server::Stats
+{
+	// Keeps stats submissions on disk until they have been delivered, so that games aren't lost while a stats server
+	// is down or if the game is closed first. A background thread sends each submission and retries failures with
+	// exponential backoff.
+	//
+	// Each submission is a "<match id>-<url hash>.json" file holding the URL on the first line followed by the body.
+	// Spooling the same match for the same URL again replaces the pending submission instead of adding a second one.
+	class StatsSpool
+	{
+	public:
+		enum class SendResult
+		{
+			// The server accepted the submission.
+			Delivered,
+
+			// The submission couldn't be delivered right now and should be tried again later.
+			Retry,
+
+			// The server will never accept the submission, so it should be thrown out.
+			Rejected,
+		};
+
+		// Sends a body to a URL.
+		typedef std::function<SendResult(const std::string &url, const std::string &body)> SendFunc;
+
+		// Builds the body of a submission.
+		typedef std::function<std::string()> BuildFunc;
+
+		StatsSpool(const std::string &directory, SendFunc send, uint32_t minRetryMs, uint32_t maxRetryMs, size_t maxSubmissions);
+		~StatsSpool();
+
+		// Writes a submission to the spool and wakes the sender. If the spool is full, the oldest submissions are
+		// dropped to make room. Returns false if the submission couldn't be written.
+		bool Add(const std::string &matchId, const std::string &url, const std::string &body);
+
+		// Queues a submission to every URL in a list, with a body which is built on the sender thread so that the
+		// caller doesn't have to wait for it. Anything still queued when the spool stops is written out by Stop.
+		// If the sender thread isn't running, the submission is written immediately.
+		void AddDeferred(const std::string &matchId, const std::vector<std::string> &urls, BuildFunc build);
+
+		// Starts the sender thread, which picks up anything left over from earlier sessions.
+		void Start();
+
+		// Stops the sender thread, waiting for any request in progress and writing out any deferred submissions.
+		// Undelivered submissions stay on disk.
+		void Stop();
+
+		// Tries once to send every submission which is due at a time from GetSpoolTime().
+		// Returns the number of submissions that were delivered.
+		size_t Drain(uint64_t now);
+
+		// Gets the number of submissions waiting to be delivered.
+		size_t GetPendingCount();
+
+	private:
+		struct RetryState
+		{
+			uint32_t Attempts;
+			uint64_t NextAttempt;
+		};
+
+		struct DeferredSubmission
+		{
+			std::string MatchId;
+			std::vector<std::string> Urls;
+			BuildFunc Build;
+		};
+
+		std::string directory;
+		SendFunc send;
+		uint32_t minRetryMs;
+		uint32_t maxRetryMs;
+		size_t maxSubmissions;
+
+		// Guards the files in the directory and the retry state
+		std::mutex spoolMutex;
+		std::map<std::string, RetryState> retries; // Keyed by file name
+		uint64_t nextAttempt;
+
+		std::mutex threadMutex;
+		std::condition_variable threadCondition;
+		bool stopping;
+		bool wake;
+		std::vector<DeferredSubmission> deferred;
+		std::thread thread;
+
+		void Run();
+		void WriteDeferred(std::vector<DeferredSubmission> &submissions);
+	};
+
+	// Gets the current time in milliseconds on the clock the spool uses for retries.
+	uint64_t GetSpoolTime();
+
+	// Decides what to do with a submission from the HTTP status code a stats server replied with.
+	StatsSpool::SendResult GetSendResult(int status);
+}
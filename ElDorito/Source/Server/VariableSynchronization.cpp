@@ -158,6 +158,7 @@ namespace
 		default:
 			throw std::runtime_error("Unsupported variable type");
 		}
+		CommandMap::Instance().MarkChanged(var);
 		if (var->UpdateEvent)
 		{
 			std::string returnInfo;
@@ -192,6 +193,7 @@ namespace
 		default:
 			return;
 		}
+		CommandMap::Instance().MarkChanged(var);
 		if (var->UpdateEvent)
 		{
 			std::string returnInfo;
@@ -0,0 +1,184 @@
+#include "VoteTally.hpp"
+#include <cstring>
+
+namespace Server::Voting
+{
+	VoteTally::VoteTally()
+	{
+		Reset(0);
+	}
+
+	void VoteTally::Reset(int newOptionCount)
+	{
+		optionCount = newOptionCount < 0 ? 0 : (newOptionCount > MaxVotingOptions ? MaxVotingOptions : newOptionCount);
+		memset(rankings, -1, sizeof(rankings));
+		memset(firstChoiceCounts, 0, sizeof(firstChoiceCounts));
+		voterCount = 0;
+	}
+
+	bool VoteTally::SetVote(int playerIndex, int option)
+	{
+		if (!IsValid(playerIndex, option))
+			return false;
+
+		auto ranking = rankings[playerIndex];
+		if (ranking[0] == option && ranking[1] == -1)
+			return false;
+
+		SetFirstChoice(playerIndex, option);
+		memset(ranking + 1, -1, MaxVotingOptions - 1);
+		return true;
+	}
+
+	bool VoteTally::AddPreference(int playerIndex, int option)
+	{
+		if (!IsValid(playerIndex, option))
+			return false;
+
+		auto ranking = rankings[playerIndex];
+		for (auto i = 0; i < MaxVotingOptions; i++)
+		{
+			if (ranking[i] == option)
+				return false;
+			if (ranking[i] == -1)
+			{
+				if (i == 0)
+					SetFirstChoice(playerIndex, option);
+				else
+					ranking[i] = static_cast<int8_t>(option);
+				return true;
+			}
+		}
+		return false;
+	}
+
+	bool VoteTally::HasRanked(int playerIndex, int option) const
+	{
+		if (!IsValid(playerIndex, option))
+			return false;
+
+		for (auto ranked : rankings[playerIndex])
+		{
+			if (ranked == -1)
+				break;
+			if (ranked == option)
+				return true;
+		}
+		return false;
+	}
+
+	bool VoteTally::ClearVote(int playerIndex)
+	{
+		if (!HasVoted(playerIndex))
+			return false;
+
+		SetFirstChoice(playerIndex, -1);
+		memset(rankings[playerIndex], -1, MaxVotingOptions);
+		return true;
+	}
+
+	bool VoteTally::HasVoted(int playerIndex) const
+	{
+		return playerIndex >= 0 && playerIndex < Blam::Network::MaxPlayers && rankings[playerIndex][0] != -1;
+	}
+
+	int VoteTally::GetFirstChoiceCount(int option) const
+	{
+		if (option < 0 || option >= optionCount)
+			return 0;
+		return firstChoiceCounts[option];
+	}
+
+	int VoteTally::FindPluralityWinner() const
+	{
+		auto winner = -1;
+		for (auto i = 0; i < optionCount; i++)
+		{
+			if (winner < 0 || firstChoiceCounts[i] >= firstChoiceCounts[winner])
+				winner = i;
+		}
+		return winner;
+	}
+
+	int VoteTally::FindRankedWinner() const
+	{
+		bool eliminated[MaxVotingOptions] = {};
+		auto remaining = optionCount;
+		while (remaining > 0)
+		{
+			// Count each player's highest preference which is still in the running
+			int counts[MaxVotingOptions] = {};
+			auto total = 0;
+			for (auto &ranking : rankings)
+			{
+				for (auto option : ranking)
+				{
+					if (option == -1)
+						break;
+					if (!eliminated[option])
+					{
+						counts[option]++;
+						total++;
+						break;
+					}
+				}
+			}
+
+			auto leader = -1;
+			auto last = -1;
+			for (auto i = 0; i < optionCount; i++)
+			{
+				if (eliminated[i])
+					continue;
+				if (leader < 0 || counts[i] >= counts[leader])
+					leader = i;
+				if (last < 0 || counts[i] < counts[last])
+					last = i;
+			}
+			if (remaining == 1 || total == 0 || counts[leader] * 2 > total)
+				return leader;
+
+			eliminated[last] = true;
+			remaining--;
+		}
+		return -1;
+	}
+
+	bool VoteTally::IsValid(int playerIndex, int option) const
+	{
+		return playerIndex >= 0 && playerIndex < Blam::Network::MaxPlayers && option >= 0 && option < optionCount;
+	}
+
+	void VoteTally::SetFirstChoice(int playerIndex, int option)
+	{
+		auto &first = rankings[playerIndex][0];
+		if (first != -1)
+			firstChoiceCounts[first]--;
+		else
+			voterCount++;
+
+		if (option != -1)
+			firstChoiceCounts[option]++;
+		else
+			voterCount--;
+		first = static_cast<int8_t>(option);
+	}
+
+	VotingRandom::VotingRandom()
+		: seed(0), seeded(false)
+	{
+	}
+
+	void VotingRandom::Seed(uint32_t newSeed)
+	{
+		seed = newSeed;
+		seeded = true;
+		engine.seed(newSeed);
+	}
+
+	uint32_t VotingRandom::Next(uint32_t bound)
+	{
+		// std::uniform_int_distribution can differ between standard libraries, so scale the raw output instead
+		return static_cast<uint32_t>((static_cast<uint64_t>(engine()) * bound) >> 32);
+	}
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstdint>
+#include <random>
+#include "../Blam/BlamNetwork.hpp"
+
+namespace Server::Voting
+{
+	// The most options a vote can have, including the revote option.
+	const int MaxVotingOptions = 5;
+
+	// Keeps each player's vote in a fixed slot indexed by their player index, along with running first-choice counts.
+	// Options are numbered from 0. A player's vote is a list of options in order of preference. Plurality votes only
+	// ever have one preference.
+	class VoteTally
+	{
+	public:
+		VoteTally();
+
+		// Clears every vote and sets how many options there are.
+		void Reset(int optionCount);
+
+		int GetOptionCount() const { return optionCount; }
+
+		// Replaces a player's vote with a single option.
+		// Returns false if the vote is invalid or didn't change.
+		bool SetVote(int playerIndex, int option);
+
+		// Adds an option as a player's next preference.
+		// Returns false if the vote is invalid or the option is already ranked.
+		bool AddPreference(int playerIndex, int option);
+
+		// Checks whether an option is anywhere in a player's ranking.
+		bool HasRanked(int playerIndex, int option) const;
+
+		// Removes a player's vote, e.g. because they left. Returns false if they hadn't voted.
+		bool ClearVote(int playerIndex);
+
+		bool HasVoted(int playerIndex) const;
+		int GetVoterCount() const { return voterCount; }
+
+		// Gets the number of players whose first choice is an option.
+		int GetFirstChoiceCount(int option) const;
+
+		// Finds the option with the most first-choice votes. Ties go to the later option.
+		// Returns -1 if there are no options.
+		int FindPluralityWinner() const;
+
+		// Finds the winner by instant runoff: until an option has a majority, the option with the fewest votes is
+		// eliminated and its votes move to each player's next preference. Ties go to the later option, both when
+		// picking the winner and when picking which option to eliminate. Returns -1 if there are no options.
+		int FindRankedWinner() const;
+
+	private:
+		int optionCount;
+		int8_t rankings[Blam::Network::MaxPlayers][MaxVotingOptions]; // Each ends at the first -1
+		int firstChoiceCounts[MaxVotingOptions];
+		int voterCount;
+
+		bool IsValid(int playerIndex, int option) const;
+		void SetFirstChoice(int playerIndex, int option);
+	};
+
+	// A seeded random number generator for picking voting options, so that a sequence of rounds can be reproduced.
+	class VotingRandom
+	{
+	public:
+		VotingRandom();
+
+		void Seed(uint32_t seed);
+		bool IsSeeded() const { return seeded; }
+		uint32_t GetSeed() const { return seed; }
+
+		// Gets a number in [0, bound). The sequence only depends on the seed.
+		uint32_t Next(uint32_t bound);
+
+	private:
+		std::mt19937 engine;
+		uint32_t seed;
+		bool seeded;
+	};
+}
@@ -144,7 +144,7 @@ namespace Server::Voting
 			
 	}
 
-	void LogVote(const VotingMessage &message, std::string name)
+	void LogVote(const VotingMessage &message, int playerIndex)
 	{
 		auto* session = Blam::Network::GetActiveSession();
 		if (!(session && session->IsEstablished() && session->IsHost()))
@@ -153,7 +153,7 @@ namespace Server::Voting
 		for (auto elem : VotingSystems)
 		{
 			if (elem->isEnabled()) {
-				elem->LogVote(message, name);
+				elem->LogVote(message, playerIndex);
 			}
 		}
 	}
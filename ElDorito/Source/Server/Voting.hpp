@@ -10,5 +10,5 @@ namespace Server::Voting
 	void PlayerJoinedVoteInProgress(int playerIndex);
 	void CancelVoteInProgress();
 	void StartNewVote();
-	void LogVote(const VotingMessage &message, std::string name);
+	void LogVote(const VotingMessage &message, int playerIndex);
 }
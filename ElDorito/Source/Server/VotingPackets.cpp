@@ -2,7 +2,6 @@
 #include "../Patches/CustomPackets.hpp"
 #include "../Server/Voting.hpp"
 #include "../Modules/ModuleServer.hpp"
-#include "../Utils/Utils.hpp"
 
 
 using namespace Server::Voting;
@@ -115,11 +114,9 @@ namespace
 		//Vote messages will not be passed on to the message handler. 
 		if (message.Type == VotingMessageType::Vote)
 		{
-			auto &membership = session->MembershipInfo;
-			auto &player = membership.PlayerSessions[membership.GetPeerPlayer(peer)];
-			std::string name = Utils::String::ThinString(player.Properties.DisplayName);
-
-			Server::Voting::LogVote(message, name);
+			auto playerIndex = session->MembershipInfo.GetPeerPlayer(peer);
+			if (playerIndex >= 0)
+				Server::Voting::LogVote(message, playerIndex);
 			return;
 		}
 
@@ -145,6 +142,15 @@ namespace
 		return true;
 	}
 
+	// Sends an already-built packet to a peer, handling it locally if the peer is us.
+	void SendVotingPacket(Blam::Network::Session *session, int peer, const VotingMessagePacket &packet)
+	{
+		if (peer == session->MembershipInfo.LocalPeerIndex)
+			ReceivedVotingMessage(session, peer, packet.Data);
+		else
+			VotingPacketSender->Send(peer, packet);
+	}
+
 
 }
 
@@ -171,12 +177,16 @@ namespace Server::Voting
 	bool BroadcastVotingMessage(VotingMessage &message)
 	{
 		auto session = Blam::Network::GetActiveSession();
+		if (!session)
+			return false;
+
+		// The packet is the same for every peer, so only build it once
+		auto packet = VotingPacketSender->New();
+		packet.Data = message;
+
 		auto membership = &session->MembershipInfo;
 		for (int peer = membership->FindFirstPeer(); peer >= 0; peer = membership->FindNextPeer(peer))
-		{
-			if (!SendVotingMessagePacket(session, peer, message))
-				return false;
-		}
+			SendVotingPacket(session, peer, packet);
 		return true;
 	}
 
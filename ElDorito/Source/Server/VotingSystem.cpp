@@ -8,6 +8,7 @@
 #include <iostream>
 #include <stdio.h>
 #include <algorithm>
+#include <bitset>
 #include <unordered_map>
 
 #include "../Utils/Logger.hpp"
@@ -69,6 +70,9 @@ namespace Server::Voting
 		"Assault",
 	};
 
+	//How many times to try generating a voting option that hasn't been picked already before settling for one that has
+	const int MaxOptionAttempts = 32;
+
 	int numberOfPlayersInGame()
 	{
 		int numPlayers = 0;
@@ -111,6 +115,12 @@ namespace Server::Voting
 		return mapId;
 	}
 
+	//Identifies an option for checking whether it won recently
+	std::string getOptionKey(const MapAndType &option)
+	{
+		return option.haloMap.mapName + "|" + option.haloType.typeName;
+	}
+
 	AbstractVotingSystem::AbstractVotingSystem(){}
 	VotingSystem::VotingSystem() : AbstractVotingSystem() {}
 
@@ -144,12 +154,46 @@ namespace Server::Voting
 		return success;
 	}
 
+	void AbstractVotingSystem::EnsureSeeded()
+	{
+		//A configured seed replaces whatever the generator was seeded with, e.g. before the config was loaded
+		auto seed = static_cast<uint32_t>(Modules::ModuleServer::Instance().VarServerVotingSeed->ValueInt);
+		if (random.IsSeeded() && (seed == 0 || seed == random.GetSeed()))
+			return;
+
+		if (seed == 0)
+			seed = static_cast<uint32_t>(time(nullptr));
+		random.Seed(seed);
+		Utils::Logger::Instance().Log(Utils::LogTypes::Game, Utils::LogLevel::Info, "Voting seed: %u", seed);
+	}
+
+	bool AbstractVotingSystem::RemoveDepartedVoters()
+	{
+		auto* session = Blam::Network::GetActiveSession();
+		if (!session)
+			return false;
+
+		auto &membership = session->MembershipInfo;
+		std::bitset<Blam::Network::MaxPlayers> present;
+		for (auto player = membership.FindFirstPlayer(); player >= 0; player = membership.FindNextPlayer(player))
+			present.set(player);
+
+		auto removed = false;
+		for (auto i = 0; i < Blam::Network::MaxPlayers; i++)
+		{
+			if (!present[i] && tally.ClearVote(i))
+				removed = true;
+		}
+		return removed;
+	}
+
 	void VotingSystem::Reset()
 	{
 		numberOfRevotesUsed = 0;
 		winnerChosenTime = 0;
 		voteStartedTime = 0;
-		mapVotes.clear();
+		tally.Reset(0);
+		tallyChanged = false;
 	}
 
 	void VotingSystem::NewVote() {
@@ -158,38 +202,35 @@ namespace Server::Voting
 	}
 
 
-	void VotingSystem::LogVote(const VotingMessage &message, std::string name)
+	void VotingSystem::LogVote(const VotingMessage &message, int playerIndex)
 	{
 
 		// If we aren't in a vote or if voting is not enabled, exit
 		if (!(voteStartedTime != 0 && Modules::ModuleServer::Instance().VarServerVotingEnabled->ValueInt))
 			return;
 
-		unsigned int vote = message.Vote;
-
-		//unlikely to happen unless someone messes with the JS
-		if (vote < 0 || vote >(Modules::ModuleServer::Instance().VarServerNumberOfVotingOptions->ValueInt + 1))
-			return;
-
-		// If this person has already voted, then we replace his vote. If not, then we add a new name-vote pair
-		std::map<std::string, int>::iterator it = mapVotes.find(name);
-		if (it != mapVotes.end())
-			it->second = vote;
+		//Votes are numbered from 1. The tally ignores anything out of range, which is unlikely to happen unless someone messes with the JS
+		auto option = message.Vote - 1;
+		//In ranked-choice mode, clicking an option which is already ranked starts the ranking over from it
+		bool changed;
+		if (Modules::ModuleServer::Instance().VarServerVotingRankedChoice->ValueInt && !tally.HasRanked(playerIndex, option))
+			changed = tally.AddPreference(playerIndex, option);
 		else
-			mapVotes.insert(std::make_pair(name, vote));
+			changed = tally.SetVote(playerIndex, option);
 
-		countVotes();
+		//The new counts are sent on the next tick, so a burst of votes only sends one update
+		if (changed)
+			tallyChanged = true;
+	}
 
-		//create a message to send to all of the players with the new vote counts
+	//Sends the first-choice vote counts to all of the players
+	void VotingSystem::BroadcastTally()
+	{
 		VotingMessage newmessage(VotingMessageType::VoteTally);
-		int optionIndex = 0;
-		for (auto &option : currentVotingOptions) {
-			newmessage.votes[optionIndex] = option.Count;
-			optionIndex++;
-			option.Count = 0;
-		}
+		for (auto i = 0; i < tally.GetOptionCount(); i++)
+			newmessage.votes[i] = tally.GetFirstChoiceCount(i);
 		BroadcastVotingMessage(newmessage);
-
+		tallyChanged = false;
 	}
 
 	//Populate the Maps and Gametypes with default ones if no valid json was supplied
@@ -220,7 +261,7 @@ namespace Server::Voting
 		MapAndType m;
 		if (Modules::ModuleServer::Instance().VarVetoSystemSelectionType->ValueInt == 0) {
 			//randomly pick one out of the playlist and remove it.
-			int optionIndex = rand() % currentPlaylist.size();
+			int optionIndex = random.Next(currentPlaylist.size());
 
 			m = currentPlaylist[optionIndex];
 			currentPlaylist.erase(currentPlaylist.begin() + optionIndex);
@@ -240,17 +281,27 @@ namespace Server::Voting
 	//Randomly picks a voting option. If the gametype it picks has maps that are specific to that gametype, then it picks a map from those.
 	MapAndType VotingSystem::GenerateVotingOption()
 	{
-		HaloType gametype = gameTypes[rand() % gameTypes.size()];
+		HaloType gametype = gameTypes[random.Next(gameTypes.size())];
 		HaloMap map;
 
 		if (gametype.specificMaps.size() > 0)
-			map = gametype.specificMaps[rand() % gametype.specificMaps.size()];
+			map = gametype.specificMaps[random.Next(gametype.specificMaps.size())];
 		else
-			map = haloMaps[rand() % haloMaps.size()];
+			map = haloMaps[random.Next(haloMaps.size())];
 
 		return MapAndType(map, gametype);
 	}
 
+	bool VotingSystem::IsDuplicateOption(const MapAndType &option) const
+	{
+		return std::find(currentVotingOptions.begin(), currentVotingOptions.end(), option) != currentVotingOptions.end();
+	}
+
+	bool VotingSystem::WonRecently(const MapAndType &option) const
+	{
+		return std::find(recentWinners.begin(), recentWinners.end(), getOptionKey(option)) != recentWinners.end();
+	}
+
 	//Creates the message to send to peers. TODO abstract VotingMessage out of VotingSystem
 	VotingMessage VetoSystem::GenerateVotingOptionsMessage()
 	{
@@ -294,51 +345,47 @@ namespace Server::Voting
 		return newmessage;
 	}
 
-	//Counds the votes
-	void VotingSystem::countVotes()
+	//Sends the number of veto votes to all of the players
+	void VetoSystem::BroadcastTally()
 	{
-		for (auto const &vote : mapVotes)
-		{
-			//in case someone modifies the js and sends something other than a valid vote.
-			if (vote.second > currentVotingOptions.size() || vote.second < 1)
-				continue;
-			currentVotingOptions.at(vote.second - 1).Count++;
-		}
-	}
-	//Counds the votes
-	void VetoSystem::countVotes()
-	{
-		currentNumberOfVotes = 0;
-		for (auto const &vote : mapVotes)
-		{
-			//in case someone modifies the js and sends something other than a valid vote.
-			if (vote.second != 1)
-				continue;
-			currentNumberOfVotes++;
-		}
+		VotingMessage newmessage(VotingMessageType::VoteTally);
+		newmessage.votes[0] = tally.GetVoterCount();
+		newmessage.votes[1] = tally.GetVoterCount();
+		BroadcastVotingMessage(newmessage);
+		tallyChanged = false;
 	}
 
 	/*
-	* Counts the votes, sorts the options by vote tally.
+	* Finds the winning option from the tally, by instant runoff if ranked choice voting is enabled.
 	*
 	* - Ties are handled like Halo Reach: Ties will be awarded to the latter option.
 	*   So if option 3 has 2 votes and option 4 has 2 votes, option 4 will win.
 	*/
 	void VotingSystem::FindWinner()
 	{
-		countVotes();
-		std::sort(currentVotingOptions.begin(), currentVotingOptions.end());
-		auto winningOption = currentVotingOptions.back();
+		auto &serverModule = Modules::ModuleServer::Instance();
+		auto winnerIndex = serverModule.VarServerVotingRankedChoice->ValueInt ? tally.FindRankedWinner() : tally.FindPluralityWinner();
+		if (winnerIndex < 0 || winnerIndex >= static_cast<int>(currentVotingOptions.size()))
+		{
+			tally.Reset(0);
+			voteStartedTime = 0;
+			return;
+		}
+		auto winningOption = currentVotingOptions[winnerIndex];
 
 		if (winningOption.isRevoteOption)
 		{
 			numberOfRevotesUsed++;
-			mapVotes.clear();
+			tally.Reset(0);
 			voteStartedTime = 0;
 			revoteFlag = true;
 			return;
 		}
 
+		recentWinners.push_front(getOptionKey(winningOption));
+		while (recentWinners.size() > static_cast<size_t>(serverModule.VarServerVotingRecentWinners->ValueInt))
+			recentWinners.pop_back();
+
 		VotingMessage newmessage(VotingMessageType::Winner);
 		newmessage.winner = winningOption.index;
 		BroadcastVotingMessage(newmessage);
@@ -352,7 +399,7 @@ namespace Server::Voting
 
 		time(&winnerChosenTime);
 		voteStartedTime = 0;
-		mapVotes.clear();
+		tally.Reset(0);
 	}
 
 	//Starts a new vote
@@ -361,15 +408,20 @@ namespace Server::Voting
 		if (idle)
 			return;
 
+		EnsureSeeded();
 		currentVotingOptions.clear();
 
 		for (unsigned int i = 0; i < Modules::ModuleServer::Instance().VarServerNumberOfVotingOptions->ValueInt; i++)
 		{
-			auto Option = GenerateVotingOption();
-
-			//dissallow duplicates
-			while (std::find(currentVotingOptions.begin(), currentVotingOptions.end(), Option) != currentVotingOptions.end())
+			//Prefer options that aren't duplicates and haven't won recently, then settle for ones that aren't duplicates.
+			//If there aren't enough maps and gametypes for that either, allow a duplicate rather than trying forever.
+			MapAndType Option;
+			for (auto attempt = 0; attempt < MaxOptionAttempts * 2; attempt++)
+			{
 				Option = GenerateVotingOption();
+				if (!IsDuplicateOption(Option) && (attempt >= MaxOptionAttempts || !WonRecently(Option)))
+					break;
+			}
 			Option.index = i + 1;
 			currentVotingOptions.push_back(Option);
 		}
@@ -382,6 +434,8 @@ namespace Server::Voting
 			revote.index = currentVotingOptions.size() + 1;
 			currentVotingOptions.push_back(revote);
 		}
+		tally.Reset(currentVotingOptions.size());
+		tallyChanged = false;
 		time(&voteStartedTime);
 		auto message = GenerateVotingOptionsMessage();
 		BroadcastVotingMessage(message);
@@ -436,6 +490,12 @@ namespace Server::Voting
 		if (voteStartedTime == 0)
 			return;
 
+		//Players who leave mid-vote don't get a say in the outcome
+		if (RemoveDepartedVoters())
+			tallyChanged = true;
+		if (tallyChanged)
+			BroadcastTally();
+
 		auto elapsed = curTime1 - voteStartedTime;
 
 		//Exit if we haven't used up the time yet.
@@ -568,8 +628,8 @@ namespace Server::Voting
 		voteStartedTime = 0;
 		numberOfVetosUsed = 0;
 		startime = 0;
-		currentNumberOfVotes = 0;
-		mapVotes.clear();
+		tally.Reset(0);
+		tallyChanged = false;
 	}
 
 
@@ -579,6 +639,7 @@ namespace Server::Voting
 		if (idle)
 			return;
 
+		EnsureSeeded();
 		numberOfVetosUsed++;
 		currentVetoOption = GenerateVotingOption();
 		currentVetoOption.canveto = true;
@@ -586,21 +647,17 @@ namespace Server::Voting
 		auto message = GenerateVotingOptionsMessage();
 		BroadcastVotingMessage(message);
 
+		tally.Reset(1);
+		tallyChanged = false;
 		time(&voteStartedTime);
 
 	}
 
 
-	/*
-	* Counts the votes, sorts the options by vote tally.
-	*
-	* - Ties are handled like Halo Reach: Ties will be awarded to the latter option.
-	*   So if option 3 has 2 votes and option 4 has 2 votes, option 4 will win.
-	*/
+	//Vetoes the current option if enough players voted to
 	void VetoSystem::FindWinner()
 	{
-		countVotes();
-
+		auto currentNumberOfVotes = tally.GetVoterCount();
 		auto numPlayers = numberOfPlayersInGame();
 		if (currentNumberOfVotes >= (1 + (((numPlayers - 1) * Modules::ModuleServer::Instance().VarVetoVotePassPercentage->ValueInt) / 100))) {
 			revoteFlag = true;
@@ -612,7 +669,7 @@ namespace Server::Voting
 		}
 
 		voteStartedTime = 0;
-		mapVotes.clear();
+		tally.Reset(0);
 	}
 
 	void VetoSystem::SetGameAndMap()
@@ -768,6 +825,12 @@ namespace Server::Voting
 		if (voteStartedTime == 0)
 			return;
 
+		//Players who leave mid-vote don't get a say in the outcome
+		if (RemoveDepartedVoters())
+			tallyChanged = true;
+		if (tallyChanged)
+			BroadcastTally();
+
 		auto elapsed = curTime1 - voteStartedTime;
 
 		//Exit if we haven't used up the time yet.
@@ -779,39 +842,27 @@ namespace Server::Voting
 
 	}
 
-	void VetoSystem::LogVote(const VotingMessage &message, std::string name)
+	void VetoSystem::LogVote(const VotingMessage &message, int playerIndex)
 	{
 		// If we aren't in a vote or if voting is not enabled, exit
 		auto* session = Blam::Network::GetActiveSession();
 		if (!(session && session->IsEstablished() && session->IsHost() && Modules::ModuleServer::Instance().VarVetoSystemEnabled->ValueInt && !Modules::ModuleServer::Instance().VarServerVotingEnabled->ValueInt && voteStartedTime != 0))
 			return;
 
-		unsigned int vote = message.Vote;
-
-
-		// If this person has already voted, then we replace his vote. If not, then we add a new name-vote pair
-		std::map<std::string, int>::iterator it = mapVotes.find(name);
-		if (it != mapVotes.end()) {
-			mapVotes.erase(it);
-		}
-
-		else
-			mapVotes.insert(std::make_pair(name, vote));
-
-		countVotes();
-
-		//create a message to send to all of the players with the new vote counts
-		VotingMessage newmessage(VotingMessageType::VoteTally);
-		newmessage.votes[0] = currentNumberOfVotes;
-		newmessage.votes[1] = currentNumberOfVotes;
-		BroadcastVotingMessage(newmessage);
+		// If this person has already voted, then voting again takes it back
+		if (tally.HasVoted(playerIndex))
+			tally.ClearVote(playerIndex);
+		else if (message.Vote != 1 || !tally.SetVote(playerIndex, 0))
+			return;
 
+		//The new count is sent on the next tick, so a burst of votes only sends one update
+		tallyChanged = true;
 	}
 	void VetoSystem::NewVote() {
 		if (numberOfVetosUsed < Modules::ModuleServer::Instance().VarNumberOfVetoVotes->ValueInt) {
 
 			//we want to start a new veto vote
-			mapVotes.clear();
+			tally.Reset(0);
 			voteStartedTime = 0;
 			StartVoting();
 		}
@@ -853,9 +904,10 @@ namespace Server::Voting
 		}
 
 		//Add 10 items to the playlist
+		EnsureSeeded();
 		for (int i = 0; i < 10; i++) {
-			HaloType gametype = gameTypes[rand() % gameTypes.size()];
-			HaloMap map = haloMaps[rand() % haloMaps.size()];
+			HaloType gametype = gameTypes[random.Next(gameTypes.size())];
+			HaloMap map = haloMaps[random.Next(haloMaps.size())];
 			entirePlaylist.push_back(MapAndType(map, gametype));
 		}
 		currentPlaylist = entirePlaylist;
@@ -1,8 +1,9 @@
 #pragma once
 #include <string>
 #include <vector>
-#include <map>
+#include <deque>
 #include "../Server/VotingPackets.hpp"
+#include "../Server/VoteTally.hpp"
 #include "../Modules/ModuleServer.hpp"
 
 namespace Server::Voting
@@ -53,20 +54,13 @@ namespace Server::Voting
 	struct MapAndType {
 		HaloMap haloMap;
 		HaloType haloType;
-		int Count; //number of votes
 		int index = -1;
 		bool canveto = false;
 		bool isRevoteOption = false;
-		MapAndType() { Count = 0; }
+		MapAndType() {}
 		MapAndType(HaloMap hm, HaloType ht) {
 			haloMap = hm;
 			haloType = ht;
-			Count = 0;
-		}
-
-		//Used for sorting
-		bool operator<(const MapAndType& val) const {
-			return Count < val.Count;
 		}
 
 		//This is used for comparing voting options to see if they are unique. 
@@ -96,19 +90,27 @@ namespace Server::Voting
 			
 			
 		virtual VotingMessage GenerateVotingOptionsMessage() = 0;
-		virtual void LogVote(const VotingMessage &message, std::string name) = 0; //TODO abstract VotingMessage out of VotingSystem
+		virtual void LogVote(const VotingMessage &message, int playerIndex) = 0; //TODO abstract VotingMessage out of VotingSystem
 		void GenerateVotingOptionsMessage(int peer);
 		bool ReloadVotingJson(std::string filename);
 		AbstractVotingSystem();
 	protected:
 			
 			
-		//Map of playerNames and their vote. We can use the playerName safely since mid-session name changes are no longer allowed.
-		std::map<std::string, int> mapVotes = std::map<std::string, int>{};
+		//Each player's vote, kept in the slot for their player index.
+		VoteTally tally;
+		//Set when the tally changes, so that it only gets sent once per tick.
+		bool tallyChanged = false;
+		VotingRandom random;
 		time_t voteStartedTime = 0;
 		bool revoteFlag = false;
 		bool idle = false;
 
+		//Seeds the random number generator from Server.VotingSeed, or from the time if that's 0.
+		void EnsureSeeded();
+		//Clears the votes of players who have left. Returns true if any were cleared.
+		bool RemoveDepartedVoters();
+
 	private:
 		virtual bool LoadJson(std::string filename) = 0;
 		virtual MapAndType GenerateVotingOption() = 0;
@@ -128,7 +130,7 @@ namespace Server::Voting
 		virtual bool isEnabled();
 			
 			
-		virtual void LogVote(const VotingMessage &message, std::string name); //TODO abstract VotingMessage out of VotingSystem
+		virtual void LogVote(const VotingMessage &message, int playerIndex); //TODO abstract VotingMessage out of VotingSystem
 		VotingSystem();
 
 	private:
@@ -136,7 +138,9 @@ namespace Server::Voting
 		virtual void loadDefaultMapsAndTypes();
 		virtual MapAndType GenerateVotingOption();
 
-		void countVotes();
+		bool IsDuplicateOption(const MapAndType &option) const;
+		bool WonRecently(const MapAndType &option) const;
+		void BroadcastTally();
 		void FindWinner();
 		//The time the winner was chosen. Used to determine when to start the game ( 5 seconds after the winner is chosen )
 		time_t winnerChosenTime = 0;
@@ -144,6 +148,8 @@ namespace Server::Voting
 		unsigned int numberOfRevotesUsed = 0;
 		//The current voting options being voted on.
 		std::vector<MapAndType> currentVotingOptions = std::vector<MapAndType>{};
+		//The most recent winners, newest first. These are kept out of new votes when possible.
+		std::deque<std::string> recentWinners = std::deque<std::string>{};
 
 
 		//The pool of maps and gametypes to choose from
@@ -163,7 +169,7 @@ namespace Server::Voting
 		virtual void StartVoting();
 		virtual VotingMessage GenerateVotingOptionsMessage();
 		virtual bool isEnabled();
-		virtual void LogVote(const VotingMessage &message, std::string name); //TODO abstract VotingMessage out of VotingSystem
+		virtual void LogVote(const VotingMessage &message, int playerIndex); //TODO abstract VotingMessage out of VotingSystem
 		VetoSystem();
 
 	private:
@@ -171,7 +177,7 @@ namespace Server::Voting
 		virtual MapAndType GenerateVotingOption();
 		void SetGameAndMap();
 		void SetStartTimer();
-		void countVotes();
+		void BroadcastTally();
 		void FindWinner();
 		virtual void loadDefaultMapsAndTypes();
 
@@ -183,7 +189,6 @@ namespace Server::Voting
 		std::vector<MapAndType> entirePlaylist = std::vector<MapAndType>{};
 		MapAndType currentVetoOption;
 		int numberOfVetosUsed = 0;
-		int currentNumberOfVotes = 0;
 	};
 }
 
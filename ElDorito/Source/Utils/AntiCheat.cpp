@@ -1,65 +1,95 @@
-#include <chrono>
+#include <algorithm>
 #include <tchar.h>
-#include <thread>
 #include <Windows.h>
 #include <Psapi.h>
 
+#include "AntiCheat.hpp"
+#include "AntiCheatScanner.hpp"
+#include "String.hpp"
 #include "../Blam/BlamNetwork.hpp"
 #include "../CommandMap.hpp"
+#include "../Patches/Core.hpp"
 
-namespace Utils::AntiCheat
+namespace
 {
-	static int ticks = 0;
-	void AntiSpeed()
+	using namespace Utils::AntiCheat;
+
+	// How often the background thread scans the process.
+	const std::chrono::milliseconds ScanInterval(15000);
+
+	BOOL CALLBACK EnumWindowTitles(HWND hwnd, LPARAM lParam)
 	{
-		HMODULE hMods[1024];
-		DWORD cbNeeded;
-		unsigned int i;
+		// GetWindowText sends WM_GETTEXT to windows in this process, which would deadlock
+		// if the thread that owns the window is waiting for the scanner to stop.
+		// InternalGetWindowText reads the title without sending anything.
+		auto titles = reinterpret_cast<std::vector<std::string>*>(lParam);
+		wchar_t title[80];
+		if (InternalGetWindowText(hwnd, title, sizeof(title) / sizeof(title[0])) > 0)
+			titles->push_back(Utils::String::ThinString(title));
+		return TRUE;
+	}
 
-		EnumProcessModules(GetCurrentProcess(), hMods, sizeof(hMods), &cbNeeded);
+	// Inspects the current process using the Win32 API.
+	class Win32ProcessInspector : public ProcessInspector
+	{
+	public:
+		void GetModulePaths(std::vector<std::string> *result) override
 		{
-			for (i = 0; i < (cbNeeded / sizeof(HMODULE)); i++)
+			HMODULE hMods[1024];
+			DWORD cbNeeded;
+			if (!EnumProcessModules(GetCurrentProcess(), hMods, sizeof(hMods), &cbNeeded))
+				return;
+
+			auto count = std::min(cbNeeded / sizeof(HMODULE), sizeof(hMods) / sizeof(HMODULE));
+			for (auto i = 0U; i < count; i++)
 			{
 				TCHAR szModName[MAX_PATH];
 				if (GetModuleFileNameEx(GetCurrentProcess(), hMods[i], szModName, sizeof(szModName) / sizeof(TCHAR)))
-				{
-					if (std::strstr(szModName, "speedhack-i386.dll") != NULL)//found speedhack dll from cheat engine.
-					{
-						Modules::CommandMap::Instance().ExecuteCommand("exit"); //exit game
-					}
-				}
+					result->push_back(szModName);
 			}
 		}
+
+		void GetWindowTitles(std::vector<std::string> *result) override
+		{
+			EnumWindows(EnumWindowTitles, reinterpret_cast<LPARAM>(result));
+		}
+	};
+
+	Scanner& GetScanner()
+	{
+		static Scanner scanner(std::make_shared<Win32ProcessInspector>(), ScanInterval);
+		return scanner;
 	}
+}
 
-	//Should keep the script kiddies away.
-	//TODO: Replace with a better check
-	BOOL CALLBACK AntiTrainer(HWND hwnd, LPARAM lParam)
+namespace Utils::AntiCheat
+{
+	void OnTickCheck()
 	{
-		char title[80];
-		GetWindowText(hwnd, title, sizeof(title));
-		if (strcmp(title, "Halo Online Trainer") == 0)
+		static auto started = false;
+		auto &scanner = GetScanner();
+		if (!started)
+		{
+			started = true;
+			scanner.Start();
+			Patches::Core::OnShutdown([]() { GetScanner().Stop(); });
+		}
+
+		switch (scanner.TakeVerdict())
+		{
+		case Verdict::SpeedHack:
+			Modules::CommandMap::Instance().ExecuteCommand("exit"); //exit game
+			break;
+		case Verdict::Trainer:
 		{
 			auto session = Blam::Network::GetActiveSession();
-			if (session && session->IsEstablished() && !session->IsHost()) 
+			if (session && session->IsEstablished() && !session->IsHost())
 			{
 				MessageBox(NULL, "Detected Halo Online Trainer!\nOnly hosts are allowed to use a trainer!", "AntiCheat", MB_OK); //Tell the user what they did wrong.
 				Modules::CommandMap::Instance().ExecuteCommand("exit"); //exit game
 			}
+			break;
 		}
-
-		return TRUE;
-	}
-
-	void OnTickCheck()
-	{
-		if (ticks > 1000)//Only check every so many ticks
-		{
-			ticks = 0;
-			AntiSpeed();
-			EnumWindows(AntiTrainer, NULL);
 		}
-		else
-			ticks++;
 	}
 }
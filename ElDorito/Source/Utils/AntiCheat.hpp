@@ -2,6 +2,6 @@
 
 namespace Utils::AntiCheat
 {
-	void AntiSpeed();
+	// Starts the background scanner if needed and acts on its latest verdict.
 	void OnTickCheck();
 }
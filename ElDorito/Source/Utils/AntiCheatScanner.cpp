@@ -0,0 +1,93 @@
+#include "AntiCheatScanner.hpp"
+
+namespace
+{
+	// The speedhack DLL which Cheat Engine injects.
+	const char* SpeedHackModuleName = "speedhack-i386.dll";
+
+	// Should keep the script kiddies away.
+	// TODO: Replace with a better check
+	const char* TrainerWindowTitle = "Halo Online Trainer";
+}
+
+namespace Utils::AntiCheat
+{
+	Verdict Scan(ProcessInspector *inspector)
+	{
+		std::vector<std::string> modulePaths;
+		inspector->GetModulePaths(&modulePaths);
+		for (auto &&path : modulePaths)
+		{
+			if (path.find(SpeedHackModuleName) != std::string::npos)
+				return Verdict::SpeedHack;
+		}
+
+		std::vector<std::string> windowTitles;
+		inspector->GetWindowTitles(&windowTitles);
+		for (auto &&title : windowTitles)
+		{
+			if (title == TrainerWindowTitle)
+				return Verdict::Trainer;
+		}
+		return Verdict::Clean;
+	}
+
+	Scanner::Scanner(std::shared_ptr<ProcessInspector> inspector, std::chrono::milliseconds interval)
+		: inspector(inspector), interval(interval), stopping(false), verdict(static_cast<int>(Verdict::Clean))
+	{
+	}
+
+	Scanner::~Scanner()
+	{
+		Stop();
+	}
+
+	void Scanner::Start()
+	{
+		if (worker.joinable())
+			return;
+
+		stopping = false;
+		worker = std::thread(&Scanner::Run, this);
+	}
+
+	void Scanner::Stop()
+	{
+		if (!worker.joinable())
+			return;
+
+		{
+			std::lock_guard<std::mutex> lock(stopMutex);
+			stopping = true;
+		}
+		stopCondition.notify_all();
+		worker.join();
+	}
+
+	void Scanner::ScanNow()
+	{
+		auto result = Scan(inspector.get());
+		if (result != Verdict::Clean)
+			verdict = static_cast<int>(result);
+	}
+
+	Verdict Scanner::TakeVerdict()
+	{
+		return static_cast<Verdict>(verdict.exchange(static_cast<int>(Verdict::Clean)));
+	}
+
+	void Scanner::Run()
+	{
+		std::unique_lock<std::mutex> lock(stopMutex);
+		while (!stopping)
+		{
+			// Wait on the condition so that Stop() doesn't have to wait out the interval
+			if (stopCondition.wait_for(lock, interval, [this] { return stopping; }))
+				break;
+
+			lock.unlock();
+			ScanNow();
+			lock.lock();
+		}
+	}
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Utils::AntiCheat
+{
+	// The result of a scan.
+	enum class Verdict
+	{
+		// Nothing suspicious was found.
+		Clean,
+
+		// Cheat Engine's speedhack DLL is loaded into the process.
+		SpeedHack,
+
+		// A known trainer window is open.
+		Trainer,
+	};
+
+	// Interface for a class which enumerates the state a scan looks at.
+	class ProcessInspector
+	{
+	public:
+		virtual ~ProcessInspector() { }
+
+		// Gets the paths of the modules loaded into the process.
+		virtual void GetModulePaths(std::vector<std::string> *result) = 0;
+
+		// Gets the titles of the top-level windows on the desktop.
+		virtual void GetWindowTitles(std::vector<std::string> *result) = 0;
+	};
+
+	// Scans a process and returns what was found.
+	Verdict Scan(ProcessInspector *inspector);
+
+	// Periodically scans a process on a background thread. Only the verdict
+	// is handed back, so the thread calling TakeVerdict() never enumerates
+	// anything itself.
+	class Scanner
+	{
+	public:
+		Scanner(std::shared_ptr<ProcessInspector> inspector, std::chrono::milliseconds interval);
+		~Scanner();
+
+		// Starts the background thread if it isn't running.
+		void Start();
+
+		// Stops the background thread and waits for it to exit.
+		void Stop();
+
+		// Runs a scan on the calling thread and records its verdict.
+		void ScanNow();
+
+		// Gets the most recent non-clean verdict and resets it to clean.
+		Verdict TakeVerdict();
+
+	private:
+		void Run();
+
+		std::shared_ptr<ProcessInspector> inspector;
+		std::chrono::milliseconds interval;
+		std::thread worker;
+		std::mutex stopMutex;
+		std::condition_variable stopCondition;
+		bool stopping;
+		std::atomic<int> verdict;
+	};
+}
@@ -143,31 +143,25 @@ namespace Utils
 			std::string message(entry.Message);
 			delete[] entry.Message;
 
-			for (auto filter : gameModule.FiltersExclude)
-			{
-				// TODO: case-insensitive comparison
-				if (strstr(message.c_str(), filter.c_str()) != nullptr)
-					goto closefile; // string contains an excluded string
-			}
-
-			for (auto filter : gameModule.FiltersInclude)
-			{
-				// TODO: case-insensitive comparison
-				if (strstr(message.c_str(), filter.c_str()) != nullptr)
-					continue;
-
-				goto closefile;  // string doesn't contain an included string
-			}
+			// TODO: case-insensitive comparison
+			if (excludeFilters.MatchesAny(message.c_str()) || !includeFilters.MatchesAll(message.c_str()))
+				continue;
 
 			time_t t = std::chrono::system_clock::to_time_t(entry.Time);
 			tm ourLocalTime;
 			if (localtime_s(&ourLocalTime, &t) != 0)
-				goto closefile;
+				continue;
 
 			outfile << '[' << std::put_time(&ourLocalTime, "%H:%M:%S") << "] " << LogTypesToString(entry.Type) << " - " << message << '\n';
 		}
 
-		closefile:
 		outfile.close();
 	}
+
+	void Logger::SetFilters(const std::vector<std::string> &include, const std::vector<std::string> &exclude)
+	{
+		std::lock_guard<std::mutex> lock(flushMutex);
+		includeFilters.Compile(include);
+		excludeFilters.Compile(exclude);
+	}
 }
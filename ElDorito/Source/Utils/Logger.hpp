@@ -1,6 +1,8 @@
 #pragma once
 #include "Singleton.hpp"
+#include "MultiPatternMatcher.hpp"
 #include <string>
+#include <vector>
 #include <boost/lockfree/queue.hpp>
 #include <mutex>
 #include <windows.h>
@@ -45,6 +47,9 @@ namespace Utils
 		std::mutex flushMutex;
 		static DWORD WINAPI Flusher(LPVOID lpParam);
 
+		MultiPatternMatcher includeFilters;
+		MultiPatternMatcher excludeFilters;
+
 	public:
 		LogLevel Level;
 		LogTypes Types;
@@ -54,5 +59,9 @@ namespace Utils
 
 		void Log(LogTypes type, LogLevel level, std::string message, ...);
 		void Flush();
+
+		// Sets the filters applied when messages are written. Messages are only written
+		// if they contain every include filter and none of the exclude filters.
+		void SetFilters(const std::vector<std::string> &include, const std::vector<std::string> &exclude);
 	};
 }
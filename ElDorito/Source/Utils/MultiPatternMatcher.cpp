@@ -0,0 +1,130 @@
+#include "MultiPatternMatcher.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <queue>
+
+namespace Utils
+{
+	MultiPatternMatcher::MultiPatternMatcher()
+	{
+		Compile({});
+	}
+
+	MultiPatternMatcher::MultiPatternMatcher(const std::vector<std::string> &patterns)
+	{
+		Compile(patterns);
+	}
+
+	void MultiPatternMatcher::Compile(const std::vector<std::string> &patterns)
+	{
+		nodes.clear();
+		nodes.push_back({ {}, 0, NoNode, {} });
+		emptyPatterns.clear();
+		patternCount = patterns.size();
+
+		// Build a trie out of the patterns
+		for (size_t i = 0; i < patterns.size(); i++)
+		{
+			if (patterns[i].empty())
+			{
+				emptyPatterns.push_back(static_cast<uint32_t>(i));
+				continue;
+			}
+
+			uint32_t node = 0;
+			for (auto ch : patterns[i])
+			{
+				auto &edges = nodes[node].Edges;
+				auto edge = std::lower_bound(edges.begin(), edges.end(), std::make_pair(static_cast<uint8_t>(ch), 0u));
+				if (edge != edges.end() && edge->first == static_cast<uint8_t>(ch))
+				{
+					node = edge->second;
+					continue;
+				}
+
+				auto next = static_cast<uint32_t>(nodes.size());
+				edges.insert(edge, std::make_pair(static_cast<uint8_t>(ch), next));
+				nodes.push_back({ {}, 0, NoNode, {} });
+				node = next;
+			}
+			nodes[node].Patterns.push_back(static_cast<uint32_t>(i));
+		}
+
+		std::fill(std::begin(rootNext), std::end(rootNext), 0);
+		for (auto &edge : nodes[0].Edges)
+			rootNext[edge.first] = edge.second;
+
+		// Link each node to the node for its longest proper suffix, going breadth-first so that suffixes are done first
+		std::queue<uint32_t> queue;
+		for (auto &edge : nodes[0].Edges)
+			queue.push(edge.second);
+		while (!queue.empty())
+		{
+			auto node = queue.front();
+			queue.pop();
+
+			auto &fail = nodes[nodes[node].Fail];
+			nodes[node].OutputLink = !fail.Patterns.empty() ? nodes[node].Fail : fail.OutputLink;
+
+			for (auto &edge : nodes[node].Edges)
+			{
+				nodes[edge.second].Fail = Next(nodes[node].Fail, edge.first);
+				queue.push(edge.second);
+			}
+		}
+	}
+
+	bool MultiPatternMatcher::MatchesAny(const char *text) const
+	{
+		if (!emptyPatterns.empty())
+			return true;
+
+		uint32_t state = 0;
+		for (auto ch = text; *ch; ch++)
+		{
+			state = Next(state, static_cast<uint8_t>(*ch));
+			if (!nodes[state].Patterns.empty() || nodes[state].OutputLink != NoNode)
+				return true;
+		}
+		return false;
+	}
+
+	bool MultiPatternMatcher::MatchesAll(const char *text) const
+	{
+		if (patternCount == 0)
+			return true;
+
+		// Duplicate patterns are found together, so count them all at once
+		std::vector<bool> found(patternCount);
+		size_t remaining = patternCount;
+		ForEachMatch(text, [&](size_t pattern)
+		{
+			if (!found[pattern])
+			{
+				found[pattern] = true;
+				remaining--;
+			}
+		});
+		return remaining == 0;
+	}
+
+	uint32_t MultiPatternMatcher::FindEdge(uint32_t node, uint8_t ch) const
+	{
+		auto &edges = nodes[node].Edges;
+		auto edge = std::lower_bound(edges.begin(), edges.end(), std::make_pair(ch, 0u));
+		return (edge != edges.end() && edge->first == ch) ? edge->second : NoNode;
+	}
+
+	uint32_t MultiPatternMatcher::Next(uint32_t state, uint8_t ch) const
+	{
+		while (state != 0)
+		{
+			auto next = FindEdge(state, ch);
+			if (next != NoNode)
+				return next;
+			state = nodes[state].Fail;
+		}
+		return rootNext[ch];
+	}
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Utils
+{
+	// Searches text for a set of strings in a single pass, no matter how many strings there are.
+	// The strings are compiled into an Aho-Corasick automaton, so compile once and reuse the matcher.
+	class MultiPatternMatcher
+	{
+	public:
+		// Constructs a matcher with no patterns.
+		MultiPatternMatcher();
+
+		// Constructs a matcher and compiles a set of patterns.
+		explicit MultiPatternMatcher(const std::vector<std::string> &patterns);
+
+		// Replaces the patterns in the matcher.
+		void Compile(const std::vector<std::string> &patterns);
+
+		// Gets the number of patterns, including duplicates.
+		size_t PatternCount() const { return patternCount; }
+
+		// Returns true if any pattern occurs in a string.
+		bool MatchesAny(const char *text) const;
+
+		// Returns true if every pattern occurs in a string. This is true if there are no patterns.
+		bool MatchesAll(const char *text) const;
+
+		// Calls a function with the index of a pattern each time it occurs in a string.
+		// Empty patterns are reported once, before anything else.
+		template<class Func>
+		void ForEachMatch(const char *text, Func callback) const
+		{
+			for (auto pattern : emptyPatterns)
+				callback(static_cast<size_t>(pattern));
+
+			uint32_t state = 0;
+			for (auto ch = text; *ch; ch++)
+			{
+				state = Next(state, static_cast<uint8_t>(*ch));
+				for (auto node = state; node != NoNode; node = nodes[node].OutputLink)
+				{
+					for (auto pattern : nodes[node].Patterns)
+						callback(static_cast<size_t>(pattern));
+				}
+			}
+		}
+
+	private:
+		static const uint32_t NoNode = 0xFFFFFFFF;
+
+		struct Node
+		{
+			std::vector<std::pair<uint8_t, uint32_t>> Edges; // Sorted by character
+			uint32_t Fail;
+			uint32_t OutputLink; // The closest node along the fail links which ends a pattern
+			std::vector<uint32_t> Patterns;
+		};
+
+		std::vector<Node> nodes;
+		uint32_t rootNext[256]; // Most characters in a text lead back to the root, so its edges are looked up directly
+		std::vector<uint32_t> emptyPatterns;
+		size_t patternCount;
+
+		uint32_t FindEdge(uint32_t node, uint8_t ch) const;
+		uint32_t Next(uint32_t state, uint8_t ch) const;
+	};
+}
@@ -1,5 +1,6 @@
 #pragma once
 #include "ClientFunctions.hpp"
+#include "CommandListCache.hpp"
 #include "../../Ui/ScreenLayer.hpp"
 #include "../../Ui/WebVirtualKeyboard.hpp"
 #include "../../Ui/WebForge.hpp"
@@ -23,6 +24,8 @@ namespace
 	uint16_t PingId;
 	bool PingHandlerRegistered;
 
+	Anvil::Client::Rendering::Bridge::CommandListCache CommandList;
+
 	void PongReceived(const Blam::Network::NetworkAddress &from, uint32_t timestamp, uint16_t id, uint32_t latency);
 }
 
@@ -246,97 +249,21 @@ namespace Anvil::Client::Rendering::Bridge::ClientFunctions
 	QueryError OnCommands(const rapidjson::Value &p_Args, std::string *p_Result)
 	{
 		const auto &commandMap = Modules::CommandMap::Instance();
-						
-		rapidjson::StringBuffer buffer;
-		rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
-		writer.StartArray();
-		for (auto &&command : commandMap.Commands)
+
+		// If a "since" version is given, only send the commands which changed after it
+		auto sinceArg = p_Args.FindMember("since");
+		if (sinceArg != p_Args.MemberEnd())
 		{
-			writer.StartObject();
-			writer.Key("type");
-			writer.Int(command.Type);
-			writer.Key("module");
-			writer.String(command.ModuleName.c_str());
-			writer.Key("name");
-			writer.String(command.Name.c_str());
-			writer.Key("shortName");
-			writer.String(command.ShortName.c_str());
-			writer.Key("description");
-			writer.String(command.Description.c_str());
-			switch (command.Type)
+			if (!sinceArg->value.IsUint())
 			{
-			case Modules::eCommandTypeVariableInt:
-				writer.Key("value");
-				writer.Int(command.ValueInt);
-				writer.Key("defaultValue");
-				writer.Int(command.DefaultValueInt);
-				writer.Key("minValue");
-				writer.Int(command.ValueIntMin);
-				writer.Key("maxValue");
-				writer.Int(command.ValueIntMax);
-				break;
-			case Modules::eCommandTypeVariableInt64:
-				writer.Key("value");
-				writer.Int64(command.ValueInt64);
-				writer.Key("defaultValue");
-				writer.Int64(command.DefaultValueInt64);
-				writer.Key("minValue");
-				writer.Int64(command.ValueInt64Min);
-				writer.Key("maxValue");
-				writer.Int64(command.ValueInt64Max);
-				break;
-			case Modules::eCommandTypeVariableFloat:
-				writer.Key("value");
-				writer.Double(command.ValueFloat);
-				writer.Key("defaultValue");
-				writer.Double(command.DefaultValueFloat);
-				writer.Key("minValue");
-				writer.Double(command.ValueFloatMin);
-				writer.Key("maxValue");
-				writer.Double(command.ValueFloatMax);
-				break;
-			case Modules::eCommandTypeVariableString:
-				writer.Key("value");
-				writer.String(command.ValueString.c_str());
-				writer.Key("defaultValue");
-				writer.String(command.DefaultValueString.c_str());
-				writer.Key("minValue");
-				writer.Null();
-				writer.Key("maxValue");
-				writer.Null();
-				break;
-			default:
-				writer.Key("value");
-				writer.Null();
-				writer.Key("defaultValue");
-				writer.Null();
-				writer.Key("minValue");
-				writer.Null();
-				writer.Key("maxValue");
-				writer.Null();
-				break;
+				*p_Result = "Bad query: \"since\" argument must be a version number";
+				return QueryError_BadQuery;
 			}
-			writer.Key("replicated");
-			writer.Bool((command.Flags & eCommandFlagsReplicated) != 0);
-			writer.Key("archived");
-			writer.Bool((command.Flags & eCommandFlagsArchived) != 0);
-			writer.Key("hidden");
-			writer.Bool((command.Flags & eCommandFlagsHidden) != 0);
-			writer.Key("hostOnly");
-			writer.Bool((command.Flags & eCommandFlagsHostOnly) != 0);
-			writer.Key("hideValue");
-			writer.Bool((command.Flags & eCommandFlagsOmitValueInList) != 0);
-			writer.Key("internal");
-			writer.Bool((command.Flags & eCommandFlagsInternal) != 0);
-			writer.Key("arguments");
-			writer.StartArray();
-			for (auto &&arg : command.CommandArgs)
-				writer.String(arg.c_str());
-			writer.EndArray();
-			writer.EndObject();
+			*p_Result = CommandList.GetChangesSince(commandMap, sinceArg->value.GetUint());
+			return QueryError_Ok;
 		}
-		writer.EndArray();
-		*p_Result = buffer.GetString();
+
+		*p_Result = CommandList.GetList(commandMap);
 		return QueryError_Ok;
 	}
 
@@ -0,0 +1,30 @@
+#pragma once
+#include <string>
+
+namespace Modules
+{
+	class CommandMap;
+}
+
+namespace Anvil::Client::Rendering::Bridge
+{
+	// Builds the JSON command listings sent to the web UI.
+	class CommandListCache
+	{
+	public:
+		CommandListCache();
+
+		// Gets a JSON array of every command.
+		// It's only rebuilt when the command map's version has changed since the last call.
+		const std::string& GetList(const Modules::CommandMap &commandMap);
+
+		// Gets a JSON object holding the command map's current version and
+		// an array of the commands which were added or changed after a version.
+		std::string GetChangesSince(const Modules::CommandMap &commandMap, unsigned int since) const;
+
+	private:
+		std::string list;
+		unsigned int listVersion;
+		bool listBuilt;
+	};
+}
@@ -15,7 +15,8 @@ namespace Anvil::Client::Rendering::Bridge
 		QueryError_InvalidArgument,
 		QueryError_NetworkError,
 		QueryError_NotAvailable,
-		QueryError_CommandFailed
+		QueryError_CommandFailed,
+		QueryError_Busy
 	};
 
 	// Signature for a function that handles queries.
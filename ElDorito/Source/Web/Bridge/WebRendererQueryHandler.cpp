@@ -1,41 +1,195 @@
 #include "WebRendererQueryHandler.hpp"
+#include "../../ThirdParty/rapidjson/writer.h"
+#include "../../ThirdParty/rapidjson/stringbuffer.h"
 
+#include <algorithm>
+
+using Anvil::Client::Rendering::Bridge::QueryError;
 using Anvil::Client::Rendering::Bridge::WebRendererQuery;
 using Anvil::Client::Rendering::Bridge::WebRendererQueryHandler;
+using Anvil::Client::Rendering::Bridge::WebRendererQueryStats;
+
+namespace
+{
+	double ElapsedMs(std::chrono::steady_clock::time_point p_Start, std::chrono::steady_clock::time_point p_End)
+	{
+		return std::chrono::duration<double, std::milli>(p_End - p_Start).count();
+	}
+}
 
 WebRendererQueryHandler::WebRendererQueryHandler() :
-	m_Queries(1024)
+	m_Queries(MaxPendingQueries)
+{
+	AddMethod("queryStats", [this](const rapidjson::Value &p_Args, std::string *p_Result)
+	{
+		*p_Result = SerializeStats();
+		return QueryError_Ok;
+	});
+}
+
+WebRendererQueryHandler::~WebRendererQueryHandler()
 {
+	PendingQuery *s_Query;
+	while (m_Queries.pop(s_Query))
+		delete s_Query;
 }
 
 bool WebRendererQueryHandler::OnQuery(CefRefPtr<CefBrowser> p_Browser, CefRefPtr<CefFrame> p_Frame, int64 p_QueryId, const CefString &p_Request, bool p_Persistent, CefRefPtr<Callback> p_Callback)
 {
-	auto s_Query = new PendingQuery();
+	std::unique_ptr<PendingQuery> s_Query(new PendingQuery());
 
 	// Parse the JSON request
 	auto &s_Json = s_Query->m_Json;
 	auto s_RequestStr = p_Request.ToString();
 	s_Json.Parse(s_RequestStr.c_str());
-	if (s_Json.HasParseError())
+	if (s_Json.HasParseError() || !s_Json.IsObject())
 	{
 		p_Callback->Failure(QueryError_BadQuery, "Bad query: Failed to parse JSON");
-		delete s_Query;
 		return true;
 	}
 
-	// Get the method name
-	auto s_MethodMember = s_Json.FindMember("method");
-	if (s_MethodMember == s_Json.MemberEnd())
+	// A "batch" array holds several calls, otherwise the query itself is the call
+	auto s_BatchMember = s_Json.FindMember("batch");
+	s_Query->m_IsBatch = (s_BatchMember != s_Json.MemberEnd());
+	if (s_Query->m_IsBatch)
 	{
-		p_Callback->Failure(QueryError_BadQuery, "Bad query: A \"method\" value is required");
-		delete s_Query;
+		if (!s_BatchMember->value.IsArray() || s_BatchMember->value.Empty())
+		{
+			p_Callback->Failure(QueryError_BadQuery, "Bad query: \"batch\" must be a non-empty array");
+			return true;
+		}
+		if (s_BatchMember->value.Size() > MaxBatchSize)
+		{
+			p_Callback->Failure(QueryError_BadQuery, "Bad query: A batch can have at most " + std::to_string(MaxBatchSize) + " calls");
+			return true;
+		}
+
+		// Calls which can't be parsed fail on their own without failing the rest of the batch
+		for (auto &s_CallJson : s_BatchMember->value.GetArray())
+		{
+			PendingCall s_Call;
+			s_Call.m_ErrorCode = ParseCall(s_CallJson, &s_Call, &s_Call.m_Result);
+			s_Query->m_Calls.push_back(std::move(s_Call));
+		}
+	}
+	else
+	{
+		PendingCall s_Call;
+		std::string s_Error;
+		auto s_ErrorCode = ParseCall(s_Json, &s_Call, &s_Error);
+		if (s_ErrorCode != QueryError_Ok)
+		{
+			p_Callback->Failure(s_ErrorCode, s_Error);
+			return true;
+		}
+		s_Query->m_Calls.push_back(std::move(s_Call));
+	}
+
+	// Push the query onto the command queue, or tell the caller to back off if it's full
+	s_Query->m_NextCall = 0;
+	s_Query->m_QueueTime = Clock::now();
+	s_Query->m_Callback = p_Callback;
+	if (!m_Queries.bounded_push(s_Query.get()))
+	{
+		p_Callback->Failure(QueryError_Busy, "Busy: Too many queries are pending, try again later");
 		return true;
 	}
+	s_Query.release();
+	return true;
+}
+
+void WebRendererQueryHandler::OnQueryCanceled(CefRefPtr<CefBrowser> p_Browser, CefRefPtr<CefFrame> p_Frame, int64 p_QueryId)
+{
+}
+
+void WebRendererQueryHandler::AddMethod(const std::string &p_Name, const WebRendererQuery &p_Method)
+{
+	auto &s_Method = m_Methods[p_Name];
+	s_Method.m_Handler = p_Method;
+	s_Method.m_Stats = {};
+}
+
+void WebRendererQueryHandler::Update()
+{
+	auto s_FrameStart = Clock::now();
+	size_t s_CallsRun = 0;
+	while (true)
+	{
+		// Continue the query left over from the last frame before taking a new one
+		if (!m_CurrentQuery)
+		{
+			PendingQuery *s_PendingQuery;
+			if (!m_Queries.pop(s_PendingQuery))
+				break;
+			m_CurrentQuery.reset(s_PendingQuery);
+		}
+
+		auto &s_Query = *m_CurrentQuery;
+		while (s_Query.m_NextCall < s_Query.m_Calls.size())
+		{
+			auto s_Now = Clock::now();
+			if (s_CallsRun > 0 && (s_CallsRun >= MaxCallsPerFrame ||
+				std::chrono::duration_cast<std::chrono::microseconds>(s_Now - s_FrameStart).count() >= MaxFrameTimeUs))
+			{
+				return;
+			}
+
+			auto &s_Call = s_Query.m_Calls[s_Query.m_NextCall++];
+			if (!s_Call.m_Method)
+				continue; // Failed to parse
+
+			s_Call.m_ErrorCode = s_Call.m_Method->m_Handler(*s_Call.m_Args, &s_Call.m_Result);
+			s_CallsRun++;
+
+			auto s_RunTime = ElapsedMs(s_Now, Clock::now());
+			auto s_WaitTime = ElapsedMs(s_Query.m_QueueTime, s_Now);
+			auto &s_Stats = s_Call.m_Method->m_Stats;
+			s_Stats.m_Calls++;
+			if (s_Call.m_ErrorCode != QueryError_Ok)
+				s_Stats.m_Failures++;
+			s_Stats.m_TotalRunTime += s_RunTime;
+			s_Stats.m_MaxRunTime = std::max(s_Stats.m_MaxRunTime, s_RunTime);
+			s_Stats.m_TotalWaitTime += s_WaitTime;
+			s_Stats.m_MaxWaitTime = std::max(s_Stats.m_MaxWaitTime, s_WaitTime);
+		}
+
+		FinishQuery(&s_Query);
+		m_CurrentQuery.reset();
+	}
+}
+
+bool WebRendererQueryHandler::GetStats(const std::string &p_Name, WebRendererQueryStats *p_Stats) const
+{
+	auto s_MethodIt = m_Methods.find(p_Name);
+	if (s_MethodIt == m_Methods.end())
+		return false;
+	*p_Stats = s_MethodIt->second.m_Stats;
+	return true;
+}
+
+QueryError WebRendererQueryHandler::ParseCall(const rapidjson::Value &p_Call, PendingCall *p_Result, std::string *p_Error)
+{
+	p_Result->m_Method = nullptr;
+	p_Result->m_Args = nullptr;
+	p_Result->m_ErrorCode = QueryError_Ok;
+
+	if (!p_Call.IsObject())
+	{
+		*p_Error = "Bad query: Each call must be an object";
+		return QueryError_BadQuery;
+	}
+
+	// Get the method name
+	auto s_MethodMember = p_Call.FindMember("method");
+	if (s_MethodMember == p_Call.MemberEnd())
+	{
+		*p_Error = "Bad query: A \"method\" value is required";
+		return QueryError_BadQuery;
+	}
 	if (!s_MethodMember->value.IsString())
 	{
-		p_Callback->Failure(QueryError_BadQuery, "Bad query: \"method\" must be a string");
-		delete s_Query;
-		return true;
+		*p_Error = "Bad query: \"method\" must be a string";
+		return QueryError_BadQuery;
 	}
 	auto s_Method = s_MethodMember->value.GetString();
 
@@ -43,56 +197,84 @@ bool WebRendererQueryHandler::OnQuery(CefRefPtr<CefBrowser> p_Browser, CefRefPtr
 	auto s_MethodIt = m_Methods.find(s_Method);
 	if (s_MethodIt == m_Methods.end())
 	{
-		p_Callback->Failure(QueryError_UnsupportedMethod, "Unsupported method: \"" + std::string(s_Method) + "\"");
-		delete s_Query;
-		return true;
+		*p_Error = "Unsupported method: \"" + std::string(s_Method) + "\"";
+		return QueryError_UnsupportedMethod;
 	}
-	s_Query->m_Method = s_MethodIt->second;
 
 	// Get the method arguments object
-	auto s_ArgsMember = s_Json.FindMember("args");
-	if (s_ArgsMember == s_Json.MemberEnd())
+	auto s_ArgsMember = p_Call.FindMember("args");
+	if (s_ArgsMember == p_Call.MemberEnd())
 	{
-		p_Callback->Failure(QueryError_BadQuery, "Bad query: An \"args\" value is required");
-		delete s_Query;
-		return true;
+		*p_Error = "Bad query: An \"args\" value is required";
+		return QueryError_BadQuery;
 	}
 	if (!s_ArgsMember->value.IsObject())
 	{
-		p_Callback->Failure(QueryError_BadQuery, "Bad query: \"args\" must be an object");
-		delete s_Query;
-		return true;
+		*p_Error = "Bad query: \"args\" must be an object";
+		return QueryError_BadQuery;
 	}
-	s_Query->m_Args = &s_ArgsMember->value;
 
-	// Push the query onto the command queue
-	s_Query->m_Callback = p_Callback;
-	m_Queries.push(s_Query);
-	return true;
+	p_Result->m_Method = &s_MethodIt->second;
+	p_Result->m_Args = &s_ArgsMember->value;
+	return QueryError_Ok;
 }
 
-void WebRendererQueryHandler::OnQueryCanceled(CefRefPtr<CefBrowser> p_Browser, CefRefPtr<CefFrame> p_Frame, int64 p_QueryId)
+void WebRendererQueryHandler::FinishQuery(PendingQuery *p_Query)
 {
-}
+	if (!p_Query->m_IsBatch)
+	{
+		auto &s_Call = p_Query->m_Calls[0];
+		if (s_Call.m_ErrorCode == QueryError_Ok)
+			p_Query->m_Callback->Success(s_Call.m_Result);
+		else
+			p_Query->m_Callback->Failure(s_Call.m_ErrorCode, s_Call.m_Result);
+		return;
+	}
 
-void WebRendererQueryHandler::AddMethod(const std::string &p_Name, const WebRendererQuery &p_Method)
-{
-	m_Methods[p_Name] = p_Method;
+	// Batches always succeed and report the result of each call in order
+	rapidjson::StringBuffer s_Buffer;
+	rapidjson::Writer<rapidjson::StringBuffer> s_Writer(s_Buffer);
+	s_Writer.StartArray();
+	for (auto &s_Call : p_Query->m_Calls)
+	{
+		s_Writer.StartObject();
+		s_Writer.Key("code");
+		s_Writer.Int(s_Call.m_ErrorCode);
+		s_Writer.Key("result");
+		s_Writer.String(s_Call.m_Result.c_str());
+		s_Writer.EndObject();
+	}
+	s_Writer.EndArray();
+	p_Query->m_Callback->Success(s_Buffer.GetString());
 }
 
-void WebRendererQueryHandler::Update()
+std::string WebRendererQueryHandler::SerializeStats() const
 {
-	// Process each pending query
-	PendingQuery *s_PendingQuery;
-	while (m_Queries.pop(s_PendingQuery))
+	rapidjson::StringBuffer s_Buffer;
+	rapidjson::Writer<rapidjson::StringBuffer> s_Writer(s_Buffer);
+	s_Writer.StartObject();
+	for (auto &s_Method : m_Methods)
 	{
-		std::unique_ptr<PendingQuery> s_Query(s_PendingQuery); // For safety
+		auto &s_Stats = s_Method.second.m_Stats;
+		if (s_Stats.m_Calls == 0)
+			continue;
 
-		std::string s_Result;
-		auto s_ErrorCode = s_Query->m_Method(*s_Query->m_Args, &s_Result);
-		if (s_ErrorCode == QueryError_Ok)
-			s_Query->m_Callback->Success(s_Result);
-		else
-			s_Query->m_Callback->Failure(s_ErrorCode, s_Result);
+		s_Writer.Key(s_Method.first.c_str());
+		s_Writer.StartObject();
+		s_Writer.Key("calls");
+		s_Writer.Uint(s_Stats.m_Calls);
+		s_Writer.Key("failures");
+		s_Writer.Uint(s_Stats.m_Failures);
+		s_Writer.Key("averageRunTime");
+		s_Writer.Double(s_Stats.m_TotalRunTime / s_Stats.m_Calls);
+		s_Writer.Key("maxRunTime");
+		s_Writer.Double(s_Stats.m_MaxRunTime);
+		s_Writer.Key("averageWaitTime");
+		s_Writer.Double(s_Stats.m_TotalWaitTime / s_Stats.m_Calls);
+		s_Writer.Key("maxWaitTime");
+		s_Writer.Double(s_Stats.m_MaxWaitTime);
+		s_Writer.EndObject();
 	}
-}
\ No newline at end of file
+	s_Writer.EndObject();
+	return s_Buffer.GetString();
+}
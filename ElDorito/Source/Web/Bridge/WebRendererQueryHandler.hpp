@@ -2,35 +2,94 @@
 
 #include <include/wrapper/cef_message_router.h>
 #include <boost/lockfree/queue.hpp>
+#include <chrono>
+#include <cstdint>
+#include <memory>
 #include <unordered_map>
 #include <string>
+#include <vector>
 #include "../../ThirdParty/rapidjson/document.h"
 #include "WebRendererQuery.hpp"
 
 namespace Anvil::Client::Rendering::Bridge
 {
+	// Call statistics for a query method.
+	struct WebRendererQueryStats
+	{
+		uint32_t m_Calls;
+		uint32_t m_Failures;
+		double m_TotalRunTime; // Milliseconds spent running the method
+		double m_MaxRunTime;
+		double m_TotalWaitTime; // Milliseconds spent waiting in the queue
+		double m_MaxWaitTime;
+	};
+
 	class WebRendererQueryHandler : public CefMessageRouterBrowserSide::Handler
 	{
+		typedef std::chrono::steady_clock Clock;
+
+		struct MethodInfo
+		{
+			WebRendererQuery m_Handler;
+			WebRendererQueryStats m_Stats;
+		};
+
+		struct PendingCall
+		{
+			MethodInfo *m_Method;
+			const rapidjson::GenericValue<rapidjson::UTF8<>> *m_Args;
+			QueryError m_ErrorCode;
+			std::string m_Result;
+		};
+
+		// A query can either be a single call or a batch of calls.
+		// Batches are answered with one callback once every call in them has run.
 		struct PendingQuery
 		{
 			rapidjson::GenericDocument<rapidjson::UTF8<>> m_Json;
-			WebRendererQuery m_Method;
-			const rapidjson::GenericValue<rapidjson::UTF8<>> *m_Args;
+			std::vector<PendingCall> m_Calls;
+			size_t m_NextCall;
+			bool m_IsBatch;
+			Clock::time_point m_QueueTime;
 			CefRefPtr<CefMessageRouterBrowserSide::Callback> m_Callback;
 		};
 
 		// Can't use shared_ptr here because lockfree queue entries must be trivially assignable
 		boost::lockfree::queue<PendingQuery*> m_Queries;
 
-		std::unordered_map<std::string, WebRendererQuery> m_Methods;
+		// The query being dispatched when the last frame ran out of budget
+		std::unique_ptr<PendingQuery> m_CurrentQuery;
+
+		std::unordered_map<std::string, MethodInfo> m_Methods;
+
+		QueryError ParseCall(const rapidjson::Value &p_Call, PendingCall *p_Result, std::string *p_Error);
+		void FinishQuery(PendingQuery *p_Query);
+		std::string SerializeStats() const;
 
 	public:
+		// Maximum number of queries which can be waiting to be dispatched.
+		// Queries past this are rejected with QueryError_Busy.
+		static const size_t MaxPendingQueries = 256;
+
+		// Maximum number of calls in a batch.
+		static const size_t MaxBatchSize = 32;
+
+		// Maximum number of calls and time spent dispatching them in one frame.
+		// At least one call is always dispatched.
+		static const size_t MaxCallsPerFrame = 32;
+		static const int MaxFrameTimeUs = 4000;
+
 		WebRendererQueryHandler();
+		~WebRendererQueryHandler();
 
 		bool OnQuery(CefRefPtr<CefBrowser> p_Browser, CefRefPtr<CefFrame> p_Frame, int64 p_QueryId, const CefString &p_Request, bool p_Persistent, CefRefPtr<Callback> p_Callback) override;
 		void OnQueryCanceled(CefRefPtr<CefBrowser> p_Browser, CefRefPtr<CefFrame> p_Frame, int64 p_QueryId) override;
 
 		void AddMethod(const std::string &p_Name, const WebRendererQuery &p_Method);
 		void Update();
+
+		// Gets the call statistics for a method. Returns false if the method doesn't exist.
+		// Statistics are updated by Update(), so this should only be called from the main thread.
+		bool GetStats(const std::string &p_Name, WebRendererQueryStats *p_Stats) const;
 	};
 }
@@ -0,0 +1,83 @@
+#include "NotificationBatcher.hpp"
+
+namespace
+{
+	std::string GetCoalescingKey(const std::string &event, bool broadcast);
+}
+
+namespace Web::Ui
+{
+	NotificationBatcher::NotificationBatcher(ExecuteFunc execute)
+		: execute(execute), pendingCount(0)
+	{
+	}
+
+	void NotificationBatcher::SetCoalesced(const std::string &event, bool coalesced)
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		if (coalesced)
+			coalescedEvents.insert(event);
+		else
+			coalescedEvents.erase(event);
+	}
+
+	void NotificationBatcher::Queue(const std::string &event, const std::string &data, bool broadcast)
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		if (coalescedEvents.find(event) != coalescedEvents.end())
+		{
+			auto key = GetCoalescingKey(event, broadcast);
+			auto it = coalescedIndices.find(key);
+			if (it != coalescedIndices.end())
+			{
+				queue[it->second].Superseded = true;
+				pendingCount--;
+			}
+			coalescedIndices[key] = queue.size();
+		}
+		queue.push_back({ event, data, broadcast, false });
+		pendingCount++;
+	}
+
+	void NotificationBatcher::Flush()
+	{
+		std::string js;
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			if (queue.empty())
+				return;
+
+			// ui.notify(event, data, broadcast, fromDew)
+			js = "if (window.ui) {";
+			for (auto &notification : queue)
+			{
+				if (notification.Superseded)
+					continue;
+				js += "ui.notify('" + notification.Event + "'," + notification.Data + "," + (notification.Broadcast ? "true" : "false") + ",true);";
+			}
+			js += "}";
+
+			queue.clear();
+			coalescedIndices.clear();
+			pendingCount = 0;
+		}
+
+		// Run the script outside of the lock in case it ends up queueing more notifications
+		execute(js);
+	}
+
+	size_t NotificationBatcher::GetPendingCount()
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		return pendingCount;
+	}
+}
+
+namespace
+{
+	std::string GetCoalescingKey(const std::string &event, bool broadcast)
+	{
+		// Broadcast and visible-only notifications reach different screens, so they don't replace each other
+		return (broadcast ? "b:" : "v:") + event;
+	}
+}
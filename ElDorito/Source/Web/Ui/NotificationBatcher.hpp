@@ -0,0 +1,50 @@
+#pragma once
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace Web::Ui
+{
+	// Queues screen layer notifications so that everything sent during a frame reaches the UI in one JavaScript call.
+	// Events can be marked as coalesced, which means a new notification replaces any queued one of the same event
+	// and broadcast type. The replacement goes at the end of the queue so it stays in order with everything else.
+	class NotificationBatcher
+	{
+	public:
+		// Runs a JavaScript snippet.
+		typedef std::function<void(const std::string &js)> ExecuteFunc;
+
+		explicit NotificationBatcher(ExecuteFunc execute);
+
+		// Sets whether an event only needs its most recent notification delivered.
+		void SetCoalesced(const std::string &event, bool coalesced);
+
+		// Queues a notification.
+		void Queue(const std::string &event, const std::string &data, bool broadcast);
+
+		// Sends every queued notification in one script. Does nothing if the queue is empty.
+		void Flush();
+
+		// Gets the number of notifications which will be sent by the next flush.
+		size_t GetPendingCount();
+
+	private:
+		struct Notification
+		{
+			std::string Event;
+			std::string Data;
+			bool Broadcast;
+			bool Superseded;
+		};
+
+		ExecuteFunc execute;
+		std::mutex mutex;
+		std::vector<Notification> queue;
+		std::unordered_set<std::string> coalescedEvents;
+		std::unordered_map<std::string, size_t> coalescedIndices; // Coalescing key -> index of the queued notification
+		size_t pendingCount;
+	};
+}
@@ -1,4 +1,5 @@
 #include "ScreenLayer.hpp"
+#include "NotificationBatcher.hpp"
 #include "../WebRenderer.hpp"
 #include "../WebRendererSchemeHandler.hpp"
 #include "../../Modules/ModuleServer.hpp"
@@ -33,6 +34,9 @@ namespace
 	void QuickBlockInput();
 	void QuickUnblockInput();
 
+	void ExecuteNotificationScript(const std::string &js);
+	Web::Ui::NotificationBatcher& GetNotificationBatcher();
+
 	class WebOverlayInputContext : public Patches::Input::InputContext
 	{
 	public:
@@ -97,11 +101,19 @@ namespace Web::Ui::ScreenLayer
 		Patches::Ui::OnCreateWindow(WindowCreated);
 		Patches::Core::OnShutdown(ShutdownRenderer);
 		Patches::Input::RegisterDefaultInputHandler(OnGameInputUpdated);
+
+		// These events carry their full state each time, so only the latest one in a frame matters
+		auto &batcher = GetNotificationBatcher();
+		batcher.SetCoalesced("scoreboard", true);
+		batcher.SetCoalesced("timerUpdate", true);
+		batcher.SetCoalesced("VoteCountsUpdated", true);
+		batcher.SetCoalesced("loadprogress", true);
 	}
 
 	void Tick()
 	{
 		WebRenderer::GetInstance()->Update();
+		FlushNotifications();
 	}
 
 	void Resize()
@@ -124,6 +136,8 @@ namespace Web::Ui::ScreenLayer
 	{
 		if (ElDorito::Instance().IsDedicated())
 			return;
+		FlushNotifications();
+
 		// ui.requestScreen(id, data)
 		auto js = "if (window.ui) ui.requestScreen('" + screenId + "', " + data + ");";
 		WebRenderer::GetInstance()->ExecuteJavascript(js);
@@ -133,6 +147,8 @@ namespace Web::Ui::ScreenLayer
 	{
 		if (ElDorito::Instance().IsDedicated())
 			return;
+		FlushNotifications();
+
 		// ui.hideScreen(id)
 		auto js = "if (window.ui) ui.hideScreen('" + screenId + "');";
 		WebRenderer::GetInstance()->ExecuteJavascript(js);
@@ -142,9 +158,14 @@ namespace Web::Ui::ScreenLayer
 	{
 		if (ElDorito::Instance().IsDedicated())
 			return;
-		// ui.notify(event, data, broadcast, fromDew)
-		auto js = "if (window.ui) ui.notify('" + event + "'," + data + "," + (broadcast ? "true" : "false") + ",true);";
-		WebRenderer::GetInstance()->ExecuteJavascript(js);
+		GetNotificationBatcher().Queue(event, data, broadcast);
+	}
+
+	void FlushNotifications()
+	{
+		if (ElDorito::Instance().IsDedicated())
+			return;
+		GetNotificationBatcher().Flush();
 	}
 
 	void CaptureInput(bool capture, bool pointerCapture)
@@ -566,4 +587,15 @@ namespace
 			action->Flags |= eActionStateFlagsHandled;
 		}
 	}
+
+	void ExecuteNotificationScript(const std::string &js)
+	{
+		WebRenderer::GetInstance()->ExecuteJavascript(js);
+	}
+
+	Web::Ui::NotificationBatcher& GetNotificationBatcher()
+	{
+		static Web::Ui::NotificationBatcher batcher(ExecuteNotificationScript);
+		return batcher;
+	}
 }
@@ -11,8 +11,13 @@ namespace Web::Ui::ScreenLayer
 	void Show(const std::string &screenId, const std::string &data);
 	void Hide(const std::string &screenId);
 	void CaptureInput(bool capture, bool pointerOnly);
+
+	// Queues a notification to be sent to screens at the end of the frame.
 	void Notify(const std::string &event, const std::string &data, bool broadcast);
 
+	// Sends queued notifications right away.
+	void FlushNotifications();
+
 	enum class AlertIcon
 	{
 		None = 0,
@@ -73,7 +73,9 @@ namespace
 		jsonWriter.EndObject();
 
 		// Send a loadprogress event to visible screens only
+		// The main loop doesn't tick while a map is loading, so it has to be flushed here
 		ScreenLayer::Notify("loadprogress", jsonBuffer.GetString(), false);
+		ScreenLayer::FlushNotifications();
 	}
 
 	void WebLoadingScreenUi::Hide()
@@ -0,0 +1,180 @@
+#include "Test.hpp"
+#include "Blam/Math/Batch.hpp"
+#include "Blam/Math/RealMatrix4x3.hpp"
+#include "Blam/Math/RealQuaternion.hpp"
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace Blam::Math;
+
+namespace
+{
+	// Not a multiple of four, so the SSE loops have a remainder
+	const size_t PointCount = 1003;
+	const size_t BenchmarkCount = 100000;
+
+	std::vector<RealVector3D> RandomPoints(size_t count)
+	{
+		std::mt19937 rng(1);
+		std::uniform_real_distribution<float> dist(-100.f, 100.f);
+		std::vector<RealVector3D> points(count);
+		for (auto &point : points)
+			point = RealVector3D(dist(rng), dist(rng), dist(rng));
+		return points;
+	}
+
+	RealMatrix4x3 TestMatrix()
+	{
+		return RealMatrix4x3(1.5f, RealVector3D(0.6f, 0.8f, 0), RealVector3D(-0.8f, 0.6f, 0), RealVector3D(0, 0, 1), RealVector3D(10, 20, 30));
+	}
+
+	RealVector3D TransformScalar(const RealMatrix4x3 &m, const RealVector3D &p, bool includePosition)
+	{
+		auto result = (m.Forward * p.I + m.Left * p.J + m.Up * p.K) * m.Scale;
+		return includePosition ? result + m.Position : result;
+	}
+
+	bool IsClose(const RealVector3D &expected, const RealVector3D &actual)
+	{
+		return (expected - actual).Length() < 1e-3f;
+	}
+
+	// Runs a test with the scalar loops, then again with the SSE ones if they're supported.
+	template<typename Func>
+	void ForEachImplementation(Func func)
+	{
+		Batch::SetSseEnabled(false);
+		func();
+		if (Batch::IsSseSupported())
+		{
+			Batch::SetSseEnabled(true);
+			func();
+		}
+		Batch::SetSseEnabled(Batch::IsSseSupported());
+	}
+}
+
+TEST_CASE(Batch, TransformPointsByMatrix)
+{
+	auto points = RandomPoints(PointCount);
+	auto matrix = TestMatrix();
+	ForEachImplementation([&]()
+	{
+		std::vector<RealVector3D> out(PointCount);
+		Batch::TransformPoints(matrix, points.data(), out.data(), PointCount);
+		auto mismatches = 0;
+		for (size_t i = 0; i < PointCount; i++)
+			mismatches += !IsClose(TransformScalar(matrix, points[i], true), out[i]);
+		CHECK_EQUAL(0, mismatches);
+	});
+}
+
+TEST_CASE(Batch, TransformVectorsInPlace)
+{
+	auto points = RandomPoints(PointCount);
+	auto matrix = TestMatrix();
+	ForEachImplementation([&]()
+	{
+		auto out = points;
+		Batch::TransformVectors(matrix, out.data(), out.data(), PointCount);
+		auto mismatches = 0;
+		for (size_t i = 0; i < PointCount; i++)
+			mismatches += !IsClose(TransformScalar(matrix, points[i], false), out[i]);
+		CHECK_EQUAL(0, mismatches);
+	});
+}
+
+TEST_CASE(Batch, TransformPointsByQuaternion)
+{
+	auto points = RandomPoints(PointCount);
+	auto rotation = RealQuaternion::Normalize(RealQuaternion(0.1f, 0.2f, 0.3f, 0.9f));
+	RealVector3D translation(1, 2, 3);
+	ForEachImplementation([&]()
+	{
+		std::vector<RealVector3D> out(PointCount);
+		Batch::TransformPoints(rotation, translation, points.data(), out.data(), PointCount);
+		auto mismatches = 0;
+		for (size_t i = 0; i < PointCount; i++)
+			mismatches += !IsClose(RealVector3D::Transform(points[i], rotation) + translation, out[i]);
+		CHECK_EQUAL(0, mismatches);
+	});
+}
+
+TEST_CASE(Batch, DistancesSquared)
+{
+	auto points = RandomPoints(PointCount);
+	RealVector3D origin(1, 2, 3);
+	ForEachImplementation([&]()
+	{
+		std::vector<float> out(PointCount);
+		Batch::DistancesSquared(origin, points.data(), out.data(), PointCount);
+		auto mismatches = 0;
+		for (size_t i = 0; i < PointCount; i++)
+			mismatches += std::abs((points[i] - origin).Length2() - out[i]) > 1e-2f;
+		CHECK_EQUAL(0, mismatches);
+	});
+}
+
+TEST_CASE(Batch, PointsInBounds)
+{
+	auto points = RandomPoints(PointCount);
+	points[0] = RealVector3D(50, 60, 70); // On the edge, which counts as inside
+	Bounds<RealVector3D> bounds(RealVector3D(-50, -50, -50), RealVector3D(50, 60, 70));
+	ForEachImplementation([&]()
+	{
+		std::vector<uint8_t> out(PointCount);
+		auto inside = Batch::PointsInBounds(bounds, points.data(), out.data(), PointCount);
+		size_t expectedInside = 0;
+		auto mismatches = 0;
+		for (size_t i = 0; i < PointCount; i++)
+		{
+			auto &p = points[i];
+			auto expected = p.I >= -50 && p.I <= 50 && p.J >= -50 && p.J <= 60 && p.K >= -50 && p.K <= 70;
+			expectedInside += expected;
+			mismatches += expected != (out[i] != 0);
+		}
+		CHECK_EQUAL(0, mismatches);
+		CHECK_EQUAL(expectedInside, inside);
+		CHECK(out[0] != 0);
+	});
+}
+
+// Transforms 100k points with the scalar and SSE loops, and one at a time
+// the way callers did before the batch functions existed.
+BENCHMARK(Batch, Transform100k)
+{
+	auto points = RandomPoints(BenchmarkCount);
+	std::vector<RealVector3D> out(BenchmarkCount);
+	std::vector<float> distances(BenchmarkCount);
+	auto matrix = TestMatrix();
+	auto rotation = RealQuaternion::Normalize(RealQuaternion(0.1f, 0.2f, 0.3f, 0.9f));
+	RealVector3D translation(1, 2, 3);
+
+	auto perCall = Tests::Time(50, [&]()
+	{
+		for (size_t i = 0; i < BenchmarkCount; i++)
+			out[i] = RealVector3D::Transform(points[i], rotation) + translation;
+	});
+	Tests::Report("Quaternion, one call per point", perCall / 1000, "us");
+
+	ForEachImplementation([&]()
+	{
+		auto name = Batch::IsSseEnabled() ? "SSE" : "scalar";
+		auto quaternion = Tests::Time(50, [&]()
+		{
+			Batch::TransformPoints(rotation, translation, points.data(), out.data(), BenchmarkCount);
+		});
+		auto transform = Tests::Time(50, [&]()
+		{
+			Batch::TransformPoints(matrix, points.data(), out.data(), BenchmarkCount);
+		});
+		auto distance = Tests::Time(50, [&]()
+		{
+			Batch::DistancesSquared(translation, points.data(), distances.data(), BenchmarkCount);
+		});
+		Tests::Report(std::string("Quaternion, batch, ") + name, quaternion / 1000, "us");
+		Tests::Report(std::string("Matrix, batch, ") + name, transform / 1000, "us");
+		Tests::Report(std::string("Distances, batch, ") + name, distance / 1000, "us");
+	});
+}
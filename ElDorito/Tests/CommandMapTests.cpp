@@ -0,0 +1,253 @@
+#include "Test.hpp"
+#include "CommandMap.hpp"
+#include "ElDorito.hpp"
+#include <random>
+
+using namespace Modules;
+
+namespace
+{
+	// The splitting rules of the CommandLineToArgvA function which CommandLineArgs replaced,
+	// written with strings so that the results can be compared.
+	std::vector<std::string> ReferenceSplit(const std::string &commandLine)
+	{
+		std::vector<std::string> args;
+		auto inQuotes = false;
+		auto inSpace = true;
+		for (auto ch : commandLine)
+		{
+			if (inQuotes)
+			{
+				if (ch == '\"')
+					inQuotes = false;
+				else
+					args.back() += ch;
+				continue;
+			}
+			switch (ch)
+			{
+			case '\"':
+				inQuotes = true;
+				if (inSpace)
+					args.emplace_back();
+				inSpace = false;
+				break;
+			case ' ':
+			case '\t':
+			case '\n':
+			case '\r':
+				inSpace = true;
+				break;
+			default:
+				if (inSpace)
+					args.emplace_back();
+				args.back() += ch;
+				inSpace = false;
+				break;
+			}
+		}
+		return args;
+	}
+
+	// Checks that CommandLineArgs splits a command line the same way as the reference.
+	bool CheckSplit(CommandLineArgs &args, const std::string &commandLine)
+	{
+		auto expected = ReferenceSplit(commandLine);
+		if (!CHECK_EQUAL(expected.size(), args.Parse(commandLine)))
+			return false;
+		for (size_t i = 0; i < expected.size(); i++)
+		{
+			if (!CHECK_EQUAL(expected[i], std::string(args[i])))
+				return false;
+			if (!CHECK(args[i].data()[args[i].size()] == '\0'))
+				return false;
+		}
+		return CHECK(args.ToVector() == expected);
+	}
+
+	std::string RandomCommandLine(std::mt19937 &random, size_t maxLength)
+	{
+		static const char alphabet[] = "ab \"\t\r\nxyz";
+		std::string commandLine(random() % (maxLength + 1), ' ');
+		for (auto &ch : commandLine)
+			ch = alphabet[random() % (sizeof(alphabet) - 1)];
+		return commandLine;
+	}
+
+	bool SetString(const std::string&, std::string&)
+	{
+		return true;
+	}
+
+	std::vector<std::string> LastArguments;
+
+	bool RecordArguments(const std::vector<std::string> &arguments, std::string&)
+	{
+		LastArguments = arguments;
+		return true;
+	}
+}
+
+TEST_CASE(CommandLineArgs, SplitsOnWhitespaceAndQuotes)
+{
+	CommandLineArgs args;
+	CHECK_EQUAL(0U, args.Parse(""));
+	CHECK_EQUAL(0U, args.Parse(" \t\r\n"));
+
+	if (CHECK_EQUAL(3U, args.Parse("Server.Name  \"My Server\"\tx")))
+	{
+		CHECK_EQUAL(std::string("Server.Name"), std::string(args[0]));
+		CHECK_EQUAL(std::string("My Server"), std::string(args[1]));
+		CHECK_EQUAL(std::string("x"), std::string(args[2]));
+		CHECK_EQUAL(11U, args.GetFirstArgumentEnd());
+	}
+
+	// The end of the first argument is in the original line, after any whitespace or quotes
+	args.Parse("  \"game.foo\" bar");
+	CHECK_EQUAL(12U, args.GetFirstArgumentEnd());
+	args.Parse(" game.foo");
+	CHECK_EQUAL(9U, args.GetFirstArgumentEnd());
+
+	// Quotes inside an argument join it with the quoted text, and empty quotes are an empty argument
+	if (CHECK_EQUAL(3U, args.Parse("a\"b c\"d \"\" \"unterminated")))
+	{
+		CHECK_EQUAL(std::string("ab cd"), std::string(args[0]));
+		CHECK_EQUAL(std::string(""), std::string(args[1]));
+		CHECK_EQUAL(std::string("unterminated"), std::string(args[2]));
+	}
+
+	CHECK(args.ToVector(1) == (std::vector<std::string>{ "", "unterminated" }));
+}
+
+TEST_CASE(CommandLineArgs, MatchesTheOldTokenizer)
+{
+	std::mt19937 random(1);
+	CommandLineArgs args;
+	for (auto i = 0; i < 20000; i++)
+	{
+		// Every tenth line is long enough to need the heap storage
+		if (!CheckSplit(args, RandomCommandLine(random, (i % 10 == 0) ? 1200 : 40)))
+			break;
+	}
+}
+
+TEST_CASE(CommandLineArgs, ManyArgumentsUseTheHeap)
+{
+	std::string commandLine;
+	for (auto i = 0; i < 40; i++)
+		commandLine += std::to_string(i) + " ";
+
+	CommandLineArgs args;
+	CheckSplit(args, commandLine);
+	CheckSplit(args, "short line");
+	CheckSplit(args, std::string(300, 'x') + " y");
+}
+
+TEST_CASE(CommandMap, SetVariableParsesNumbers)
+{
+	auto &commandMap = CommandMap::Instance();
+	Command command;
+	command.Name = "Test.Number";
+	command.Flags = eCommandFlagsNone;
+	command.Type = eCommandTypeVariableInt;
+	auto variable = commandMap.AddCommand(command);
+
+	std::string previous;
+	std::string value = "0x10";
+	CHECK_EQUAL(eVariableSetReturnValueSuccess, commandMap.SetVariable(variable, value, previous));
+	CHECK_EQUAL(16UL, variable->ValueInt);
+
+	// Trailing text is ignored, like std::stoul did
+	value = "12abc";
+	CHECK_EQUAL(eVariableSetReturnValueSuccess, commandMap.SetVariable(variable, value, previous));
+	CHECK_EQUAL(12UL, variable->ValueInt);
+
+	value = "abc";
+	CHECK_EQUAL(eVariableSetReturnValueInvalidArgument, commandMap.SetVariable(variable, value, previous));
+	CHECK_EQUAL(12UL, variable->ValueInt);
+
+	variable->Type = eCommandTypeVariableFloat;
+	value = "1.5";
+	CHECK_EQUAL(eVariableSetReturnValueSuccess, commandMap.SetVariable(variable, value, previous));
+	CHECK_EQUAL(1.5f, variable->ValueFloat);
+	value = "1e999";
+	CHECK_EQUAL(eVariableSetReturnValueInvalidArgument, commandMap.SetVariable(variable, value, previous));
+
+	variable->Type = eCommandTypeVariableInt64;
+	value = "99999999999999999999999";
+	CHECK_EQUAL(eVariableSetReturnValueInvalidArgument, commandMap.SetVariable(variable, value, previous));
+}
+
+TEST_CASE(CommandMap, ExecuteSplitsQuotedValues)
+{
+	auto &commandMap = CommandMap::Instance();
+	Command command;
+	command.Name = "Test.Quoted";
+	command.Flags = eCommandFlagsNone;
+	command.Type = eCommandTypeVariableString;
+	command.UpdateEvent = SetString;
+	auto variable = commandMap.AddCommand(command);
+
+	std::string output;
+	CHECK(commandMap.ExecuteCommandWithStatus("test.quoted \"two words\"", true, &output));
+	CHECK_EQUAL(std::string("two words"), variable->ValueString);
+}
+
+TEST_CASE(CommandMap, RawArgumentsSkipLeadingWhitespaceAndQuotes)
+{
+	auto &commandMap = CommandMap::Instance();
+	Command command;
+	command.Name = "Test.Queued";
+	command.Flags = eCommandFlagsRunOnMainMenu;
+	command.Type = eCommandTypeCommand;
+	command.UpdateEvent = RecordArguments;
+	commandMap.AddCommand(command);
+	command.Name = "Test.Raw";
+	command.Flags = eCommandFlagsArgsNoParse;
+	commandMap.AddCommand(command);
+
+	// Commands queued until the main menu shows run with the arguments they were given
+	std::string output;
+	for (auto line : { "  test.queued bar \"two words\"", "\"test.queued\" bar \"two words\"" })
+	{
+		ElDorito::Instance().GameHasMenuShown = false;
+		LastArguments.clear();
+		CHECK(commandMap.ExecuteCommandWithStatus(line, true, &output));
+		CHECK(LastArguments.empty());
+		ElDorito::Instance().GameHasMenuShown = true;
+		commandMap.ExecuteQueue();
+		CHECK(LastArguments == (std::vector<std::string>{ "bar", "two words" }));
+	}
+
+	CHECK(commandMap.ExecuteCommandWithStatus("  \"test.raw\" a  \"b c\"", true, &output));
+	CHECK(LastArguments == (std::vector<std::string>{ "a  \"b c\"" }));
+}
+
+// Splits typical console lines with the tokenizer and with the reference,
+// which allocates a string per argument like the old one allocated its buffer.
+BENCHMARK(CommandLineArgs, Parse)
+{
+	const std::vector<std::string> lines =
+	{
+		"Server.Name \"My Server\"",
+		"Bind PrintScreen Game.TakeScreenshot",
+		"Game.Map guardian",
+		"Player.Colors.Primary #FF0000",
+		std::string("Server.Message \"") + std::string(200, 'm') + "\"",
+	};
+
+	CommandLineArgs args;
+	size_t count = 0, index = 0;
+	auto parsed = Tests::Time(1000000, [&]()
+	{
+		count += args.Parse(lines[index++ % lines.size()]);
+	});
+	index = 0;
+	auto reference = Tests::Time(1000000, [&]()
+	{
+		count += ReferenceSplit(lines[index++ % lines.size()]).size();
+	});
+	CHECK(count > 0);
+	Tests::Report("Split a line, CommandLineArgs", parsed, "ns");
+	Tests::Report("Split a line into strings", reference, "ns");
+}
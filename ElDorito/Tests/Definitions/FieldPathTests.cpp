@@ -0,0 +1,184 @@
+#include "Test.hpp"
+#include "Definitions/FieldPath.hpp"
+#include "Blam/Tags/TagBlock.hpp"
+#include <new>
+
+using namespace Definitions;
+
+namespace
+{
+	// Root is laid out like this:
+	//   0x00 Speed
+	//   0x04 Inner.Offset
+	//   0x10 Parts[2].Offset
+	//   0x28 Bytes[4]
+	//   0x2C Barrels
+	const StructDefinition ElementStruct =
+	{
+		"Element", 8,
+		{
+			{ FieldType::ShortInteger, "Rounds" },
+			{ FieldType::Pad, 2 },
+			{ FieldType::Real, "Rate_Value" },
+		}
+	};
+
+	const StructDefinition InnerStruct =
+	{
+		"Inner", 12,
+		{
+			{ FieldType::RealPoint3D, "Offset" },
+		}
+	};
+
+	const StructDefinition RootStruct =
+	{
+		"Root", 64,
+		{
+			{ FieldType::Real, "Speed" },
+			{ FieldType::Struct, "Inner", &InnerStruct },
+			{ FieldType::Array, FieldType::Struct, "Parts", 2, &InnerStruct },
+			{ FieldType::Array, FieldType::CharInteger, "Bytes", 4 },
+			{ FieldType::Block, "Barrels", &ElementStruct },
+		}
+	};
+
+	// A Root with a Barrels block
+	struct TestTag
+	{
+		uint8_t Data[64] = {};
+		uint8_t Elements[16] = {};
+
+		explicit TestTag(int32_t barrelCount)
+		{
+			new (Data + 0x2C) Blam::Tags::TagBlock<uint8_t>(barrelCount, Elements);
+		}
+
+		template<typename T>
+		T &At(size_t offset) { return *reinterpret_cast<T *>(Data + offset); }
+
+		template<typename T>
+		T &Element(size_t offset) { return *reinterpret_cast<T *>(Elements + offset); }
+	};
+
+	FieldPath Compile(const std::string &path)
+	{
+		FieldPath result;
+		std::string error;
+		if (!FieldPath::Compile(RootStruct, path, &result, &error))
+			Tests::Fail(__FILE__, __LINE__, path + ": " + error);
+		return result;
+	}
+
+	bool CompileFails(const std::string &path)
+	{
+		FieldPath result;
+		std::string error;
+		return !FieldPath::Compile(RootStruct, path, &result, &error) && !error.empty();
+	}
+}
+
+TEST_CASE(FieldPath, CompilesOffsets)
+{
+	CHECK_EQUAL(0U, Compile("speed").GetOffset());
+	CHECK_EQUAL(4U, Compile("Speed").GetSize());
+	CHECK_EQUAL(0x04U, Compile("inner.offset").GetOffset());
+	CHECK_EQUAL(12U, Compile("inner.offset").GetSize());
+	CHECK_EQUAL(0x1CU, Compile("parts[1].offset").GetOffset());
+	CHECK_EQUAL(0x2BU, Compile("Bytes[3]").GetOffset());
+	CHECK_EQUAL(1U, Compile("Bytes[3]").GetSize());
+
+	auto barrel = Compile("barrels[1].rate_value");
+	CHECK_EQUAL(1U, barrel.GetBlockCount());
+	CHECK_EQUAL(4U, barrel.GetOffset());
+	CHECK(barrel.GetType() == FieldType::Real);
+}
+
+TEST_CASE(FieldPath, RejectsInvalidPaths)
+{
+	CHECK(CompileFails("parts[2].offset"));
+	CHECK(CompileFails("speed.x"));
+	CHECK(CompileFails("speed[0]"));
+	CHECK(CompileFails("nope"));
+	CHECK(CompileFails("inner..offset"));
+	CHECK(CompileFails("barrels[x].rounds"));
+	CHECK(CompileFails("barrels[].rounds"));
+}
+
+TEST_CASE(FieldPath, ReadsAndWritesThroughBlocks)
+{
+	TestTag a(2), b(1);
+	auto path = Compile("barrels[1].rate_value");
+
+	CHECK(path.Write(a.Data, 3.5f));
+	float value = 0;
+	CHECK(path.Read(a.Data, &value));
+	CHECK_EQUAL(3.5f, value);
+	CHECK_EQUAL(3.5f, a.Element<float>(12));
+
+	// b only has one barrel, and a double isn't the size of the field
+	CHECK(!path.Read(b.Data, &value));
+	double wrongSize;
+	CHECK(!path.Read(a.Data, &wrongSize));
+}
+
+TEST_CASE(FieldPath, FormatsAndParsesValues)
+{
+	TestTag tag(1);
+	std::string text, error;
+
+	auto offset = Compile("inner.offset");
+	CHECK(ParseFieldValue(offset, tag.Data, { "1", "-2.5", "3" }, &error));
+	CHECK(FormatFieldValue(offset, tag.Data, &text));
+	CHECK_EQUAL(std::string("1 -2.5 3"), text);
+
+	auto rounds = Compile("barrels[0].rounds");
+	CHECK(ParseFieldValue(rounds, tag.Data, { "-300" }, &error));
+	CHECK_EQUAL(-300, tag.Element<int16_t>(0));
+	CHECK(FormatFieldValue(rounds, tag.Data, &text));
+	CHECK_EQUAL(std::string("-300"), text);
+
+	auto byte = Compile("bytes[1]");
+	CHECK(ParseFieldValue(byte, tag.Data, { "-128" }, &error));
+	CHECK(FormatFieldValue(byte, tag.Data, &text));
+	CHECK_EQUAL(std::string("-128"), text);
+
+	// Nothing is written if any value is invalid
+	CHECK(!ParseFieldValue(offset, tag.Data, { "4", "five", "6" }, &error));
+	CHECK(!ParseFieldValue(offset, tag.Data, { "4", "5" }, &error));
+	CHECK_EQUAL(1.f, tag.At<float>(0x04));
+	CHECK(!ParseFieldValue(rounds, tag.Data, { "32768" }, &error));
+	CHECK(!ParseFieldValue(byte, tag.Data, { "128" }, &error));
+	CHECK_EQUAL(-300, tag.Element<int16_t>(0));
+
+	// Structs aren't numbers
+	CHECK(!FormatFieldValue(Compile("inner"), tag.Data, &text));
+	CHECK(!ParseFieldValue(Compile("inner"), tag.Data, { "1" }, &error));
+}
+
+TEST_CASE(FieldPath, SetDiffsAndApplies)
+{
+	TestTag a(2), b(1);
+	FieldPathSet fields(RootStruct);
+	std::string error;
+	CHECK(fields.Add("speed", &error));
+	CHECK(fields.Add("inner.offset", &error));
+	CHECK(fields.Add("barrels[0].rounds", &error));
+	CHECK(fields.Add("barrels[1].rate_value", &error));
+
+	// Copying a block would make both tags point at the same elements
+	CHECK(!fields.Add("barrels", &error));
+	CHECK_EQUAL(4U, fields.Count());
+
+	a.At<float>(0) = 2;
+	a.Element<int16_t>(0) = 7;
+
+	// barrels[1] only exists in a, so it's different too
+	CHECK_EQUAL(3U, fields.Diff(a.Data, b.Data).size());
+	CHECK_EQUAL(3U, fields.Apply(a.Data, b.Data));
+	auto diff = fields.Diff(a.Data, b.Data);
+	if (CHECK_EQUAL(1U, diff.size()))
+		CHECK_EQUAL(std::string("barrels[1].rate_value"), fields.Get(diff[0]).GetPath());
+	CHECK_EQUAL(7, b.Element<int16_t>(0));
+	CHECK_EQUAL(2.f, b.At<float>(0));
+}
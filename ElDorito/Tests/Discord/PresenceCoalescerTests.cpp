@@ -0,0 +1,146 @@
+#include "Test.hpp"
+#include "Discord/PresenceCoalescer.hpp"
+#include <vector>
+
+using Discord::PresenceCoalescer;
+using Discord::PresenceState;
+
+namespace
+{
+	uint64_t Now;
+
+	uint64_t FakeClock()
+	{
+		return Now;
+	}
+
+	PresenceState MakeState(const std::string &state, int partySize = 1)
+	{
+		PresenceState presence;
+		presence.State = state;
+		presence.PartySize = partySize;
+		presence.PartyMax = 16;
+		return presence;
+	}
+
+	// Records what would have been sent to Discord
+	struct Sink
+	{
+		std::vector<PresenceState> Sent;
+
+		PresenceCoalescer::SendFunc Func()
+		{
+			return [this](const PresenceState &state) { Sent.push_back(state); };
+		}
+	};
+}
+
+TEST_CASE(PresenceCoalescer, DropsUnchangedStates)
+{
+	Now = 0;
+	Sink sink;
+	PresenceCoalescer coalescer(2000, FakeClock, sink.Func());
+
+	coalescer.Submit(MakeState("In Lobby"));
+	for (auto i = 0; i < 10; i++)
+	{
+		Now += 5000;
+		coalescer.Submit(MakeState("In Lobby"));
+		coalescer.Flush();
+	}
+	CHECK_EQUAL(1U, sink.Sent.size());
+	CHECK(!coalescer.HasPending());
+
+	// Any visible field counts as a change
+	Now += 5000;
+	coalescer.Submit(MakeState("In Lobby", 2));
+	CHECK_EQUAL(2U, sink.Sent.size());
+}
+
+TEST_CASE(PresenceCoalescer, CollapsesBurstsIntoTheFinalState)
+{
+	Now = 0;
+	Sink sink;
+	PresenceCoalescer coalescer(2000, FakeClock, sink.Func());
+
+	// A kill streak: many changes inside one interval
+	coalescer.Submit(MakeState("Slayer 0-0"));
+	for (auto i = 1; i <= 20; i++)
+	{
+		Now += 50;
+		coalescer.Submit(MakeState("Slayer " + std::to_string(i) + "-0"));
+		coalescer.Flush();
+	}
+	CHECK_EQUAL(1U, sink.Sent.size());
+	CHECK(coalescer.HasPending());
+
+	// The final state goes out once the interval is up, and only once
+	Now = 1999;
+	coalescer.Flush();
+	CHECK_EQUAL(1U, sink.Sent.size());
+	Now = 2000;
+	coalescer.Flush();
+	coalescer.Flush();
+	if (!CHECK_EQUAL(2U, sink.Sent.size()))
+		return;
+	CHECK_EQUAL(std::string("Slayer 20-0"), sink.Sent[1].State);
+	CHECK(!coalescer.HasPending());
+}
+
+TEST_CASE(PresenceCoalescer, ChangingBackCancelsThePendingState)
+{
+	Now = 0;
+	Sink sink;
+	PresenceCoalescer coalescer(2000, FakeClock, sink.Func());
+
+	coalescer.Submit(MakeState("a"));
+	Now = 100;
+	coalescer.Submit(MakeState("b"));
+	coalescer.Submit(MakeState("a"));
+	CHECK(!coalescer.HasPending());
+	Now = 5000;
+	coalescer.Flush();
+	CHECK_EQUAL(1U, sink.Sent.size());
+}
+
+TEST_CASE(PresenceCoalescer, ResetResendsThePresence)
+{
+	Now = 0;
+	Sink sink;
+	PresenceCoalescer coalescer(2000, FakeClock, sink.Func());
+
+	coalescer.Submit(MakeState("a"));
+	coalescer.Reset();
+	coalescer.Submit(MakeState("a"));
+	if (!CHECK_EQUAL(2U, sink.Sent.size()))
+		return;
+	CHECK(sink.Sent[0] == sink.Sent[1]);
+}
+
+TEST_CASE(PresenceCoalescer, SendsAtMostOncePerInterval)
+{
+	Now = 0;
+	Sink sink;
+	PresenceCoalescer coalescer(2000, FakeClock, sink.Func());
+
+	// A change every 100 ms for a minute
+	std::vector<uint64_t> sendTimes;
+	for (auto i = 0; i < 600; i++)
+	{
+		Now = i * 100;
+		auto sent = sink.Sent.size();
+		coalescer.Submit(MakeState(std::to_string(i)));
+		if (sink.Sent.size() != sent)
+			sendTimes.push_back(Now);
+	}
+	Now += 2000;
+	coalescer.Flush();
+
+	CHECK_EQUAL(30U, sendTimes.size());
+	for (size_t i = 1; i < sendTimes.size(); i++)
+	{
+		if (!CHECK(sendTimes[i] - sendTimes[i - 1] >= 2000))
+			break;
+	}
+	CHECK_EQUAL(std::string("599"), sink.Sent.back().State);
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+// Stands in for the real BlamData.hpp, whose structures only have the
+// right layout in a 32-bit build. Only what the tested code uses is here.
+
+#include <cstdint>
+#include "Tags/Tag.hpp"
+
+namespace Blam
+{
+	struct DataArrayBase
+	{
+		char Name[0x20];
+		int MaxCount;
+		int DatumSize;
+		Blam::Tags::Tag Signature; // 'd@t@'
+		int ActualCount;
+	};
+
+	struct DataPoolBase
+	{
+		Blam::Tags::Tag Signature; // 'pool'
+		char Name[0x20];
+		int Size;
+		int FreeSize;
+	};
+
+	struct LruvCacheBase
+	{
+		char Name[0x20];
+		int Signature; // 'weee'
+	};
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+// Stands in for the real BlamNetwork.hpp, whose structures only have the
+// right layout in a 32-bit build. Only what the tested code uses is here.
+
+#include <cstdint>
+#include <string>
+
+namespace Blam::Players
+{
+	struct PlayerProperties
+	{
+		uint64_t Uid = 0;
+		wchar_t DisplayName[16] = {};
+	};
+}
+
+namespace Blam::Network
+{
+	const int MaxPeers = 17;
+	const int MaxPlayers = 16;
+
+	struct PlayerSession
+	{
+		Players::PlayerProperties Properties;
+	};
+
+	struct SessionMembership
+	{
+		PlayerSession PlayerSessions[MaxPlayers];
+		int PeerPlayers[MaxPeers]; // Not in the real structure; -1 for a peer which isn't connected
+
+		SessionMembership()
+		{
+			for (auto &player : PeerPlayers)
+				player = -1;
+		}
+
+		int FindFirstPeer() const { return FindNextPeer(-1); }
+
+		int FindNextPeer(int lastPeer) const
+		{
+			for (auto i = lastPeer + 1; i < MaxPeers; i++)
+			{
+				if (PeerPlayers[i] >= 0)
+					return i;
+			}
+			return -1;
+		}
+
+		int GetPeerPlayer(int peer) const { return PeerPlayers[peer]; }
+	};
+
+	struct NetworkAddress
+	{
+		union
+		{
+			uint32_t IPv4;
+			uint8_t Data[16];
+		} Address = {};
+		uint16_t Port = 0;
+		uint16_t AddressSize = 4;
+
+		std::string ToString() const
+		{
+			ToStringCount()++;
+			return std::to_string(Address.IPv4 >> 24) + "." + std::to_string((Address.IPv4 >> 16) & 0xFF) + "." +
+				std::to_string((Address.IPv4 >> 8) & 0xFF) + "." + std::to_string(Address.IPv4 & 0xFF);
+		}
+
+		// Not in the real structure: counts ToString calls, so tests can check that nothing is formatted needlessly
+		static int &ToStringCount()
+		{
+			static int count = 0;
+			return count;
+		}
+	};
+
+	struct Session
+	{
+		bool Established = false;
+		bool Host = false;
+		SessionMembership MembershipInfo;
+		NetworkAddress PeerAddresses[MaxPeers]; // Not in the real structure
+
+		bool IsEstablished() const { return Established; }
+		bool IsHost() const { return Host; }
+		NetworkAddress GetPeerAddress(int peerIndex) const { return PeerAddresses[peerIndex]; }
+	};
+
+	// The session returned by GetActiveSession. Tests can point this at their own session.
+	inline Session *&ActiveSession()
+	{
+		static Session *session = nullptr;
+		return session;
+	}
+
+	inline Session *GetActiveSession() { return ActiveSession(); }
+}
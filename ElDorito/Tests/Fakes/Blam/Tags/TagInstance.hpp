@@ -0,0 +1,81 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <map>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "Tag.hpp"
+
+// Stands in for the real TagInstance.hpp, which reads the game's tag tables.
+// Tests register the tags they need with TagInstance::Register().
+
+namespace Blam::Tags
+{
+	struct TagInstance
+	{
+		uint16_t Index;
+
+		inline static std::unordered_map<int32_t, std::string> TagNames;
+
+		TagInstance(const uint16_t index) : Index(index) { }
+
+		// Adds a tag to the fake tag table.
+		static void Register(uint16_t index, Tag groupTag, void *definition)
+		{
+			GetTable()[index] = std::make_pair(groupTag, definition);
+		}
+
+		// Removes every tag from the fake tag table.
+		static void Clear()
+		{
+			GetTable().clear();
+		}
+
+		Tag GetGroupTag()
+		{
+			auto it = GetTable().find(Index);
+			return it != GetTable().end() ? it->second.first : static_cast<Tag>(-1);
+		}
+
+		template <typename T>
+		T *GetDefinition()
+		{
+			auto it = GetTable().find(Index);
+			return it != GetTable().end() ? static_cast<T*>(it->second.second) : nullptr;
+		}
+
+		static std::vector<TagInstance> GetInstances()
+		{
+			std::vector<TagInstance> result;
+			for (auto &tag : GetTable())
+				result.push_back(TagInstance(tag.first));
+			return result;
+		}
+
+		static std::vector<TagInstance> GetInstancesInGroup(const Tag groupTag)
+		{
+			std::vector<TagInstance> result;
+			for (auto &tag : GetTable())
+			{
+				if (tag.second.first == groupTag)
+					result.push_back(TagInstance(tag.first));
+			}
+			return result;
+		}
+
+		static bool IsLoaded(Tag groupTag, uint32_t index)
+		{
+			TagInstance instance(index);
+			return instance.GetDefinition<void>() && instance.GetGroupTag() == groupTag;
+		}
+
+	private:
+		// Sorted by index like the real table, so tests are deterministic
+		static std::map<uint16_t, std::pair<Tag, void*>>& GetTable()
+		{
+			static std::map<uint16_t, std::pair<Tag, void*>> table;
+			return table;
+		}
+	};
+}
@@ -0,0 +1,11 @@
+#pragma once
+#include "Tag.hpp"
+#include "TagBlock.hpp"
+#include "TagData.hpp"
+#include "TagGroup.hpp"
+#include "TagInstance.hpp"
+#include "TagReference.hpp"
+
+// Tag structures contain pointers, so they only have the right size in a
+// 32-bit build. Tests build them natively and don't check.
+#define TAG_STRUCT_SIZE_ASSERT(type, size)
@@ -0,0 +1,14 @@
+#pragma once
+
+// Stands in for the real ElDorito.hpp, which pulls in most of the game.
+
+#include <string>
+#include "Utils/Singleton.hpp"
+
+class ElDorito : public Utils::Singleton<ElDorito>
+{
+public:
+	bool GameHasMenuShown = true;
+
+	bool IsDedicated() const { return false; }
+};
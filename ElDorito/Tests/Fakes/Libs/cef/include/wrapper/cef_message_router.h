@@ -0,0 +1,76 @@
+#pragma once
+
+// Stands in for CEF's message router, with only what the query handler uses,
+// so tests don't need to link against CEF.
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+typedef int64_t int64;
+
+// Unlike CEF's, this isn't intrusive: wrap a new object once and copy the CefRefPtr from then on.
+template <typename T>
+class CefRefPtr
+{
+public:
+	CefRefPtr() {}
+	CefRefPtr(std::nullptr_t) {}
+	CefRefPtr(T *ptr) : ptr(ptr) {}
+
+	template <typename U>
+	CefRefPtr(const CefRefPtr<U> &other) : ptr(other.ptr) {}
+
+	T *get() const { return ptr.get(); }
+	T *operator->() const { return ptr.get(); }
+	explicit operator bool() const { return ptr != nullptr; }
+
+private:
+	template <typename U> friend class CefRefPtr;
+	std::shared_ptr<T> ptr;
+};
+
+class CefString
+{
+public:
+	CefString() {}
+	CefString(const char *str) : str(str) {}
+	CefString(const std::string &str) : str(str) {}
+
+	std::string ToString() const { return str; }
+
+private:
+	std::string str;
+};
+
+class CefBrowser;
+class CefFrame;
+
+class CefMessageRouterBrowserSide
+{
+public:
+	class Callback
+	{
+	public:
+		virtual ~Callback() {}
+		virtual void Success(const CefString &response) = 0;
+		virtual void Failure(int error_code, const CefString &error_message) = 0;
+	};
+
+	class Handler
+	{
+	public:
+		typedef CefMessageRouterBrowserSide::Callback Callback;
+
+		virtual ~Handler() {}
+
+		virtual bool OnQuery(CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame, int64 query_id, const CefString &request, bool persistent, CefRefPtr<Callback> callback)
+		{
+			return false;
+		}
+
+		virtual void OnQueryCanceled(CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame, int64 query_id)
+		{
+		}
+	};
+};
@@ -0,0 +1,10 @@
+#include "ModuleGame.hpp"
+
+// Only registers the variables used by code under test.
+namespace Modules
+{
+	ModuleGame::ModuleGame() : ModuleBase("Game")
+	{
+		VarRconPort = AddVariableInt("RconPort", "rcon_port", "The port number used by the remote console", eCommandFlagsArchived, 11776);
+	}
+}
@@ -0,0 +1,11 @@
+#include "ModuleServer.hpp"
+
+// Only registers the variables used by code under test.
+namespace Modules
+{
+	ModuleServer::ModuleServer() : ModuleBase("Server")
+	{
+		VarRconPassword = AddVariableString("RconPassword", "rconpassword", "Password for the remote console", eCommandFlagsArchived, "");
+		VarTempBanMinutes = AddVariableInt("TempBanMinutes", "temp_ban_minutes", "Duration of a temporary ban (in minutes)", eCommandFlagsArchived, 30);
+	}
+}
@@ -0,0 +1,52 @@
+#include "Core.hpp"
+#include <vector>
+
+namespace
+{
+	std::vector<Patches::Core::ShutdownCallback> shutdownCallbacks;
+	std::vector<Patches::Core::MapLoadedCallback> mapLoadedCallbacks;
+	std::vector<Patches::Core::GameStartCallback> gameStartCallbacks;
+}
+
+namespace Patches::Core
+{
+	void OnShutdown(ShutdownCallback callback)
+	{
+		shutdownCallbacks.push_back(callback);
+	}
+
+	void ExecuteShutdownCallbacks()
+	{
+		for (auto &&callback : shutdownCallbacks)
+			callback();
+	}
+
+	void OnMapLoaded(MapLoadedCallback callback)
+	{
+		mapLoadedCallbacks.push_back(callback);
+	}
+
+	void OnGameStart(GameStartCallback callback)
+	{
+		gameStartCallbacks.push_back(callback);
+	}
+
+	void ExecuteMapLoadedCallbacks(const char *mapPath)
+	{
+		for (auto &&callback : mapLoadedCallbacks)
+			callback(mapPath);
+	}
+
+	void ExecuteGameStartCallbacks()
+	{
+		for (auto &&callback : gameStartCallbacks)
+			callback();
+	}
+
+	void ResetCallbacks()
+	{
+		shutdownCallbacks.clear();
+		mapLoadedCallbacks.clear();
+		gameStartCallbacks.clear();
+	}
+}
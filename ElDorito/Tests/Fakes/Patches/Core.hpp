@@ -0,0 +1,27 @@
+#pragma once
+
+// Stands in for the real Core.hpp. The callbacks are stored by Fakes/Patches/Core.cpp
+// and only run when a test asks for them.
+
+#include <functional>
+#include <string>
+
+namespace Patches::Core
+{
+	typedef std::function<void()> ShutdownCallback;
+	void OnShutdown(ShutdownCallback callback);
+	void ExecuteShutdownCallbacks();
+
+	typedef std::function<void(const char *mapPath)> MapLoadedCallback;
+	void OnMapLoaded(MapLoadedCallback callback);
+
+	typedef std::function<void()> GameStartCallback;
+	void OnGameStart(GameStartCallback callback);
+
+	// Runs the callbacks registered with OnMapLoaded and OnGameStart.
+	void ExecuteMapLoadedCallbacks(const char *mapPath);
+	void ExecuteGameStartCallbacks();
+
+	// Forgets every registered callback.
+	void ResetCallbacks();
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+// Stands in for the real Logger.hpp. Messages are kept in memory instead of
+// being written to a file, so tests can check what was logged.
+
+#include "Singleton.hpp"
+#include <chrono>
+#include <cstdarg>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace Utils
+{
+	enum class LogLevel
+	{
+		None = 0,
+		Trace,
+		Info,
+		Warning,
+		Error
+	};
+
+	enum LogTypes
+	{
+		None = 0,
+		Game = 1 << 0,
+		Network = 1 << 1,
+		Graphics = 1 << 2,
+		Memory = 1 << 3,
+		Sound = 1 << 4,
+		Input = 1 << 5,
+		Debug = 1 << 31,
+		All = 0xFFFFFFFF
+	};
+
+	class Logger : public Singleton<Logger>
+	{
+	public:
+		struct Message
+		{
+			LogLevel Level;
+			std::string Text;
+		};
+
+		void Log(LogTypes type, LogLevel level, std::string message, ...)
+		{
+			va_list ap;
+			va_start(ap, message);
+			char buffer[1024];
+			vsnprintf(buffer, sizeof(buffer), message.c_str(), ap);
+			va_end(ap);
+
+			std::lock_guard<std::mutex> lock(mutex);
+			messages.push_back({ level, buffer });
+		}
+
+		// Gets and clears the messages logged so far.
+		std::vector<Message> TakeMessages()
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			std::vector<Message> result;
+			result.swap(messages);
+			return result;
+		}
+
+	private:
+		std::mutex mutex;
+		std::vector<Message> messages;
+	};
+}
@@ -0,0 +1,105 @@
+#include "Test.hpp"
+#include "Forge/ObjectSet.hpp"
+#include <random>
+#include <set>
+#include <vector>
+
+using Forge::ObjectSet;
+
+namespace
+{
+	// A datum index with a random salt in the upper half
+	uint32_t RandomDatum(std::mt19937 &random, uint32_t maxIndex)
+	{
+		return (random() << 16) | (random() % maxIndex);
+	}
+
+	std::vector<uint16_t> Indices(const ObjectSet &set)
+	{
+		std::vector<uint16_t> indices;
+		set.ForEach([&](uint16_t index) { indices.push_back(index); });
+		return indices;
+	}
+}
+
+TEST_CASE(ObjectSet, AgreesWithStdSet)
+{
+	std::mt19937 random(1);
+	for (auto i = 0; i < 2000; i++)
+	{
+		ObjectSet set;
+		std::set<uint16_t> reference;
+		auto operations = random() % 300;
+		for (auto j = 0U; j < operations; j++)
+		{
+			auto datum = RandomDatum(random, 2048);
+			if (random() % 4 == 0)
+			{
+				set.Remove(datum);
+				reference.erase(datum & 0xFFFF);
+			}
+			else
+			{
+				set.Add(datum);
+				reference.insert(datum & 0xFFFF);
+			}
+		}
+
+		auto ok = CHECK(Indices(set) == std::vector<uint16_t>(reference.begin(), reference.end()));
+		ok = CHECK_EQUAL(static_cast<int>(reference.size()), set.Count()) && ok;
+		ok = CHECK_EQUAL(!reference.empty(), set.Any()) && ok;
+		for (uint32_t index = 0; index < 2048 && ok; index++)
+			ok = CHECK_EQUAL(reference.count(index) > 0, set.Contains(0x12340000 | index));
+		if (!ok)
+			break;
+	}
+}
+
+TEST_CASE(ObjectSet, IgnoresOutOfRangeIndices)
+{
+	ObjectSet set;
+	CHECK(!set.Contains(0xFFFFFFFF));
+	set.Add(0xFFFFFFFF);
+	set.Add(2048);
+	CHECK(!set.Any());
+
+	set.Add(0);
+	set.Add(2047);
+	CHECK((Indices(set) == std::vector<uint16_t>{ 0, 2047 }));
+	set.Clear();
+	CHECK_EQUAL(0, set.Count());
+}
+
+// Visits a selection of 4 and of 1,500 objects, with ForEach and by testing
+// every object index like the selection renderer used to.
+BENCHMARK(ObjectSet, WalkSelection)
+{
+	std::mt19937 random(2);
+	for (auto selectionSize : { 4, 1500 })
+	{
+		ObjectSet set;
+		while (set.Count() < selectionSize)
+			set.Add(random() % 2048);
+
+		volatile uint32_t visitedSum = 0;
+		uint32_t forEachSum = 0, scanSum = 0;
+		auto forEach = Tests::Time(10000, [&]()
+		{
+			set.ForEach([&](uint16_t index) { forEachSum += index; });
+			visitedSum = forEachSum;
+		});
+		auto scan = Tests::Time(10000, [&]()
+		{
+			for (uint32_t index = 0; index < 2048; index++)
+			{
+				if (set.Contains(index))
+					scanSum += index;
+			}
+			visitedSum = scanSum;
+		});
+		CHECK_EQUAL(scanSum, forEachSum);
+		auto label = std::to_string(selectionSize) + " selected";
+		Tests::Report(label + ", ForEach", forEach, "ns");
+		Tests::Report(label + ", every object", scan, "ns");
+	}
+}
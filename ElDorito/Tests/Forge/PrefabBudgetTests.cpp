@@ -0,0 +1,128 @@
+#include "Test.hpp"
+#include "Forge/PrefabBudget.hpp"
+#include <memory>
+
+using namespace Forge::Prefabs;
+using Blam::MapVariant;
+
+namespace
+{
+	std::unique_ptr<MapVariant> EmptyMap()
+	{
+		std::unique_ptr<MapVariant> mapv(new MapVariant());
+		mapv->MaxBudget = 1000;
+		return mapv;
+	}
+
+	// Adds a budget entry the way the game does when a tag is first spawned
+	MapVariant::BudgetEntry& AddBudget(MapVariant &mapv, uint32_t tagIndex, uint8_t countOnMap, uint8_t maxAllowed, float cost)
+	{
+		auto &budget = mapv.Budget[mapv.BudgetEntryCount++];
+		budget.TagIndex = tagIndex;
+		budget.CountOnMap = countOnMap;
+		budget.DesignTimeMax = maxAllowed;
+		budget.Cost = cost;
+		mapv.CurrentBudget += cost * countOnMap;
+		return budget;
+	}
+
+	void PlaceObjects(MapVariant &mapv, int count)
+	{
+		for (auto i = 0; i < count; i++)
+			mapv.Placements[i].PlacementFlags |= 1;
+	}
+
+	Prefab MakePrefab(std::initializer_list<std::pair<uint32_t, int>> tagCounts)
+	{
+		Prefab prefab = {};
+		for (auto &tagCount : tagCounts)
+		{
+			PrefabObject object = {};
+			object.TagIndex = tagCount.first;
+			prefab.Objects.insert(prefab.Objects.end(), tagCount.second, object);
+		}
+		return prefab;
+	}
+}
+
+TEST_CASE(PrefabBudget, FitsWithinEveryLimit)
+{
+	auto mapv = EmptyMap();
+	AddBudget(*mapv, 0x1000, 3, 8, 10);
+	AddBudget(*mapv, 0x2000, 50, 0xFF, 1);
+	PlaceObjects(*mapv, 53);
+
+	// Exactly at the item limit, an unlimited tag and a tag which isn't on the map yet
+	auto check = CheckPrefabBudget(MakePrefab({ { 0x1000, 5 }, { 0x2000, 200 }, { 0x3000, 4 } }), *mapv);
+	CHECK(check.Error == PrefabBudgetError::None);
+	CHECK(CheckPrefabBudget(Prefab{}, *mapv).Error == PrefabBudgetError::None);
+}
+
+TEST_CASE(PrefabBudget, CountsPlacements)
+{
+	auto mapv = EmptyMap();
+	PlaceObjects(*mapv, 630);
+	CHECK(CheckPrefabBudget(MakePrefab({ { 0x1000, 10 } }), *mapv).Error == PrefabBudgetError::None);
+
+	auto check = CheckPrefabBudget(MakePrefab({ { 0x1000, 6 }, { 0x2000, 5 } }), *mapv);
+	CHECK(check.Error == PrefabBudgetError::NotEnoughPlacements);
+	CHECK_EQUAL(11.0f, check.Needed);
+	CHECK_EQUAL(10.0f, check.Available);
+}
+
+TEST_CASE(PrefabBudget, SumsObjectsPerTag)
+{
+	auto mapv = EmptyMap();
+	AddBudget(*mapv, 0x1000, 1, 0xFF, 0);
+	AddBudget(*mapv, 0x2000, 6, 8, 0);
+
+	// No single run of the tag is over the limit, only all of them together
+	auto check = CheckPrefabBudget(MakePrefab({ { 0x2000, 1 }, { 0x1000, 4 }, { 0x2000, 1 }, { 0x1000, 4 }, { 0x2000, 1 } }), *mapv);
+	CHECK(check.Error == PrefabBudgetError::OverItemLimit);
+	CHECK_EQUAL(0x2000U, check.TagIndex);
+	CHECK_EQUAL(3.0f, check.Needed);
+	CHECK_EQUAL(2.0f, check.Available);
+
+	// A tag which is already over its limit has nothing left
+	AddBudget(*mapv, 0x3000, 4, 2, 0);
+	check = CheckPrefabBudget(MakePrefab({ { 0x3000, 1 } }), *mapv);
+	CHECK(check.Error == PrefabBudgetError::OverItemLimit);
+	CHECK_EQUAL(0.0f, check.Available);
+}
+
+TEST_CASE(PrefabBudget, SumsCosts)
+{
+	auto mapv = EmptyMap();
+	AddBudget(*mapv, 0x1000, 10, 0xFF, 50);
+	AddBudget(*mapv, 0x2000, 0, 0xFF, 25);
+
+	// 500 is spent and 500 is left
+	CHECK(CheckPrefabBudget(MakePrefab({ { 0x1000, 6 }, { 0x2000, 8 } }), *mapv).Error == PrefabBudgetError::None);
+
+	auto check = CheckPrefabBudget(MakePrefab({ { 0x1000, 6 }, { 0x2000, 9 } }), *mapv);
+	CHECK(check.Error == PrefabBudgetError::OverBudget);
+	CHECK_EQUAL(525.0f, check.Needed);
+	CHECK_EQUAL(500.0f, check.Available);
+
+	// Maps without a budget aren't limited
+	mapv->MaxBudget = 0;
+	CHECK(CheckPrefabBudget(MakePrefab({ { 0x1000, 6 }, { 0x2000, 9 } }), *mapv).Error == PrefabBudgetError::None);
+}
+
+TEST_CASE(PrefabBudget, CountsFreeBudgetEntries)
+{
+	auto mapv = EmptyMap();
+	for (uint32_t i = 0; i < 254; i++)
+		AddBudget(*mapv, 0x1000 + i, 1, 0xFF, 0);
+
+	// Two entries are left at the end of the list
+	CHECK(CheckPrefabBudget(MakePrefab({ { 0x1000, 1 }, { 0x9000, 1 }, { 0x9001, 1 } }), *mapv).Error == PrefabBudgetError::None);
+	auto check = CheckPrefabBudget(MakePrefab({ { 0x9000, 1 }, { 0x9001, 1 }, { 0x9002, 1 } }), *mapv);
+	CHECK(check.Error == PrefabBudgetError::NotEnoughBudgetEntries);
+	CHECK_EQUAL(3.0f, check.Needed);
+	CHECK_EQUAL(2.0f, check.Available);
+
+	// Entries freed when the last object of a tag is deleted are reused
+	mapv->Budget[5].TagIndex = 0xFFFFFFFF;
+	CHECK(CheckPrefabBudget(MakePrefab({ { 0x9000, 1 }, { 0x9001, 1 }, { 0x9002, 1 } }), *mapv).Error == PrefabBudgetError::None);
+}
@@ -0,0 +1,184 @@
+#include "Test.hpp"
+#include "Forge/PrefabFormat.hpp"
+#include <fstream>
+#include <iterator>
+
+using namespace Forge::Prefabs;
+
+// The fixtures were written independently of the game code, with the layout described in PrefabFormat.cpp and a
+// standard CRC-32 (zlib's) over everything but the checksum field:
+// - current.prefab: version 2, 3 objects
+// - extended.prefab: version 2 with 8 bytes of unknown header fields and 4 bytes of unknown fields on each of 2 objects
+// - legacy.prefab: the original unversioned format (a 0x38-byte header and 0x44-byte placements), saying 3 objects but
+//   holding 2
+
+namespace
+{
+	std::vector<uint8_t> ReadFixture(const char *name)
+	{
+		std::ifstream stream(std::string(PREFAB_FIXTURE_DIR "/") + name, std::ios::binary);
+		return std::vector<uint8_t>(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+	}
+
+	// The object the fixture generator wrote at an index
+	PrefabObject FixtureObject(uint32_t i)
+	{
+		PrefabObject object = {};
+		object.Flags = 0x10 + i;
+		object.TagIndex = 0xE000 + i;
+		object.Position = { 1.5f * i, -2.0f, 3.25f };
+		object.RightVector = { 1, 0, 0 };
+		object.UpVector = { 0, 0, 1 };
+		object.Properties.EngineFlags = static_cast<uint16_t>(0x8000 | i);
+		object.Properties.ObjectFlags = 1;
+		object.Properties.TeamAffilation = static_cast<uint8_t>(i % 8);
+		object.Properties.SharedStorage = 2;
+		object.Properties.RespawnTime = static_cast<uint8_t>(30 + i);
+		object.Properties.ObjectType = 3;
+		object.Properties.ZoneShape = 1;
+		object.Properties.ZoneRadiusWidth = 2.5f;
+		object.Properties.ZoneDepth = 4.0f;
+		object.Properties.ZoneTop = 1.0f;
+		object.Properties.ZoneBottom = -1.0f;
+		return object;
+	}
+
+	Prefab FixturePrefab(uint32_t objectCount)
+	{
+		Prefab prefab;
+		prefab.Flags = 3;
+		prefab.DateCreated = 1700000000;
+		prefab.Name = "Tower";
+		prefab.Author = "builder";
+		for (auto i = 0U; i < objectCount; i++)
+			prefab.Objects.push_back(FixtureObject(i));
+		return prefab;
+	}
+
+	bool ObjectsEqual(const PrefabObject &a, const PrefabObject &b)
+	{
+		return a.Flags == b.Flags && a.TagIndex == b.TagIndex &&
+			a.Position.I == b.Position.I && a.Position.J == b.Position.J && a.Position.K == b.Position.K &&
+			a.RightVector.I == b.RightVector.I && a.UpVector.K == b.UpVector.K &&
+			a.Properties.EngineFlags == b.Properties.EngineFlags && a.Properties.ObjectFlags == b.Properties.ObjectFlags &&
+			a.Properties.TeamAffilation == b.Properties.TeamAffilation && a.Properties.SharedStorage == b.Properties.SharedStorage &&
+			a.Properties.RespawnTime == b.Properties.RespawnTime && a.Properties.ObjectType == b.Properties.ObjectType &&
+			a.Properties.ZoneShape == b.Properties.ZoneShape && a.Properties.ZoneRadiusWidth == b.Properties.ZoneRadiusWidth &&
+			a.Properties.ZoneDepth == b.Properties.ZoneDepth && a.Properties.ZoneTop == b.Properties.ZoneTop &&
+			a.Properties.ZoneBottom == b.Properties.ZoneBottom;
+	}
+
+	bool PrefabsEqual(const Prefab &a, const Prefab &b)
+	{
+		if (a.Flags != b.Flags || a.DateCreated != b.DateCreated || a.Name != b.Name || a.Author != b.Author ||
+			a.Objects.size() != b.Objects.size())
+		{
+			return false;
+		}
+		for (size_t i = 0; i < a.Objects.size(); i++)
+		{
+			if (!ObjectsEqual(a.Objects[i], b.Objects[i]))
+				return false;
+		}
+		return true;
+	}
+}
+
+TEST_CASE(PrefabFormat, WritesTheFixture)
+{
+	auto fixture = ReadFixture("current.prefab");
+	CHECK_EQUAL(268U, fixture.size());
+	CHECK(SerializePrefab(FixturePrefab(3)) == fixture);
+}
+
+TEST_CASE(PrefabFormat, RoundTrips)
+{
+	Prefab prefab;
+	auto fixture = ReadFixture("current.prefab");
+	if (!CHECK(DeserializePrefab(fixture.data(), fixture.size(), &prefab) == PrefabError::None))
+		return;
+	CHECK(PrefabsEqual(FixturePrefab(3), prefab));
+	CHECK(SerializePrefab(prefab) == fixture);
+
+	// Long strings are cut down to what fits, and an empty prefab is still valid
+	auto empty = FixturePrefab(0);
+	empty.Name = "a name which is far too long";
+	auto data = SerializePrefab(empty);
+	CHECK(DeserializePrefab(data.data(), data.size(), &prefab) == PrefabError::None);
+	CHECK_EQUAL(std::string("a name which is"), prefab.Name);
+	CHECK(prefab.Objects.empty());
+}
+
+TEST_CASE(PrefabFormat, SkipsUnknownFields)
+{
+	Prefab prefab;
+	auto fixture = ReadFixture("extended.prefab");
+	if (!CHECK(DeserializePrefab(fixture.data(), fixture.size(), &prefab) == PrefabError::None))
+		return;
+	CHECK(PrefabsEqual(FixturePrefab(2), prefab));
+
+	// Header fields after the checksum are covered by it too
+	fixture[64] ^= 1;
+	CHECK(DeserializePrefab(fixture.data(), fixture.size(), &prefab) == PrefabError::BadChecksum);
+}
+
+TEST_CASE(PrefabFormat, RejectsCorruptFiles)
+{
+	Prefab prefab;
+	for (auto &&name : { "current.prefab", "extended.prefab" })
+	{
+		auto fixture = ReadFixture(name);
+
+		// Every single-bit change is caught by some check
+		for (size_t i = 0; i < fixture.size() * 8; i++)
+		{
+			auto corrupt = fixture;
+			corrupt[i / 8] ^= 1 << (i % 8);
+			if (!CHECK(DeserializePrefab(corrupt.data(), corrupt.size(), &prefab) != PrefabError::None))
+				break;
+		}
+
+		for (size_t size = 0; size < fixture.size(); size++)
+		{
+			if (!CHECK(DeserializePrefab(fixture.data(), size, &prefab) == PrefabError::Truncated))
+				break;
+		}
+
+		auto longer = fixture;
+		longer.push_back(0);
+		CHECK(DeserializePrefab(longer.data(), longer.size(), &prefab) == PrefabError::TrailingData);
+	}
+
+	// A newer version is refused rather than misread
+	auto fixture = ReadFixture("current.prefab");
+	fixture[6] = 3;
+	CHECK(DeserializePrefab(fixture.data(), fixture.size(), &prefab) == PrefabError::UnsupportedVersion);
+}
+
+TEST_CASE(PrefabFormat, MigratesLegacyFiles)
+{
+	Prefab prefab;
+	auto fixture = ReadFixture("legacy.prefab");
+	if (!CHECK(DeserializePrefab(fixture.data(), fixture.size(), &prefab) == PrefabError::None))
+		return;
+
+	auto expected = FixturePrefab(2);
+	expected.Flags = 1;
+	expected.DateCreated = 1500000000;
+	expected.Name = "Legacy Base";
+	expected.Author = "forger";
+	CHECK(PrefabsEqual(expected, prefab));
+
+	// Saving it again writes the current format, which reads back the same
+	auto converted = SerializePrefab(prefab);
+	Prefab reloaded;
+	CHECK(DeserializePrefab(converted.data(), converted.size(), &reloaded) == PrefabError::None);
+	CHECK(PrefabsEqual(expected, reloaded));
+
+	// The old format can't be checked as thoroughly, but partial placements and extra ones are refused
+	auto partial = fixture;
+	partial.pop_back();
+	CHECK(DeserializePrefab(partial.data(), partial.size(), &prefab) == PrefabError::Truncated);
+	fixture[48] = 1; // Object count
+	CHECK(DeserializePrefab(fixture.data(), fixture.size(), &prefab) == PrefabError::TrailingData);
+}
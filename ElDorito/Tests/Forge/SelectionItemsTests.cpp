@@ -0,0 +1,255 @@
+#include "Test.hpp"
+#include "Forge/SelectionItems.hpp"
+#include <random>
+#include <tuple>
+#include <vector>
+
+using namespace Forge;
+using Blam::Math::RealMatrix4x3;
+using Blam::Math::RealVector3D;
+
+namespace
+{
+	const int ObjectCount = 2048;
+	const uint32_t TagCount = 8;
+
+	// An object table which counts how often it is read
+	class FakeObjectSource : public SelectedObjectSource
+	{
+	public:
+		std::vector<bool> Exists;
+		std::vector<SelectedObject> Objects;
+		std::vector<AABB> Boxes;
+		int BoundingBoxReads = 0;
+		int TransformReads = 0;
+
+		FakeObjectSource() : Exists(ObjectCount), Objects(ObjectCount)
+		{
+			for (auto i = 0U; i < TagCount; i++)
+				Boxes.push_back(AABB{ -1.0f * i, 1.0f * i, -2.0f, 2.0f, 0.0f, 0.5f * i });
+		}
+
+		bool FindObject(uint16_t index, SelectedObject *result) override
+		{
+			if (index >= ObjectCount || !Exists[index])
+				return false;
+			*result = Objects[index];
+			return true;
+		}
+
+		// The last tag has no bounding box
+		const AABB* GetBoundingBox(uint32_t tagIndex) override
+		{
+			BoundingBoxReads++;
+			return (tagIndex < TagCount - 1) ? &Boxes[tagIndex] : nullptr;
+		}
+
+		void GetTransform(uint32_t objectIndex, RealMatrix4x3 *result) override
+		{
+			TransformReads++;
+			auto &object = Objects[objectIndex & 0xFFFF];
+			*result = RealMatrix4x3(1.0f, object.Forward, RealVector3D::Cross(object.Up, object.Forward), object.Up, object.Center);
+		}
+	};
+
+	void Place(std::mt19937 &random, SelectedObject *object)
+	{
+		std::uniform_real_distribution<float> position(-100, 100);
+		object->Center = RealVector3D(position(random), position(random), position(random));
+		object->Forward = RealVector3D(1, 0, 0);
+		object->Up = RealVector3D(0, 0, 1);
+	}
+
+	void Spawn(std::mt19937 &random, FakeObjectSource &source, uint16_t index)
+	{
+		auto &object = source.Objects[index];
+		object.ObjectIndex = ((object.ObjectIndex >> 16) + 1) << 16 | index;
+		object.TagIndex = random() % TagCount;
+		Place(random, &object);
+		source.Exists[index] = true;
+	}
+
+	// What the selection renderer did before the cache: walk every object and read everything again
+	std::vector<SelectionItem> FullWalk(const ObjectSet &selection, SelectedObjectSource &source)
+	{
+		std::vector<SelectionItem> items;
+		for (uint32_t index = 0; index < ObjectCount && items.size() < SelectionItemList::MaxItems; index++)
+		{
+			SelectedObject object;
+			if (!selection.Contains(index) || !source.FindObject(static_cast<uint16_t>(index), &object))
+				continue;
+			auto boundingBox = source.GetBoundingBox(object.TagIndex);
+			if (!boundingBox)
+				continue;
+			RealMatrix4x3 transform;
+			source.GetTransform(object.ObjectIndex, &transform);
+			SelectionItem item;
+			BuildSelectionItem(object, *boundingBox, transform, &item);
+			items.push_back(item);
+		}
+		return items;
+	}
+
+	bool SameItem(const SelectionItem &a, const SelectionItem &b)
+	{
+		return a.Transform == b.Transform && a.Width == b.Width && a.Depth == b.Depth && a.Height == b.Height &&
+			a.Object.ObjectIndex == b.Object.ObjectIndex && a.Object.TagIndex == b.Object.TagIndex &&
+			a.Object.Center == b.Object.Center && a.Object.Forward == b.Object.Forward && a.Object.Up == b.Object.Up;
+	}
+
+	// Doesn't count the reads made by the full walk
+	bool AgreesWithFullWalk(const SelectionItemList &list, const ObjectSet &selection, FakeObjectSource &source)
+	{
+		auto reads = std::make_pair(source.BoundingBoxReads, source.TransformReads);
+		auto expected = FullWalk(selection, source);
+		std::tie(source.BoundingBoxReads, source.TransformReads) = reads;
+		if (!CHECK_EQUAL(static_cast<int>(expected.size()), list.GetCount()))
+			return false;
+		for (auto i = 0; i < list.GetCount(); i++)
+		{
+			if (!CHECK(SameItem(expected[i], list.GetItems()[i])))
+				return false;
+		}
+		return true;
+	}
+}
+
+TEST_CASE(SelectionItems, AgreesWithAFullWalk)
+{
+	std::mt19937 random(3);
+	FakeObjectSource source;
+	for (uint16_t i = 0; i < 600; i++)
+		Spawn(random, source, i);
+
+	// Objects are selected, moved, respawned with other tags and deleted at random between updates
+	SelectionItemList list;
+	ObjectSet selection;
+	for (auto tick = 0; tick < 3000; tick++)
+	{
+		auto changes = random() % 8;
+		for (auto i = 0U; i < changes; i++)
+		{
+			auto index = static_cast<uint16_t>(random() % 700);
+			switch (random() % 5)
+			{
+			case 0:
+				selection.Add(index);
+				break;
+			case 1:
+				selection.Remove(index);
+				break;
+			case 2:
+				Place(random, &source.Objects[index]);
+				break;
+			case 3:
+				Spawn(random, source, index);
+				break;
+			case 4:
+				source.Exists[index] = false;
+				break;
+			}
+		}
+
+		list.Update(selection, source);
+		if (!AgreesWithFullWalk(list, selection, source))
+			return;
+	}
+
+	// More objects selected than there are items
+	for (uint16_t i = 0; i < 600; i++)
+		selection.Add(i);
+	list.Update(selection, source);
+	CHECK_EQUAL(static_cast<int>(SelectionItemList::MaxItems), list.GetCount());
+	AgreesWithFullWalk(list, selection, source);
+}
+
+TEST_CASE(SelectionItems, OnlyNewOrMovedObjectsAreRead)
+{
+	std::mt19937 random(4);
+	FakeObjectSource source;
+	ObjectSet selection;
+	for (uint16_t i = 0; i < 20; i++)
+	{
+		Spawn(random, source, i);
+		source.Objects[i].TagIndex = i % 2;
+		selection.Add(i);
+	}
+
+	SelectionItemList list;
+	list.Update(selection, source);
+	CHECK_EQUAL(20, list.GetCount());
+	CHECK_EQUAL(2, source.BoundingBoxReads);
+	CHECK_EQUAL(20, source.TransformReads);
+
+	// Nothing moved
+	list.Update(selection, source);
+	CHECK_EQUAL(2, source.BoundingBoxReads);
+	CHECK_EQUAL(20, source.TransformReads);
+
+	// Moving, rotating and respawning objects only reads those objects again
+	source.Objects[3].Center.K += 1;
+	source.Objects[7].Up = RealVector3D(0, 1, 0);
+	Spawn(random, source, 11);
+	source.Objects[11].TagIndex = 1;
+	list.Update(selection, source);
+	CHECK_EQUAL(2, source.BoundingBoxReads);
+	CHECK_EQUAL(23, source.TransformReads);
+	AgreesWithFullWalk(list, selection, source);
+
+	// Clearing keeps the bounding boxes, resetting forgets them
+	list.Clear();
+	CHECK_EQUAL(0, list.GetCount());
+	list.Update(selection, source);
+	CHECK_EQUAL(2, source.BoundingBoxReads);
+	CHECK_EQUAL(43, source.TransformReads);
+	list.Reset();
+	list.Update(selection, source);
+	CHECK_EQUAL(4, source.BoundingBoxReads);
+	CHECK_EQUAL(63, source.TransformReads);
+}
+
+// Updates a selection of 200 objects out of 1,500 with 5 of them moving every
+// tick, and does the same with a full walk which reads every selected object.
+BENCHMARK(SelectionItems, MovingSelection)
+{
+	std::mt19937 random(5);
+	FakeObjectSource source;
+	ObjectSet selection;
+	for (uint16_t i = 0; i < 1500; i++)
+		Spawn(random, source, i);
+	while (selection.Count() < 200)
+		selection.Add(random() % 1500);
+	std::vector<uint16_t> selected;
+	selection.ForEach([&](uint16_t index) { selected.push_back(index); });
+
+	const int ticks = 10000;
+	SelectionItemList list;
+	list.Update(selection, source);
+	source.BoundingBoxReads = source.TransformReads = 0;
+	std::mt19937 moves(6);
+	auto cached = Tests::Time(ticks, [&]()
+	{
+		for (auto i = 0; i < 5; i++)
+			Place(moves, &source.Objects[selected[moves() % selected.size()]]);
+		list.Update(selection, source);
+	});
+	auto cachedReads = source.BoundingBoxReads + source.TransformReads;
+
+	source.BoundingBoxReads = source.TransformReads = 0;
+	volatile int itemCount = 0;
+	moves.seed(6);
+	auto fullWalk = Tests::Time(ticks, [&]()
+	{
+		for (auto i = 0; i < 5; i++)
+			Place(moves, &source.Objects[selected[moves() % selected.size()]]);
+		itemCount = static_cast<int>(FullWalk(selection, source).size());
+	});
+	auto fullWalkReads = source.BoundingBoxReads + source.TransformReads;
+
+	CHECK_EQUAL(list.GetCount(), static_cast<int>(itemCount));
+	AgreesWithFullWalk(list, selection, source);
+	Tests::Report("per tick, cached", cached, "ns");
+	Tests::Report("per tick, full walk", fullWalk, "ns");
+	Tests::Report("tag and transform reads per tick, cached", cachedReads / static_cast<double>(ticks), "");
+	Tests::Report("tag and transform reads per tick, full walk", fullWalkReads / static_cast<double>(ticks), "");
+}
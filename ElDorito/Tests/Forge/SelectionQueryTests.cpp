@@ -0,0 +1,198 @@
+#include "Test.hpp"
+#include "Forge/SelectionQuery.hpp"
+#include <algorithm>
+#include <random>
+
+using namespace Forge::SelectionQuery;
+using Blam::Math::RealVector3D;
+
+namespace
+{
+	// Spreads placements over a forge-map-sized area, mostly flat, with a few far outside it
+	std::vector<PlacementInfo> RandomPlacements(std::mt19937 &random, size_t count)
+	{
+		std::uniform_real_distribution<float> position(-300, 300);
+		std::vector<PlacementInfo> placements;
+		for (auto i = 0U; i < count; i++)
+		{
+			PlacementInfo placement;
+			placement.ObjectIndex = i | 0x10000;
+			placement.TagIndex = random() % 5;
+			placement.Position = RealVector3D(position(random), position(random), position(random) / 10);
+			if (random() % 20 == 0)
+				placement.Position = RealVector3D(1e9f, -1e9f, 0);
+			placement.Team = static_cast<uint8_t>(random() % 3);
+			placement.ObjectType = static_cast<uint8_t>(random() % 4);
+			placement.EngineFlags = static_cast<uint16_t>(random() % 4);
+			placements.push_back(placement);
+		}
+		return placements;
+	}
+
+	Query RandomQuery(std::mt19937 &random)
+	{
+		std::uniform_real_distribution<float> position(-300, 300), radius(0, 120);
+		Query query;
+		query.Shape = static_cast<QueryShape>(random() % 4);
+		RealVector3D a(position(random), position(random), position(random) / 10);
+		RealVector3D b(position(random), position(random), position(random) / 10);
+		query.Min = RealVector3D(std::min(a.I, b.I), std::min(a.J, b.J), std::min(a.K, b.K));
+		query.Max = RealVector3D(std::max(a.I, b.I), std::max(a.J, b.J), std::max(a.K, b.K));
+		query.Center = a;
+		query.Radius = radius(random);
+		if (random() % 2)
+			query.Filter.TagIndex = random() % 5;
+		if (random() % 2)
+			query.Filter.Team = random() % 3;
+		if (random() % 3 == 0)
+			query.Filter.ObjectType = random() % 4;
+		if (random() % 3 == 0)
+			query.Filter.RequiredEngineFlags = static_cast<uint16_t>(random() % 4);
+		return query;
+	}
+
+	// What a query should return, found by checking every placement
+	std::vector<uint32_t> BruteForce(const std::vector<PlacementInfo> &placements, const Query &query)
+	{
+		std::vector<uint32_t> results;
+		for (auto &&placement : placements)
+		{
+			if (IsInShape(placement, query) && MatchesFilter(placement, query.Filter))
+				results.push_back(placement.ObjectIndex);
+		}
+		return results;
+	}
+
+	std::vector<uint32_t> RunSorted(const PlacementGrid &grid, const Query &query)
+	{
+		std::vector<uint32_t> results;
+		grid.Run(query, &results);
+		std::sort(results.begin(), results.end());
+		return results;
+	}
+}
+
+TEST_CASE(SelectionQuery, Shapes)
+{
+	PlacementInfo placement = {};
+	placement.Position = RealVector3D(3, 4, 10);
+
+	Query query;
+	CHECK(IsInShape(placement, query));
+
+	query.Shape = QueryShape::Box;
+	query.Min = RealVector3D(0, 0, 0);
+	query.Max = RealVector3D(3, 4, 10);
+	CHECK(IsInShape(placement, query));
+	query.Max.K = 9;
+	CHECK(!IsInShape(placement, query));
+
+	// Sphere measures in 3D, radius only horizontally
+	query.Center = RealVector3D(0, 0, 0);
+	query.Radius = 5;
+	query.Shape = QueryShape::Sphere;
+	CHECK(!IsInShape(placement, query));
+	query.Shape = QueryShape::Radius;
+	CHECK(IsInShape(placement, query));
+	query.Radius = 4.9f;
+	CHECK(!IsInShape(placement, query));
+}
+
+TEST_CASE(SelectionQuery, Filters)
+{
+	PlacementInfo placement = {};
+	placement.TagIndex = 7;
+	placement.Team = 1;
+	placement.ObjectType = 2;
+	placement.EngineFlags = 0x5;
+
+	QueryFilter filter;
+	CHECK(MatchesFilter(placement, filter));
+	filter.TagIndex = 7;
+	filter.Team = 1;
+	filter.ObjectType = 2;
+	filter.RequiredEngineFlags = 0x4;
+	CHECK(MatchesFilter(placement, filter));
+	filter.RequiredEngineFlags = 0x6;
+	CHECK(!MatchesFilter(placement, filter));
+	filter.RequiredEngineFlags = 0;
+	filter.Team = 0;
+	CHECK(!MatchesFilter(placement, filter));
+}
+
+TEST_CASE(SelectionQuery, GridAgreesWithBruteForce)
+{
+	std::mt19937 random(1);
+	for (auto i = 0; i < 2000; i++)
+	{
+		auto placements = RandomPlacements(random, random() % 641);
+		PlacementGrid grid(i % 2 ? 8.0f : 3.0f);
+		grid.Build(placements);
+		if (!CHECK_EQUAL(placements.size(), grid.GetCount()))
+			break;
+
+		auto query = RandomQuery(random);
+		auto expected = BruteForce(placements, query);
+		std::sort(expected.begin(), expected.end());
+		if (!CHECK(expected == RunSorted(grid, query)))
+			break;
+	}
+}
+
+TEST_CASE(SelectionQuery, RebuildingReplacesPlacements)
+{
+	std::mt19937 random(2);
+	PlacementGrid grid;
+	grid.Build(RandomPlacements(random, 640));
+	grid.Build({});
+	CHECK_EQUAL(0U, grid.GetCount());
+	CHECK(RunSorted(grid, Query()).empty());
+
+	auto placements = RandomPlacements(random, 10);
+	grid.Build(placements);
+	CHECK_EQUAL(10U, RunSorted(grid, Query()).size());
+}
+
+// Runs small box and radius queries over a full map variant, with the grid and by
+// checking every placement.
+BENCHMARK(SelectionQuery, SmallQueries)
+{
+	std::mt19937 random(3);
+	auto placements = RandomPlacements(random, 640);
+	PlacementGrid grid;
+	grid.Build(placements);
+
+	Query query;
+	query.Shape = QueryShape::Radius;
+	query.Center = RealVector3D(10, 20, 0);
+	query.Radius = 15;
+
+	size_t gridCount = 0, scanCount = 0;
+	std::vector<uint32_t> results;
+	auto gridTime = Tests::Time(10000, [&]()
+	{
+		results.clear();
+		grid.Run(query, &results);
+		gridCount += results.size();
+	});
+	auto scanTime = Tests::Time(10000, [&]()
+	{
+		scanCount += BruteForce(placements, query).size();
+	});
+
+	// Invalidating the grid every tick made nearly every query rebuild it first
+	size_t rebuildCount = 0;
+	PlacementGrid rebuiltGrid;
+	auto rebuildTime = Tests::Time(10000, [&]()
+	{
+		rebuiltGrid.Build(placements);
+		results.clear();
+		rebuiltGrid.Run(query, &results);
+		rebuildCount += results.size();
+	});
+	CHECK_EQUAL(scanCount, gridCount);
+	CHECK_EQUAL(scanCount, rebuildCount);
+	Tests::Report("640 placements, 15 unit radius, built grid", gridTime, "ns");
+	Tests::Report("640 placements, 15 unit radius, rebuilding the grid", rebuildTime, "ns");
+	Tests::Report("640 placements, 15 unit radius, every placement", scanTime, "ns");
+}
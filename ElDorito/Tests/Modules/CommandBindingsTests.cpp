@@ -0,0 +1,162 @@
+#include "Test.hpp"
+#include "Modules/CommandBindings.hpp"
+#include <algorithm>
+#include <cctype>
+
+using namespace Modules;
+
+namespace
+{
+	std::vector<std::string> lastArguments;
+	int callCount = 0;
+
+	bool RecordArguments(const std::vector<std::string>& Arguments, std::string& returnInfo)
+	{
+		lastArguments = Arguments;
+		callCount++;
+		returnInfo = "ok";
+		return true;
+	}
+
+	Command* AddTestCommand(const std::string &name)
+	{
+		Command command;
+		command.Name = name;
+		command.ModuleName = "Test";
+		command.Flags = eCommandFlagsNone;
+		command.Type = eCommandTypeCommand;
+		command.UpdateEvent = RecordArguments;
+		return CommandMap::Instance().AddCommand(command);
+	}
+}
+
+TEST_CASE(CommandBindings, BindResolvesCommandAndArguments)
+{
+	auto command = AddTestCommand("Test.Bind");
+	CommandBindings bindings(8);
+	bindings.Bind(3, "test.bind", "one \"two three\"", false);
+
+	auto &binding = bindings.Get(3);
+	CHECK(binding.target == command);
+	CHECK_EQUAL(2U, binding.arguments.size());
+
+	std::string output;
+	lastArguments.clear();
+	CHECK(bindings.Execute(3, true, &output));
+	CHECK_EQUAL(std::string("ok"), output);
+	if (CHECK_EQUAL(2U, lastArguments.size()))
+	{
+		CHECK_EQUAL(std::string("one"), lastArguments[0]);
+		CHECK_EQUAL(std::string("two three"), lastArguments[1]);
+	}
+}
+
+TEST_CASE(CommandBindings, HoldBindingAppendsKeyState)
+{
+	AddTestCommand("Test.Hold");
+	CommandBindings bindings(8);
+	bindings.Bind(1, "Test.Hold", "", true);
+
+	std::string output;
+	bindings.Execute(1, true, &output);
+	CHECK(bindings.Get(1).active);
+	CHECK(lastArguments == std::vector<std::string>{ "1" });
+
+	bindings.Execute(1, false, &output);
+	CHECK(!bindings.Get(1).active);
+	CHECK(lastArguments == std::vector<std::string>{ "0" });
+}
+
+TEST_CASE(CommandBindings, LateCommandsAreResolved)
+{
+	CommandBindings bindings(8);
+	bindings.Bind(2, "Test.Late", "", false);
+
+	std::string output;
+	CHECK(!bindings.Execute(2, true, &output));
+	CHECK_EQUAL(std::string("Command/Variable not found"), output);
+
+	auto command = AddTestCommand("Test.Late");
+	bindings.ResolvePending();
+	CHECK(bindings.Get(2).target == command);
+	CHECK(bindings.Execute(2, true, &output));
+}
+
+TEST_CASE(CommandBindings, FindKeysFollowsRebinding)
+{
+	CommandBindings bindings(8);
+	bindings.Bind(0, "Test.A", "", false);
+	bindings.Bind(4, "TEST.A", "", false);
+	bindings.Bind(5, "Test.B", "", false);
+
+	auto keys = bindings.FindKeys("test.a");
+	if (CHECK(keys != nullptr))
+		CHECK(*keys == (std::vector<size_t>{ 0, 4 }));
+
+	bindings.Bind(0, "Test.B", "", false);
+	bindings.Unbind(4);
+	CHECK(bindings.FindKeys("Test.A") == nullptr);
+	keys = bindings.FindKeys("Test.B");
+	if (CHECK(keys != nullptr))
+		CHECK(*keys == (std::vector<size_t>{ 5, 0 }));
+	CHECK(bindings.Get(4).command.empty());
+	CHECK(bindings.Get(4).target == nullptr);
+}
+
+// Binds every key to its own command among as many commands as the game
+// registers, then compares dispatching and finding a binding with the
+// resolved table against rebuilding and re-parsing the command string,
+// and walking every key, which is what happened before.
+BENCHMARK(CommandBindings, DispatchAndReverseLookup)
+{
+	const size_t keyCount = 109; // eKeyCode_Count
+	const size_t commandCount = 600;
+	for (size_t i = 0; i < commandCount; i++)
+		AddTestCommand("Bench.Command" + std::to_string(i));
+
+	CommandBindings bindings(keyCount);
+	for (size_t key = 0; key < keyCount; key++)
+		bindings.Bind(key, "Bench.Command" + std::to_string(commandCount - 1 - key), "1 \"two words\" 3", false);
+
+	std::string output;
+	auto resolved = Tests::Time(100, [&]()
+	{
+		for (size_t key = 0; key < keyCount; key++)
+			bindings.Execute(key, true, &output);
+	});
+	auto reparsed = Tests::Time(100, [&]()
+	{
+		for (size_t key = 0; key < keyCount; key++)
+		{
+			auto &binding = bindings.Get(key);
+			CommandMap::Instance().ExecuteCommandWithStatus(binding.command[0] + " " + binding.command[1], true, &output);
+		}
+	});
+	Tests::Report("Dispatch every key, resolved", resolved / keyCount, "ns/key");
+	Tests::Report("Dispatch every key, re-parsed", reparsed / keyCount, "ns/key");
+
+	auto lookupIndex = 0U;
+	auto indexed = Tests::Time(100000, [&]()
+	{
+		auto name = "Bench.Command" + std::to_string(commandCount - 1 - (lookupIndex++ % keyCount));
+		callCount += bindings.FindKeys(name) != nullptr;
+	});
+	lookupIndex = 0;
+	auto walked = Tests::Time(100000, [&]()
+	{
+		auto name = "Bench.Command" + std::to_string(commandCount - 1 - (lookupIndex++ % keyCount));
+		std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+		for (size_t key = 0; key < keyCount; key++)
+		{
+			auto &binding = bindings.Get(key);
+			if (binding.command.empty())
+				continue;
+			auto bound = binding.command[0];
+			std::transform(bound.begin(), bound.end(), bound.begin(), ::tolower);
+			if (bound == name)
+				break;
+		}
+	});
+	Tests::Report("Find a command's keys, indexed", indexed, "ns");
+	Tests::Report("Find a command's keys, walking every key", walked, "ns");
+}
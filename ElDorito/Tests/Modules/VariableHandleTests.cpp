@@ -0,0 +1,127 @@
+#include "Test.hpp"
+#include "Modules/ModuleBase.hpp"
+#include "Utils/String.hpp"
+
+using namespace Modules;
+
+namespace
+{
+	class TestModule : public ModuleBase
+	{
+	public:
+		Command* VarInt;
+		Command* VarFloat;
+		Command* VarString;
+
+		TestModule() : ModuleBase("Handle")
+		{
+			VarInt = AddVariableInt("Int", "handle_int", "", eCommandFlagsNone, 5);
+			VarFloat = AddVariableFloat("Float", "handle_float", "", eCommandFlagsNone, 1.5f);
+			VarString = AddVariableString("String", "handle_string", "", eCommandFlagsNone, "abc");
+		}
+
+		using ModuleBase::AddVariableInt;
+		using ModuleBase::AddVariableString;
+	};
+
+	TestModule& GetTestModule()
+	{
+		static TestModule module;
+		return module;
+	}
+}
+
+TEST_CASE(VariableHandle, ReadsAndWritesTheVariable)
+{
+	auto &module = GetTestModule();
+	auto intHandle = module.GetVariableHandle<unsigned long>("Int");
+	auto floatHandle = module.GetVariableHandle<float>("Float");
+	auto stringHandle = module.GetVariableHandle<std::string>("String");
+	if (!CHECK(intHandle.IsValid() && floatHandle.IsValid() && stringHandle.IsValid()))
+		return;
+	CHECK(intHandle.GetCommand() == module.VarInt);
+	CHECK_EQUAL(5UL, intHandle.Get());
+	CHECK_EQUAL(1.5f, floatHandle.Get());
+	CHECK_EQUAL(std::string("abc"), stringHandle.Get());
+
+	// Changes made through the command map are seen through the handle
+	std::string value = "7", previous;
+	CommandMap::Instance().SetVariable(module.VarInt, value, previous);
+	CHECK_EQUAL(7UL, intHandle.Get());
+
+	// Setting through the handle keeps the value string in sync and bumps the version
+	auto version = CommandMap::Instance().GetVersion();
+	intHandle.Set(9);
+	CHECK_EQUAL(9UL, module.VarInt->ValueInt);
+	CHECK_EQUAL(std::string("9"), module.VarInt->ValueString);
+	CHECK(CommandMap::Instance().GetVersion() > version);
+	CHECK_EQUAL(CommandMap::Instance().GetVersion(), module.VarInt->Version);
+
+	stringHandle.Set("def");
+	CHECK_EQUAL(std::string("def"), module.VarString->ValueString);
+}
+
+TEST_CASE(VariableHandle, WrongTypeOrNameIsInvalid)
+{
+	auto &module = GetTestModule();
+	CHECK(!module.GetVariableHandle<float>("Int").IsValid());
+	CHECK(!module.GetVariableHandle<std::string>("Float").IsValid());
+	CHECK(!module.GetVariableHandle<unsigned long>("Missing").IsValid());
+	CHECK(!VariableHandle<unsigned long>().IsValid());
+}
+
+TEST_CASE(VariableHandle, HandlesSurviveAddingCommands)
+{
+	auto &module = GetTestModule();
+	auto handle = module.GetVariableHandle<unsigned long>("Int");
+	auto command = handle.GetCommand();
+	for (auto i = 0; i < 1000; i++)
+		module.AddVariableInt("Growth" + std::to_string(i), "", "", eCommandFlagsNone, i);
+
+	CHECK(handle.GetCommand() == command);
+	CHECK(module.GetVariableHandle<unsigned long>("Int").GetCommand() == command);
+	handle.Set(11);
+	unsigned long value = 0;
+	CHECK(module.GetVariableInt("Int", value));
+	CHECK_EQUAL(11UL, value);
+}
+
+// Runs the camera mode check from ModuleCamera::UpdatePosition a million times,
+// with about as many commands registered as the game has: by name, the way it
+// read the variable before (lowercasing a copy), and through a handle.
+BENCHMARK(VariableHandle, MillionCameraModeChecks)
+{
+	auto &module = GetTestModule();
+	for (auto i = 0; i < 600; i++)
+		module.AddVariableInt("Bench" + std::to_string(i), "", "", eCommandFlagsNone, i);
+	auto varMode = module.AddVariableString("Mode", "", "", eCommandFlagsNone, "Flying");
+	auto mode = module.GetVariableHandle<std::string>("Mode");
+
+	const size_t checks = 1000000;
+	size_t byNameFlying = 0, copyFlying = 0, handleFlying = 0;
+	auto byName = Tests::Time(1, [&]()
+	{
+		std::string value;
+		for (size_t i = 0; i < checks; i++)
+		{
+			module.GetVariableString("Mode", value);
+			byNameFlying += !Utils::String::ToLower(value).compare("flying");
+		}
+	});
+	auto copy = Tests::Time(1, [&]()
+	{
+		for (size_t i = 0; i < checks; i++)
+			copyFlying += !Utils::String::ToLower(varMode->ValueString).compare("flying");
+	});
+	auto byHandle = Tests::Time(1, [&]()
+	{
+		for (size_t i = 0; i < checks; i++)
+			handleFlying += !_stricmp(mode.Get().c_str(), "flying");
+	});
+	CHECK_EQUAL(checks, byNameFlying);
+	CHECK_EQUAL(checks, copyFlying);
+	CHECK_EQUAL(checks, handleFlying);
+	Tests::Report("1M checks by name", byName / 1e6, "ms");
+	Tests::Report("1M checks lowercasing the value", copy / 1e6, "ms");
+	Tests::Report("1M checks through a handle", byHandle / 1e6, "ms");
+}
@@ -0,0 +1,160 @@
+#include "Test.hpp"
+#include "Patches/ContentItemIndex.hpp"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+using namespace Patches::ContentItems;
+namespace fs = std::filesystem;
+
+namespace
+{
+	// Creates an empty directory for a test to put files in.
+	fs::path MakeTestDirectory(const std::string &name)
+	{
+		auto path = fs::temp_directory_path() / ("ElDoritoTests-" + name);
+		fs::remove_all(path);
+		fs::create_directories(path);
+		return path;
+	}
+
+	// Writes a BLF file whose content header is filled with a value.
+	void WriteBlf(const fs::path &path, uint8_t fill)
+	{
+		std::vector<char> data(0x40 + ContentHeaderSize + 0x20, 0);
+		memcpy(&data[0], "_blf", 4);
+		memset(&data[0x40], fill, ContentHeaderSize);
+		std::ofstream(path, std::ios::binary).write(data.data(), data.size());
+	}
+
+	void WriteText(const fs::path &path, const std::string &text)
+	{
+		std::ofstream(path, std::ios::binary) << text;
+	}
+
+	// Builds a tree of variants and maps with some files which aren't content mixed in.
+	void BuildContentTree(const fs::path &root, int count)
+	{
+		for (auto i = 0; i < count; i++)
+		{
+			auto directory = root / ((i % 2) ? "maps" : "variants") / ("item" + std::to_string(i));
+			fs::create_directories(directory);
+			WriteBlf(directory / "variant.bin", static_cast<uint8_t>(i));
+			if (i % 4 == 0)
+				WriteText(directory / "notes.txt", std::string(0x200, 'x'));
+			if (i % 8 == 0)
+				WriteText(directory / "small.bin", "_blf");
+		}
+	}
+
+	bool HasHeader(const std::vector<IndexedContentItem> &items, const fs::path &path, uint8_t fill)
+	{
+		for (auto &item : items)
+		{
+			// The index joins paths with backslashes
+			auto itemPath = item.Path;
+			std::replace(itemPath.begin(), itemPath.end(), '\\', '/');
+			if (itemPath == path.generic_string())
+				return item.IsContent && item.Header[0] == fill && item.Header[ContentHeaderSize - 1] == fill;
+		}
+		return false;
+	}
+}
+
+TEST_CASE(ContentItemIndex, OnlyChangedFilesAreRead)
+{
+	auto root = MakeTestDirectory("ContentItemIndex");
+	BuildContentTree(root, 16);
+	std::vector<std::string> directories = { (root / "variants").string(), (root / "maps").string() };
+
+	ContentItemIndex index;
+	auto items = index.Update(directories, 4);
+	CHECK_EQUAL(16U, items.size());
+	CHECK_EQUAL(16U + 4 + 2, index.GetReadCount());
+	CHECK(HasHeader(items, root / "maps" / "item3" / "variant.bin", 3));
+
+	items = index.Update(directories, 4);
+	CHECK_EQUAL(16U, items.size());
+	CHECK_EQUAL(0U, index.GetReadCount());
+
+	// Rewriting a file with the same size less than a second later is still noticed
+	auto changed = root / "variants" / "item6" / "variant.bin";
+	auto writeTime = fs::last_write_time(changed);
+	WriteBlf(changed, 0xAA);
+	fs::last_write_time(changed, writeTime + std::chrono::milliseconds(10));
+	fs::remove(root / "maps" / "item5" / "variant.bin");
+	items = index.Update(directories, 4);
+	CHECK_EQUAL(15U, items.size());
+	CHECK_EQUAL(1U, index.GetReadCount());
+	CHECK(HasHeader(items, changed, 0xAA));
+	fs::remove_all(root);
+}
+
+TEST_CASE(ContentItemIndex, SaveAndLoad)
+{
+	auto root = MakeTestDirectory("ContentItemIndexSave");
+	BuildContentTree(root, 8);
+	std::vector<std::string> directories = { (root / "variants").string(), (root / "maps").string() };
+	auto indexPath = (root / "index.bin").string();
+
+	ContentItemIndex index;
+	index.Update(directories);
+	CHECK(index.Save(indexPath));
+
+	ContentItemIndex loaded;
+	CHECK(loaded.Load(indexPath));
+	auto items = loaded.Update(directories);
+	CHECK_EQUAL(8U, items.size());
+	CHECK_EQUAL(0U, loaded.GetReadCount());
+	CHECK(HasHeader(items, root / "variants" / "item2" / "variant.bin", 2));
+
+	// An index from an older version is thrown away
+	std::fstream stream(indexPath, std::ios::in | std::ios::out | std::ios::binary);
+	uint32_t version = 1;
+	stream.seekp(4);
+	stream.write(reinterpret_cast<const char*>(&version), sizeof(version));
+	stream.close();
+	CHECK(!loaded.Load(indexPath));
+	fs::remove_all(root);
+}
+
+TEST_CASE(ContentItemIndex, UnreadableFilesAreNotCached)
+{
+	auto root = MakeTestDirectory("ContentItemIndexUnreadable");
+	BuildContentTree(root, 2);
+	auto locked = root / "variants" / "item0" / "variant.bin";
+	fs::permissions(locked, fs::perms::none);
+	if (std::ifstream(locked))
+	{
+		// Permissions don't stop this user from reading the file
+		fs::remove_all(root);
+		return;
+	}
+
+	std::vector<std::string> directories = { (root / "variants").string() };
+	ContentItemIndex index;
+	CHECK_EQUAL(0U, index.Update(directories).size());
+	CHECK_EQUAL(0U, index.Update(directories).size());
+	CHECK_EQUAL(1U, index.GetReadCount());
+
+	fs::permissions(locked, fs::perms::owner_all);
+	CHECK_EQUAL(1U, index.Update(directories).size());
+	fs::remove_all(root);
+}
+
+// Compares scanning a tree of content for the first time against scanning
+// it again once the index knows about every file.
+BENCHMARK(ContentItemIndex, ColdAndWarmUpdate)
+{
+	auto root = MakeTestDirectory("ContentItemIndexBenchmark");
+	BuildContentTree(root, 2000);
+	std::vector<std::string> directories = { (root / "variants").string(), (root / "maps").string() };
+
+	ContentItemIndex index;
+	auto cold = Tests::Time(1, [&]() { index.Update(directories); });
+	auto warm = Tests::Time(5, [&]() { index.Update(directories); });
+	Tests::Report("Update 2000 items, cold", cold / 1000000, "ms");
+	Tests::Report("Update 2000 items, warm", warm / 1000000, "ms");
+	fs::remove_all(root);
+}
@@ -0,0 +1,72 @@
+#include "Test.hpp"
+#include "Patches/MemoryTelemetry.hpp"
+
+using namespace Patches::MemoryTelemetry;
+
+TEST_CASE(MemoryTelemetry, TracksPeakUsage)
+{
+	ArenaTracker tracker;
+	tracker.RecordInit(ArenaType::Array, "objects", 0x1000, 4096);
+	tracker.RecordInit(ArenaType::Pool, "effects", 0x2000, 1024);
+
+	CHECK(tracker.RecordUsage(0x1000, 100));
+	CHECK(tracker.RecordUsage(0x1000, 300));
+	CHECK(tracker.RecordUsage(0x1000, 200));
+	CHECK(!tracker.RecordUsage(0x3000, 10));
+
+	auto &arenas = tracker.GetArenas();
+	if (!CHECK_EQUAL(2U, arenas.size()))
+		return;
+	CHECK_EQUAL(std::string("objects"), arenas[0].Name);
+	CHECK_EQUAL(200U, arenas[0].Used);
+	CHECK_EQUAL(300U, arenas[0].PeakUsed);
+	CHECK_EQUAL(1U, arenas[0].InitCount);
+	CHECK_EQUAL(4096U, tracker.GetTotalReserved(ArenaType::Array));
+	CHECK_EQUAL(1024U, tracker.GetTotalReserved(ArenaType::Pool));
+	CHECK_EQUAL(0U, tracker.GetTotalReserved(ArenaType::Cache));
+}
+
+TEST_CASE(MemoryTelemetry, ReinitializingKeepsOrReplacesArenas)
+{
+	ArenaTracker tracker;
+	tracker.RecordInit(ArenaType::Array, "objects", 0x1000, 4096);
+	tracker.RecordUsage(0x1000, 300);
+
+	// The same arena being initialized again (e.g. on map load) keeps its peak
+	tracker.RecordInit(ArenaType::Array, "objects", 0x1000, 8192);
+	auto arena = tracker.GetArenas()[0];
+	CHECK_EQUAL(2U, arena.InitCount);
+	CHECK_EQUAL(0U, arena.Used);
+	CHECK_EQUAL(300U, arena.PeakUsed);
+	CHECK_EQUAL(8192U, arena.Reserved);
+
+	// A different arena at the same address replaces it
+	tracker.RecordInit(ArenaType::Pool, "sounds", 0x1000, 512);
+	arena = tracker.GetArenas()[0];
+	CHECK_EQUAL(1U, tracker.GetArenas().size());
+	CHECK_EQUAL(std::string("sounds"), arena.Name);
+	CHECK_EQUAL(1U, arena.InitCount);
+	CHECK_EQUAL(0U, arena.PeakUsed);
+
+	tracker.Clear();
+	CHECK(tracker.GetArenas().empty());
+	CHECK(!tracker.RecordUsage(0x1000, 1));
+}
+
+TEST_CASE(MemoryTelemetry, FormatsFilteredStats)
+{
+	ArenaTracker tracker;
+	tracker.RecordInit(ArenaType::Array, "object headers", 0x1000, 4096);
+	tracker.RecordInit(ArenaType::Cache, "sound cache", 0x2000, 64);
+	tracker.RecordUsage(0x1000, 100);
+
+	auto all = FormatArenaStats(tracker.GetArenas(), "");
+	CHECK(all.find("object headers") != std::string::npos);
+	CHECK(all.find("sound cache") != std::string::npos);
+	CHECK(all.find("4160") != std::string::npos); // Total reserved
+
+	auto filtered = FormatArenaStats(tracker.GetArenas(), "sound");
+	CHECK(filtered.find("object headers") == std::string::npos);
+	CHECK(filtered.find("sound cache") != std::string::npos);
+	CHECK(filtered.find("cache") != std::string::npos);
+}
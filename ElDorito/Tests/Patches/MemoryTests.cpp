@@ -0,0 +1,75 @@
+#include "Test.hpp"
+#include "Patches/Memory.hpp"
+
+using namespace Patches::Memory;
+
+TEST_CASE(Memory, DefaultPlanMatchesTheOldSizes)
+{
+	// The sizes the hardcoded expansion applied before profiles existed: 1000 cached
+	// object render states (growing sub-allocation 4 by 0xC0000 after alignment),
+	// a 100 MB cache increase and the runtime state globals left alone
+	auto plan = PlanMemoryMap(MemoryProfile());
+	CHECK_EQUAL(0x390000U, plan.GameStateSubAllocation4Size);
+	CHECK_EQUAL(0x1340000U, plan.GameStateGlobalsSize);
+	CHECK_EQUAL(0xAF00000U, plan.GlobalDataSize);
+	CHECK_EQUAL(0x2AF00000U, plan.GlobalCacheSize);
+	CHECK_EQUAL(0x380000U, plan.RuntimeGlobalsSize);
+}
+
+TEST_CASE(Memory, PlanFollowsTheProfile)
+{
+	MemoryProfile original;
+	original.CacheIncreaseMB = 0;
+	original.CachedObjectRenderStates = 384;
+	auto plan = PlanMemoryMap(original);
+	CHECK_EQUAL(0x2D0000U, plan.GameStateSubAllocation4Size);
+	CHECK_EQUAL(0x1280000U, plan.GameStateGlobalsSize);
+	CHECK_EQUAL(0xAE00000U, plan.GlobalDataSize);
+	CHECK_EQUAL(0x24B00000U, plan.GlobalCacheSize);
+
+	// Expanding the runtime state globals also grows the global data
+	auto expanded = original;
+	expanded.ExpandRuntimeStateGlobals = true;
+	auto expandedPlan = PlanMemoryMap(expanded);
+	CHECK(expandedPlan.RuntimeGlobalsSize > plan.RuntimeGlobalsSize);
+	CHECK_EQUAL(0U, expandedPlan.RuntimeGlobalsSize % 0x10000);
+	CHECK(expandedPlan.GlobalDataSize >= plan.GlobalDataSize + (expandedPlan.RuntimeGlobalsSize - plan.RuntimeGlobalsSize));
+	CHECK_EQUAL(0U, expandedPlan.GlobalDataSize % 0x100000);
+
+	auto bigCache = original;
+	bigCache.CacheIncreaseMB = 512;
+	CHECK_EQUAL(0x24B00000U + 512U * 1024 * 1024, PlanMemoryMap(bigCache).GlobalCacheSize);
+}
+
+TEST_CASE(Memory, ParsesProfiles)
+{
+	std::vector<std::string> errors;
+	auto profile = ParseMemoryProfile("{ \"cacheIncreaseMB\": 200, \"cachedObjectRenderStates\": 2048, \"expandRuntimeStateGlobals\": true }", &errors);
+	CHECK(errors.empty());
+	CHECK_EQUAL(200U, profile.CacheIncreaseMB);
+	CHECK_EQUAL(2048U, profile.CachedObjectRenderStates);
+	CHECK(profile.ExpandRuntimeStateGlobals);
+
+	// Missing values keep their defaults
+	profile = ParseMemoryProfile("{ \"cacheIncreaseMB\": 0 }", &errors);
+	CHECK(errors.empty());
+	CHECK_EQUAL(0U, profile.CacheIncreaseMB);
+	CHECK_EQUAL(MemoryProfile().CachedObjectRenderStates, profile.CachedObjectRenderStates);
+}
+
+TEST_CASE(Memory, InvalidValuesUseTheDefaults)
+{
+	std::vector<std::string> errors;
+	auto profile = ParseMemoryProfile("{ \"cacheIncreaseMB\": 513, \"cachedObjectRenderStates\": 100, \"expandRuntimeStateGlobals\": 1 }", &errors);
+	CHECK_EQUAL(3U, errors.size());
+	CHECK_EQUAL(MemoryProfile().CacheIncreaseMB, profile.CacheIncreaseMB);
+	CHECK_EQUAL(MemoryProfile().CachedObjectRenderStates, profile.CachedObjectRenderStates);
+	CHECK(!profile.ExpandRuntimeStateGlobals);
+
+	errors.clear();
+	ParseMemoryProfile("[ 1, 2 ]", &errors);
+	CHECK_EQUAL(1U, errors.size());
+	errors.clear();
+	ParseMemoryProfile("{ not json", &errors);
+	CHECK_EQUAL(1U, errors.size());
+}
@@ -0,0 +1,258 @@
+#include "Test.hpp"
+#include "Patches/UiTagData.hpp"
+#include "Blam/Tags/UI/ChudGlobalsDefinition.hpp"
+#include "Blam/Tags/UI/ChudDefinition.hpp"
+#include "Blam/Tags/UI/MultilingualUnicodeStringList.hpp"
+#include "Blam/Tags/UI/GfxTexturesList.hpp"
+#include "Blam/Tags/Globals/CacheFileGlobalTags.hpp"
+#include "Blam/Tags/Game/Globals.hpp"
+#include "Blam/Tags/Game/MultiplayerGlobals.hpp"
+#include "Blam/Tags/Objects/Biped.hpp"
+#include <cstring>
+#include <memory>
+
+using namespace Blam::Tags;
+using namespace Blam::Tags::UI;
+using namespace Patches::Ui;
+
+namespace
+{
+	// Points a tag block at the elements in a vector.
+	template<typename T>
+	void SetBlock(TagBlock<T> *block, std::vector<T> &elements)
+	{
+		*block = TagBlock<T>(static_cast<int32_t>(elements.size()), elements.data());
+	}
+
+	GfxTexturesList::Texture MakeTexture(const char *fileName, int32_t bitmapIndex)
+	{
+		GfxTexturesList::Texture texture = {};
+		strncpy(texture.FileName, fileName, sizeof(texture.FileName) - 1);
+		texture.Bitmap = TagReference('bitm', bitmapIndex);
+		return texture;
+	}
+
+	MultilingualUnicodeStringList::LocalizedString MakeString(const char *name, int32_t stringId, int32_t englishOffset)
+	{
+		MultilingualUnicodeStringList::LocalizedString str = {};
+		strncpy(str.StringIDStr, name, sizeof(str.StringIDStr));
+		str.StringID = stringId;
+		str.Offsets[0] = englishOffset;
+		return str;
+	}
+
+	ChudGlobalsDefinition::HudGlobal::HudAttribute MakeHudAttribute(float warpDirection, uint32_t width, uint32_t height)
+	{
+		ChudGlobalsDefinition::HudGlobal::HudAttribute attribute = {};
+		attribute.WarpDirection = warpDirection;
+		attribute.ResolutionWidth = width;
+		attribute.ResolutionHeight = height;
+		attribute.HorizontalScale = 1.5f;
+		attribute.VerticalScale = 2.5f;
+		attribute.MotionSensorOffsetX = 12.f;
+		return attribute;
+	}
+
+	// A set of tags laid out like the ones ResolveUiTagData looks for.
+	struct SyntheticTags
+	{
+		std::vector<ChudGlobalsDefinition::HudGlobal::HudAttribute> spartanAttributes, eliteAttributes, monitorAttributes;
+		std::vector<ChudGlobalsDefinition::HudGlobal> hudGlobals;
+		std::unique_ptr<ChudGlobalsDefinition> chgd = std::make_unique<ChudGlobalsDefinition>();
+
+		std::vector<ChudDefinition::PlacementDataDefinition> placement;
+		std::vector<ChudDefinition::HudWidgetDefinition> widgets;
+		std::unique_ptr<ChudDefinition> chdt = std::make_unique<ChudDefinition>();
+
+		std::vector<Objects::Unit::HudInterface> hudInterfaces;
+		std::unique_ptr<Objects::Biped> bipd = std::make_unique<Objects::Biped>();
+
+		std::vector<MultilingualUnicodeStringList::LocalizedString> strings;
+		std::unique_ptr<MultilingualUnicodeStringList> unic = std::make_unique<MultilingualUnicodeStringList>();
+
+		std::vector<Game::MultiplayerGlobals::Runtime::LoopingSoundReference> loopingSounds;
+		std::vector<struct Game::MultiplayerGlobals::Runtime> runtime;
+		std::unique_ptr<Game::MultiplayerGlobals> mulg = std::make_unique<Game::MultiplayerGlobals>();
+
+		std::vector<Game::Globals::InterfaceTag> interfaceTags;
+		std::vector<struct Game::Globals::PlayerRepresentation> representations;
+		std::unique_ptr<Game::Globals> matg = std::make_unique<Game::Globals>();
+
+		std::vector<Globals::CacheFileGlobalTags::GlobalsTag> globalsTags;
+		std::unique_ptr<Globals::CacheFileGlobalTags> cfgt = std::make_unique<Globals::CacheFileGlobalTags>();
+
+		std::vector<GfxTexturesList::Texture> menuTextures, mapTextures;
+		std::unique_ptr<GfxTexturesList> menuGfxt = std::make_unique<GfxTexturesList>();
+		std::unique_ptr<GfxTexturesList> mapGfxt = std::make_unique<GfxTexturesList>();
+
+		SyntheticTags()
+		{
+			spartanAttributes = { MakeHudAttribute(0.25f, 1920, 1080) };
+			eliteAttributes = { MakeHudAttribute(-0.5f, 1, 1) };
+			monitorAttributes = { MakeHudAttribute(0.75f, 1, 1) };
+			hudGlobals.resize(3);
+			hudGlobals[0].Biped = ChudGlobalsDefinition::HudGlobal::Spartan;
+			hudGlobals[0].ScoreboardHud = TagReference('chdt', 0x20);
+			hudGlobals[0].HudStrings = TagReference('unic', 0x30);
+			SetBlock(&hudGlobals[0].HudAttributes, spartanAttributes);
+			hudGlobals[1].Biped = ChudGlobalsDefinition::HudGlobal::Elite;
+			SetBlock(&hudGlobals[1].HudAttributes, eliteAttributes);
+			hudGlobals[2].Biped = ChudGlobalsDefinition::HudGlobal::Monitor;
+			SetBlock(&hudGlobals[2].HudAttributes, monitorAttributes);
+			SetBlock(&chgd->HudGlobals, hudGlobals);
+
+			placement.resize(1);
+			placement[0].OffsetY = 42.f;
+			widgets.resize(2);
+			widgets[0].NameStringID = 1;
+			widgets[1].NameStringID = 0x2ABD; // in_helmet_bottom_new
+			SetBlock(&widgets[1].PlacementData, placement);
+			SetBlock(&chdt->HudWidgets, widgets);
+
+			hudInterfaces.resize(1);
+			hudInterfaces[0].UnitHudInterface = TagReference('chdt', 0x21);
+			SetBlock(&bipd->Unit.HudInterfaces, hudInterfaces);
+
+			strings = { MakeString("speaking_player", 0x1234, 0x80), MakeString("other", 1, 2) };
+			SetBlock(&unic->Strings, strings);
+
+			loopingSounds.resize(1);
+			loopingSounds[0].LoopingSound = TagReference('lsnd', 0x40);
+			runtime.resize(1);
+			SetBlock(&runtime[0].LoopingSounds, loopingSounds);
+			SetBlock(&mulg->Runtime, runtime);
+
+			interfaceTags.resize(2);
+			interfaceTags[0].HudGlobals = TagReference('chgd', 0x99); // Not loaded
+			interfaceTags[1].HudGlobals = TagReference('chgd', 0x10);
+			representations.resize(2);
+			representations[0].Name = 1;
+			representations[0].ThirdPersonUnit = TagReference('bipd', 0x50);
+			representations[1].Name = 4376; // mp_spartan
+			representations[1].ThirdPersonUnit = TagReference('bipd', 0x51);
+			SetBlock(&matg->InterfaceTags, interfaceTags);
+			SetBlock(&matg->PlayerRepresentation, representations);
+			matg->MultiplayerGlobals = TagReference('mulg', 0x60);
+
+			globalsTags.resize(2);
+			globalsTags[0].Tag = TagReference('scnr', 0x70);
+			globalsTags[1].Tag = TagReference('matg', 0x71);
+			SetBlock(&cfgt->GlobalsTags, globalsTags);
+
+			menuTextures = { MakeTexture("main_menu.swf", 1) };
+			SetBlock(&menuGfxt->Textures, menuTextures);
+			mapTextures = { MakeTexture("placeholder.bitmap", 0x100), MakeTexture("320", 0x101), MakeTexture("705_guardian", 0x102) };
+			SetBlock(&mapGfxt->Textures, mapTextures);
+
+			TagInstance::Clear();
+			TagInstance::Register(0x01, 'cfgt', cfgt.get());
+			TagInstance::Register(0x10, 'chgd', chgd.get());
+			TagInstance::Register(0x20, 'chdt', chdt.get());
+			TagInstance::Register(0x21, 'chdt', chdt.get());
+			TagInstance::Register(0x30, 'unic', unic.get());
+			TagInstance::Register(0x51, 'bipd', bipd.get());
+			TagInstance::Register(0x60, 'mulg', mulg.get());
+			TagInstance::Register(0x71, 'matg', matg.get());
+			TagInstance::Register(0x80, 'gfxt', menuGfxt.get());
+			TagInstance::Register(0x81, 'gfxt', mapGfxt.get());
+		}
+
+		~SyntheticTags()
+		{
+			TagInstance::Clear();
+		}
+	};
+}
+
+TEST_CASE(UiTagData, ResolvesEverythingInOnePass)
+{
+	SyntheticTags tags;
+	ResolveUiTagData();
+	auto &data = GetUiTagData();
+
+	CHECK(data.Resolved);
+	CHECK_EQUAL(0x10U, data.ChgdIndex);
+	CHECK_EQUAL(0x20U, data.ScoreboardChdtIndex);
+	CHECK_EQUAL(0x30U, data.HudMessagesUnicIndex);
+	CHECK_EQUAL(0x21U, data.SpartanChdtIndex);
+	CHECK_EQUAL(0x40U, data.PttLsndIndex);
+
+	CHECK(data.SpeakingPlayerStringFound);
+	CHECK_EQUAL(0x80U, data.SpeakingPlayerOffset);
+	CHECK_EQUAL(0x1234, data.SpeakingPlayerStringID);
+
+	CHECK(data.HudDistortionFound);
+	CHECK_EQUAL(0.25f, data.HudDistortionDirection[0]);
+	CHECK_EQUAL(-0.5f, data.HudDistortionDirection[1]);
+	CHECK_EQUAL(0.75f, data.HudDistortionDirection[2]);
+
+	CHECK(data.HudResolutionFound);
+	CHECK_EQUAL(1920, data.HudResolutionWidth);
+	CHECK_EQUAL(1080, data.HudResolutionHeight);
+	CHECK_EQUAL(1.5f, data.HudResolutionScaleX);
+	CHECK_EQUAL(2.5f, data.HudResolutionScaleY);
+	CHECK_EQUAL(12.f, data.HudMotionSensorOffsetX);
+	CHECK_EQUAL(42.f, data.HudBottomVisorOffsetY);
+
+	// The first texture list isn't named after maps, so the second one is used
+	CHECK(data.MapImagesFound);
+	CHECK_EQUAL(0x101U, data.GetMapImage(320));
+	CHECK_EQUAL(0x102U, data.GetMapImage(705));
+	CHECK_EQUAL(0x100U, data.GetMapImage(31));
+}
+
+TEST_CASE(UiTagData, MissingTagsAreReportedAsNotFound)
+{
+	{
+		SyntheticTags tags;
+		ResolveUiTagData();
+		CHECK(GetUiTagData().HudResolutionFound);
+	}
+
+	// Resolving again replaces everything from the last time
+	ResolveUiTagData();
+	auto &data = GetUiTagData();
+	CHECK(data.Resolved);
+	CHECK_EQUAL(0U, data.ChgdIndex);
+	CHECK(!data.HudDistortionFound);
+	CHECK(!data.HudResolutionFound);
+	CHECK(!data.SpeakingPlayerStringFound);
+	CHECK(!data.MapImagesFound);
+	CHECK(data.MapImages.empty());
+}
+
+TEST_CASE(UiTagData, MapImagesNeedNumericNames)
+{
+	std::vector<GfxTexturesList::Texture> textures = { MakeTexture("placeholder", 9), MakeTexture("100", 10), MakeTexture("menu", 11) };
+	GfxTexturesList gfxt;
+	SetBlock(&gfxt.Textures, textures);
+
+	UiTagData data;
+	CHECK(!ResolveMapImages(gfxt, &data));
+	CHECK(!data.MapImagesFound);
+	CHECK(data.MapImages.empty());
+
+	textures.pop_back();
+	SetBlock(&gfxt.Textures, textures);
+	CHECK(ResolveMapImages(gfxt, &data));
+	CHECK_EQUAL(10U, data.GetMapImage(100));
+	CHECK_EQUAL(9U, data.GetMapImage(101));
+}
+
+TEST_CASE(UiTagData, SpeakingPlayerStringIsFoundFromTheEnd)
+{
+	std::vector<MultilingualUnicodeStringList::LocalizedString> strings =
+	{
+		MakeString("speaking_player", 1, 0x10),
+		MakeString("speaking_player_2", 2, 0x20),
+		MakeString("speaking_player", 3, 0x30),
+	};
+	MultilingualUnicodeStringList unic;
+	SetBlock(&unic.Strings, strings);
+
+	UiTagData data;
+	ResolveSpeakingPlayerString(unic, &data);
+	CHECK(data.SpeakingPlayerStringFound);
+	CHECK_EQUAL(3, data.SpeakingPlayerStringID);
+	CHECK_EQUAL(0x30U, data.SpeakingPlayerOffset);
+}
@@ -0,0 +1,212 @@
+#include "Test.hpp"
+#include "Server/BanList.hpp"
+#include "Modules/ModuleServer.hpp"
+#include "Patches/PlayerUid.hpp"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <random>
+
+// Same as the real one, which lives with the UID patches
+bool Patches::PlayerUid::ParseUid(const std::string &str, uint64_t *out)
+{
+	try
+	{
+		size_t end;
+		*out = std::stoull(str, &end, 16);
+		return end == str.length();
+	}
+	catch (std::exception&)
+	{
+		return false;
+	}
+}
+
+namespace
+{
+	// The ban list is saved relative to the working directory, so each run uses an empty one
+	void UseEmptyDirectory()
+	{
+		auto directory = std::filesystem::temp_directory_path() / "ElDoritoBanListTests";
+		std::filesystem::remove_all(directory);
+		std::filesystem::create_directories(directory / "mods" / "server");
+		std::filesystem::current_path(directory);
+	}
+
+	std::string ReadBanFile()
+	{
+		std::ifstream stream(Server::DefaultTempBanListPath);
+		return std::string(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+	}
+}
+
+TEST_CASE(TempBanList, ExpiresInOrder)
+{
+	UseEmptyDirectory();
+	Server::TempBanList bans;
+
+	// Mix IP and UID bans, then check the count against a sorted list of expiry times
+	std::mt19937 random(3);
+	std::vector<std::time_t> expiries;
+	for (auto i = 0; i < 500; i++)
+	{
+		auto expiry = static_cast<std::time_t>(1000 + random() % 100000);
+		if (i % 2)
+			bans.AddIp("10.0." + std::to_string(i / 256) + "." + std::to_string(i % 256), expiry);
+		else
+			bans.AddUid(0x1000 + i, expiry);
+		expiries.push_back(expiry);
+	}
+	std::sort(expiries.begin(), expiries.end());
+	CHECK_EQUAL(500U, bans.Count());
+
+	for (std::time_t now = 0; now <= 102000; now += 5000)
+	{
+		bans.Expire(now);
+		auto remaining = expiries.end() - std::upper_bound(expiries.begin(), expiries.end(), now);
+		if (!CHECK_EQUAL(static_cast<size_t>(remaining), bans.Count()))
+			break;
+	}
+}
+
+TEST_CASE(TempBanList, UidsAreIndexedSeparatelyFromIps)
+{
+	UseEmptyDirectory();
+	Server::TempBanList bans;
+	bans.AddIp("192.168.0.1", 2000);
+	bans.AddUid(0xabcdef, 3000);
+
+	CHECK(bans.ContainsUid(0xabcdef, 1000));
+	CHECK(!bans.ContainsUid(0x123456, 1000));
+	CHECK(bans.ContainsIp("192.168.0.1", 1000));
+
+	// Removing one kind of ban doesn't touch the other
+	CHECK(bans.RemoveIp("192.168.0.1"));
+	CHECK(!bans.RemoveIp("192.168.0.1"));
+	CHECK(bans.ContainsUid(0xabcdef, 1000));
+
+	// A lapsed ban doesn't count
+	CHECK(!bans.ContainsUid(0xabcdef, 3000));
+	CHECK_EQUAL(0U, bans.Count());
+
+	bans.AddUid(0xabcdef, 4000);
+	CHECK(bans.RemoveUid(0xabcdef));
+	CHECK(!bans.RemoveUid(0xabcdef));
+	CHECK_EQUAL(0U, bans.Count());
+}
+
+TEST_CASE(TempBanList, BansAreExtended)
+{
+	UseEmptyDirectory();
+	Modules::ModuleServer::Instance().VarTempBanMinutes->ValueInt = 30;
+	Server::TempBanList bans;
+
+	auto now = std::time(nullptr);
+	bans.AddUid(42);
+	bans.AddUid(42);
+	CHECK_EQUAL(1U, bans.Count());
+	CHECK(bans.ContainsUid(42, now + 59 * 60));
+	CHECK(!bans.ContainsUid(42, now + 61 * 60));
+
+	// An explicit expiry only ever makes a ban longer
+	bans.AddIp("1.2.3.4", now + 600);
+	bans.AddIp("1.2.3.4", now + 60);
+	CHECK(bans.ContainsIp("1.2.3.4", now + 300));
+}
+
+TEST_CASE(TempBanList, LookupsDontWriteTheFile)
+{
+	UseEmptyDirectory();
+	auto now = std::time(nullptr);
+	Server::TempBanList bans;
+	bans.AddUid(0x10, now + 100);
+	bans.AddUid(0x20, now + 200);
+	CHECK(ReadBanFile().empty());
+	bans.Flush();
+	auto file = ReadBanFile();
+	CHECK(file.find("uid 0000000000000010 ") != std::string::npos);
+
+	// A ban lapsing during a lookup only changes the list in memory
+	CHECK(!bans.ContainsUid(0x10, now + 150));
+	CHECK_EQUAL(1U, bans.Count());
+	bans.Flush();
+	CHECK_EQUAL(file, ReadBanFile());
+
+	// Extending a ban to an earlier time doesn't change anything either
+	bans.AddUid(0x20, now + 50);
+	bans.Flush();
+	CHECK_EQUAL(file, ReadBanFile());
+
+	CHECK(bans.RemoveUid(0x20));
+	CHECK_EQUAL(file, ReadBanFile());
+	bans.Flush();
+	CHECK(ReadBanFile().find("uid 0000000000000020 ") == std::string::npos);
+}
+
+TEST_CASE(TempBanList, BansAreSavedAndLoaded)
+{
+	UseEmptyDirectory();
+	auto now = std::time(nullptr);
+	{
+		Server::TempBanList bans;
+		bans.AddIp("1.1.1.1", now + 100);
+		bans.AddUid(0x0123456789abcdef, now + 200);
+	}
+	auto file = ReadBanFile();
+	CHECK(file.find("ip 1.1.1.1 ") != std::string::npos);
+	CHECK(file.find("uid 0123456789abcdef ") != std::string::npos);
+
+	// Expired and duplicate bans are skipped when loading
+	{
+		std::ofstream stream(Server::DefaultTempBanListPath, std::ios::app);
+		stream << "ip 2.2.2.2 " << static_cast<long long>(now - 10) << '\n';
+		stream << "uid 0123456789abcdef " << static_cast<long long>(now + 900) << '\n';
+		stream << "uid nonsense " << static_cast<long long>(now + 900) << '\n';
+	}
+
+	Server::TempBanList loaded;
+	CHECK_EQUAL(2U, loaded.Count());
+	CHECK(loaded.ContainsIp("1.1.1.1", now));
+	CHECK(!loaded.ContainsIp("2.2.2.2", now));
+	CHECK(loaded.ContainsUid(0x0123456789abcdef, now));
+	CHECK(!loaded.ContainsUid(0x0123456789abcdef, now + 200));
+}
+
+// Looks up bans in lists of 1,000 and 100,000 bans, with a ban lapsing
+// every 100 lookups. Neither lookups nor lapsing bans scan the list or write the file.
+BENCHMARK(TempBanList, LookupsOnALargeList)
+{
+	UseEmptyDirectory();
+	for (auto size : { 1000, 100000 })
+	{
+		Server::TempBanList bans;
+		std::mt19937 random(3);
+		for (auto i = 0; i < size; i++)
+		{
+			if (i % 2)
+				bans.AddIp("10." + std::to_string(i / 65536) + "." + std::to_string(i / 256 % 256) + "." + std::to_string(i % 256), 1000 + i);
+			else
+				bans.AddUid(0x1000 + i, 1000 + i);
+		}
+		bans.Flush();
+
+		// Lookups start once the first bans have lapsed, and time moves on by one ban every 100 lookups
+		const auto lookups = 100000;
+		size_t found = 0;
+		auto elapsed = Tests::Time(1, [&]()
+		{
+			for (auto i = 0; i < lookups; i++)
+			{
+				auto now = static_cast<std::time_t>(1000 + i / 100);
+				auto target = static_cast<int>(random() % size);
+				if (target % 2)
+					found += bans.ContainsIp("10." + std::to_string(target / 65536) + "." + std::to_string(target / 256 % 256) + "." + std::to_string(target % 256), now);
+				else
+					found += bans.ContainsUid(0x1000 + target, now);
+			}
+		});
+		CHECK(found > 0);
+		CHECK_EQUAL(static_cast<size_t>(size - lookups / 100), bans.Count());
+		Tests::Report(std::to_string(size) + " bans, per lookup", elapsed / lookups, "ns");
+	}
+}
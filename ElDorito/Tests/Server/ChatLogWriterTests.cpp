@@ -0,0 +1,162 @@
+#include "Test.hpp"
+#include "Server/ChatLogWriter.hpp"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+using Server::Chat::ChatLogOptions;
+using Server::Chat::ChatLogWriter;
+
+namespace
+{
+	const time_t StartTime = 1760832000; // 2025-10-19 00:00 UTC
+
+	std::filesystem::path UseEmptyDirectory()
+	{
+		auto directory = std::filesystem::temp_directory_path() / "ElDoritoChatLogTests";
+		std::filesystem::remove_all(directory);
+		std::filesystem::create_directories(directory);
+		return directory;
+	}
+
+	// Gets the names of the log files in a directory, in the order they were written:
+	// "chat.log.<date>", "chat.log.<date>.1", "chat.log.<date>.2", ..., then "chat.log"
+	std::vector<std::string> ListFiles(const std::filesystem::path &directory)
+	{
+		std::vector<std::string> names;
+		for (auto &&entry : std::filesystem::directory_iterator(directory))
+			names.push_back(entry.path().filename().string());
+
+		auto sortKey = [](const std::string &name)
+		{
+			if (name == "chat.log")
+				return std::make_pair(std::string("~"), 0);
+			auto date = name.substr(9, 10);
+			auto suffix = name.length() > 19 ? std::stoi(name.substr(20)) : 0;
+			return std::make_pair(date, suffix);
+		};
+		std::sort(names.begin(), names.end(), [&](const std::string &a, const std::string &b)
+		{
+			return sortKey(a) < sortKey(b);
+		});
+		return names;
+	}
+
+	std::vector<std::string> ReadLines(const std::filesystem::path &path)
+	{
+		std::vector<std::string> lines;
+		std::ifstream stream(path);
+		std::string line;
+		while (std::getline(stream, line))
+			lines.push_back(line);
+		return lines;
+	}
+
+	// Reads the "line <n>" lines written to a set of log files, in file order. Returns
+	// the total from the dropped lines markers, or -1 if a line is out of order.
+	long long ReadNumberedLines(const std::filesystem::path &directory, const std::vector<std::string> &files, size_t *lineCount)
+	{
+		long long dropped = 0, last = -1;
+		*lineCount = 0;
+		for (auto &&file : files)
+		{
+			for (auto &&line : ReadLines(directory / file))
+			{
+				if (line.compare(0, 4, "*** ") == 0)
+				{
+					dropped += std::stoll(line.substr(4));
+					continue;
+				}
+				auto number = std::stoll(line.substr(5));
+				if (number <= last)
+					return -1;
+				last = number;
+				(*lineCount)++;
+			}
+		}
+		return dropped;
+	}
+}
+
+TEST_CASE(ChatLogWriter, FloodAcrossADateChange)
+{
+	auto directory = UseEmptyDirectory();
+	ChatLogOptions options{ (directory / "chat.log").string(), 20000, true };
+
+	// 50,000 lines as fast as possible, with the date changing partway through.
+	// Lines which don't fit in the queue are dropped.
+	ChatLogWriter writer(1000, 50);
+	size_t queued = 0;
+	for (auto i = 0; i < 50000; i++)
+	{
+		auto time = StartTime + (i >= 30000 ? 24 * 60 * 60 : 0);
+		if (writer.Queue(options, "line " + std::to_string(i), time))
+			queued++;
+	}
+	CHECK_EQUAL(50000U, queued + writer.GetDroppedCount());
+
+	// How many of the flood's second-day lines make it in depends on timing, so add one which always does
+	while (!writer.Queue(options, "line 50000", StartTime + 24 * 60 * 60))
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	queued++;
+	writer.Stop();
+
+	auto files = ListFiles(directory);
+	if (!CHECK(files.size() >= 2))
+		return;
+	CHECK_EQUAL(std::string("chat.log.2025-10-19"), files.front());
+	CHECK_EQUAL(std::string("line 50000"), ReadLines(directory / "chat.log").back());
+	for (auto &&file : files)
+		CHECK(std::filesystem::file_size(directory / file) <= 20000);
+
+	// Every line is accounted for, either written in order or counted by a marker
+	size_t lineCount;
+	auto dropped = ReadNumberedLines(directory, files, &lineCount);
+	CHECK_EQUAL(queued, lineCount);
+	CHECK_EQUAL(static_cast<long long>(writer.GetDroppedCount()), dropped);
+}
+
+TEST_CASE(ChatLogWriter, NotesDroppedLines)
+{
+	auto directory = UseEmptyDirectory();
+	ChatLogOptions options{ (directory / "chat.log").string(), 0, false };
+
+	ChatLogWriter writer(4, 60000);
+	for (auto i = 0; i < 100; i++)
+		writer.Queue(options, "line " + std::to_string(i), StartTime);
+	writer.Stop();
+	CHECK(writer.GetDroppedCount() > 0);
+
+	size_t lineCount;
+	auto dropped = ReadNumberedLines(directory, { "chat.log" }, &lineCount);
+	CHECK_EQUAL(100U, lineCount + writer.GetDroppedCount());
+	CHECK_EQUAL(static_cast<long long>(writer.GetDroppedCount()), dropped);
+
+	// Nothing more is noted once the writer has caught up
+	writer.Queue(options, "line 100", StartTime);
+	writer.Stop();
+	auto lines = ReadLines(directory / "chat.log");
+	CHECK_EQUAL(std::string("line 100"), lines.back());
+}
+
+TEST_CASE(ChatLogWriter, RotatesBySize)
+{
+	auto directory = UseEmptyDirectory();
+	ChatLogOptions options{ (directory / "chat.log").string(), 100, false };
+
+	// 10-byte lines, so each file holds 10
+	ChatLogWriter writer(1000, 50);
+	for (auto i = 0; i < 35; i++)
+		writer.Queue(options, "line " + std::to_string(1000 + i), StartTime);
+	writer.Stop();
+
+	CHECK((ListFiles(directory) == std::vector<std::string>
+	{
+		"chat.log.2025-10-19", "chat.log.2025-10-19.1", "chat.log.2025-10-19.2", "chat.log",
+	}));
+	auto lines = ReadLines(directory / "chat.log.2025-10-19.1");
+	if (CHECK_EQUAL(10U, lines.size()))
+		CHECK_EQUAL(std::string("line 1010"), lines.front());
+	CHECK_EQUAL(5U, ReadLines(directory / "chat.log").size());
+}
@@ -0,0 +1,204 @@
+#include "Test.hpp"
+#include "Server/NamePolicy.hpp"
+#include "Utils/String.hpp"
+#include <algorithm>
+#include <random>
+
+using Server::NamePolicy;
+using Server::NamePolicyRules;
+
+namespace
+{
+	std::string RandomString(std::mt19937 &random, const char *alphabet, size_t alphabetLength, size_t minLength, size_t maxLength)
+	{
+		std::string str(minLength + random() % (maxLength - minLength + 1), ' ');
+		for (auto &ch : str)
+			ch = alphabet[random() % alphabetLength];
+		return str;
+	}
+
+	// What join checks did before the policy: lowercase the name and search for each entry in turn
+	bool OldLoopBlocks(std::string name, const std::vector<std::string> &substrings)
+	{
+		std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+		for (auto &&substring : substrings)
+		{
+			if (name.find(substring) != std::string::npos)
+				return true;
+		}
+		return false;
+	}
+
+	NamePolicy CompilePolicy()
+	{
+		NamePolicyRules rules;
+		rules.Substrings = { "badword", "  " };
+		rules.ExactNames = { "Admin" };
+		rules.Patterns = { "mod*tor", "x?z", "*evil*" };
+		NamePolicy policy;
+		policy.Compile(rules);
+		return policy;
+	}
+}
+
+TEST_CASE(NamePolicy, LookAlikeSpellingsAreBlocked)
+{
+	auto policy = CompilePolicy();
+	CHECK(policy.IsBlocked(L"xxBADWORDxx"));
+	CHECK(policy.IsBlocked(L"b4dw0rd"));
+	CHECK(policy.IsBlocked(L"B4DW\x00D2RD"));
+	CHECK(policy.IsBlocked(L"\xFF42\xFF41\xFF44word"));  // Fullwidth
+	CHECK(policy.IsBlocked(L"b\x0430" L"dword"));         // Cyrillic a
+	CHECK(policy.IsBlocked(L"b\x0391" L"DWORD"));         // Greek capital alpha
+	CHECK(policy.IsBlocked(L"ba\x0301" L"dword"));        // Combining acute accent
+	CHECK(policy.IsBlocked(L"b\x00E0" L"dword"));         // Precomposed accent
+	CHECK(policy.IsBlocked(L"B\x00C0" L"DWORD"));
+	CHECK(policy.IsBlocked(L"bad\x200Bword"));            // Zero-width space
+	CHECK(!policy.IsBlocked(L"GoodName"));
+	CHECK(!policy.IsBlocked(L"bad"));
+
+	// Exact names have to match the whole skeleton
+	CHECK(policy.IsBlocked(L"admin"));
+	CHECK(policy.IsBlocked(L"AdM1n"));
+	CHECK(policy.IsBlocked(L"\x0410" L"dmin"));
+	CHECK(!policy.IsBlocked(L"admins"));
+	CHECK(!policy.IsBlocked(L"xadmin"));
+
+	// Exact names and patterns also ignore separators and treat 'i' and 'l' as the same
+	CHECK(policy.IsBlocked(L"A.D.M.I.N"));
+	CHECK(policy.IsBlocked(L"Ev_1l One"));
+	CHECK(policy.IsBlocked(L"the d3vil"));
+
+	CHECK_EQUAL(std::string("badword"), Server::GetNameSkeleton(L"B.4-D W0_RD"));
+	CHECK_EQUAL(std::string("admln"), Server::GetNameSkeleton(L"\xFF21\x0501m\x0456n"));
+	CHECK_EQUAL(std::string("b.ad word"), Server::GetSubstringSkeleton(L"B.4D W0RD"));
+}
+
+TEST_CASE(NamePolicy, SubstringsDontMatchAcrossWords)
+{
+	NamePolicyRules rules;
+	rules.Substrings = { "nazi", "al" };
+	NamePolicy policy;
+	policy.Compile(rules);
+
+	// Dropping the space and merging 'i' with 'l' would find "nazl" in "anazlatan"
+	CHECK(!policy.IsBlocked(L"Ana Zlatan"));
+	CHECK(!policy.IsBlocked(L"Na Zi"));
+	CHECK(!policy.IsBlocked(L"Ail"));
+	CHECK(policy.IsBlocked(L"N4Z1"));
+	CHECK(policy.IsBlocked(L"\x0421" L"Al"));
+	CHECK(policy.IsBlocked(L"n\x0430z!"));
+
+	CHECK_EQUAL(std::string("ana zlatan"), Server::GetSubstringSkeleton(L"Ana Zlatan"));
+	CHECK_EQUAL(std::string("nazi"), Server::GetSubstringSkeleton(L"N4Z|"));
+}
+
+TEST_CASE(NamePolicy, PatternsMatchWholeCharacters)
+{
+	auto policy = CompilePolicy();
+	CHECK(policy.IsBlocked(L"moderator"));
+	CHECK(policy.IsBlocked(L"M0D_3RAT0R"));
+	CHECK(policy.IsBlocked(L"modtor"));
+	CHECK(!policy.IsBlocked(L"moderators"));
+
+	CHECK(policy.IsBlocked(L"xyz"));
+	CHECK(!policy.IsBlocked(L"xz"));
+	CHECK(!policy.IsBlocked(L"xyyz"));
+
+	// Characters which take several bytes in UTF-8 still only match one '?'
+	CHECK(policy.IsBlocked(L"x\x4E2Dz"));
+	CHECK(policy.IsBlocked(L"x\x044Fz"));
+	CHECK(!policy.IsBlocked(L"x\x4E2D\x4E2Dz"));
+	CHECK_EQUAL(6U, policy.RuleCount());
+
+	// Patterns with no literal part are always tried
+	NamePolicyRules rules;
+	rules.Patterns = { "???" };
+	policy.Compile(rules);
+	CHECK(policy.IsBlocked(L"\x4E2D\x6587\x5B57"));
+	CHECK(!policy.IsBlocked(L"\x4E2D\x6587"));
+}
+
+TEST_CASE(NamePolicy, EmptyRulesAreIgnored)
+{
+	NamePolicyRules rules;
+	rules.Substrings = { "", "\xE2\x80\x8B" };
+	rules.ExactNames = { "" };
+	rules.Patterns = { "_" };
+	NamePolicy policy;
+	policy.Compile(rules);
+	CHECK_EQUAL(0U, policy.RuleCount());
+	CHECK(!policy.IsBlocked(L"anything"));
+
+	// Recompiling replaces the old rules
+	rules.Patterns = { "*" };
+	policy.Compile(rules);
+	CHECK_EQUAL(1U, policy.RuleCount());
+	CHECK(policy.IsBlocked(L"anything"));
+}
+
+TEST_CASE(NamePolicy, BlocksEverythingTheOldLoopDid)
+{
+	// The old loop lowercased names but not its entries, so entries with capitals never matched
+	const char ruleAlphabet[] = "abcdeilost0135 .";
+	const char nameAlphabet[] = "abcdeilostABEIL0135 .";
+	std::mt19937 random(5);
+	for (auto i = 0; i < 3000; i++)
+	{
+		std::vector<std::string> substrings;
+		for (auto j = 0; j < 5; j++)
+			substrings.push_back(RandomString(random, ruleAlphabet, sizeof(ruleAlphabet) - 1, 1, 3));
+		NamePolicyRules rules;
+		rules.Substrings = substrings;
+		NamePolicy policy;
+		policy.Compile(rules);
+
+		for (auto j = 0; j < 20; j++)
+		{
+			auto name = RandomString(random, nameAlphabet, sizeof(nameAlphabet) - 1, 1, 10);
+			if (OldLoopBlocks(name, substrings) && !CHECK(policy.IsBlocked(Utils::String::WidenString(name))))
+				return;
+		}
+	}
+}
+
+// Checks 20,000 names against 10,000 substrings, 10,000 exact names and 1,000
+// patterns, and against the 10,000 substrings with the old loop.
+BENCHMARK(NamePolicy, TenThousandRules)
+{
+	std::mt19937 random(7);
+	const char *letters = "abcdefghijklmnopqrstuvwxyz";
+	NamePolicyRules rules;
+	for (auto i = 0; i < 10000; i++)
+	{
+		rules.Substrings.push_back(RandomString(random, letters, 26, 5, 8));
+		rules.ExactNames.push_back(RandomString(random, letters, 26, 8, 8));
+	}
+	for (auto i = 0; i < 1000; i++)
+		rules.Patterns.push_back(RandomString(random, letters, 26, 3, 3) + "*" + RandomString(random, letters, 26, 2, 2));
+
+	std::vector<std::string> names;
+	for (auto i = 0; i < 20000; i++)
+		names.push_back(RandomString(random, letters, 26, 5, 15));
+	std::vector<std::wstring> wideNames;
+	for (auto &&name : names)
+		wideNames.push_back(Utils::String::WidenString(name));
+
+	NamePolicy policy;
+	auto compile = Tests::Time(1, [&]() { policy.Compile(rules); });
+	size_t blocked = 0, oldBlocked = 0;
+	auto checks = Tests::Time(1, [&]()
+	{
+		for (auto &&name : wideNames)
+			blocked += policy.IsBlocked(name);
+	});
+	auto oldLoop = Tests::Time(1, [&]()
+	{
+		for (auto &&name : names)
+			oldBlocked += OldLoopBlocks(name, rules.Substrings);
+	});
+	CHECK(blocked >= oldBlocked);
+	Tests::Report("compile 21,000 rules", compile / 1e6, "ms");
+	Tests::Report("per name, policy", checks / 1e3 / names.size(), "us");
+	Tests::Report("per name, old loop over 10,000 substrings", oldLoop / 1e3 / names.size(), "us");
+}
@@ -0,0 +1,274 @@
+#include "Test.hpp"
+#include "Server/PlayerDirectory.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <random>
+
+using Server::PlayerDirectory;
+using Server::PlayerRecord;
+
+namespace
+{
+	const char *Names[] = { "Alpha", "alpha", "ALPHA", "Alphonse", "Bravo", "bravo2", "Charlie", "Al" };
+	const char *Ips[] = { "10.0.0.1", "10.0.0.2", "192.168.1.5" };
+
+	void SetPlayer(Blam::Network::Session &session, int peer, int player, const char *name, uint64_t uid, const char *ip)
+	{
+		session.MembershipInfo.PeerPlayers[peer] = player;
+		auto &properties = session.MembershipInfo.PlayerSessions[player].Properties;
+		properties.Uid = uid;
+		std::fill(std::begin(properties.DisplayName), std::end(properties.DisplayName), L'\0');
+		for (auto i = 0; name[i] && i < 16; i++)
+			properties.DisplayName[i] = name[i];
+		unsigned int a, b, c, d;
+		std::sscanf(ip, "%u.%u.%u.%u", &a, &b, &c, &d);
+		session.PeerAddresses[peer].Address.IPv4 = (a << 24) | (b << 16) | (c << 8) | d;
+	}
+
+	std::string LowerAscii(std::string str)
+	{
+		std::transform(str.begin(), str.end(), str.begin(), [](char ch) { return static_cast<char>(tolower(ch)); });
+		return str;
+	}
+
+	// The lookups the admin commands did before the directory: walk every connected peer
+	template<class Predicate>
+	std::vector<int> Scan(const Blam::Network::Session &session, Predicate predicate)
+	{
+		std::vector<int> result;
+		auto &membership = session.MembershipInfo;
+		for (auto peer = membership.FindFirstPeer(); peer >= 0; peer = membership.FindNextPeer(peer))
+		{
+			auto player = membership.GetPeerPlayer(peer);
+			if (predicate(player, peer))
+				result.push_back(player);
+		}
+		std::sort(result.begin(), result.end());
+		return result;
+	}
+
+	// A full Levenshtein distance with no cutoff
+	int GetDistance(const std::string &a, const std::string &b)
+	{
+		std::vector<std::vector<int>> distances(a.length() + 1, std::vector<int>(b.length() + 1));
+		for (size_t i = 0; i <= a.length(); i++)
+		{
+			for (size_t j = 0; j <= b.length(); j++)
+			{
+				if (i == 0 || j == 0)
+					distances[i][j] = static_cast<int>(i + j);
+				else
+					distances[i][j] = std::min({ distances[i - 1][j] + 1, distances[i][j - 1] + 1, distances[i - 1][j - 1] + (a[i - 1] == b[j - 1] ? 0 : 1) });
+			}
+		}
+		return distances[a.length()][b.length()];
+	}
+
+	std::string ScanName(const Blam::Network::Session &session, int player)
+	{
+		auto &name = session.MembershipInfo.PlayerSessions[player].Properties.DisplayName;
+		return std::string(std::begin(name), std::find(std::begin(name), std::end(name), L'\0'));
+	}
+
+	bool AgreesWithScan(const PlayerDirectory &directory, const Blam::Network::Session &session)
+	{
+		auto players = Scan(session, [](int, int) { return true; });
+		if (!CHECK_EQUAL(static_cast<int>(players.size()), directory.GetCount()))
+			return false;
+		for (auto player : players)
+		{
+			auto record = directory.Get(player);
+			if (!CHECK(record != nullptr) || !CHECK_EQUAL(ScanName(session, player), record->Name))
+				return false;
+		}
+
+		for (auto name : Names)
+		{
+			auto folded = LowerAscii(name);
+			auto byName = Scan(session, [&](int player, int) { return LowerAscii(ScanName(session, player)) == folded; });
+			auto byPrefix = Scan(session, [&](int player, int) { return LowerAscii(ScanName(session, player)).compare(0, folded.size(), folded) == 0; });
+			auto exact = Scan(session, [&](int player, int) { return ScanName(session, player) == name; });
+			if (!CHECK(byName == directory.FindByName(name)) ||
+				!CHECK(byPrefix == directory.FindByNamePrefix(name)) ||
+				!CHECK_EQUAL(exact.empty() ? -1 : exact[0], directory.FindByExactName(name)))
+			{
+				return false;
+			}
+		}
+		for (auto ip : Ips)
+		{
+			auto byIp = Scan(session, [&](int, int peer) { return session.PeerAddresses[peer].ToString() == ip; });
+			if (!CHECK(byIp == directory.FindByIp(ip)))
+				return false;
+		}
+		for (uint64_t uid = 1; uid <= 4; uid++)
+		{
+			auto byUid = Scan(session, [&](int player, int) { return session.MembershipInfo.PlayerSessions[player].Properties.Uid == uid; });
+			if (!CHECK(byUid == directory.FindByUid(uid)))
+				return false;
+		}
+		for (auto peer = 0; peer < Blam::Network::MaxPeers; peer++)
+		{
+			if (!CHECK_EQUAL(session.MembershipInfo.PeerPlayers[peer], directory.FindByPeer(peer)))
+				return false;
+		}
+		return true;
+	}
+}
+
+TEST_CASE(PlayerDirectory, SyncAgreesWithScanningTheSession)
+{
+	Blam::Network::Session session;
+	session.Established = true;
+	PlayerDirectory directory;
+
+	// Players join, leave, rename and swap peers at random, syncing after each change
+	std::mt19937 random(9);
+	for (auto i = 0; i < 5000; i++)
+	{
+		auto peer = static_cast<int>(random() % Blam::Network::MaxPeers);
+		if (session.MembershipInfo.PeerPlayers[peer] >= 0 && random() % 3 == 0)
+		{
+			session.MembershipInfo.PeerPlayers[peer] = -1;
+		}
+		else
+		{
+			// Use the peer's current player, or a free slot for a new one
+			auto player = session.MembershipInfo.PeerPlayers[peer];
+			if (player < 0)
+			{
+				auto used = Scan(session, [](int, int) { return true; });
+				for (player = 0; player < Blam::Network::MaxPlayers && std::binary_search(used.begin(), used.end(), player); player++)
+					;
+				if (player == Blam::Network::MaxPlayers)
+					continue;
+			}
+			SetPlayer(session, peer, player, Names[random() % _countof(Names)], 1 + random() % 4, Ips[random() % _countof(Ips)]);
+		}
+
+		directory.Sync(&session);
+		if (!AgreesWithScan(directory, session))
+			break;
+	}
+
+	session.Established = false;
+	directory.Sync(&session);
+	CHECK_EQUAL(0, directory.GetCount());
+	CHECK(directory.FindByName("alpha").empty());
+}
+
+TEST_CASE(PlayerDirectory, ExactNamesIgnoreOtherCases)
+{
+	Blam::Network::Session session;
+	session.Established = true;
+	SetPlayer(session, 0, 0, "Host", 1, "10.0.0.1");
+	SetPlayer(session, 3, 5, "alpha", 2, "10.0.0.2");
+	SetPlayer(session, 4, 2, "ALPHA", 3, "10.0.0.2");
+	PlayerDirectory directory;
+	directory.Sync(&session);
+
+	CHECK(directory.FindByName("Alpha") == (std::vector<int>{ 2, 5 }));
+	CHECK_EQUAL(5, directory.FindByExactName("alpha"));
+	CHECK_EQUAL(2, directory.FindByExactName("ALPHA"));
+	CHECK_EQUAL(-1, directory.FindByExactName("Alpha"));
+	CHECK_EQUAL(-1, directory.FindByExactName("alph"));
+
+	// The admin commands still fall back to another case
+	CHECK_EQUAL(5, directory.FindFirstByName("alpha"));
+	CHECK_EQUAL(2, directory.FindFirstByName("Alpha"));
+	CHECK_EQUAL(-1, directory.FindFirstByName("Bravo"));
+
+	// Renaming a player re-indexes them
+	SetPlayer(session, 3, 5, "Alpha", 2, "10.0.0.2");
+	directory.Sync(&session);
+	CHECK_EQUAL(5, directory.FindByExactName("Alpha"));
+	CHECK_EQUAL(-1, directory.FindByExactName("alpha"));
+	CHECK_EQUAL(0, directory.FindByPeer(0));
+}
+
+TEST_CASE(PlayerDirectory, UnchangedSlotsArentReformatted)
+{
+	Blam::Network::Session session;
+	session.Established = true;
+	SetPlayer(session, 0, 0, "Host", 1, "10.0.0.1");
+	SetPlayer(session, 1, 1, "Alpha", 2, "10.0.0.2");
+	SetPlayer(session, 2, 2, "Bravo", 3, "192.168.1.5");
+	PlayerDirectory directory;
+	directory.Sync(&session);
+
+	auto &formatted = Blam::Network::NetworkAddress::ToStringCount();
+	formatted = 0;
+	for (auto i = 0; i < 100; i++)
+		directory.Sync(&session);
+	CHECK_EQUAL(0, formatted);
+
+	// Only the slot whose address changed is formatted again
+	SetPlayer(session, 2, 2, "Bravo", 3, "10.0.0.2");
+	directory.Sync(&session);
+	CHECK_EQUAL(1, formatted);
+	CHECK(directory.FindByIp("10.0.0.2") == (std::vector<int>{ 1, 2 }));
+	CHECK(directory.FindByIp("192.168.1.5").empty());
+
+	// A player added by hand is checked against the session on the next sync
+	PlayerRecord record = *directory.Get(1);
+	record.Ip = "1.2.3.4";
+	directory.Join(record);
+	directory.Sync(&session);
+	CHECK(directory.FindByIp("1.2.3.4").empty());
+	CHECK(directory.FindByIp("10.0.0.2") == (std::vector<int>{ 1, 2 }));
+}
+
+TEST_CASE(PlayerDirectory, FuzzyNamesAreOrderedByDistance)
+{
+	Blam::Network::Session session;
+	session.Established = true;
+	SetPlayer(session, 0, 0, "Alphonse", 1, "10.0.0.1");
+	SetPlayer(session, 1, 3, "ALPHA", 2, "10.0.0.1");
+	SetPlayer(session, 2, 5, "Alpah", 3, "10.0.0.1");
+	SetPlayer(session, 3, 7, "Alp", 4, "10.0.0.1");
+	SetPlayer(session, 4, 9, "Bravo", 5, "10.0.0.1");
+	PlayerDirectory directory;
+	directory.Sync(&session);
+
+	// Closest first, ties in player order, and nothing past the cutoff
+	CHECK(directory.FindByFuzzyName("alpha", 0) == (std::vector<int>{ 3 }));
+	CHECK(directory.FindByFuzzyName("alpha", 1) == (std::vector<int>{ 3 }));
+	CHECK(directory.FindByFuzzyName("alpha", 2) == (std::vector<int>{ 3, 5, 7 }));
+	CHECK(directory.FindByFuzzyName("alpah", 2) == (std::vector<int>{ 5, 3, 7 }));
+	CHECK(directory.FindByFuzzyName("Alphons", 3) == (std::vector<int>{ 0, 3 }));
+	CHECK(directory.FindByFuzzyName("zzz", 2).empty());
+
+	// Random names against a full distance computation
+	const char *alphabet = "abAB";
+	std::mt19937 random(11);
+	for (auto i = 0; i < 2000; i++)
+	{
+		for (auto player = 0; player < 8; player++)
+		{
+			std::string name(random() % 6, ' ');
+			for (auto &ch : name)
+				ch = alphabet[random() % 4];
+			SetPlayer(session, player, player, name.c_str(), player, "10.0.0.1");
+		}
+		directory.Sync(&session);
+
+		std::string query(random() % 6, ' ');
+		for (auto &ch : query)
+			ch = alphabet[random() % 4];
+		auto maxDistance = static_cast<int>(random() % 4);
+
+		std::vector<std::pair<int, int>> expected;
+		for (auto player = 0; player < 8; player++)
+		{
+			auto distance = GetDistance(LowerAscii(query), LowerAscii(ScanName(session, player)));
+			if (distance <= maxDistance)
+				expected.emplace_back(distance, player);
+		}
+		std::sort(expected.begin(), expected.end());
+		std::vector<int> expectedPlayers;
+		for (auto &match : expected)
+			expectedPlayers.push_back(match.second);
+		if (!CHECK(expectedPlayers == directory.FindByFuzzyName(query, maxDistance)))
+			break;
+	}
+}
@@ -0,0 +1,104 @@
+#include "Test.hpp"
+#include "Server/RateLimiter.hpp"
+
+using namespace Server;
+
+namespace
+{
+	uint64_t now = 0;
+
+	uint64_t FakeClock()
+	{
+		return now;
+	}
+
+	RateLimiter& GetLimiter(uint32_t burst, uint32_t timeoutMs)
+	{
+		static RateLimiter limiter;
+		limiter.SetClock(FakeClock);
+
+		RateLimit limit;
+		limit.Burst = burst;
+		limit.IntervalMs = 1000;
+		limit.TimeoutMs = timeoutMs;
+		limit.TimeoutResetMs = 10000;
+		limiter.SetLimit(RateLimitClass::Chat, limit);
+		limiter.SetLimit(RateLimitClass::Vote, limit);
+		now = 1000000;
+		return limiter;
+	}
+}
+
+TEST_CASE(RateLimiter, BurstThenRefill)
+{
+	auto &limiter = GetLimiter(4, 0);
+	for (auto i = 0; i < 4; i++)
+		CHECK(limiter.Consume(0, 1, RateLimitClass::Chat) == RateLimitResult::Allowed);
+	CHECK(limiter.Consume(0, 1, RateLimitClass::Chat) == RateLimitResult::Limited);
+
+	// One token comes back each interval
+	now += 999;
+	CHECK(limiter.Consume(0, 1, RateLimitClass::Chat) == RateLimitResult::Limited);
+	now += 1;
+	CHECK(limiter.Consume(0, 1, RateLimitClass::Chat) == RateLimitResult::Allowed);
+	CHECK(limiter.Consume(0, 1, RateLimitClass::Chat) == RateLimitResult::Limited);
+
+	// A full bucket doesn't keep filling past the burst
+	now += 60000;
+	for (auto i = 0; i < 4; i++)
+		CHECK(limiter.Consume(0, 1, RateLimitClass::Chat) == RateLimitResult::Allowed);
+	CHECK(limiter.Consume(0, 1, RateLimitClass::Chat) == RateLimitResult::Limited);
+}
+
+TEST_CASE(RateLimiter, CostIsSpentAtOnce)
+{
+	auto &limiter = GetLimiter(4, 0);
+	CHECK(limiter.Consume(0, 1, RateLimitClass::Chat, 3) == RateLimitResult::Allowed);
+	CHECK(limiter.Consume(0, 1, RateLimitClass::Chat, 2) == RateLimitResult::Limited);
+	CHECK(limiter.Consume(0, 1, RateLimitClass::Chat, 1) == RateLimitResult::Allowed);
+}
+
+TEST_CASE(RateLimiter, TimeoutsDoubleUntilReset)
+{
+	auto &limiter = GetLimiter(2, 5000);
+	uint32_t remaining = 0;
+	limiter.Consume(0, 1, RateLimitClass::Chat, 2);
+	CHECK(limiter.Consume(0, 1, RateLimitClass::Chat, 1, &remaining) == RateLimitResult::TimedOut);
+	CHECK_EQUAL(5000U, remaining);
+
+	now += 2000;
+	CHECK(limiter.Consume(0, 1, RateLimitClass::Chat, 1, &remaining) == RateLimitResult::TimedOut);
+	CHECK_EQUAL(3000U, remaining);
+
+	// Spamming again before the reset time doubles the timeout
+	now += 3000;
+	limiter.Consume(0, 1, RateLimitClass::Chat, 2);
+	CHECK(limiter.Consume(0, 1, RateLimitClass::Chat, 1, &remaining) == RateLimitResult::TimedOut);
+	CHECK_EQUAL(10000U, remaining);
+
+	// After the reset time it goes back to the default
+	now += 10000 + 10000;
+	limiter.Consume(0, 1, RateLimitClass::Chat, 2);
+	CHECK(limiter.Consume(0, 1, RateLimitClass::Chat, 1, &remaining) == RateLimitResult::TimedOut);
+	CHECK_EQUAL(5000U, remaining);
+}
+
+TEST_CASE(RateLimiter, BucketsAreSeparate)
+{
+	auto &limiter = GetLimiter(1, 0);
+	CHECK(limiter.Consume(0, 1, RateLimitClass::Chat) == RateLimitResult::Allowed);
+	CHECK(limiter.Consume(0, 1, RateLimitClass::Chat) == RateLimitResult::Limited);
+
+	// Other slots and classes have their own buckets
+	CHECK(limiter.Consume(1, 2, RateLimitClass::Chat) == RateLimitResult::Allowed);
+	CHECK(limiter.Consume(0, 1, RateLimitClass::Vote) == RateLimitResult::Allowed);
+	CHECK(limiter.Consume(RconRateLimitSlot, 0, RateLimitClass::Chat) == RateLimitResult::Allowed);
+
+	// A new player in the slot doesn't inherit the old player's bucket
+	CHECK(limiter.Consume(0, 3, RateLimitClass::Chat) == RateLimitResult::Allowed);
+	CHECK(limiter.Consume(0, 3, RateLimitClass::Chat) == RateLimitResult::Limited);
+
+	// Out of range slots are always limited, and unlimited classes always allowed
+	CHECK(limiter.Consume(MaxRateLimitSlots, 1, RateLimitClass::Chat) == RateLimitResult::Limited);
+	CHECK(limiter.Consume(0, 1, RateLimitClass::Rcon) == RateLimitResult::Allowed);
+}
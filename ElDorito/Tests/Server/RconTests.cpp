@@ -0,0 +1,235 @@
+#include "Test.hpp"
+#include "Server/Rcon.hpp"
+#include "Patches/Core.hpp"
+#include "Modules/ModuleGame.hpp"
+#include "Modules/ModuleServer.hpp"
+#include "Utils/Cryptography.hpp"
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <websocketpp/client.hpp>
+#include <websocketpp/config/asio_no_tls_client.hpp>
+
+using namespace Modules;
+
+// Only used to make up a password if none is set, and the test sets one
+bool Utils::Cryptography::RandomPassword(int length, std::string& out)
+{
+	out = std::string(length, 'x');
+	return true;
+}
+
+namespace
+{
+	typedef websocketpp::client<websocketpp::config::asio_client> Client;
+
+	const uint16_t TestPort = 38917;
+	const char *TestPassword = "rcon test password";
+
+	std::thread::id echoThread;
+
+	bool CommandEcho(const std::vector<std::string>& Arguments, std::string& returnInfo)
+	{
+		echoThread = std::this_thread::get_id();
+		returnInfo = Arguments.empty() ? "" : Arguments[0];
+		return true;
+	}
+
+	// Connects to the rcon server over loopback and collects the messages it sends.
+	class RconClient
+	{
+	public:
+		RconClient()
+		{
+			client.clear_access_channels(websocketpp::log::alevel::all);
+			client.clear_error_channels(websocketpp::log::elevel::all);
+			client.init_asio();
+			client.set_open_handler([this](websocketpp::connection_hdl hdl) { OnOpen(hdl); });
+			client.set_message_handler([this](websocketpp::connection_hdl, Client::message_ptr msg) { OnMessage(msg->get_payload()); });
+			client.set_fail_handler([this](websocketpp::connection_hdl) { OnFail(); });
+		}
+
+		~RconClient()
+		{
+			client.stop();
+			if (thread.joinable())
+				thread.join();
+		}
+
+		// Connects and waits for the connection to open. The server may not be listening yet,
+		// so failed connections are retried.
+		bool Connect()
+		{
+			thread = std::thread([this]()
+			{
+				client.start_perpetual();
+				client.run();
+			});
+			for (auto attempt = 0; attempt < 50; attempt++)
+			{
+				websocketpp::lib::error_code ec;
+				auto connection = client.get_connection("ws://127.0.0.1:" + std::to_string(TestPort), ec);
+				if (ec)
+					return false;
+				connection->add_subprotocol("dew-rcon");
+
+				std::unique_lock<std::mutex> lock(mutex);
+				finished = false;
+				client.connect(connection);
+				changed.wait_for(lock, std::chrono::seconds(5), [this]() { return finished; });
+				if (open)
+					return true;
+				lock.unlock();
+				std::this_thread::sleep_for(std::chrono::milliseconds(100));
+			}
+			return false;
+		}
+
+		void Send(const std::string &message)
+		{
+			client.send(hdl, message, websocketpp::frame::opcode::TEXT);
+		}
+
+		// Waits until count messages have been received and returns them.
+		std::vector<std::string> Receive(size_t count)
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			changed.wait_for(lock, std::chrono::seconds(5), [&]() { return messages.size() >= count; });
+			std::vector<std::string> result;
+			result.swap(messages);
+			return result;
+		}
+
+	private:
+		Client client;
+		std::thread thread;
+		websocketpp::connection_hdl hdl;
+		std::mutex mutex;
+		std::condition_variable changed;
+		std::vector<std::string> messages;
+		bool open = false;
+		bool finished = false;
+
+		void OnOpen(websocketpp::connection_hdl connection)
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			hdl = connection;
+			open = finished = true;
+			changed.notify_all();
+		}
+
+		void OnFail()
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			finished = true;
+			changed.notify_all();
+		}
+
+		void OnMessage(const std::string &message)
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			messages.push_back(message);
+			changed.notify_all();
+		}
+	};
+
+	void StartServer()
+	{
+		static auto started = false;
+		if (started)
+			return;
+		started = true;
+
+		Command command;
+		command.Name = "Test.Echo";
+		command.ModuleName = "Test";
+		command.Flags = eCommandFlagsNone;
+		command.Type = eCommandTypeCommand;
+		command.UpdateEvent = CommandEcho;
+		Modules::CommandMap::Instance().AddCommand(command);
+
+		Modules::ModuleGame::Instance().VarRconPort->ValueInt = TestPort;
+		Modules::ModuleServer::Instance().VarRconPassword->ValueString = TestPassword;
+		Server::Rcon::Initialize();
+		// Stops the server so its thread can be joined when the test exits
+		std::atexit(Patches::Core::ExecuteShutdownCallbacks);
+	}
+
+	// Calls Tick until count replies have arrived, like the game thread would.
+	std::vector<std::string> TickUntilReplies(RconClient *client, size_t count)
+	{
+		std::vector<std::string> replies;
+		for (auto i = 0; i < 100 && replies.size() < count; i++)
+		{
+			Server::Rcon::Tick();
+			auto received = client->Receive(0);
+			replies.insert(replies.end(), received.begin(), received.end());
+			std::this_thread::sleep_for(std::chrono::milliseconds(10));
+		}
+		return replies;
+	}
+}
+
+TEST_CASE(Rcon, CommandsRunOnTheTickingThread)
+{
+	StartServer();
+	RconClient client;
+	if (!CHECK(client.Connect()))
+		return;
+
+	client.Send(TestPassword);
+	CHECK(client.Receive(1) == std::vector<std::string>{ "accept" });
+
+	echoThread = std::thread::id();
+	client.Send("Test.Echo first");
+	client.Send("Test.Echo second");
+
+	// Nothing runs until the game thread ticks
+	std::this_thread::sleep_for(std::chrono::milliseconds(100));
+	CHECK(echoThread == std::thread::id());
+	CHECK(client.Receive(0).empty());
+
+	auto replies = TickUntilReplies(&client, 2);
+	CHECK(replies == (std::vector<std::string>{ "first", "second" }));
+	CHECK(echoThread == std::this_thread::get_id());
+}
+
+TEST_CASE(Rcon, FullQueueIsReported)
+{
+	StartServer();
+	RconClient client;
+	if (!CHECK(client.Connect()))
+		return;
+	client.Send(TestPassword);
+	client.Receive(1);
+
+	const size_t MaxPendingCommands = 64;
+	const size_t extra = 6;
+	for (size_t i = 0; i < MaxPendingCommands + extra; i++)
+		client.Send("Test.Echo " + std::to_string(i));
+
+	auto rejected = client.Receive(extra);
+	CHECK(rejected == std::vector<std::string>(extra, "Command queue is full"));
+
+	auto replies = TickUntilReplies(&client, MaxPendingCommands);
+	if (CHECK_EQUAL(MaxPendingCommands, replies.size()))
+	{
+		CHECK_EQUAL(std::string("0"), replies.front());
+		CHECK_EQUAL(std::to_string(MaxPendingCommands - 1), replies.back());
+	}
+}
+
+TEST_CASE(Rcon, BroadcastsAreSentWithoutTicking)
+{
+	StartServer();
+	RconClient authenticated, unauthenticated;
+	if (!CHECK(authenticated.Connect()) || !CHECK(unauthenticated.Connect()))
+		return;
+	authenticated.Send(TestPassword);
+	authenticated.Receive(1);
+
+	Server::Rcon::SendMessageToClients("one");
+	Server::Rcon::SendMessageToClients("two");
+	CHECK(authenticated.Receive(2) == (std::vector<std::string>{ "one", "two" }));
+	CHECK(unauthenticated.Receive(0).empty());
+}
@@ -0,0 +1,151 @@
+#include "Test.hpp"
+#include "Server/StatsSnapshot.hpp"
+#include "ThirdParty/rapidjson/document.h"
+#include <set>
+
+using namespace Server::Stats;
+
+namespace
+{
+	// Fills in a snapshot the way CaptureSnapshot does at the end of a game, from made-up game state
+	GameSnapshot CaptureFakeGame(int64_t endTime, int port, int playerCount)
+	{
+		GameSnapshot snapshot;
+		snapshot.GameVersion = "0.6.1.0";
+		snapshot.ServerName = "Test \"Server\"";
+		snapshot.ServerPort = 11775;
+		snapshot.Port = port;
+		snapshot.HostPlayer = "Host";
+		snapshot.SprintEnabled = true;
+		snapshot.SprintUnlimitedEnabled = false;
+		snapshot.MaxPlayers = 16;
+		snapshot.MapName = "Guardian";
+		snapshot.MapFile = "guardian";
+		snapshot.Variant = "Team Slayer";
+		snapshot.VariantType = "slayer";
+		snapshot.TeamGame = true;
+		snapshot.HasTeamScores = true;
+		snapshot.TeamScores = { 50, 42 };
+
+		for (auto i = 0; i < playerCount; i++)
+		{
+			PlayerSnapshot player = {};
+			player.Name = "Player" + std::to_string(i);
+			player.ClientName = player.Name;
+			player.ServiceTag = "P" + std::to_string(i);
+			player.Ip = "10.0.0." + std::to_string(i + 1);
+			player.Team = i % 2;
+			player.PlayerIndex = i;
+			player.Uid = "000000000000000" + std::to_string(i % 10);
+			player.PrimaryColor = "#FF0000";
+			player.Score = 10 * i;
+			player.Kills = i;
+			player.Deaths = playerCount - i;
+			player.BestStreak = i / 2;
+			player.Medals = { { "DoubleKill", i }, { "SniperHeadshots", 1 } };
+			player.Weapons = { { "AssaultRifle", 2, i, 1, 0, 0, i / 3 } };
+			player.NemesisIndex = (i + 1) % playerCount;
+			for (auto j = 0; j < 16; j++)
+				player.VersusPlayerKills[j] = (i + j) % 3;
+			snapshot.Players.push_back(player);
+		}
+
+		snapshot.MatchId = GetMatchId(endTime, port);
+		return snapshot;
+	}
+}
+
+TEST_CASE(StatsSnapshot, SerializesTheWholeGame)
+{
+	auto snapshot = CaptureFakeGame(1500000000, 11774, 3);
+	rapidjson::Document json;
+	json.Parse(SerializeSnapshot(snapshot).c_str());
+	if (!CHECK(!json.HasParseError() && json.IsObject()))
+		return;
+
+	CHECK_EQUAL(std::string("matchId"), std::string(json.MemberBegin()->name.GetString()));
+	CHECK_EQUAL(std::string("1500000000-11774"), std::string(json["matchId"].GetString()));
+	CHECK_EQUAL(std::string("Test \"Server\""), std::string(json["serverName"].GetString()));
+	CHECK_EQUAL(11775, json["serverPort"].GetInt());
+	CHECK_EQUAL(11774, json["port"].GetInt());
+
+	auto &game = json["game"];
+	CHECK(game["sprintEnabled"].GetBool());
+	CHECK(!game["sprintUnlimitedEnabled"].GetBool());
+	CHECK_EQUAL(std::string("guardian"), std::string(game["mapFile"].GetString()));
+	CHECK_EQUAL(std::string("slayer"), std::string(game["variantType"].GetString()));
+	CHECK_EQUAL(2U, game["teamScores"].Size());
+	CHECK_EQUAL(42, game["teamScores"][1].GetInt());
+
+	auto &players = json["players"];
+	if (!CHECK_EQUAL(3U, players.Size()))
+		return;
+	auto &player = players[2];
+	CHECK_EQUAL(std::string("Player2"), std::string(player["name"].GetString()));
+	CHECK_EQUAL(std::string("10.0.0.3"), std::string(player["ip"].GetString()));
+	CHECK_EQUAL(20, player["playerGameStats"]["score"].GetInt());
+	CHECK_EQUAL(1, player["playerGameStats"]["deaths"].GetInt());
+	CHECK_EQUAL(2U, player["playerMedals"].Size());
+	CHECK_EQUAL(std::string("DoubleKill"), std::string(player["playerMedals"][0]["medalName"].GetString()));
+	CHECK_EQUAL(2, player["playerMedals"][0]["count"].GetInt());
+	CHECK_EQUAL(2, player["playerWeapons"][0]["weaponIndex"].GetInt());
+	CHECK_EQUAL(0, player["otherStats"]["nemesisIndex"].GetInt());
+	if (CHECK_EQUAL(16U, player["playerVersusPlayerKills"].Size()))
+	{
+		for (auto j = 0; j < 16; j++)
+			CHECK_EQUAL((2 + j) % 3, player["playerVersusPlayerKills"][j].GetInt());
+	}
+}
+
+TEST_CASE(StatsSnapshot, LeavesOutUnknownFields)
+{
+	auto snapshot = CaptureFakeGame(1500000000, 11774, 0);
+	snapshot.VariantType.clear();
+	snapshot.TeamGame = false;
+	snapshot.HasTeamScores = false;
+	rapidjson::Document json;
+	json.Parse(SerializeSnapshot(snapshot).c_str());
+	if (!CHECK(!json.HasParseError()))
+		return;
+
+	auto &game = json["game"];
+	CHECK(!game.HasMember("variantType"));
+	CHECK(!game.HasMember("teamScores"));
+	CHECK(!game["teamGame"].GetBool());
+	CHECK(json["players"].IsArray() && json["players"].Empty());
+}
+
+TEST_CASE(StatsSnapshot, EscapesNames)
+{
+	auto snapshot = CaptureFakeGame(1500000000, 11774, 1);
+	const std::string name = "\"}],\\\n\t\x01 \xD0\x96";
+	snapshot.Players[0].Name = name;
+	snapshot.Variant = name;
+	rapidjson::Document json;
+	json.Parse(SerializeSnapshot(snapshot).c_str());
+	if (!CHECK(!json.HasParseError()))
+		return;
+	CHECK_EQUAL(name, std::string(json["players"][0]["name"].GetString()));
+	CHECK_EQUAL(name, std::string(json["game"]["variant"].GetString()));
+	CHECK_EQUAL(1U, json["players"].Size());
+}
+
+TEST_CASE(StatsSnapshot, MatchIdsTellGamesApart)
+{
+	// Capturing the same game again gives the same ID
+	CHECK_EQUAL(CaptureFakeGame(1500000000, 11774, 2).MatchId, CaptureFakeGame(1500000000, 11774, 4).MatchId);
+
+	// Any other end time or port gives a different one
+	std::set<std::string> ids;
+	auto games = 0;
+	for (int64_t endTime = 1499999990; endTime < 1500000010; endTime++)
+	{
+		for (auto port : { 0, 1, 11774, 11775, 65535 })
+		{
+			ids.insert(CaptureFakeGame(endTime, port, 0).MatchId);
+			games++;
+		}
+	}
+	CHECK_EQUAL(static_cast<size_t>(games), ids.size());
+	CHECK(GetMatchId(1, 23) != GetMatchId(12, 3));
+}
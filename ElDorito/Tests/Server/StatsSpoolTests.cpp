@@ -0,0 +1,197 @@
+#include "Test.hpp"
+#include "Server/StatsSpool.hpp"
+#include "Server/StatsSnapshot.hpp"
+#include <atomic>
+#include <filesystem>
+#include <set>
+
+using Server::Stats::StatsSpool;
+using SendResult = Server::Stats::StatsSpool::SendResult;
+
+namespace
+{
+	std::string UseEmptyDirectory()
+	{
+		auto directory = std::filesystem::temp_directory_path() / "ElDoritoStatsSpoolTests";
+		std::filesystem::remove_all(directory);
+		return directory.string() + "/";
+	}
+
+	// Stands in for the stats servers. Fails two of every three requests and records what got through.
+	struct FlakyServer
+	{
+		std::mutex Mutex;
+		int Requests = 0;
+		std::multiset<std::string> Received; // "<url> <body>"
+
+		StatsSpool::SendFunc Func()
+		{
+			return [this](const std::string &url, const std::string &body)
+			{
+				std::lock_guard<std::mutex> lock(Mutex);
+				if (++Requests % 3 != 0)
+					return SendResult::Retry;
+				Received.insert(url + " " + body);
+				return SendResult::Delivered;
+			};
+		}
+	};
+}
+
+TEST_CASE(StatsSpool, RetriesWithBackoff)
+{
+	auto directory = UseEmptyDirectory();
+	std::vector<uint64_t> attempts;
+	StatsSpool spool(directory, [&](const std::string&, const std::string&)
+	{
+		attempts.push_back(0);
+		return attempts.size() < 4 ? SendResult::Retry : SendResult::Delivered;
+	}, 10, 25, 100);
+	CHECK(spool.Add("1000-11774", "http://a/submit", "{}"));
+
+	// Tried right away, then after 10, 20 and 25 (capped) more
+	std::vector<uint64_t> sendTimes;
+	for (uint64_t now = 0; now <= 100 && spool.GetPendingCount(); now++)
+	{
+		auto before = attempts.size();
+		spool.Drain(now);
+		if (attempts.size() != before)
+			sendTimes.push_back(now);
+	}
+	CHECK((sendTimes == std::vector<uint64_t>{ 0, 10, 30, 55 }));
+	CHECK_EQUAL(0U, spool.GetPendingCount());
+}
+
+TEST_CASE(StatsSpool, RejectedSubmissionsAreDiscarded)
+{
+	auto directory = UseEmptyDirectory();
+	auto sends = 0;
+	StatsSpool spool(directory, [&](const std::string&, const std::string&)
+	{
+		sends++;
+		return SendResult::Rejected;
+	}, 10, 100, 100);
+	spool.Add("1", "http://a/submit", "{}");
+	CHECK_EQUAL(0U, spool.Drain(0));
+	CHECK_EQUAL(0U, spool.GetPendingCount());
+	spool.Drain(1000);
+	CHECK_EQUAL(1, sends);
+}
+
+TEST_CASE(StatsSpool, ReplacesAndCapsSubmissions)
+{
+	auto directory = UseEmptyDirectory();
+	FlakyServer server;
+	StatsSpool spool(directory, server.Func(), 5, 20, 5);
+
+	// The same match for the same URL replaces the pending submission, another URL doesn't
+	spool.Add("1000-11774", "http://a/submit", "old");
+	spool.Add("1000-11774", "http://a/submit", "new");
+	spool.Add("1000-11774", "http://b/submit", "new");
+	CHECK_EQUAL(2U, spool.GetPendingCount());
+
+	for (auto i = 0; i < 8; i++)
+		spool.Add(std::to_string(i), "http://a/submit", "{}");
+	CHECK_EQUAL(5U, spool.GetPendingCount());
+
+	for (uint64_t now = 0; now < 10000 && spool.GetPendingCount(); now += 5)
+		spool.Drain(now);
+	CHECK_EQUAL(5U, server.Received.size());
+	CHECK(server.Received.find("http://a/submit old") == server.Received.end());
+}
+
+TEST_CASE(StatsSpool, SameGameIsOnlySentOnce)
+{
+	auto directory = UseEmptyDirectory();
+	FlakyServer server;
+	StatsSpool spool(directory, server.Func(), 5, 20, 100);
+
+	// Two captures of one game and one of the next game on the same port
+	auto capture = [&](int64_t endTime, const std::string &hostPlayer)
+	{
+		Server::Stats::GameSnapshot snapshot = {};
+		snapshot.Port = 11774;
+		snapshot.HostPlayer = hostPlayer;
+		snapshot.MatchId = Server::Stats::GetMatchId(endTime, snapshot.Port);
+		spool.AddDeferred(snapshot.MatchId, { "http://a/submit" }, [snapshot]() { return Server::Stats::SerializeSnapshot(snapshot); });
+		return Server::Stats::SerializeSnapshot(snapshot);
+	};
+	capture(1000, "first");
+	auto second = capture(1000, "second");
+	auto next = capture(1001, "next");
+	CHECK_EQUAL(2U, spool.GetPendingCount());
+
+	for (uint64_t now = 0; now < 10000 && spool.GetPendingCount(); now += 5)
+		spool.Drain(now);
+	CHECK((server.Received == std::multiset<std::string>{ "http://a/submit " + second, "http://a/submit " + next }));
+}
+
+TEST_CASE(StatsSpool, DeliversEverythingOnceAcrossRestarts)
+{
+	auto directory = UseEmptyDirectory();
+	FlakyServer server;
+	{
+		// Closed before anything is sent
+		StatsSpool spool(directory, server.Func(), 5, 20, 100);
+		for (auto i = 0; i < 20; i++)
+			spool.Add(std::to_string(1000 + i) + "-11774", "http://a/submit", "game " + std::to_string(i));
+	}
+
+	StatsSpool spool(directory, server.Func(), 5, 20, 100);
+	CHECK_EQUAL(20U, spool.GetPendingCount());
+	spool.Start();
+	for (auto i = 0; i < 500 && spool.GetPendingCount(); i++)
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	spool.Stop();
+
+	CHECK_EQUAL(0U, spool.GetPendingCount());
+	CHECK_EQUAL(20U, server.Received.size());
+	CHECK_EQUAL(20U, std::set<std::string>(server.Received.begin(), server.Received.end()).size());
+}
+
+TEST_CASE(StatsSpool, DeferredSubmissionsAreBuiltOnTheSender)
+{
+	auto directory = UseEmptyDirectory();
+	FlakyServer server;
+	StatsSpool spool(directory, server.Func(), 5, 20, 100);
+
+	// Without the sender running, it's written straight away
+	auto builds = 0;
+	spool.AddDeferred("1", { "http://a/submit", "http://b/submit" }, [&]() { builds++; return "first"; });
+	CHECK_EQUAL(1, builds);
+	CHECK_EQUAL(2U, spool.GetPendingCount());
+
+	spool.Start();
+	std::atomic<std::thread::id> builtOn;
+	spool.AddDeferred("2", { "http://a/submit" }, [&]()
+	{
+		builtOn = std::this_thread::get_id();
+		return "second";
+	});
+
+	// Stopping right away still writes it out
+	spool.Stop();
+	CHECK(builtOn.load() != std::thread::id());
+	CHECK(builtOn.load() != std::this_thread::get_id());
+
+	for (uint64_t now = 0; now < 10000 && spool.GetPendingCount(); now += 5)
+		spool.Drain(now);
+	CHECK_EQUAL(3U, server.Received.size());
+	CHECK_EQUAL(1U, server.Received.count("http://a/submit second"));
+}
+
+TEST_CASE(StatsSpool, ClassifiesStatusCodes)
+{
+	using Server::Stats::GetSendResult;
+	CHECK(GetSendResult(200) == SendResult::Delivered);
+	CHECK(GetSendResult(204) == SendResult::Delivered);
+	CHECK(GetSendResult(400) == SendResult::Rejected);
+	CHECK(GetSendResult(404) == SendResult::Rejected);
+	CHECK(GetSendResult(413) == SendResult::Rejected);
+	CHECK(GetSendResult(408) == SendResult::Retry);
+	CHECK(GetSendResult(429) == SendResult::Retry);
+	CHECK(GetSendResult(500) == SendResult::Retry);
+	CHECK(GetSendResult(503) == SendResult::Retry);
+	CHECK(GetSendResult(301) == SendResult::Retry);
+	CHECK(GetSendResult(0) == SendResult::Retry);
+}
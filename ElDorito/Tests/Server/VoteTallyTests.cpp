@@ -0,0 +1,199 @@
+#include "Test.hpp"
+#include "Server/VoteTally.hpp"
+#include <algorithm>
+#include <map>
+#include <random>
+
+using namespace Server::Voting;
+
+namespace
+{
+	// What VotingSystem::LogVote does with a click in ranked-choice mode
+	bool ClickRanked(VoteTally &tally, int playerIndex, int option)
+	{
+		if (!tally.HasRanked(playerIndex, option))
+			return tally.AddPreference(playerIndex, option);
+		return tally.SetVote(playerIndex, option);
+	}
+
+	// Instant runoff written from scratch, with the same tie rules as VoteTally
+	int ReferenceRankedWinner(int optionCount, const std::vector<std::vector<int>> &ballots)
+	{
+		std::vector<bool> eliminated(optionCount);
+		auto remaining = optionCount;
+		while (true)
+		{
+			std::vector<int> counts(optionCount);
+			auto total = 0;
+			for (auto &&ballot : ballots)
+			{
+				auto choice = std::find_if(ballot.begin(), ballot.end(), [&](int option) { return !eliminated[option]; });
+				if (choice != ballot.end())
+				{
+					counts[*choice]++;
+					total++;
+				}
+			}
+
+			auto leader = -1, last = -1;
+			for (auto i = 0; i < optionCount; i++)
+			{
+				if (eliminated[i])
+					continue;
+				if (leader < 0 || counts[i] >= counts[leader])
+					leader = i;
+				if (last < 0 || counts[i] < counts[last])
+					last = i;
+			}
+			if (remaining == 1 || total == 0 || counts[leader] * 2 > total)
+				return leader;
+			eliminated[last] = true;
+			remaining--;
+		}
+	}
+}
+
+TEST_CASE(VoteTally, PluralityVotes)
+{
+	VoteTally tally;
+	tally.Reset(4);
+
+	// With no votes, the last option (the revote) wins
+	CHECK_EQUAL(3, tally.FindPluralityWinner());
+
+	CHECK(tally.SetVote(0, 0));
+	CHECK(tally.SetVote(1, 1));
+	CHECK(tally.SetVote(2, 1));
+	CHECK(tally.SetVote(3, 0));
+	CHECK_EQUAL(1, tally.FindPluralityWinner()); // Ties go to the later option
+	CHECK(!tally.SetVote(1, 1));
+
+	tally.SetVote(4, 0);
+	CHECK_EQUAL(0, tally.FindPluralityWinner());
+
+	// Players leaving take their votes with them
+	CHECK(tally.ClearVote(4));
+	CHECK(tally.ClearVote(3));
+	CHECK(!tally.ClearVote(3));
+	CHECK_EQUAL(1, tally.FindPluralityWinner());
+	CHECK_EQUAL(3, tally.GetVoterCount());
+
+	CHECK(!tally.SetVote(5, 9));
+	CHECK(!tally.SetVote(Blam::Network::MaxPlayers, 0));
+	CHECK(!tally.SetVote(-1, 0));
+}
+
+TEST_CASE(VoteTally, RankedVotes)
+{
+	VoteTally tally;
+	tally.Reset(3);
+
+	// First choices are A=2, B=1, C=2, so B is eliminated and its vote moves to C
+	int rankings[5][2] = { { 0, 1 }, { 0, 1 }, { 1, 2 }, { 2, 1 }, { 2, 1 } };
+	for (auto player = 0; player < 5; player++)
+	{
+		for (auto option : rankings[player])
+			CHECK(ClickRanked(tally, player, option));
+	}
+	CHECK_EQUAL(2, tally.FindRankedWinner());
+	CHECK_EQUAL(2, tally.FindPluralityWinner());
+
+	// Once C's voters leave, A has a majority
+	tally.ClearVote(3);
+	tally.ClearVote(4);
+	CHECK_EQUAL(0, tally.FindRankedWinner());
+}
+
+TEST_CASE(VoteTally, ReclickingStartsTheRankingOver)
+{
+	VoteTally tally;
+	tally.Reset(4);
+	ClickRanked(tally, 0, 0);
+	ClickRanked(tally, 0, 1);
+	ClickRanked(tally, 0, 2);
+	CHECK(tally.HasRanked(0, 2));
+	CHECK(!tally.HasRanked(0, 3));
+
+	// Adding an option that's already ranked is refused. LogVote replaces the vote instead.
+	CHECK(!tally.AddPreference(0, 1));
+	CHECK(ClickRanked(tally, 0, 1));
+	CHECK_EQUAL(1, tally.GetFirstChoiceCount(1));
+	CHECK_EQUAL(0, tally.GetFirstChoiceCount(0));
+	CHECK(!tally.HasRanked(0, 0));
+	CHECK(!tally.HasRanked(0, 2));
+	CHECK_EQUAL(1, tally.GetVoterCount());
+
+	// Clicking a sole choice again changes nothing
+	CHECK(!ClickRanked(tally, 0, 1));
+}
+
+TEST_CASE(VoteTally, RankedAgreesWithReference)
+{
+	// Replays random rounds of clicks, with players leaving mid-vote
+	std::mt19937 random(7);
+	VoteTally tally;
+	for (auto round = 0; round < 20000; round++)
+	{
+		auto optionCount = 1 + static_cast<int>(random() % MaxVotingOptions);
+		tally.Reset(optionCount);
+		std::map<int, std::vector<int>> ballots;
+		for (auto event = 0; event < 40; event++)
+		{
+			auto player = static_cast<int>(random() % Blam::Network::MaxPlayers);
+			if (random() % 10 == 0)
+			{
+				tally.ClearVote(player);
+				ballots.erase(player);
+				continue;
+			}
+
+			auto option = static_cast<int>(random() % optionCount);
+			ClickRanked(tally, player, option);
+			auto &ballot = ballots[player];
+			if (std::find(ballot.begin(), ballot.end(), option) != ballot.end())
+				ballot = { option };
+			else
+				ballot.push_back(option);
+		}
+
+		std::vector<std::vector<int>> ballotList;
+		std::vector<int> firstChoices(optionCount);
+		for (auto &&ballot : ballots)
+		{
+			ballotList.push_back(ballot.second);
+			firstChoices[ballot.second[0]]++;
+		}
+
+		auto ok = CHECK_EQUAL(ReferenceRankedWinner(optionCount, ballotList), tally.FindRankedWinner());
+		ok = CHECK_EQUAL(static_cast<int>(ballotList.size()), tally.GetVoterCount()) && ok;
+		for (auto i = 0; i < optionCount && ok; i++)
+			ok = CHECK_EQUAL(firstChoices[i], tally.GetFirstChoiceCount(i));
+		if (!ok)
+			break;
+	}
+}
+
+TEST_CASE(VotingRandom, SequenceOnlyDependsOnTheSeed)
+{
+	VotingRandom a, b;
+	CHECK(!a.IsSeeded());
+	a.Seed(42);
+	b.Seed(42);
+	CHECK(a.IsSeeded());
+	CHECK_EQUAL(42U, a.GetSeed());
+
+	auto same = true;
+	for (auto i = 0; i < 1000; i++)
+	{
+		auto value = a.Next(7);
+		same = same && value == b.Next(7);
+		if (!CHECK(value < 7))
+			break;
+	}
+	CHECK(same);
+
+	a.Seed(42);
+	auto first = a.Next(1000);
+	a.Seed(42);
+	CHECK_EQUAL(first, a.Next(1000));
+}
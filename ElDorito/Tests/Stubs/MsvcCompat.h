@@ -0,0 +1,28 @@
+#pragma once
+
+// Included before every source when not building with MSVC, for things the
+// game sources expect the MSVC runtime to define without an include.
+
+#define _countof(array) (sizeof(array) / sizeof((array)[0]))
+
+// Calling conventions only matter in the 32-bit game
+#define __cdecl
+#define __stdcall
+#define __thiscall
+
+#include <cstdio>
+#include <ctime>
+#include <sys/stat.h>
+
+#define _stat64 stat64
+
+inline int gmtime_s(struct tm *result, const time_t *time)
+{
+	return gmtime_r(time, result) ? 0 : -1;
+}
+
+template<size_t Size, typename... Args>
+inline int sprintf_s(char (&buffer)[Size], const char *format, Args... args)
+{
+	return snprintf(buffer, Size, format, args...);
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+// Stands in for the Windows port of dirent.h in ThirdParty. Like the port,
+// d_type holds S_IF* mode bits rather than DT_* values, so S_ISDIR() and
+// S_ISREG() can be used on it.
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <sys/stat.h>
+
+struct dirent
+{
+	char d_name[260];
+	unsigned int d_type;
+};
+
+struct DIR
+{
+	std::filesystem::directory_iterator it;
+	dirent entry;
+};
+
+inline DIR *opendir(const char *path)
+{
+	std::string native(path);
+	std::replace(native.begin(), native.end(), '\\', '/');
+	std::error_code error;
+	std::filesystem::directory_iterator it(native, error);
+	if (error)
+		return nullptr;
+	return new DIR{ it, {} };
+}
+
+inline dirent *readdir(DIR *dir)
+{
+	if (dir->it == std::filesystem::directory_iterator())
+		return nullptr;
+	auto name = dir->it->path().filename().string();
+	snprintf(dir->entry.d_name, sizeof(dir->entry.d_name), "%s", name.c_str());
+	dir->entry.d_type = dir->it->is_directory() ? S_IFDIR : (dir->it->is_regular_file() ? S_IFREG : 0);
+	std::error_code error;
+	dir->it.increment(error);
+	if (error)
+		dir->it = std::filesystem::directory_iterator();
+	return &dir->entry;
+}
+
+inline int closedir(DIR *dir)
+{
+	delete dir;
+	return 0;
+}
@@ -0,0 +1,5 @@
+#pragma once
+
+// Utils/String.cpp includes "String.h", which MSVC finds as the CRT's string.h.
+
+#include <string.h>
@@ -0,0 +1,124 @@
+#pragma once
+
+// Stands in for the Windows headers when the tests are built on other
+// platforms. Only what the tested code uses is here.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <strings.h>
+#include <thread>
+#include <vector>
+
+typedef unsigned long DWORD;
+typedef int BOOL;
+typedef void *HANDLE;
+typedef unsigned long long ULONGLONG;
+typedef void *LPVOID;
+
+#define WINAPI
+
+#define TRUE 1
+#define FALSE 0
+
+typedef struct
+{
+	DWORD dwLowDateTime;
+	DWORD dwHighDateTime;
+} FILETIME;
+
+typedef struct
+{
+	DWORD dwFileAttributes;
+	FILETIME ftCreationTime;
+	FILETIME ftLastAccessTime;
+	FILETIME ftLastWriteTime;
+	DWORD nFileSizeHigh;
+	DWORD nFileSizeLow;
+} WIN32_FILE_ATTRIBUTE_DATA;
+
+enum GET_FILEEX_INFO_LEVELS
+{
+	GetFileExInfoStandard,
+};
+
+inline int _stricmp(const char *a, const char *b) { return strcasecmp(a, b); }
+inline int _strnicmp(const char *a, const char *b, size_t n) { return strncasecmp(a, b, n); }
+
+inline ULONGLONG GetTickCount64()
+{
+	return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+inline DWORD GetTickCount()
+{
+	return static_cast<DWORD>(GetTickCount64());
+}
+
+// Converts a Windows path to a native one.
+inline std::filesystem::path StubPath(const wchar_t *path)
+{
+	std::wstring native(path);
+	std::replace(native.begin(), native.end(), L'\\', L'/');
+	return std::filesystem::path(native);
+}
+
+inline BOOL GetFileAttributesExW(const wchar_t *path, GET_FILEEX_INFO_LEVELS, WIN32_FILE_ATTRIBUTE_DATA *data)
+{
+	std::error_code error;
+	auto nativePath = StubPath(path);
+	auto size = std::filesystem::file_size(nativePath, error);
+	if (error)
+		return FALSE;
+	auto writeTime = std::filesystem::last_write_time(nativePath, error);
+	if (error)
+		return FALSE;
+
+	// Only differences between times matter, so the epoch doesn't need to match FILETIME's
+	auto ticks = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(writeTime.time_since_epoch()).count() / 100);
+	*data = {};
+	data->nFileSizeLow = static_cast<DWORD>(size & 0xFFFFFFFF);
+	data->nFileSizeHigh = static_cast<DWORD>(size >> 32);
+	data->ftLastWriteTime.dwLowDateTime = static_cast<DWORD>(ticks & 0xFFFFFFFF);
+	data->ftLastWriteTime.dwHighDateTime = static_cast<DWORD>(ticks >> 32);
+	return TRUE;
+}
+
+inline int _wfopen_s(FILE **file, const wchar_t *path, const wchar_t *mode)
+{
+	std::string narrowMode(mode, mode + wcslen(mode));
+	*file = fopen(StubPath(path).c_str(), narrowMode.c_str());
+	return *file ? 0 : 1;
+}
+
+typedef DWORD(*LPTHREAD_START_ROUTINE)(LPVOID);
+
+// Threads are joined when the test exits instead of being left running
+// while static objects they use are destroyed.
+struct StubThreads
+{
+	std::vector<std::thread> Threads;
+
+	~StubThreads()
+	{
+		for (auto &thread : Threads)
+			thread.join();
+	}
+
+	static StubThreads &Instance()
+	{
+		static StubThreads threads;
+		return threads;
+	}
+};
+
+inline HANDLE CreateThread(void *, size_t, LPTHREAD_START_ROUTINE start, LPVOID parameter, DWORD, DWORD *)
+{
+	auto &threads = StubThreads::Instance().Threads;
+	threads.emplace_back(start, parameter);
+	return reinterpret_cast<HANDLE>(threads.size());
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+// MSVC's __cpuid and _BitScanForward, for GCC and Clang.
+
+#include <cpuid.h>
+
+#undef __cpuid
+inline void __cpuid(int info[4], int leaf)
+{
+	__cpuid_count(leaf, 0, info[0], info[1], info[2], info[3]);
+}
+
+inline unsigned char _BitScanForward(unsigned long *index, unsigned long mask)
+{
+	if (!mask)
+		return 0;
+	*index = __builtin_ctzl(mask);
+	return 1;
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <chrono>
+#include <sstream>
+#include <string>
+
+namespace Tests
+{
+	typedef void(*TestFunc)();
+
+	// Adds a test or benchmark to the list that TestMain runs. Use the TEST_CASE and BENCHMARK macros instead.
+	struct Registration
+	{
+		Registration(const char *suite, const char *name, TestFunc func, bool isBenchmark);
+	};
+
+	// Records a failed check. The test keeps running.
+	void Fail(const char *file, int line, const std::string &message);
+
+	// Prints a benchmark result.
+	void Report(const std::string &label, double value, const char *unit);
+
+	inline bool Check(bool result, const char *expression, const char *file, int line)
+	{
+		if (!result)
+			Fail(file, line, expression);
+		return result;
+	}
+
+	template<typename Expected, typename Actual>
+	bool CheckEqual(const Expected &expected, const Actual &actual, const char *expression, const char *file, int line)
+	{
+		if (expected == actual)
+			return true;
+		std::stringstream message;
+		message << expression << " is " << actual << ", expected " << expected;
+		Fail(file, line, message.str());
+		return false;
+	}
+
+	// Runs a function a number of times and returns the average time per run in nanoseconds.
+	template<typename Func>
+	double Time(size_t iterations, Func func)
+	{
+		auto start = std::chrono::steady_clock::now();
+		for (size_t i = 0; i < iterations; i++)
+			func();
+		auto elapsed = std::chrono::steady_clock::now() - start;
+		return std::chrono::duration<double, std::nano>(elapsed).count() / iterations;
+	}
+}
+
+#define TEST_CASE(suite, name) \
+	static void suite##_##name(); \
+	static Tests::Registration suite##_##name##_registration(#suite, #name, suite##_##name, false); \
+	static void suite##_##name()
+
+#define BENCHMARK(suite, name) \
+	static void suite##_##name(); \
+	static Tests::Registration suite##_##name##_registration(#suite, #name, suite##_##name, true); \
+	static void suite##_##name()
+
+// Both return whether the check passed, so a test can stop if continuing would crash
+#define CHECK(expression) Tests::Check(!!(expression), #expression, __FILE__, __LINE__)
+#define CHECK_EQUAL(expected, actual) Tests::CheckEqual((expected), (actual), #actual, __FILE__, __LINE__)
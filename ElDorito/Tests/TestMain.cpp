@@ -0,0 +1,79 @@
+#include "Test.hpp"
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace
+{
+	struct TestCase
+	{
+		const char *Suite;
+		const char *Name;
+		Tests::TestFunc Func;
+		bool IsBenchmark;
+	};
+
+	std::vector<TestCase>& GetTestCases()
+	{
+		static std::vector<TestCase> testCases;
+		return testCases;
+	}
+
+	int failureCount = 0;
+}
+
+namespace Tests
+{
+	Registration::Registration(const char *suite, const char *name, TestFunc func, bool isBenchmark)
+	{
+		GetTestCases().push_back({ suite, name, func, isBenchmark });
+	}
+
+	void Fail(const char *file, int line, const std::string &message)
+	{
+		std::printf("%s(%d): check failed: %s\n", file, line, message.c_str());
+		failureCount++;
+	}
+
+	void Report(const std::string &label, double value, const char *unit)
+	{
+		std::printf("  %-48s %12.2f %s\n", label.c_str(), value, unit);
+	}
+}
+
+// Usage: <tests> [--bench] [name]
+// Runs the tests, or the benchmarks with --bench. If a name is given, only
+// tests whose suite or name matches it are run.
+int main(int argc, char *argv[])
+{
+	auto benchmarks = false;
+	const char *filter = nullptr;
+	for (auto i = 1; i < argc; i++)
+	{
+		if (std::strcmp(argv[i], "--bench") == 0)
+			benchmarks = true;
+		else
+			filter = argv[i];
+	}
+
+	auto runCount = 0;
+	auto failedCount = 0;
+	for (auto &test : GetTestCases())
+	{
+		if (test.IsBenchmark != benchmarks)
+			continue;
+		if (filter && std::strcmp(filter, test.Suite) != 0 && std::strcmp(filter, test.Name) != 0)
+			continue;
+
+		std::printf("%s.%s\n", test.Suite, test.Name);
+		std::fflush(stdout);
+		auto previousFailures = failureCount;
+		test.Func();
+		runCount++;
+		if (failureCount != previousFailures)
+			failedCount++;
+	}
+
+	std::printf("%d run, %d failed\n", runCount, failedCount);
+	return failedCount > 0 ? 1 : 0;
+}
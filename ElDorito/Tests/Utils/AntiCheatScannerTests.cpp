@@ -0,0 +1,104 @@
+#include "Test.hpp"
+#include "Utils/AntiCheatScanner.hpp"
+#include <atomic>
+#include <mutex>
+
+using namespace Utils::AntiCheat;
+
+namespace
+{
+	// Returns fake process data which a test can change while the scanner runs.
+	class FakeProcessInspector : public ProcessInspector
+	{
+	public:
+		std::atomic<int> ScanCount{ 0 };
+
+		void SetModulePaths(const std::vector<std::string> &paths)
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			modulePaths = paths;
+		}
+
+		void SetWindowTitles(const std::vector<std::string> &titles)
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			windowTitles = titles;
+		}
+
+		void GetModulePaths(std::vector<std::string> *result) override
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			*result = modulePaths;
+		}
+
+		void GetWindowTitles(std::vector<std::string> *result) override
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			*result = windowTitles;
+			ScanCount++;
+		}
+
+	private:
+		std::mutex mutex;
+		std::vector<std::string> modulePaths;
+		std::vector<std::string> windowTitles;
+	};
+
+	// Waits for the scanner to finish a number of scans after the current one.
+	void WaitForScans(FakeProcessInspector *inspector, int count)
+	{
+		auto target = inspector->ScanCount + count + 1;
+		auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+		while (inspector->ScanCount < target && std::chrono::steady_clock::now() < deadline)
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+}
+
+TEST_CASE(AntiCheatScanner, ScanFindsCheats)
+{
+	FakeProcessInspector inspector;
+	inspector.SetModulePaths({ "C:\\Games\\eldorado.exe", "C:\\Windows\\System32\\kernel32.dll" });
+	inspector.SetWindowTitles({ "ElDewrito", "Halo Online Trainer (not quite)" });
+	CHECK(Scan(&inspector) == Verdict::Clean);
+
+	inspector.SetWindowTitles({ "ElDewrito", "Halo Online Trainer" });
+	CHECK(Scan(&inspector) == Verdict::Trainer);
+
+	// Speedhacks are checked first
+	inspector.SetModulePaths({ "C:\\Games\\eldorado.exe", "C:\\Temp\\speedhack-i386.dll" });
+	CHECK(Scan(&inspector) == Verdict::SpeedHack);
+}
+
+TEST_CASE(AntiCheatScanner, VerdictIsHeldUntilTaken)
+{
+	auto inspector = std::make_shared<FakeProcessInspector>();
+	Scanner scanner(inspector, std::chrono::milliseconds(1));
+	scanner.Start();
+	WaitForScans(inspector.get(), 2);
+	CHECK(scanner.TakeVerdict() == Verdict::Clean);
+
+	// A verdict isn't lost if the cheat goes away before it's taken
+	inspector->SetWindowTitles({ "Halo Online Trainer" });
+	WaitForScans(inspector.get(), 1);
+	inspector->SetWindowTitles({});
+	WaitForScans(inspector.get(), 2);
+	CHECK(scanner.TakeVerdict() == Verdict::Trainer);
+	CHECK(scanner.TakeVerdict() == Verdict::Clean);
+	scanner.Stop();
+}
+
+TEST_CASE(AntiCheatScanner, StopDoesNotWaitOutTheInterval)
+{
+	auto inspector = std::make_shared<FakeProcessInspector>();
+	Scanner scanner(inspector, std::chrono::hours(1));
+	scanner.Start();
+	auto start = std::chrono::steady_clock::now();
+	scanner.Stop();
+	CHECK(std::chrono::steady_clock::now() - start < std::chrono::seconds(1));
+	CHECK_EQUAL(0, inspector->ScanCount.load());
+
+	// ScanNow works without the thread
+	inspector->SetModulePaths({ "speedhack-i386.dll" });
+	scanner.ScanNow();
+	CHECK(scanner.TakeVerdict() == Verdict::SpeedHack);
+}
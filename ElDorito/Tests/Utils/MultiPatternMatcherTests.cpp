@@ -0,0 +1,128 @@
+#include "Test.hpp"
+#include "Utils/MultiPatternMatcher.hpp"
+#include <cstring>
+#include <random>
+
+using Utils::MultiPatternMatcher;
+
+namespace
+{
+	std::string RandomString(std::mt19937 &random, const char *alphabet, size_t maxLength)
+	{
+		auto alphabetLength = std::strlen(alphabet);
+		std::string str(random() % (maxLength + 1), ' ');
+		for (auto &ch : str)
+			ch = alphabet[random() % alphabetLength];
+		return str;
+	}
+
+	// What the log filters did before the matcher: search for each pattern in turn
+	bool ContainsAny(const std::string &text, const std::vector<std::string> &patterns)
+	{
+		for (auto &&pattern : patterns)
+		{
+			if (std::strstr(text.c_str(), pattern.c_str()))
+				return true;
+		}
+		return false;
+	}
+
+	bool ContainsAll(const std::string &text, const std::vector<std::string> &patterns)
+	{
+		for (auto &&pattern : patterns)
+		{
+			if (!std::strstr(text.c_str(), pattern.c_str()))
+				return false;
+		}
+		return true;
+	}
+}
+
+TEST_CASE(MultiPatternMatcher, FindsOverlappingPatterns)
+{
+	MultiPatternMatcher matcher({ "he", "she", "his", "hers", "he" });
+	CHECK_EQUAL(5U, matcher.PatternCount());
+
+	std::vector<size_t> counts(5);
+	matcher.ForEachMatch("ushers", [&](size_t pattern) { counts[pattern]++; });
+	CHECK(counts == (std::vector<size_t>{ 1, 1, 0, 1, 1 }));
+
+	CHECK(matcher.MatchesAny("ahis"));
+	CHECK(!matcher.MatchesAny("xyz"));
+	CHECK(!matcher.MatchesAll("she"));
+	CHECK(matcher.MatchesAll("she his hers"));
+}
+
+TEST_CASE(MultiPatternMatcher, EmptyPatternsAndSets)
+{
+	MultiPatternMatcher none;
+	CHECK(!none.MatchesAny("text"));
+	CHECK(none.MatchesAll("text"));
+
+	MultiPatternMatcher empty({ "" });
+	CHECK(empty.MatchesAny(""));
+	CHECK(empty.MatchesAll("text"));
+
+	// Recompiling replaces the old patterns
+	empty.Compile({ "abc" });
+	CHECK(!empty.MatchesAny(""));
+	CHECK(empty.MatchesAny("xabcx"));
+
+	// Bytes outside ASCII are matched like any other
+	MultiPatternMatcher utf8({ "\xc3\xa9t\xc3\xa9" });
+	CHECK(utf8.MatchesAny("l'\xc3\xa9t\xc3\xa9"));
+	CHECK(!utf8.MatchesAny("\xc3\xa9"));
+}
+
+TEST_CASE(MultiPatternMatcher, AgreesWithStrstr)
+{
+	std::mt19937 random(5);
+	for (auto i = 0; i < 20000; i++)
+	{
+		std::vector<std::string> patterns(random() % 8);
+		for (auto &pattern : patterns)
+			pattern = RandomString(random, "abc", 3);
+		MultiPatternMatcher matcher(patterns);
+
+		auto text = RandomString(random, "abcd", 20);
+		if (!CHECK_EQUAL(ContainsAny(text, patterns), matcher.MatchesAny(text.c_str())) ||
+			!CHECK_EQUAL(ContainsAll(text, patterns), matcher.MatchesAll(text.c_str())))
+		{
+			break;
+		}
+	}
+}
+
+// Filters 100,000 log lines against 50 exclude filters, with the matcher and
+// by searching for each filter in turn.
+BENCHMARK(MultiPatternMatcher, FiftyLogFilters)
+{
+	std::vector<std::string> patterns;
+	for (auto i = 0; i < 50; i++)
+		patterns.push_back("filter_word_" + std::to_string(i * 7919));
+
+	std::vector<std::string> lines;
+	for (auto i = 0; i < 100000; i++)
+	{
+		auto line = "[12:00:00] Network - some log message number " + std::to_string(i) + " with payload data xyz abc";
+		if (i % 100 == 0)
+			line += patterns[i % 50];
+		lines.push_back(line);
+	}
+
+	MultiPatternMatcher matcher(patterns);
+	size_t matched = 0, searched = 0;
+	auto compiled = Tests::Time(1, [&]()
+	{
+		for (auto &&line : lines)
+			matched += matcher.MatchesAny(line.c_str());
+	});
+	auto perFilter = Tests::Time(1, [&]()
+	{
+		for (auto &&line : lines)
+			searched += ContainsAny(line, patterns);
+	});
+	CHECK_EQUAL(searched, matched);
+	Tests::Report("100,000 lines, matcher", compiled / 1e6, "ms");
+	Tests::Report("100,000 lines, strstr per filter", perFilter / 1e6, "ms");
+}
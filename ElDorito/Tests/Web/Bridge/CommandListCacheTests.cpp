@@ -0,0 +1,111 @@
+#include "Test.hpp"
+#include "Web/Bridge/Client/CommandListCache.hpp"
+#include "CommandMap.hpp"
+#include "ThirdParty/rapidjson/document.h"
+
+using namespace Modules;
+using Anvil::Client::Rendering::Bridge::CommandListCache;
+
+namespace
+{
+	Command* AddTestVariable(const std::string &name, const std::string &value)
+	{
+		Command command;
+		command.Name = name;
+		command.ModuleName = "Test";
+		command.Flags = eCommandFlagsNone;
+		command.Type = eCommandTypeVariableString;
+		command.ValueString = value;
+		command.DefaultValueString = value;
+		return CommandMap::Instance().AddCommand(command);
+	}
+
+	// Finds a command's value in a JSON array of commands, or returns an empty string.
+	std::string FindValue(const rapidjson::Value &commands, const std::string &name)
+	{
+		for (auto &&command : commands.GetArray())
+		{
+			if (command["name"].GetString() == name)
+				return command["value"].GetString();
+		}
+		return "";
+	}
+}
+
+TEST_CASE(CommandListCache, VersionChangesWhenCommandsChange)
+{
+	auto &commandMap = CommandMap::Instance();
+	auto before = commandMap.GetVersion();
+	auto command = AddTestVariable("Test.Versioned", "a");
+	CHECK(commandMap.GetVersion() > before);
+	CHECK_EQUAL(commandMap.GetVersion(), command->Version);
+
+	std::string value = "b", previous;
+	auto added = command->Version;
+	CHECK_EQUAL(eVariableSetReturnValueSuccess, commandMap.SetVariable(command, value, previous));
+	CHECK(command->Version > added);
+	CHECK_EQUAL(commandMap.GetVersion(), command->Version);
+
+	// A failed set doesn't count as a change
+	command->Type = eCommandTypeVariableInt;
+	value = "not a number";
+	auto changed = command->Version;
+	CHECK_EQUAL(eVariableSetReturnValueInvalidArgument, commandMap.SetVariable(command, value, previous));
+	CHECK_EQUAL(changed, command->Version);
+	command->Type = eCommandTypeVariableString;
+}
+
+TEST_CASE(CommandListCache, ListIsOnlyRebuiltWhenTheVersionChanges)
+{
+	auto &commandMap = CommandMap::Instance();
+	auto command = AddTestVariable("Test.Cached", "first");
+	CommandListCache cache;
+
+	rapidjson::Document list;
+	list.Parse(cache.GetList(commandMap).c_str());
+	if (!CHECK(list.IsArray()))
+		return;
+	CHECK_EQUAL(commandMap.Commands.size(), list.Size());
+	CHECK_EQUAL(std::string("first"), FindValue(list, "Test.Cached"));
+
+	// Changing the value without marking it leaves the cached list alone
+	command->ValueString = "second";
+	list.Parse(cache.GetList(commandMap).c_str());
+	CHECK_EQUAL(std::string("first"), FindValue(list, "Test.Cached"));
+
+	commandMap.MarkChanged(command);
+	list.Parse(cache.GetList(commandMap).c_str());
+	CHECK_EQUAL(std::string("second"), FindValue(list, "Test.Cached"));
+
+	// The returned string is the cached one until something changes
+	auto &cached = cache.GetList(commandMap);
+	CHECK(&cached == &cache.GetList(commandMap));
+}
+
+TEST_CASE(CommandListCache, ChangesSinceOnlyHasNewerCommands)
+{
+	auto &commandMap = CommandMap::Instance();
+	AddTestVariable("Test.Old", "old");
+	auto since = commandMap.GetVersion();
+	auto changed = AddTestVariable("Test.New", "new");
+	CommandListCache cache;
+
+	rapidjson::Document changes;
+	changes.Parse(cache.GetChangesSince(commandMap, since).c_str());
+	if (!CHECK(changes.IsObject()))
+		return;
+	CHECK_EQUAL(commandMap.GetVersion(), changes["version"].GetUint());
+	if (CHECK_EQUAL(1U, changes["commands"].Size()))
+		CHECK_EQUAL(std::string("new"), FindValue(changes["commands"], "Test.New"));
+
+	// Nothing has changed since the version that was just returned
+	since = changes["version"].GetUint();
+	changes.Parse(cache.GetChangesSince(commandMap, since).c_str());
+	CHECK_EQUAL(0U, changes["commands"].Size());
+
+	std::string value = "newer", previous;
+	commandMap.SetVariable(changed, value, previous);
+	changes.Parse(cache.GetChangesSince(commandMap, since).c_str());
+	if (CHECK_EQUAL(1U, changes["commands"].Size()))
+		CHECK_EQUAL(std::string("newer"), FindValue(changes["commands"], "Test.New"));
+}
@@ -0,0 +1,225 @@
+#include "Test.hpp"
+#include "Web/Bridge/WebRendererQueryHandler.hpp"
+#include <vector>
+
+using namespace Anvil::Client::Rendering::Bridge;
+
+namespace
+{
+	// Records how a query was answered.
+	struct Response
+	{
+		bool Answered = false;
+		bool Succeeded = false;
+		int ErrorCode = 0;
+		std::string Text;
+	};
+
+	class RecordingCallback : public CefMessageRouterBrowserSide::Callback
+	{
+	public:
+		explicit RecordingCallback(Response *response) : response(response) {}
+
+		void Success(const CefString &text) override
+		{
+			Record(true, QueryError_Ok, text);
+		}
+
+		void Failure(int errorCode, const CefString &text) override
+		{
+			Record(false, errorCode, text);
+		}
+
+	private:
+		Response *response;
+
+		void Record(bool succeeded, int errorCode, const CefString &text)
+		{
+			if (response->Answered)
+				Tests::Fail(__FILE__, __LINE__, "Query answered twice");
+			response->Answered = true;
+			response->Succeeded = succeeded;
+			response->ErrorCode = errorCode;
+			response->Text = text.ToString();
+		}
+	};
+
+	void Query(WebRendererQueryHandler *handler, const std::string &request, Response *response)
+	{
+		CefRefPtr<CefMessageRouterBrowserSide::Callback> callback(new RecordingCallback(response));
+		handler->OnQuery(nullptr, nullptr, 0, request, false, callback);
+	}
+
+	// A handler with a "count" method which returns how many times it has been called
+	// and a "fail" method which always fails.
+	struct TestHandler
+	{
+		WebRendererQueryHandler Handler;
+		int Count = 0;
+
+		TestHandler()
+		{
+			Handler.AddMethod("count", [this](const rapidjson::Value &, std::string *result)
+			{
+				*result = std::to_string(++Count);
+				return QueryError_Ok;
+			});
+			Handler.AddMethod("fail", [](const rapidjson::Value &, std::string *result)
+			{
+				*result = "failed";
+				return QueryError_CommandFailed;
+			});
+		}
+	};
+
+	const char *CountQuery = "{\"method\":\"count\",\"args\":{}}";
+
+	std::string MakeBatch(size_t calls)
+	{
+		std::string batch = "{\"batch\":[";
+		for (size_t i = 0; i < calls; i++)
+			batch += (i > 0 ? "," : "") + std::string(CountQuery);
+		return batch + "]}";
+	}
+}
+
+TEST_CASE(WebRendererQueryHandler, SingleCallsRunOnUpdate)
+{
+	TestHandler test;
+	Response ok, failed, unknown, bad;
+	Query(&test.Handler, CountQuery, &ok);
+	Query(&test.Handler, "{\"method\":\"fail\",\"args\":{}}", &failed);
+	Query(&test.Handler, "{\"method\":\"nope\",\"args\":{}}", &unknown);
+	Query(&test.Handler, "{\"method\":", &bad);
+
+	// Queries which can't be run are answered straight away
+	CHECK(unknown.Answered);
+	CHECK_EQUAL(static_cast<int>(QueryError_UnsupportedMethod), unknown.ErrorCode);
+	CHECK(bad.Answered);
+	CHECK_EQUAL(static_cast<int>(QueryError_BadQuery), bad.ErrorCode);
+	CHECK(!ok.Answered);
+
+	test.Handler.Update();
+	CHECK(ok.Succeeded);
+	CHECK_EQUAL(std::string("1"), ok.Text);
+	CHECK(failed.Answered && !failed.Succeeded);
+	CHECK_EQUAL(static_cast<int>(QueryError_CommandFailed), failed.ErrorCode);
+	CHECK_EQUAL(std::string("failed"), failed.Text);
+}
+
+TEST_CASE(WebRendererQueryHandler, FullQueueRejectsQueries)
+{
+	TestHandler test;
+	std::vector<Response> responses(WebRendererQueryHandler::MaxPendingQueries + 1);
+	for (auto &response : responses)
+		Query(&test.Handler, CountQuery, &response);
+
+	auto &rejected = responses.back();
+	CHECK(rejected.Answered);
+	CHECK_EQUAL(static_cast<int>(QueryError_Busy), rejected.ErrorCode);
+
+	// Once the queue drains, queries are accepted again
+	for (size_t i = 0; i < WebRendererQueryHandler::MaxPendingQueries; i++)
+		test.Handler.Update();
+	CHECK(responses[WebRendererQueryHandler::MaxPendingQueries - 1].Succeeded);
+
+	Response retry;
+	Query(&test.Handler, CountQuery, &retry);
+	test.Handler.Update();
+	CHECK(retry.Succeeded);
+}
+
+TEST_CASE(WebRendererQueryHandler, UpdateStopsAtTheCallBudget)
+{
+	TestHandler test;
+	std::vector<Response> responses(WebRendererQueryHandler::MaxCallsPerFrame * 2 + 1);
+	for (auto &response : responses)
+		Query(&test.Handler, CountQuery, &response);
+
+	// Frames can also stop early because of the time budget, so only check upper bounds and progress
+	test.Handler.Update();
+	CHECK(test.Count > 0);
+	CHECK(test.Count <= static_cast<int>(WebRendererQueryHandler::MaxCallsPerFrame));
+	CHECK(!responses.back().Answered);
+
+	auto frames = 1;
+	for (; frames < 100 && !responses.back().Answered; frames++)
+		test.Handler.Update();
+	CHECK(frames >= 3);
+	CHECK_EQUAL(static_cast<int>(responses.size()), test.Count);
+}
+
+TEST_CASE(WebRendererQueryHandler, BatchesAnswerOnceWithEveryResult)
+{
+	TestHandler test;
+	Response batch;
+	Query(&test.Handler, "{\"batch\":[{\"method\":\"count\",\"args\":{}},{\"method\":\"nope\",\"args\":{}},{\"method\":\"fail\",\"args\":{}}]}", &batch);
+	test.Handler.Update();
+
+	CHECK(batch.Succeeded);
+	rapidjson::Document results;
+	results.Parse(batch.Text.c_str());
+	if (!CHECK(results.IsArray() && results.Size() == 3))
+		return;
+	CHECK_EQUAL(static_cast<int>(QueryError_Ok), results[0]["code"].GetInt());
+	CHECK_EQUAL(std::string("1"), std::string(results[0]["result"].GetString()));
+	CHECK_EQUAL(static_cast<int>(QueryError_UnsupportedMethod), results[1]["code"].GetInt());
+	CHECK_EQUAL(static_cast<int>(QueryError_CommandFailed), results[2]["code"].GetInt());
+
+	Response tooLarge, empty;
+	Query(&test.Handler, MakeBatch(WebRendererQueryHandler::MaxBatchSize + 1), &tooLarge);
+	Query(&test.Handler, "{\"batch\":[]}", &empty);
+	CHECK_EQUAL(static_cast<int>(QueryError_BadQuery), tooLarge.ErrorCode);
+	CHECK_EQUAL(static_cast<int>(QueryError_BadQuery), empty.ErrorCode);
+}
+
+TEST_CASE(WebRendererQueryHandler, BatchesContinueOnTheNextFrame)
+{
+	TestHandler test;
+	std::vector<Response> singles(WebRendererQueryHandler::MaxCallsPerFrame / 2);
+	for (auto &response : singles)
+		Query(&test.Handler, CountQuery, &response);
+	Response batch;
+	Query(&test.Handler, MakeBatch(WebRendererQueryHandler::MaxBatchSize), &batch);
+
+	for (auto frames = 0; frames < 100 && !batch.Answered; frames++)
+	{
+		auto before = test.Count;
+		test.Handler.Update();
+		CHECK(test.Count - before <= static_cast<int>(WebRendererQueryHandler::MaxCallsPerFrame));
+	}
+
+	rapidjson::Document results;
+	results.Parse(batch.Text.c_str());
+	if (CHECK(results.IsArray() && results.Size() == WebRendererQueryHandler::MaxBatchSize))
+		CHECK_EQUAL(std::to_string(test.Count), std::string(results[results.Size() - 1]["result"].GetString()));
+}
+
+TEST_CASE(WebRendererQueryHandler, StatsCountCalls)
+{
+	TestHandler test;
+	std::vector<Response> responses(3);
+	Query(&test.Handler, CountQuery, &responses[0]);
+	Query(&test.Handler, CountQuery, &responses[1]);
+	Query(&test.Handler, "{\"method\":\"fail\",\"args\":{}}", &responses[2]);
+	test.Handler.Update();
+
+	WebRendererQueryStats stats;
+	if (CHECK(test.Handler.GetStats("count", &stats)))
+	{
+		CHECK_EQUAL(2U, stats.m_Calls);
+		CHECK_EQUAL(0U, stats.m_Failures);
+		CHECK(stats.m_MaxRunTime >= 0 && stats.m_TotalWaitTime >= 0);
+	}
+	if (CHECK(test.Handler.GetStats("fail", &stats)))
+		CHECK_EQUAL(1U, stats.m_Failures);
+	CHECK(!test.Handler.GetStats("nope", &stats));
+
+	Response statsQuery;
+	Query(&test.Handler, "{\"method\":\"queryStats\",\"args\":{}}", &statsQuery);
+	test.Handler.Update();
+	rapidjson::Document json;
+	json.Parse(statsQuery.Text.c_str());
+	if (CHECK(json.IsObject() && json.HasMember("count")))
+		CHECK_EQUAL(2U, json["count"]["calls"].GetUint());
+}
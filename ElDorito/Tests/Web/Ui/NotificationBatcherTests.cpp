@@ -0,0 +1,136 @@
+#include "Test.hpp"
+#include "Web/Ui/NotificationBatcher.hpp"
+#include <random>
+#include <regex>
+
+using Web::Ui::NotificationBatcher;
+
+namespace
+{
+	// Stands in for the screen layer's ExecuteJavascript
+	struct CountingExecutor
+	{
+		size_t Calls = 0;
+		std::vector<std::string> Notifications; // "event|data|broadcast" for each ui.notify call, in order
+
+		NotificationBatcher::ExecuteFunc Func()
+		{
+			return [this](const std::string &js)
+			{
+				Calls++;
+				static const std::regex notifyCall("ui\\.notify\\('([^']*)',(.*?),(true|false),true\\);");
+				for (std::sregex_iterator it(js.begin(), js.end(), notifyCall), end; it != end; ++it)
+					Notifications.push_back((*it)[1].str() + "|" + (*it)[2].str() + "|" + (*it)[3].str());
+			};
+		}
+	};
+
+	std::string Expected(const std::string &event, const std::string &data, bool broadcast)
+	{
+		return event + "|" + data + "|" + (broadcast ? "true" : "false");
+	}
+}
+
+TEST_CASE(NotificationBatcher, SendsOneScriptPerFlush)
+{
+	CountingExecutor executor;
+	NotificationBatcher batcher(executor.Func());
+
+	// Nothing queued, nothing run
+	batcher.Flush();
+	CHECK_EQUAL(0U, executor.Calls);
+
+	batcher.Queue("chat", "{\"message\":\"hi\"}", true);
+	batcher.Queue("mpevent", "{\"name\":\"kill\"}", true);
+	batcher.Queue("chat", "{\"message\":\"gg\"}", false);
+	CHECK_EQUAL(3U, batcher.GetPendingCount());
+	batcher.Flush();
+	batcher.Flush();
+
+	CHECK_EQUAL(1U, executor.Calls);
+	CHECK_EQUAL(0U, batcher.GetPendingCount());
+	CHECK((executor.Notifications == std::vector<std::string>
+	{
+		Expected("chat", "{\"message\":\"hi\"}", true),
+		Expected("mpevent", "{\"name\":\"kill\"}", true),
+		Expected("chat", "{\"message\":\"gg\"}", false),
+	}));
+}
+
+TEST_CASE(NotificationBatcher, CoalescedEventsKeepTheLatestPayload)
+{
+	CountingExecutor executor;
+	NotificationBatcher batcher(executor.Func());
+	batcher.SetCoalesced("scoreboard", true);
+
+	batcher.Queue("scoreboard", "1", true);
+	batcher.Queue("chat", "{}", true);
+	batcher.Queue("scoreboard", "2", true);
+	batcher.Queue("scoreboard", "3", false); // Visible-only doesn't replace broadcast
+	batcher.Queue("scoreboard", "4", true);
+	CHECK_EQUAL(3U, batcher.GetPendingCount());
+	batcher.Flush();
+
+	// The replacement moves to the end, after everything queued before it
+	CHECK((executor.Notifications == std::vector<std::string>
+	{
+		Expected("chat", "{}", true),
+		Expected("scoreboard", "3", false),
+		Expected("scoreboard", "4", true),
+	}));
+
+	// Turning coalescing off delivers every notification again
+	executor.Notifications.clear();
+	batcher.SetCoalesced("scoreboard", false);
+	batcher.Queue("scoreboard", "5", true);
+	batcher.Queue("scoreboard", "6", true);
+	batcher.Flush();
+	CHECK_EQUAL(2U, executor.Notifications.size());
+}
+
+TEST_CASE(NotificationBatcher, ReplayedBurstArrivesInOrder)
+{
+	CountingExecutor executor;
+	NotificationBatcher batcher(executor.Func());
+	batcher.SetCoalesced("scoreboard", true);
+	batcher.SetCoalesced("timerUpdate", true);
+
+	// Replay a burst of game events over 100 frames. The expected delivery is every
+	// notification in order, minus any coalesced one that was replaced in the same frame.
+	std::mt19937 random(4);
+	const char *events[] = { "mpevent", "chat", "scoreboard", "timerUpdate" };
+	std::vector<std::string> expected;
+	for (auto frame = 0; frame < 100; frame++)
+	{
+		std::vector<std::pair<std::string, std::string>> frameQueue; // (coalescing key, notification)
+		auto count = random() % 30;
+		for (auto i = 0U; i < count; i++)
+		{
+			std::string event = events[random() % 4];
+			auto data = std::to_string(frame * 100 + i);
+			auto broadcast = random() % 2 == 0;
+			batcher.Queue(event, data, broadcast);
+
+			auto key = event + (broadcast ? "b" : "v");
+			if (event == "scoreboard" || event == "timerUpdate")
+			{
+				for (auto it = frameQueue.begin(); it != frameQueue.end(); ++it)
+				{
+					if (it->first == key)
+					{
+						frameQueue.erase(it);
+						break;
+					}
+				}
+			}
+			frameQueue.emplace_back(key, Expected(event, data, broadcast));
+		}
+		for (auto &&queued : frameQueue)
+			expected.push_back(queued.second);
+		batcher.Flush();
+	}
+
+	CHECK(executor.Calls <= 100U);
+	CHECK_EQUAL(expected.size(), executor.Notifications.size());
+	CHECK(expected == executor.Notifications);
+}
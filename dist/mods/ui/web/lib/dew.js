@@ -97,7 +97,12 @@ DewErrorCode = {
     /**
      * The console command failed to execute successfully.
      */
-    COMMAND_FAILED: 8
+    COMMAND_FAILED: 8,
+
+    /**
+     * Too many queries are waiting to be processed. Try again later.
+     */
+    BUSY: 9
 };
 
 /**
@@ -248,6 +253,49 @@ CommandType = {
         });
     }
 
+    // Calls several native methods in one query and returns a Promise for an array of results.
+    // Each call is an object with a method name and optional args and resultMapping.
+    // Each result is either the mapped value or a DewError if that call failed.
+    dew.callMethods = function (calls) {
+        return new Promise(function (resolve, reject) {
+            if (!window.dewQuery) {
+                reject(new DewError("Unsupported method: window.dewQuery() is not available", DewErrorCode.UNSUPPORTED_METHOD, "batch"));
+                return;
+            }
+
+            var batch = calls.map(function (call) {
+                return {
+                    method: call.method,
+                    args: call.args || {}
+                };
+            });
+            window.dewQuery({
+                request: JSON.stringify({
+                    batch: batch
+                }),
+                persistent: false,
+                onSuccess: function (resultStr) {
+                    var results;
+                    try {
+                        results = JSON.parse(resultStr).map(function (result, i) {
+                            if (result.code !== DewErrorCode.OK) {
+                                return new DewError(result.result, result.code, calls[i].method);
+                            }
+                            return (calls[i].resultMapping || defaultResultMapping)(result.result);
+                        });
+                    } catch (e) {
+                        reject(e);
+                        return;
+                    }
+                    resolve(results);
+                },
+                onFailure: function (code, message) {
+                    reject(new DewError(message, code, "batch"));
+                }
+            });
+        });
+    }
+
     // Registers an event handler for a UI event.
     function registerEvent(name, callback) {
         window.addEventListener("message", function (event) {